@@ -2,20 +2,44 @@
 #extension GL_ARB_texture_gather : enable
 #endif
 
-uniform sampler2D tex;
+#ifdef GL_ES
+precision mediump sampler2DArray;
+#endif
+
+// World textures are layers of a texture array, see std3D_AddToTextureCache
+uniform sampler2DArray tex;
 uniform sampler2D worldPalette;
 uniform int tex_mode;
 uniform int blend_mode;
+uniform vec3 colorEffects_mul;
 in vec4 f_color;
+in vec4 f_light;
 in vec2 f_uv;
+in float f_layer;
 in vec3 f_coord;
 out vec4 fragColor;
 
 void main(void)
 {
-    vec4 sampled = texture(tex, f_uv);
+    vec4 sampled = texture(tex, vec3(f_uv, f_layer));
     vec4 sampled_color = vec4(1.0, 1.0, 1.0, 1.0);
     vec4 vertex_color = f_color;
+
+    // f_light is rdCache_SendFaceListToHardware's light word: the vertex
+    // intensity, extralight biased by 128, the ambient floor and the lighting
+    // mode + 1. Mode -1 means the color came in already lit, 0 is fully lit.
+    int light_mode = int(f_light.a * 255.0 + 0.5) - 1;
+    if (light_mode > 0)
+    {
+        float light = (f_light.g * 255.0 - 128.0) / 127.0;
+        if (light_mode != 1)
+            light += f_light.r;
+        vertex_color.rgb *= max(clamp(light, 0.0, 1.0), f_light.b);
+    }
+
+    // Palette filter/tint/fade
+    vertex_color.rgb = clamp(vertex_color.rgb * colorEffects_mul, 0.0, 1.0);
+
     float index = sampled.r;
     vec4 palval = texture(worldPalette, vec2(index, 0.5));
 
@@ -36,7 +60,7 @@ void main(void)
             discard;
 
         // Get texture size in pixels:
-        vec2 colorTextureSize = vec2(textureSize(tex, 0));
+        vec2 colorTextureSize = vec2(textureSize(tex, 0).xy);
 
         // Convert UV coordinates to pixel coordinates and get pixel index of top left pixel (assuming UVs are relative to top left corner of texture)
         vec2 pixCoord = f_uv * colorTextureSize - 0.5f;    // First pixel goes from -0.5 to +0.4999 (0.0 is center) last pixel goes from (size - 1.5) to (size - 0.5000001)
@@ -45,10 +69,10 @@ void main(void)
         // For Gather we want UV coordinates of bottom right corner of top left pixel
         vec2 gUV = (originPixCoord + 1.0f) / colorTextureSize;
 
-        vec4 gR   = textureGather(tex, gUV, 0);
-        vec4 gG   = textureGather(tex, gUV, 1);
-        vec4 gB   = textureGather(tex, gUV, 2);
-        vec4 gA   = textureGather(tex, gUV, 3);
+        vec4 gR   = textureGather(tex, vec3(gUV, f_layer), 0);
+        vec4 gG   = textureGather(tex, vec3(gUV, f_layer), 1);
+        vec4 gB   = textureGather(tex, vec3(gUV, f_layer), 2);
+        vec4 gA   = textureGather(tex, vec3(gUV, f_layer), 3);
 
         vec4 c00   = vec4(gB.w, gG.w, gR.w, gA.w);
         vec4 c01 = vec4(gB.x, gG.x, gR.x, gA.x);
@@ -82,7 +106,7 @@ void main(void)
     else if (tex_mode == 2)
     {
         // Get texture size in pixels:
-        vec2 colorTextureSize = vec2(textureSize(tex, 0));
+        vec2 colorTextureSize = vec2(textureSize(tex, 0).xy);
 
         // Convert UV coordinates to pixel coordinates and get pixel index of top left pixel (assuming UVs are relative to top left corner of texture)
         vec2 pixCoord = f_uv * colorTextureSize - 0.5f;    // First pixel goes from -0.5 to +0.4999 (0.0 is center) last pixel goes from (size - 1.5) to (size - 0.5000001)
@@ -91,7 +115,7 @@ void main(void)
         // For Gather we want UV coordinates of bottom right corner of top left pixel
         vec2 gUV = (originPixCoord + 1.0f) / colorTextureSize;
 
-        vec4 gIndex   = textureGather(tex, gUV);
+        vec4 gIndex   = textureGather(tex, vec3(gUV, f_layer));
 
         vec4 c00   = texture(worldPalette, vec2(gIndex.w, 0.5));
         vec4 c01 = texture(worldPalette, vec2(gIndex.x, 0.5));
@@ -1,18 +1,49 @@
 in vec3 coord3d;
 in vec4 v_color;
 in vec2 v_uv;
+in float v_layer;
+in vec4 v_inst_x;
+in vec4 v_inst_y;
+in vec4 v_inst_z;
+in vec4 v_inst_light;
+in vec4 v_light;
 uniform mat4 mvp;
+uniform mat4 mvp_static;
+uniform int static_geo;
 out vec4 f_color;
+out vec4 f_light;
 out vec2 f_uv;
+out float f_layer;
 out vec3 f_coord;
 
 void main(void)
 {
-    vec4 pos = mvp * vec4(coord3d, 1.0);
-    pos.w = 1.0/(1.0-coord3d.z);
-    pos.xyz *= pos.w;
-    gl_Position = pos;
+    if (static_geo == 1)
+    {
+        // Resident level geometry, coord3d is in world space
+        gl_Position = mvp_static * vec4(coord3d, 1.0);
+    }
+    else if (static_geo == 2)
+    {
+        // Instanced model mesh, coord3d is in model space
+        vec4 pos = vec4(coord3d, 1.0);
+        gl_Position = mvp_static * vec4(dot(v_inst_x, pos), dot(v_inst_y, pos), dot(v_inst_z, pos), 1.0);
+    }
+    else
+    {
+        vec4 pos = mvp * vec4(coord3d, 1.0);
+        pos.w = 1.0/(1.0-coord3d.z);
+        pos.xyz *= pos.w;
+        gl_Position = pos;
+    }
     f_color = v_color.bgra;
+    if (static_geo == 2)
+    {
+        // Vertex light with the instance's ambient floor and sector tint
+        f_color.rgb = vec3(max(f_color.r, v_inst_light.a)) * v_inst_light.rgb;
+    }
+    f_light = v_light;
     f_uv = v_uv;
+    f_layer = v_layer;
     f_coord = coord3d;
 }
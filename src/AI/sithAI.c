@@ -8,6 +8,7 @@
 #include "World/jkPlayer.h"
 #include "World/sithSector.h"
 #include "World/sithWorld.h"
+#include "World/sithPVS.h"
 #include "World/sithWeapon.h"
 #include "AI/sithAICmd.h"
 #include "AI/sithAIClass.h"
@@ -1055,6 +1056,11 @@ int sithAI_sub_4EB090(sithThing *a3, rdVector3 *a4, sithThing *arg8, float argC,
             return 2;
     }
     v21 = sithCollision_GetSectorLookAt(a3->sector, &a3->position, a4, 0.0);
+
+    // Added: skip the ray when no line can reach the target's sector
+    if ( !sithPVS_IsNearVisible(v21, arg8->sector) )
+        return 3;
+
     sithCollision_SearchRadiusForThings(v21, a3, a4, a5, *a8, 0.0, 0x102);
     v22 = sithCollision_NextSearchResult();
     if ( v22 )
@@ -8,6 +8,7 @@
 #include "World/jkPlayer.h"
 #include "World/sithItem.h"
 #include "Engine/sithCollision.h"
+#include "Engine/sithCollisionGrid.h"
 #include "Engine/sithCamera.h"
 #include "Engine/rdThing.h"
 #include "Engine/sithNet.h"
@@ -284,6 +285,7 @@ void sithCogFunctionThing_JumpToFrame(sithCog *ctx)
 
         rdMatrix_BuildRotate34(&thing->lookOrientation, &thing->trackParams.frames[frame].rot);
         rdVector_Copy3(&thing->position, &thing->trackParams.frames[frame].pos);
+        sithCollisionGrid_UpdateThing(thing); // Added
 
         if ( !thing->sector )
             sithThing_EnterSector(thing, sector, 1, 0);
@@ -621,6 +623,7 @@ void sithCogFunctionThing_SetThingPos(sithCog *ctx)
     if (thing)
     {
         rdVector_Copy3(&thing->position, &poppedVec);
+        sithCollisionGrid_UpdateThing(thing); // Added
         if (sithCogVm_multiplayerFlags 
             && !(ctx->flags & 0x200)
             && ctx->trigId != SITH_MESSAGE_STARTUP 
@@ -2140,7 +2143,10 @@ void sithCogFunctionThing_SetThingCollideSize(sithCog *ctx)
     sithThing* thing = sithCogVm_PopThing(ctx);
 
     if (thing)
+    {
         thing->collideSize = size;
+        sithCollisionGrid_UpdateThing(thing); // Added
+    }
 }
 
 void sithCogFunctionThing_GetThingMoveSize(sithCog *ctx)
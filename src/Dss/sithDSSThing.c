@@ -5,6 +5,7 @@
 #include "Engine/sithSoundSys.h"
 #include "Engine/sithSurface.h"
 #include "Engine/sithSound.h"
+#include "Engine/sithCollisionGrid.h"
 #include "World/sithThing.h"
 #include "World/sithSector.h"
 
@@ -241,6 +242,9 @@ int sithDSSThing_HandleSyncThingFull(sithCogMsg *msg)
     thing->thing_id = NETMSG_POPS32();
     thing->type = type;
     thing->thingtype = type; // Added: why is this needed?
+#ifdef QOL_IMPROVEMENTS
+    sithThing_AddActive(thing); // Added
+#endif
     thing->position = NETMSG_POPVEC3();
     thing->lookOrientation.rvec = NETMSG_POPVEC3();
     thing->lookOrientation.lvec = NETMSG_POPVEC3();
@@ -261,6 +265,7 @@ int sithDSSThing_HandleSyncThingFull(sithCogMsg *msg)
     thing->collideSize = NETMSG_POPF32();
     thing->light = NETMSG_POPF32();
     thing->jkFlags = NETMSG_POPU32();
+    sithCollisionGrid_UpdateThing(thing); // Added
 
     if ( thing->thingflags & SITH_TF_CAPTURED )
     {
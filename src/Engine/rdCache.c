@@ -5,29 +5,437 @@
 #include "Platform/std3D.h"
 #include "Engine/rdColormap.h"
 #include "General/stdMath.h"
+#include "General/stdProfiler.h"
+#include "Raster/rdRaster.h"
 
 #include <math.h>
+#include <string.h>
 
 #ifdef QOL_IMPROVEMENTS
 static int rdCache_totalLines = 0;
+#ifndef SDL2_RENDER
 static rdLine rdCache_aHWLines[1024];
 #endif
+#endif
+
+#ifdef QOL_IMPROVEMENTS
+int rdCache_frameFlushes = 0;
+int rdCache_lastFrameFlushes = 0;
+#endif
+
+#ifdef SDL2_RENDER
+// The frame render list grows to its high-water mark and is reused between
+// frames, instead of flushing every time the JK.EXE-sized arrays fill up.
+static rdProcEntry* rdCache_pProcFaces = NULL;
+static rdVector3* rdCache_pVertices = NULL;
+static rdVector2* rdCache_pTexVertices = NULL;
+static float* rdCache_pIntensities = NULL;
+static D3DVERTEX* rdCache_pHWVertices = NULL;
+static rdTri* rdCache_pHWSolidTris = NULL;
+static rdTri* rdCache_pHWNormalTris = NULL;
+static rdTri* rdCache_pHWSortTris = NULL;
+static rdLine* rdCache_pHWLines = NULL;
+static rdProcEntry* rdCache_pSortProcFaces = NULL;
+static rdCacheDepthKey* rdCache_pDepthKeys = NULL; // 2x rdCache_maxProcFaces, keys and scratch
+static size_t rdCache_maxProcFaces = 0;
+static size_t rdCache_maxVertices = 0;
+static size_t rdCache_maxHWVertices = 0;
+static size_t rdCache_maxHWTris = 0;
+
+#define rdCache_aProcFaces rdCache_pProcFaces
+#define rdCache_aVertices rdCache_pVertices
+#define rdCache_aTexVertices rdCache_pTexVertices
+#define rdCache_aIntensities rdCache_pIntensities
+#define rdCache_aHWVertices rdCache_pHWVertices
+#define rdCache_aHWSolidTris rdCache_pHWSolidTris
+#define rdCache_aHWNormalTris rdCache_pHWNormalTris
+#define rdCache_aHWLines rdCache_pHWLines
+
+static void* rdCache_GrowArray(void* pOld, size_t oldAmt, size_t newAmt, size_t entrySize)
+{
+    void* pNew = rdroid_pHS->alloc(newAmt * entrySize);
+    if (!pNew)
+        return NULL;
+
+    if (pOld)
+    {
+        _memcpy(pNew, pOld, oldAmt * entrySize);
+        rdroid_pHS->free(pOld);
+    }
+    return pNew;
+}
+
+static int rdCache_EnsureProcFaces(size_t amt)
+{
+    size_t newMax;
+    rdProcEntry* pNew;
+
+    if (amt <= rdCache_maxProcFaces)
+        return 1;
+
+    newMax = rdCache_maxProcFaces ? rdCache_maxProcFaces : RDCACHE_MAX_TRIS;
+    while (newMax < amt)
+        newMax *= 2;
+
+    pNew = (rdProcEntry*)rdCache_GrowArray(rdCache_pProcFaces, rdCache_maxProcFaces, newMax, sizeof(rdProcEntry));
+    if (!pNew)
+        return 0;
+    rdCache_pProcFaces = pNew;
+
+    // Depth sort scratch, nothing in it survives a flush
+    if (rdCache_pSortProcFaces)
+        rdroid_pHS->free(rdCache_pSortProcFaces);
+    if (rdCache_pDepthKeys)
+        rdroid_pHS->free(rdCache_pDepthKeys);
+    rdCache_pSortProcFaces = (rdProcEntry*)rdroid_pHS->alloc(newMax * sizeof(rdProcEntry));
+    rdCache_pDepthKeys = (rdCacheDepthKey*)rdroid_pHS->alloc(2 * newMax * sizeof(rdCacheDepthKey));
+
+    rdCache_maxProcFaces = newMax;
+    return 1;
+}
+
+static int rdCache_EnsureVertices(size_t amt)
+{
+    size_t newMax;
+    rdVector3* pNewVertices;
+    rdVector2* pNewTexVertices;
+    float* pNewIntensities;
+
+    if (amt <= rdCache_maxVertices)
+        return 1;
+
+    newMax = rdCache_maxVertices ? rdCache_maxVertices : RDCACHE_MAX_VERTICES;
+    while (newMax < amt)
+        newMax *= 2;
+
+    pNewVertices = (rdVector3*)rdroid_pHS->alloc(newMax * sizeof(rdVector3));
+    pNewTexVertices = (rdVector2*)rdroid_pHS->alloc(newMax * sizeof(rdVector2));
+    pNewIntensities = (float*)rdroid_pHS->alloc(newMax * sizeof(float));
+    if (!pNewVertices || !pNewTexVertices || !pNewIntensities)
+    {
+        if (pNewVertices)
+            rdroid_pHS->free(pNewVertices);
+        if (pNewTexVertices)
+            rdroid_pHS->free(pNewTexVertices);
+        if (pNewIntensities)
+            rdroid_pHS->free(pNewIntensities);
+        return 0;
+    }
+
+    if (rdCache_pVertices)
+    {
+        _memcpy(pNewVertices, rdCache_pVertices, rdCache_maxVertices * sizeof(rdVector3));
+        _memcpy(pNewTexVertices, rdCache_pTexVertices, rdCache_maxVertices * sizeof(rdVector2));
+        _memcpy(pNewIntensities, rdCache_pIntensities, rdCache_maxVertices * sizeof(float));
+
+        // Faces already queued point into the old arrays
+        for (size_t i = 0; i < rdCache_numProcFaces; i++)
+        {
+            rdProcEntry* face = &rdCache_pProcFaces[i];
+            face->vertices = pNewVertices + (face->vertices - rdCache_pVertices);
+            face->vertexUVs = pNewTexVertices + (face->vertexUVs - rdCache_pTexVertices);
+            face->vertexIntensities = pNewIntensities + (face->vertexIntensities - rdCache_pIntensities);
+        }
+
+        rdroid_pHS->free(rdCache_pVertices);
+        rdroid_pHS->free(rdCache_pTexVertices);
+        rdroid_pHS->free(rdCache_pIntensities);
+    }
+
+    rdCache_pVertices = pNewVertices;
+    rdCache_pTexVertices = pNewTexVertices;
+    rdCache_pIntensities = pNewIntensities;
+    rdCache_maxVertices = newMax;
+    return 1;
+}
+
+static int rdCache_EnsureHWList(size_t numVerts, size_t numTris)
+{
+    size_t newMax;
+    void* pNew;
+    void* pNew2;
+
+    if (numVerts > rdCache_maxHWVertices)
+    {
+        newMax = rdCache_maxHWVertices ? rdCache_maxHWVertices : STD3D_MAX_VERTICES;
+        while (newMax < numVerts)
+            newMax *= 2;
+
+        pNew = rdCache_GrowArray(rdCache_pHWVertices, rdCache_maxHWVertices, newMax, sizeof(D3DVERTEX));
+        if (!pNew)
+            return 0;
+        rdCache_pHWVertices = (D3DVERTEX*)pNew;
+        rdCache_maxHWVertices = newMax;
+    }
+
+    if (numTris > rdCache_maxHWTris)
+    {
+        newMax = rdCache_maxHWTris ? rdCache_maxHWTris : STD3D_MAX_TRIS;
+        while (newMax < numTris)
+            newMax *= 2;
+
+        pNew = rdCache_GrowArray(rdCache_pHWSolidTris, rdCache_maxHWTris, newMax, sizeof(rdTri));
+        if (!pNew)
+            return 0;
+        rdCache_pHWSolidTris = (rdTri*)pNew;
+
+        pNew = rdCache_GrowArray(rdCache_pHWNormalTris, rdCache_maxHWTris, newMax, sizeof(rdTri));
+        if (!pNew)
+            return 0;
+        rdCache_pHWNormalTris = (rdTri*)pNew;
+
+        pNew = rdCache_GrowArray(rdCache_pHWSortTris, 0, newMax, sizeof(rdTri));
+        if (!pNew)
+            return 0;
+        rdCache_pHWSortTris = (rdTri*)pNew;
+
+        pNew2 = rdCache_GrowArray(rdCache_pHWLines, rdCache_maxHWTris, newMax, sizeof(rdLine));
+        if (!pNew2)
+            return 0;
+        rdCache_pHWLines = (rdLine*)pNew2;
+
+        rdCache_maxHWTris = newMax;
+    }
+
+    return 1;
+}
+
+// Packs everything std3D switches state on, most expensive change first.
+// 8-bit textures sort before 16-bit ones, same as rdCache_TriCompare.
+uint64_t rdCache_TriSortKey(const rdTri* tri)
+{
+    uint64_t key = 0;
+    rdDDrawSurface* tex = tri->texture;
+
+    key |= (uint64_t)((tri->flags >> 11) & 3) << 50; // depth test/write
+    key |= (uint64_t)((tri->flags & 0x600) ? 1 : 0) << 49; // alpha blend
+    key |= (uint64_t)((tri->flags >> 16) & 1) << 48; // double-sided
+    if (tex)
+    {
+        key |= (uint64_t)(tex->is_16bit ? 1 : 0) << 32;
+        key |= tex->texture_id;
+    }
+    return key;
+}
+
+static void rdCache_SetTriSortKeys(rdTri* pTris, size_t amt)
+{
+    for (size_t i = 0; i < amt; i++)
+        pTris[i].sortKey = rdCache_TriSortKey(&pTris[i]);
+}
+
+// Stable LSD radix sort on sortKey, skipping bytes which are the same for every tri
+void rdCache_RadixSortTris(rdTri* pTris, rdTri* pScratch, size_t amt)
+{
+    size_t aCounts[256];
+    uint64_t keyAnd = ~(uint64_t)0;
+    uint64_t keyOr = 0;
+    rdTri* pSrc = pTris;
+    rdTri* pDst = pScratch;
+    rdTri* pTmp;
+
+    for (size_t i = 0; i < amt; i++)
+    {
+        keyAnd &= pTris[i].sortKey;
+        keyOr |= pTris[i].sortKey;
+    }
+
+    for (int shift = 0; shift < 64; shift += 8)
+    {
+        size_t offs = 0;
+
+        if (!(((keyAnd ^ keyOr) >> shift) & 0xFF))
+            continue;
+
+        _memset(aCounts, 0, sizeof(aCounts));
+        for (size_t i = 0; i < amt; i++)
+            aCounts[(pSrc[i].sortKey >> shift) & 0xFF]++;
+
+        for (int i = 0; i < 256; i++)
+        {
+            size_t count = aCounts[i];
+            aCounts[i] = offs;
+            offs += count;
+        }
+
+        for (size_t i = 0; i < amt; i++)
+            pDst[aCounts[(pSrc[i].sortKey >> shift) & 0xFF]++] = pSrc[i];
+
+        pTmp = pSrc;
+        pSrc = pDst;
+        pDst = pTmp;
+    }
+
+    if (pSrc != pTris)
+        _memcpy(pTris, pSrc, amt * sizeof(rdTri));
+}
+
+// Maps z to a key which sorts the same way rdCache_ProcFaceCompare does,
+// farthest first. Float bits are made monotonic (negatives flipped, sign bit
+// set on positives) and then inverted.
+uint32_t rdCache_DepthSortKey(float z)
+{
+    uint32_t bits;
+
+    _memcpy(&bits, &z, sizeof(bits));
+    bits ^= (bits & 0x80000000) ? 0xFFFFFFFF : 0x80000000;
+    return ~bits;
+}
+
+// Stable LSD radix sort on key, skipping bytes which are the same for every entry
+void rdCache_RadixSortDepthKeys(rdCacheDepthKey* pKeys, rdCacheDepthKey* pScratch, size_t amt)
+{
+    size_t aCounts[256];
+    uint32_t keyAnd = 0xFFFFFFFF;
+    uint32_t keyOr = 0;
+    rdCacheDepthKey* pSrc = pKeys;
+    rdCacheDepthKey* pDst = pScratch;
+    rdCacheDepthKey* pTmp;
+
+    for (size_t i = 0; i < amt; i++)
+    {
+        keyAnd &= pKeys[i].key;
+        keyOr |= pKeys[i].key;
+    }
+
+    for (int shift = 0; shift < 32; shift += 8)
+    {
+        size_t offs = 0;
+
+        if (!(((keyAnd ^ keyOr) >> shift) & 0xFF))
+            continue;
+
+        _memset(aCounts, 0, sizeof(aCounts));
+        for (size_t i = 0; i < amt; i++)
+            aCounts[(pSrc[i].key >> shift) & 0xFF]++;
+
+        for (int i = 0; i < 256; i++)
+        {
+            size_t count = aCounts[i];
+            aCounts[i] = offs;
+            offs += count;
+        }
+
+        for (size_t i = 0; i < amt; i++)
+            pDst[aCounts[(pSrc[i].key >> shift) & 0xFF]++] = pSrc[i];
+
+        pTmp = pSrc;
+        pSrc = pDst;
+        pDst = pTmp;
+    }
+
+    if (pSrc != pKeys)
+        _memcpy(pKeys, pSrc, amt * sizeof(rdCacheDepthKey));
+}
+
+// Replaces the _qsort on rdCache_ProcFaceCompare. Only the keys are sorted,
+// the faces are moved once into the spare array which then becomes the list.
+static void rdCache_SortProcFaces()
+{
+    rdProcEntry* pTmp;
+
+    if (!rdCache_pSortProcFaces || !rdCache_pDepthKeys)
+    {
+        _qsort(rdCache_aProcFaces, rdCache_numProcFaces, sizeof(rdProcEntry), (int (__cdecl *)(const void *, const void *))rdCache_ProcFaceCompare);
+        return;
+    }
+
+    for (size_t i = 0; i < rdCache_numProcFaces; i++)
+    {
+        rdCache_pDepthKeys[i].key = rdCache_DepthSortKey(rdCache_pProcFaces[i].z_min);
+        rdCache_pDepthKeys[i].idx = i;
+    }
+
+    rdCache_RadixSortDepthKeys(rdCache_pDepthKeys, &rdCache_pDepthKeys[rdCache_maxProcFaces], rdCache_numProcFaces);
+
+    for (size_t i = 0; i < rdCache_numProcFaces; i++)
+        rdCache_pSortProcFaces[i] = rdCache_pProcFaces[rdCache_pDepthKeys[i].idx];
+
+    pTmp = rdCache_pProcFaces;
+    rdCache_pProcFaces = rdCache_pSortProcFaces;
+    rdCache_pSortProcFaces = pTmp;
+}
+#endif // SDL2_RENDER
 
 int rdCache_Startup()
 {
     return 1;
 }
 
+void rdCache_Shutdown()
+{
+#ifdef SDL2_RENDER
+    if (rdCache_pProcFaces)
+        rdroid_pHS->free(rdCache_pProcFaces);
+    if (rdCache_pSortProcFaces)
+        rdroid_pHS->free(rdCache_pSortProcFaces);
+    if (rdCache_pDepthKeys)
+        rdroid_pHS->free(rdCache_pDepthKeys);
+    if (rdCache_pVertices)
+        rdroid_pHS->free(rdCache_pVertices);
+    if (rdCache_pTexVertices)
+        rdroid_pHS->free(rdCache_pTexVertices);
+    if (rdCache_pIntensities)
+        rdroid_pHS->free(rdCache_pIntensities);
+    if (rdCache_pHWVertices)
+        rdroid_pHS->free(rdCache_pHWVertices);
+    if (rdCache_pHWSolidTris)
+        rdroid_pHS->free(rdCache_pHWSolidTris);
+    if (rdCache_pHWNormalTris)
+        rdroid_pHS->free(rdCache_pHWNormalTris);
+    if (rdCache_pHWSortTris)
+        rdroid_pHS->free(rdCache_pHWSortTris);
+    if (rdCache_pHWLines)
+        rdroid_pHS->free(rdCache_pHWLines);
+
+    rdCache_pProcFaces = NULL;
+    rdCache_pSortProcFaces = NULL;
+    rdCache_pDepthKeys = NULL;
+    rdCache_pVertices = NULL;
+    rdCache_pTexVertices = NULL;
+    rdCache_pIntensities = NULL;
+    rdCache_pHWVertices = NULL;
+    rdCache_pHWSolidTris = NULL;
+    rdCache_pHWNormalTris = NULL;
+    rdCache_pHWSortTris = NULL;
+    rdCache_pHWLines = NULL;
+    rdCache_maxProcFaces = 0;
+    rdCache_maxVertices = 0;
+    rdCache_maxHWVertices = 0;
+    rdCache_maxHWTris = 0;
+
+    rdRaster_Shutdown();
+#endif
+}
+
 void rdCache_AdvanceFrame()
 {
     if ( rdroid_curAcceleration > 0 )
         std3D_StartScene();
+#ifdef SDL2_RENDER
+    else
+    {
+        // Software frames are still presented through std3D's menu quad
+        std3D_StartScene();
+        rdRaster_AdvanceFrame();
+    }
+#endif
 }
 
 void rdCache_FinishFrame()
 {
+#ifdef SDL2_RENDER
+    stdProfiler_Begin(STDPROFILER_ZONE_ENDSCENE);
+    std3D_EndScene();
+    stdProfiler_End(STDPROFILER_ZONE_ENDSCENE);
+#else
     if ( rdroid_curAcceleration > 0 )
         std3D_EndScene();
+#endif
+#ifdef QOL_IMPROVEMENTS
+    rdCache_lastFrameFlushes = rdCache_frameFlushes;
+    rdCache_frameFlushes = 0;
+#endif
 }
 
 void rdCache_Reset()
@@ -52,6 +460,18 @@ rdProcEntry *rdCache_GetProcEntry()
     size_t idx;
     rdProcEntry *out_procEntry;
 
+#ifdef SDL2_RENDER
+    if ( !rdCache_EnsureProcFaces(rdCache_numProcFaces + 1) )
+        rdCache_Flush();
+    if ( !rdCache_EnsureVertices(rdCache_numUsedVertices + 0x20)
+         || !rdCache_EnsureVertices(rdCache_numUsedTexVertices + 0x20)
+         || !rdCache_EnsureVertices(rdCache_numUsedIntensities + 0x20) )
+        return 0;
+
+    idx = rdCache_numProcFaces;
+    if ( rdCache_numProcFaces >= rdCache_maxProcFaces )
+        return 0;
+#else
     idx = rdCache_numProcFaces;
     if ( rdCache_numProcFaces >= RDCACHE_MAX_TRIS )
     {
@@ -67,6 +487,7 @@ rdProcEntry *rdCache_GetProcEntry()
 
     if ( (unsigned int)(RDCACHE_MAX_VERTICES - rdCache_numUsedIntensities) < 0x20 )
         return 0;
+#endif
 
     out_procEntry = &rdCache_aProcFaces[idx];
     out_procEntry->vertices = &rdCache_aVertices[rdCache_numUsedVertices];
@@ -78,17 +499,33 @@ rdProcEntry *rdCache_GetProcEntry()
 void rdCache_Flush()
 {
     size_t v0; // eax
-    size_t v1; // edi
-    size_t v3; // edi
-    rdProcEntry *face; // esi
 
     if (!rdCache_numProcFaces)
         return;
 
+    stdProfiler_Begin(STDPROFILER_ZONE_FLUSH);
+
     if ( rdroid_curSortingMethod == 2 )
     {
+#ifdef SDL2_RENDER
+        rdCache_SortProcFaces();
+#else
         _qsort(rdCache_aProcFaces, rdCache_numProcFaces, sizeof(rdProcEntry), (int (__cdecl *)(const void *, const void *))rdCache_ProcFaceCompare);
+#endif
     }
+#ifdef SDL2_RENDER
+    if ( rdroid_curAcceleration <= 0 )
+    {
+        // rdActive and the DrawFace blobs live in JK.EXE, everything goes through
+        // the native rasterizer instead
+        rdRaster_DrawFaces(rdCache_aProcFaces, rdCache_numProcFaces, rdroid_curZBufferMethod);
+    }
+    else
+#else
+    size_t v1; // edi
+    size_t v3; // edi
+    rdProcEntry *face; // esi
+
     if ( rdroid_curAcceleration <= 0 )
     {
         if ( rdroid_curOcclusionMethod )
@@ -127,15 +564,45 @@ void rdCache_Flush()
         }
     }
     else
+#endif
     {
         rdCache_SendFaceListToHardware();
     }
     rdCache_drawnFaces += rdCache_numProcFaces;
+#ifdef QOL_IMPROVEMENTS
+    rdCache_frameFlushes++;
+#endif
     rdCache_Reset();
+
+    stdProfiler_End(STDPROFILER_ZONE_FLUSH);
 }
 
 #if 1
 
+// Added: D3DVERTEX keeps its color (and on SDL2, light) words in float fields
+static void rdCache_SetHWWord(D3DVALUE *pField, uint32_t val)
+{
+    memcpy(pField, &val, sizeof(val));
+}
+
+#ifdef SDL2_RENDER
+static uint32_t rdCache_PackUnorm8(float val)
+{
+    return (uint32_t)(stdMath_Clamp(val, 0.0, 1.0) * 255.0 + 0.5);
+}
+
+// Added: the light word the world shader lights a vertex with, see default_f.glsl.
+// Bytes are the vertex intensity (filled in per vertex), extralight (128 is 0),
+// the ambient floor and the lighting mode + 1. A word of 0 means the vertex
+// color is already lit.
+static uint32_t rdCache_PackLightTerms(int lightingMode, float extraLight, float ambient)
+{
+    uint32_t extra = (uint32_t)(stdMath_Clamp(extraLight, -1.0, 1.0) * 127.0 + 128.5);
+
+    return (extra << 8) | (rdCache_PackUnorm8(ambient) << 16) | ((uint32_t)(lightingMode + 1) << 24);
+}
+#endif
+
 int rdCache_SendFaceListToHardware()
 {
     int v0; // ecx
@@ -153,15 +620,6 @@ int rdCache_SendFaceListToHardware()
     rdTexinfo *v15; // eax
     rdTexture *sith_tex_sel; // esi
     rdDDrawSurface *tex2_arr_sel; // eax
-    float *vert_lights_iter; // ecx
-    int vert_lights_iter_cnt; // edx
-    double v21; // st7
-    double v22; // st7
-    double v23; // st7
-    double v24; // st7
-    double v25; // st7
-    double v26; // st7
-    double v27; // st7
     int vertex_cnt; // eax
     rdVector3 *iterating_6c_vtxs_; // esi
     int v35; // ecx
@@ -171,13 +629,6 @@ int rdCache_SendFaceListToHardware()
     int v39; // eax
     int normals_related; // zf
     double light_level; // st7
-    int vertex_g; // ebx
-    int vertex_r; // edi
-    rdColormap *v45; // eax
-    double v47; // st7
-    __int64 v48; // rax
-    double v49; // st7
-    int vertex_b; // cl
     rdProcEntry *v52; // esi
     int final_vertex_color; // eax
     rdVector2 *uvs_in_pixels; // eax
@@ -256,6 +707,10 @@ int rdCache_SendFaceListToHardware()
     int blue; // [esp+8Ch] [ebp-14h]
     int red_and_alpha; // [esp+98h] [ebp-8h]
     int green; // [esp+9Ch] [ebp-4h]
+    float fade;
+#ifdef SDL2_RENDER
+    uint32_t light_terms;
+#endif
 
     a3 = 0; // added? aaaaaaa undefined
     v0 = 0;
@@ -297,8 +752,33 @@ int rdCache_SendFaceListToHardware()
         flags_idk |= 0x8000;
     }
 
+#ifdef SDL2_RENDER
+    // Added: filter, tint and fade are applied by the world shader, see std3D_BeginWorldDraw
+    v129 = 0;
+    v130 = 0;
+    fade = 1.0;
+#else
+    fade = rdroid_curColorEffects.fade;
+#endif
+
     std3D_ResetRenderList();
     rdCache_ResetRenderList();
+
+#ifdef SDL2_RENDER
+    // Size the hardware list for every queued face so it goes out in one draw
+    {
+        size_t numHWVerts = 0;
+        size_t numHWTris = 0;
+        for (size_t i = 0; i < rdCache_numProcFaces; i++)
+        {
+            numHWVerts += rdCache_aProcFaces[i].numVertices;
+            numHWTris += rdCache_aProcFaces[i].numVertices > 2 ? rdCache_aProcFaces[i].numVertices - 2 : 1;
+        }
+        if (!rdCache_EnsureHWList(numHWVerts + 1, numHWTris))
+            return 0;
+    }
+#endif
+
     v7 = rdCamera_pCurCamera->cameraClipFrustum;
     v8 = 1.0 / v7->field_0.z;
     rend_6c_current_idx = 0;
@@ -322,7 +802,7 @@ int rdCache_SendFaceListToHardware()
         }
 
 #ifdef SDL2_RENDER
-        d3d_maxVertices = STD3D_MAX_VERTICES;
+        d3d_maxVertices = rdCache_maxHWVertices;
 #endif
         if ( active_6c->numVertices + rdCache_totalVerts >= d3d_maxVertices )
         {
@@ -474,9 +954,20 @@ int rdCache_SendFaceListToHardware()
 
         if ( v11.mipmap_related != 3 )
         {
-            v26 = v148;
             if ( v11.mipmap_related != 4 )
                 continue;
+#ifndef SDL2_RENDER
+            float *vert_lights_iter; // ecx
+            int vert_lights_iter_cnt; // edx
+            double v21; // st7
+            double v22; // st7
+            double v23; // st7
+            double v24; // st7
+            double v25; // st7
+            double v26; // st7
+            double v27; // st7
+
+            v26 = v148;
             if ( lighting_capability == 1 )
             {
                 v27 = stdMath_Clamp(active_6c->extralight, 0.0, 1.0);
@@ -587,11 +1078,28 @@ int rdCache_SendFaceListToHardware()
 
                 //active_6c->light_level_static = v26 * 255.0;
             }
+#endif
 
             vertex_cnt = active_6c->numVertices;
             iterating_6c_vtxs = active_6c->vertices;
             vertex_a = red_and_alpha << 8;
 
+#ifdef SDL2_RENDER
+            // Added: lighting and the sector tint are evaluated by the world shader.
+            // Every vertex of the face gets the tint as its color, nx carries the
+            // raw light terms.
+            final_vertex_color = ((uint32_t)vertex_a << 16) | 0xFFFFFF;
+            if ( active_6c->colormap != rdColormap_pIdentityMap )
+            {
+                final_vertex_color = ((uint32_t)vertex_a << 16)
+                                   | (rdCache_PackUnorm8(active_6c->colormap->tint.x) << 16)
+                                   | (rdCache_PackUnorm8(active_6c->colormap->tint.y) << 8)
+                                   | rdCache_PackUnorm8(active_6c->colormap->tint.z);
+                flags_idk_ |= 0x8000;
+            }
+            light_terms = rdCache_PackLightTerms(lighting_capability, active_6c->extralight, v148);
+#endif
+
             for (int vtx_idx = 0; vtx_idx < active_6c->numVertices; vtx_idx++)
             {
                 vert_x_int = ceilf(iterating_6c_vtxs[vtx_idx].x);
@@ -611,8 +1119,24 @@ int rdCache_SendFaceListToHardware()
                 rdCache_aHWVertices[rdCache_totalVerts].z = v38;
                 v39 = lighting_capability;
                 normals_related = lighting_capability == 0;
-                rdCache_aHWVertices[rdCache_totalVerts].nx = d3dvtx_zval * 0.03125;
                 rdCache_aHWVertices[rdCache_totalVerts].nz = 0.0;
+#ifdef SDL2_RENDER
+                if ( v39 == 3 )
+                    light_level = active_6c->vertexIntensities[vtx_idx];
+                else
+                    light_level = active_6c->light_level_static;
+                rdCache_SetHWWord(&rdCache_aHWVertices[rdCache_totalVerts].nx, light_terms | rdCache_PackUnorm8(light_level));
+                v52 = active_6c;
+#else
+                int vertex_g; // ebx
+                int vertex_r; // edi
+                int vertex_b; // cl
+                rdColormap *v45; // eax
+                double v47; // st7
+                __int64 v48; // rax
+                double v49; // st7
+
+                rdCache_aHWVertices[rdCache_totalVerts].nx = d3dvtx_zval * 0.03125;
                 if ( normals_related )
                 {
                     vertex_b = 255;
@@ -675,11 +1199,11 @@ int rdCache_SendFaceListToHardware()
                     vertex_b += (__int64)((double)blue * blue_scalar);
                     blue = vertex_b;
                 }
-                if ( rdroid_curColorEffects.fade < 1.0 )
+                if ( fade < 1.0 )
                 {
-                    vertex_r = (__int64)((double)red_and_alpha * rdroid_curColorEffects.fade);
-                    vertex_g = (__int64)((double)green * rdroid_curColorEffects.fade);
-                    vertex_b = (__int64)((double)blue * rdroid_curColorEffects.fade);
+                    vertex_r = (__int64)((double)red_and_alpha * fade);
+                    vertex_g = (__int64)((double)green * fade);
+                    vertex_b = (__int64)((double)blue * fade);
                 }
                 
                 if ( vertex_r < 0 )
@@ -709,9 +1233,10 @@ int rdCache_SendFaceListToHardware()
 
                 v52 = active_6c;
                 final_vertex_color = vertex_b | (((uint8_t)vertex_g | ((vertex_a | (uint8_t)vertex_r) << 8)) << 8);
+#endif
                 
                 // For some reason, ny holds the vertex color.
-                *(uint32_t*)&rdCache_aHWVertices[rdCache_totalVerts].ny = final_vertex_color;
+                rdCache_SetHWWord(&rdCache_aHWVertices[rdCache_totalVerts].ny, final_vertex_color);
                 uvs_in_pixels = v52->vertexUVs;
                 
                 rdCache_aHWVertices[rdCache_totalVerts].tu = uvs_in_pixels[vtx_idx].x / actual_width;
@@ -729,8 +1254,12 @@ int rdCache_SendFaceListToHardware()
                 rdCache_aHWLines[tri_idx].v1 = tri_vert_idx + 1;
                 rdCache_aHWLines[tri_idx].flags = flags_idk_;
                 
-                *(uint32_t*)&rdCache_aHWVertices[rdCache_aHWLines[tri_idx].v1].ny = active_6c->extraData;
-                *(uint32_t*)&rdCache_aHWVertices[rdCache_aHWLines[tri_idx].v2].ny = active_6c->extraData;
+                rdCache_SetHWWord(&rdCache_aHWVertices[rdCache_aHWLines[tri_idx].v1].ny, active_6c->extraData);
+                rdCache_SetHWWord(&rdCache_aHWVertices[rdCache_aHWLines[tri_idx].v2].ny, active_6c->extraData);
+#ifdef SDL2_RENDER
+                rdCache_SetHWWord(&rdCache_aHWVertices[rdCache_aHWLines[tri_idx].v1].nx, 0);
+                rdCache_SetHWWord(&rdCache_aHWVertices[rdCache_aHWLines[tri_idx].v2].nx, 0);
+#endif
                 
                 rdCache_totalLines++;
             }
@@ -904,7 +1433,12 @@ LABEL_232:
             rdCache_aHWVertices[rdCache_totalVerts].z = v89;
             v90 = lighting_capability;
             normals_related = lighting_capability == 0;
+#ifdef SDL2_RENDER
+            // Added: colored from the colormap below, so the shader leaves it as is
+            rdCache_SetHWWord(&rdCache_aHWVertices[rdCache_totalVerts].nx, 0);
+#else
             rdCache_aHWVertices[rdCache_totalVerts].nx = v88 * 0.03125;
+#endif
             rdCache_aHWVertices[rdCache_totalVerts].nz = 0.0;
             if ( normals_related )
             {
@@ -967,11 +1501,11 @@ LABEL_232:
                 green = v94;
                 blue += (__int64)((double)blue * blue_scalar);
             }
-            if ( rdroid_curColorEffects.fade < 1.0 )
+            if ( fade < 1.0 )
             {
-                v96 = (__int64)((double)red_and_alpha * rdroid_curColorEffects.fade);
-                v94 = (__int64)((double)green * rdroid_curColorEffects.fade);
-                blue = (__int64)((double)blue * rdroid_curColorEffects.fade);
+                v96 = (__int64)((double)red_and_alpha * fade);
+                v94 = (__int64)((double)green * fade);
+                blue = (__int64)((double)blue * fade);
             }
             if ( v96 < 0 )
             {
@@ -999,7 +1533,7 @@ LABEL_232:
                 v103 = -1;
             }
             v104 = v103 | (((uint8_t)v94 | ((alpha_upshifta | (uint8_t)v96) << 8)) << 8);
-            *(uint32_t *)&rdCache_aHWVertices[rdCache_totalVerts].ny = v104;
+            rdCache_SetHWWord(&rdCache_aHWVertices[rdCache_totalVerts].ny, v104);
             rdCache_aHWVertices[rdCache_totalVerts].tu = 0.0;
             rdCache_aHWVertices[rdCache_totalVerts].tv = 0.0;
             rdCache_totalVerts++;
@@ -1014,8 +1548,8 @@ LABEL_232:
             rdCache_aHWLines[v117].v1 = tri_vert_idx + 1;
             rdCache_aHWLines[v117].flags = flags_idk_;
             
-            *(uint32_t*)&rdCache_aHWVertices[rdCache_aHWLines[v117].v1].ny = active_6c->extraData;
-            *(uint32_t*)&rdCache_aHWVertices[rdCache_aHWLines[v117].v2].ny = active_6c->extraData;
+            rdCache_SetHWWord(&rdCache_aHWVertices[rdCache_aHWLines[v117].v1].ny, active_6c->extraData);
+            rdCache_SetHWWord(&rdCache_aHWVertices[rdCache_aHWLines[v117].v2].ny, active_6c->extraData);
             
             rdCache_totalLines++;
         }
@@ -1087,8 +1621,15 @@ void rdCache_DrawRenderList()
             std3D_AddRenderListVertices(rdCache_aHWVertices, rdCache_totalVerts);
         }
         std3D_RenderListVerticesFinish();
+#ifdef SDL2_RENDER
+        rdCache_SetTriSortKeys(rdCache_aHWSolidTris, rdCache_totalSolidTris);
+        rdCache_SetTriSortKeys(rdCache_aHWNormalTris, rdCache_totalNormalTris);
+        if ( rdroid_curZBufferMethod == 2 )
+            rdCache_RadixSortTris(rdCache_aHWNormalTris, rdCache_pHWSortTris, rdCache_totalNormalTris);
+#else
         if ( rdroid_curZBufferMethod == 2 )
             _qsort(rdCache_aHWNormalTris, rdCache_totalNormalTris, sizeof(rdTri), rdCache_TriCompare);
+#endif
         if ( rdCache_totalSolidTris )
             std3D_AddRenderListTris(rdCache_aHWSolidTris, rdCache_totalSolidTris);
         if ( rdCache_totalNormalTris )
@@ -1157,8 +1698,13 @@ int rdCache_AddProcFace(int a1, unsigned int num_vertices, char flags)
     float extdatac; // [esp+2Ch] [ebp+8h]
     float x_max; // [esp+30h] [ebp+Ch]
 
+#ifdef SDL2_RENDER
+    if ( rdCache_numProcFaces >= rdCache_maxProcFaces )
+        return 0;
+#else
     if ( rdCache_numProcFaces >= RDCACHE_MAX_TRIS )
         return 0;
+#endif
     v6 = rdroid_curProcFaceUserData;
     current_rend_6c_idx = rdCache_numProcFaces;
     x_min = 3.4e38;
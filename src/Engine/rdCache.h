@@ -23,6 +23,7 @@
 #define rdCache_ProcFaceCompare_ADDR (0x0043E170)
 
 int rdCache_Startup();
+void rdCache_Shutdown();
 void rdCache_AdvanceFrame();
 void rdCache_FinishFrame();
 void rdCache_Reset();
@@ -37,9 +38,37 @@ int rdCache_TriCompare(const void* a_, const void* b_);
 int rdCache_ProcFaceCompare(rdProcEntry *a, rdProcEntry *b);
 int rdCache_AddProcFace(int a1, unsigned int num_vertices, char flags);
 
+#ifdef SDL2_RENDER
+// rdTri flags as rdCache_SendFaceListToHardware sets them, the z bits follow
+// rdroid_curZBufferMethod
+#define RDCACHE_TRI_BASE      (0x33)
+#define RDCACHE_TRI_ZTEST     (0x800)
+#define RDCACHE_TRI_ZWRITE    (0x1000)
+#define RDCACHE_TRI_ZBUFFERED (RDCACHE_TRI_BASE | RDCACHE_TRI_ZWRITE | RDCACHE_TRI_ZTEST) // method 2
+
+typedef struct rdCacheDepthKey
+{
+    uint32_t key;
+    uint32_t idx;
+} rdCacheDepthKey;
+
+uint64_t rdCache_TriSortKey(const rdTri* tri);
+void rdCache_RadixSortTris(rdTri* pTris, rdTri* pScratch, size_t amt);
+uint32_t rdCache_DepthSortKey(float z);
+void rdCache_RadixSortDepthKeys(rdCacheDepthKey* pKeys, rdCacheDepthKey* pScratch, size_t amt);
+#endif
+
+#ifdef QOL_IMPROVEMENTS
+// Number of rdCache_Flush calls which had faces to draw, per frame
+extern int rdCache_frameFlushes;
+extern int rdCache_lastFrameFlushes;
+#endif
+
+#ifndef SDL2_RENDER
 static void (*rdCache_DrawFaceUser)(rdProcEntry* face) = (void*)rdCache_DrawFaceUser_ADDR;
 static void (*rdCache_DrawFaceN)(rdProcEntry* face) = (void*)rdCache_DrawFaceN_ADDR;
 static void (*rdCache_DrawFaceZ)(rdProcEntry* face) = (void*)rdCache_DrawFaceZ_ADDR;
+#endif
 //static int (*rdCache_SendFaceListToHardware)(void) = (void*)rdCache_SendFaceListToHardware_ADDR;
 //static void (*rdCache_ClearFrameCounters)(void) = (void*)rdCache_ClearFrameCounters_ADDR;
 //static void (*rdCache_AdvanceFrame)(void) = (void*)rdCache_AdvanceFrame_ADDR;
@@ -8,6 +8,7 @@
 #include "Platform/std3D.h"
 #include "Engine/sithRender.h"
 #include "World/jkPlayer.h"
+#include "Primitives/rdSimd.h"
 
 static rdVector3 rdCamera_camRotation;
 
@@ -313,8 +314,40 @@ void rdCamera_PerspProject(rdVector3 *out, rdVector3 *v)
     //printf("%f %f %f -> %f %f %f\n", v->x, v->y, v->z, out->x, out->y, out->z);
 }
 
+#ifdef RDSIMD_ENABLED
+// Projects 4 packed vertices, shared by the perspective list projections
+static void rdCamera_PerspProjectLstSimd(rdVector3 *vertices_out, rdVector3 *vertices_in, unsigned int num_batches, float aspect)
+{
+    rdSimdF4 fov = rdSimd_Set1(rdCamera_pCurCamera->fov_y);
+    rdSimdF4 halfH = rdSimd_Set1(rdCamera_pCurCamera->canvas->screen_height_half);
+    rdSimdF4 halfW = rdSimd_Set1(rdCamera_pCurCamera->canvas->screen_width_half);
+    rdSimdF4 aspect4 = rdSimd_Set1(aspect);
+
+    for (unsigned int i = 0; i < num_batches; i++)
+    {
+        rdSimdF4 x, y, z, scale;
+
+        rdSimd_Load3x4(vertices_in, &x, &y, &z);
+        scale = rdSimd_Div(fov, y);
+        rdSimd_Store3x4(vertices_out,
+                        rdSimd_Add(rdSimd_Mul(scale, x), halfH),
+                        rdSimd_Sub(halfW, rdSimd_Mul(aspect4, rdSimd_Mul(scale, z))),
+                        y);
+        vertices_in += 4;
+        vertices_out += 4;
+    }
+}
+#endif
+
 void rdCamera_PerspProjectLst(rdVector3 *vertices_out, rdVector3 *vertices_in, unsigned int num_vertices)
 {
+#ifdef RDSIMD_ENABLED
+    rdCamera_PerspProjectLstSimd(vertices_out, vertices_in, num_vertices / 4, jkPlayer_enableOrigAspect ? 1.0 : rdCamera_pCurCamera->screenAspectRatio);
+    vertices_in += num_vertices & ~3;
+    vertices_out += num_vertices & ~3;
+    num_vertices &= 3;
+#endif
+
     for (int i = 0; i < num_vertices; i++)
     {
         rdCamera_PerspProject(vertices_out, vertices_in);
@@ -332,6 +365,13 @@ void rdCamera_PerspProjectSquare(rdVector3 *out, rdVector3 *v)
 
 void rdCamera_PerspProjectSquareLst(rdVector3 *vertices_out, rdVector3 *vertices_in, unsigned int num_vertices)
 {
+#ifdef RDSIMD_ENABLED
+    rdCamera_PerspProjectLstSimd(vertices_out, vertices_in, num_vertices / 4, 1.0);
+    vertices_in += num_vertices & ~3;
+    vertices_out += num_vertices & ~3;
+    num_vertices &= 3;
+#endif
+
     for (int i = 0; i < num_vertices; i++)
     {
         rdCamera_PerspProjectSquare(vertices_out, vertices_in);
@@ -1,6 +1,9 @@
 #include "rdClip.h"
 
 #include "rdCanvas.h"
+#include "Engine/rdroid.h"
+#include "Engine/rdCamera.h"
+#include "Primitives/rdSimd.h"
 #include "jk.h"
 
 #include <math.h>
@@ -926,2878 +929,379 @@ int rdClip_SphereInFrustrum(rdClipFrustum *frust, rdVector3 *pos, float rad)
     return v5 == 0;
 }
 
-int rdClip_Face3W(rdClipFrustum *frustum, rdVector3 *vertices, int numVertices)
+// The Face3 clippers all share one implementation. The decompiled versions were
+// one unrolled loop per plane and per vertex format, which is identical apart
+// from which attributes get interpolated. The working polygon is kept as
+// separate x/y/z/u/v/light arrays so every plane pass is a straight loop over
+// floats, and a 4-wide outcode pass up front lets faces which are entirely on
+// screen (the common case) skip the clipper altogether.
+
+#define RDCLIP_MAX_VERTS (64)
+
+#define RDCLIP_UV    (0x1)
+#define RDCLIP_LIGHT (0x2)
+
+// Plane IDs double as the rdClip_faceStatus bit each plane sets
+#define RDCLIP_PLANE_NEAR   (0x1)
+#define RDCLIP_PLANE_FAR    (0x2)
+#define RDCLIP_PLANE_TOP    (0x4)
+#define RDCLIP_PLANE_BOTTOM (0x8)
+#define RDCLIP_PLANE_LEFT   (0x10)
+#define RDCLIP_PLANE_RIGHT  (0x20)
+#define RDCLIP_PLANE_SIDES  (RDCLIP_PLANE_TOP | RDCLIP_PLANE_BOTTOM | RDCLIP_PLANE_LEFT | RDCLIP_PLANE_RIGHT)
+
+typedef struct rdClipPoly
 {
-    //return _rdClip_Face3W(frustum, vertices, numVertices);
-    rdVector3 *v3; // edx
-    int v5; // ebp
-    rdVector3 *v6; // esi
-    rdVector3 *v7; // ecx
-    double v9; // st7
-    //char v10; // c0
-    double v12; // st6
-    //char v13; // c3
-    double v15; // st5
-    //char v16; // c0
-    double v18; // st4
-    //char v19; // c0
-    double v20; // st5
-    double v22; // st5
-    rdVector3 *v23; // ecx
-    int v24; // eax
-    rdVector3 *v25; // esi
-    rdVector3 *v26; // edi
-    rdVector3 *v27; // ecx
-    rdVector3 *v28; // edx
-    double v30; // st7
-    //unsigned __int8 v31; // c0
-    //unsigned __int8 v32; // c3
-    double v34; // st6
-    //char v35; // c3
-    double v37; // st5
-    //char v38; // c0
-    double v40; // st4
-    //char v41; // c0
-    double v42; // st5
-    double v44; // st5
-    rdVector3 *v45; // ecx
-    int v46; // eax
-    rdVector3 *v47; // esi
-    rdVector3 *v48; // edi
-    rdVector3 *v49; // ecx
-    rdVector3 *v50; // edx
-    double v52; // st7
-    //unsigned __int8 v53; // c0
-    //unsigned __int8 v54; // c3
-    double v56; // st5
-    double v57; // st6
-    //char v58; // c3
-    double v60; // st5
-    double v61; // st4
-    //char v62; // c0
-    double v64; // st3
-    //char v65; // c0
-    double v66; // st4
-    double v68; // st3
-    rdVector3 *v69; // ecx
-    int v70; // eax
-    rdVector3 *v71; // esi
-    rdVector3 *v72; // edi
-    rdVector3 *v73; // ecx
-    rdVector3 *v74; // edx
-    double v76; // st7
-    //char v77; // c0
-    double v79; // st5
-    double v80; // st6
-    //char v81; // c3
-    double v83; // st5
-    double v84; // st4
-    //char v85; // c0
-    double v87; // st3
-    //char v88; // c0
-    double v89; // st4
-    double v91; // st3
-    rdVector3 *v92; // ecx
-    int v93; // eax
-    rdVector3 *v94; // esi
-    rdVector3 *v95; // edi
-    rdVector3 *v96; // ecx
-    rdVector3 *v97; // edx
-    double v98; // st7
-    rdVector3 *v100; // eax
-    rdVector3 *v101; // esi
-    int v104; // eax
-    rdVector3 *v105; // esi
-    rdVector3 *v106; // edi
-    rdVector3 *v107; // ecx
-    rdVector3 *v108; // edx
-    double v109; // st7
-    rdVector3 *v111; // eax
-    float v112; // [esp+10h] [ebp-8h]
-    float v113; // [esp+10h] [ebp-8h]
-    float v114; // [esp+10h] [ebp-8h]
-    float v115; // [esp+10h] [ebp-8h]
-    int v116; // [esp+14h] [ebp-4h]
-    int v117; // [esp+14h] [ebp-4h]
-    int v118; // [esp+14h] [ebp-4h]
-    int v119; // [esp+14h] [ebp-4h]
-    float frustuma; // [esp+1Ch] [ebp+4h]
-    float frustumb; // [esp+1Ch] [ebp+4h]
-    float frustumc; // [esp+1Ch] [ebp+4h]
-    float frustumd; // [esp+1Ch] [ebp+4h]
-    float numVerticesa; // [esp+24h] [ebp+Ch]
-    float numVerticesi; // [esp+24h] [ebp+Ch]
-    float numVerticesb; // [esp+24h] [ebp+Ch]
-    float numVerticesc; // [esp+24h] [ebp+Ch]
-    float numVerticesj; // [esp+24h] [ebp+Ch]
-    float numVerticesd; // [esp+24h] [ebp+Ch]
-    float numVerticese; // [esp+24h] [ebp+Ch]
-    float numVerticesk; // [esp+24h] [ebp+Ch]
-    float numVerticesf; // [esp+24h] [ebp+Ch]
-    float numVerticesl; // [esp+24h] [ebp+Ch]
-    int numVerticesg; // [esp+24h] [ebp+Ch]
-    int numVerticesh; // [esp+24h] [ebp+Ch]
-
-    v3 = vertices;
-    pSourceVert = vertices;
-    v5 = 0;
-    v6 = workVerts;
-    rdClip_faceStatus = 0;
-    pDestVert = workVerts;
-    v7 = &vertices[numVertices - 1];
-    for (v116 = numVertices; v116 > 0; v116--)
-    {
-        numVerticesa = frustum->farLeft * v7->y;
-        v9 = frustum->farLeft * v3->y;
-        if ( numVerticesa <= v7->x || v9 <= v3->x )
-        {
-            if ( v7->x != numVerticesa && v9 != v3->x && (v7->x < (double)numVerticesa || v9 > v3->x) )
-            {
-                frustuma = v3->y - v7->y;
-                v112 = v3->x - v7->x;
-                v12 = v3->y * v7->x - v7->y * v3->x;
-                numVerticesi = frustum->farLeft * frustuma - v112;
-                if (numVerticesi != 0.0)
-                {
-                    v12 = v12 / numVerticesi;
-                }
-                numVerticesb = frustum->farLeft * v12;
-                v15 = frustuma;
-                if (v15 < 0.0)
-                    v15 = -v15;
-                v18 = v112;
-                if (v18 < 0.0)
-                    v18 = -v18;
-                if ( v15 <= v18 )
-                    v20 = (numVerticesb - v7->x) / v112;
-                else
-                    v20 = (v12 - v7->y) / frustuma;
-                v6->x = numVerticesb;
-                v6->y = v12;
-                ++v5;
-                ++v6;
-                v22 = (v3->z - v7->z) * v20;
-                rdClip_faceStatus |= 0x10;
-                v6[-1].z = v22 + v7->z;
-            }
-            if ( v9 <= v3->x )
-            {
-                v23 = v6;
-                ++v5;
-                ++v6;
-                *v23 = *v3;
-            }
-        }
-        v7 = v3++;
-    }
-    if ( v5 < 3 )
-        return v5;
-    v24 = v5;
-    v5 = 0;
-    v25 = vertices;
-    v26 = workVerts;
-    pDestVert = vertices;
-    pSourceVert = workVerts;
-    v27 = &workVerts[v24 - 1];
-    v28 = workVerts;
-    
-    for (v117 = v24; v117 > 0; v117--)
-    {
-        numVerticesc = frustum->right * v27->y;
-        v30 = frustum->right * v28->y;
-        if ( numVerticesc >= v27->x || v30 >= v28->x )
-        {
-            if ( v27->x != numVerticesc && v30 != v28->x && (v27->x > (double)numVerticesc || v30 < v28->x) )
-            {
-                frustumb = v28->y - v27->y;
-                v113 = v28->x - v27->x;
-                v34 = v28->y * v27->x - v27->y * v28->x;
-                numVerticesj = frustum->right * frustumb - v113;
-                if ( numVerticesj != 0 )
-                {
-                    v34 = v34 / numVerticesj;
-                }
-                numVerticesd = frustum->right * v34;
-                v37 = frustumb;
-                if ( v37 < 0.0 )
-                    v37 = -v37;
-                v40 = v113;
-                if ( v40 < 0.0 )
-                    v40 = -v40;
-                if ( v37 <= v40 )
-                    v42 = (numVerticesd - v27->x) / v113;
-                else
-                    v42 = (v34 - v27->y) / frustumb;
-                v25->x = numVerticesd;
-                v25->y = v34;
-                ++v5;
-                ++v25;
-                rdClip_faceStatus |= 0x20;
-                v44 = (v28->z - v27->z) * v42;
-                v25[-1].z = v44 + v27->z;
-            }
-            if ( v30 >= v28->x )
-            {
-                v45 = v25;
-                ++v5;
-                ++v25;
-                v45->x = v28->x;
-                v45->y = v28->y;
-                v26 = pSourceVert;
-                v45->z = v28->z;
-            }
-        }
-        v27 = v28++;
-    }
+    float pos[3][RDCLIP_MAX_VERTS];
+    float uv[2][RDCLIP_MAX_VERTS];
+    float light[RDCLIP_MAX_VERTS];
+} rdClipPoly;
 
-    if ( v5 < 3 )
-        return v5;
-
-    v46 = v5;
-    v47 = v26;
-    v5 = 0;
-    v48 = pDestVert;
-    pDestVert = v47;
-    pSourceVert = v48;
-    v49 = &v48[v46 - 1];
-    v50 = v48;
-    v118 = v46;
-    do
-    {
-        numVerticese = frustum->farTop * v49->y;
-        v52 = v50->y * frustum->farTop;
-        if ( numVerticese >= v49->z || v52 >= v50->z )
-        {
-            if ( v49->z != numVerticese && v52 != v50->z && (v49->z > (double)numVerticese || v52 < v50->z) )
-            {
-                frustumc = v50->y - v49->y;
-                v114 = v50->z - v49->z;
-                v56 = v50->y * v49->z - v50->z * v49->y;
-                v57 = v56;
-                numVerticesk = frustum->farTop * frustumc - v114;
-                if (numVerticesk != 0.0)
-                {
-                    
-                    v57 = v56 / numVerticesk;
-                }
-                v60 = frustum->farTop * v57;
-                v61 = frustumc;
-                if (v61 < 0.0)
-                    v61 = -v61;
-                v64 = v114;
-                if ( v64 < 0.0 )
-                    v64 = -v64;
-                if ( v61 <= v64 )
-                    v66 = (v60 - v49->z) / v114;
-                else
-                    v66 = (v57 - v49->y) / frustumc;
-                ++v5;
-                ++v47;
-                v68 = (v50->x - v49->x) * v66 + v49->x;
-                rdClip_faceStatus |= 0x4;
-                v47[-1].x = v68;
-                v47[-1].y = v57;
-                v47[-1].z = v60;
-            }
-            if ( v52 >= v50->z )
-            {
-                v69 = v47;
-                ++v5;
-                ++v47;
-                v69->x = v50->x;
-                v69->y = v50->y;
-                v48 = pSourceVert;
-                v69->z = v50->z;
-            }
-        }
-        v49 = v50++;
-        --v118;
-    }
-    while ( v118 );
-    if ( v5 < 3 )
-        return v5;
-    v70 = v5;
-    v71 = v48;
-    v5 = 0;
-    v72 = pDestVert;
-    pDestVert = v71;
-    pSourceVert = v72;
-    v73 = &v72[v70 - 1];
-    v74 = v72;
-    v119 = v70;
-    do
-    {
-        numVerticesf = frustum->bottom * v73->y;
-        v76 = v74->y * frustum->bottom;
-        if ( numVerticesf <= v73->z || v76 <= v74->z )
-        {
-            if ( v73->z != numVerticesf && v76 != v74->z && (v73->z < (double)numVerticesf || v76 > v74->z) )
-            {
-                frustumd = v74->y - v73->y;
-                v115 = v74->z - v73->z;
-                v79 = v74->y * v73->z - v74->z * v73->y;
-                v80 = v79;
-                numVerticesl = frustum->bottom * frustumd - v115;
-                if ( numVerticesl != 0.0 )
-                {
-                    v80 = v79 / numVerticesl;
-                }
-                v83 = frustum->bottom * v80;
-                v84 = frustumd;
-                if ( v84 < 0.0 )
-                    v84 = -v84;
-                v87 = v115;
-                if ( v87 < 0.0 )
-                    v87 = -v87;
-                if ( v84 <= v87 )
-                    v89 = (v83 - v73->z) / v115;
-                else
-                    v89 = (v80 - v73->y) / frustumd;
-                ++v5;
-                ++v71;
-                v91 = (v74->x - v73->x) * v89 + v73->x;
-                rdClip_faceStatus |= 8;
-                v71[-1].x = v91;
-                v71[-1].y = v80;
-                v71[-1].z = v83;
-            }
-            if ( v76 <= v74->z )
-            {
-                v92 = v71;
-                ++v5;
-                ++v71;
-                v92->x = v74->x;
-                v92->y = v74->y;
-                v72 = pSourceVert;
-                v92->z = v74->z;
-            }
-        }
-        v73 = v74++;
-        --v119;
-    }
-    while ( v119 );
-    if ( v5 < 3 )
-        return v5;
-    v93 = v5;
-    v94 = v72;
-    v5 = 0;
-    v95 = pDestVert;
-    pDestVert = v94;
-    pSourceVert = v95;
-    v96 = &v95[v93 - 1];
-    v97 = v95;
-    numVerticesg = v93;
-    do
+static rdClipPoly rdClip_aPolys[2];
+
+// Returns a mask of every plane at least one vertex is outside of, and in
+// pAllOut the planes which every vertex is outside of.
+static int rdClip_CalcOutcodes(const rdClipFrustum *frustum, float left, float top, const rdVector3 *vertices, int numVertices, int *pAllOut)
+{
+    int anyOut = 0;
+    int allOut = RDCLIP_PLANE_SIDES | RDCLIP_PLANE_NEAR | RDCLIP_PLANE_FAR;
+    int hasFar = frustum->field_0.x != 0.0;
+    int i = 0;
+
+#ifdef RDSIMD_ENABLED
+    rdSimdF4 kLeft = rdSimd_Set1(left);
+    rdSimdF4 kRight = rdSimd_Set1(frustum->right);
+    rdSimdF4 kTop = rdSimd_Set1(top);
+    rdSimdF4 kBottom = rdSimd_Set1(frustum->bottom);
+    rdSimdF4 kNear = rdSimd_Set1(frustum->field_0.y);
+    rdSimdF4 kFar = rdSimd_Set1(frustum->field_0.z);
+
+    for (; i + 4 <= numVertices; i += 4)
     {
-        if ( v96->y >= (double)frustum->field_0.y || v97->y >= (double)frustum->field_0.y )
-        {
-            if ( v96->y != frustum->field_0.y && v97->y != frustum->field_0.y && (v96->y < (double)frustum->field_0.y || v97->y < (double)frustum->field_0.y) )
-            {
-                ++v5;
-                v98 = (frustum->field_0.y - v96->y) / (v97->y - v96->y);
-                v94->y = frustum->field_0.y;
-                ++v94;
-                rdClip_faceStatus |= 1;
-                v94[-1].z = (v97->z - v96->z) * v98 + v96->z;
-                v94[-1].x = (v97->x - v96->x) * v98 + v96->x;
-            }
-            if ( v97->y >= (double)frustum->field_0.y )
-            {
-                v100 = v94;
-                ++v5;
-                ++v94;
-                v100->x = v97->x;
-                v100->y = v97->y;
-                v95 = pSourceVert;
-                v100->z = v97->z;
-            }
-        }
-        v96 = v97++;
-        --numVerticesg;
+        rdSimdF4 x, y, z;
+        int m;
+
+        rdSimd_Load3x4(&vertices[i], &x, &y, &z);
+
+#define RDCLIP_OUTCODE4(mask, plane) \
+        m = (mask); \
+        if (m) anyOut |= (plane); \
+        if (m != 0xF) allOut &= ~(plane);
+
+        RDCLIP_OUTCODE4(rdSimd_LessMask(x, rdSimd_Mul(kLeft, y)), RDCLIP_PLANE_LEFT);
+        RDCLIP_OUTCODE4(rdSimd_LessMask(rdSimd_Mul(kRight, y), x), RDCLIP_PLANE_RIGHT);
+        RDCLIP_OUTCODE4(rdSimd_LessMask(rdSimd_Mul(kTop, y), z), RDCLIP_PLANE_TOP);
+        RDCLIP_OUTCODE4(rdSimd_LessMask(z, rdSimd_Mul(kBottom, y)), RDCLIP_PLANE_BOTTOM);
+        RDCLIP_OUTCODE4(rdSimd_LessMask(y, kNear), RDCLIP_PLANE_NEAR);
+        RDCLIP_OUTCODE4(hasFar ? rdSimd_LessMask(kFar, y) : 0, RDCLIP_PLANE_FAR);
+
+#undef RDCLIP_OUTCODE4
     }
-    while ( numVerticesg );
-    v101 = pDestVert;
-    if ( v5 < 3 )
+#endif
+
+    for (; i < numVertices; i++)
     {
-        rdClip_faceStatus |= 0x40;
-        return v5;
+        const rdVector3 *v = &vertices[i];
+        int code = 0;
+
+        if (v->x < left * v->y)
+            code |= RDCLIP_PLANE_LEFT;
+        if (v->x > frustum->right * v->y)
+            code |= RDCLIP_PLANE_RIGHT;
+        if (v->z > top * v->y)
+            code |= RDCLIP_PLANE_TOP;
+        if (v->z < frustum->bottom * v->y)
+            code |= RDCLIP_PLANE_BOTTOM;
+        if (v->y < frustum->field_0.y)
+            code |= RDCLIP_PLANE_NEAR;
+        if (hasFar && v->y > frustum->field_0.z)
+            code |= RDCLIP_PLANE_FAR;
+
+        anyOut |= code;
+        allOut &= code;
     }
-    if (frustum->field_0.x)
+
+    *pAllOut = allOut;
+    return anyOut;
+}
+
+static inline void rdClip_LerpAttribs(const rdClipPoly *src, rdClipPoly *dst, int prev, int cur, int out, float t, int flags)
+{
+    if (flags & RDCLIP_UV)
     {
-        v104 = v5;
-        v105 = v95;
-        v5 = 0;
-        v106 = pDestVert;
-        pDestVert = v105;
-        pSourceVert = v106;
-        v107 = &v106[v104 - 1];
-        v108 = v106;
-        numVerticesh = v104;
-        do
-        {
-            if ( v107->y <= (double)frustum->field_0.z || v108->y <= (double)frustum->field_0.z )
-            {
-                if ( v107->y != frustum->field_0.z
-                  && v108->y != frustum->field_0.z
-                  && (v107->y > (double)frustum->field_0.z || v108->y > (double)frustum->field_0.z) )
-                {
-                    ++v5;
-                    v109 = (frustum->field_0.z - v107->y) / (v108->y - v107->y);
-                    v105->y = frustum->field_0.z;
-                    ++v105;
-                    rdClip_faceStatus |= 0x2;
-                    v105[-1].z = (v108->z - v107->z) * v109 + v107->z;
-                    v105[-1].x = (v108->x - v107->x) * v109 + v107->x;
-                }
-                if ( v108->y <= (double)frustum->field_0.z )
-                {
-                    v111 = v105;
-                    ++v5;
-                    ++v105;
-                    *v111 = *v108;
-                }
-            }
-            v107 = v108++;
-            --numVerticesh;
-        }
-        while ( numVerticesh );
-        if ( v5 < 3 )
-            return v5;
-        v101 = pDestVert;
+        dst->uv[0][out] = (src->uv[0][cur] - src->uv[0][prev]) * t + src->uv[0][prev];
+        dst->uv[1][out] = (src->uv[1][cur] - src->uv[1][prev]) * t + src->uv[1][prev];
     }
-    if ( v101 != vertices )
-        _memcpy(vertices, pDestVert, 4 * ((unsigned int)(sizeof(rdVector3) * v5) >> 2));
-    return v5;
+    if (flags & RDCLIP_LIGHT)
+        dst->light[out] = (src->light[cur] - src->light[prev]) * t + src->light[prev];
 }
 
-int rdClip_Face3GT(rdClipFrustum *frustum, rdVector3 *vertices, rdVector2 *uvs, float *a4, int numVertices)
+static inline void rdClip_CopyVert(const rdClipPoly *src, rdClipPoly *dst, int cur, int out, int flags)
 {
-    //return _rdClip_Face3GT(frustum, vertices, uvs, a4, numVertices);
-    float *v5; // ecx
-    rdVector2 *v6; // esi
-    rdVector3 *v7; // edi
-    rdVector3 *v8; // ebx
-    rdVector2 *v9; // edx
-    rdVector2 *v10; // ebp
-    rdVector3 *v11; // ecx
-    double v13; // st7
-    //char v14; // c0
-    double v16; // st6
-    //char v17; // c3
-    double v19; // st5
-    double v20; // st4
-    //char v21; // c0
-    double v23; // st3
-    //char v24; // c0
-    double v25; // st4
-    double v26; // st3
-    double v27; // st2
-    double v28; // st5
-    double v29; // rtt
-    double v30; // st3
-    double v31; // st5
-    double v32; // rt1
-    double v33; // st3
-    double v34; // st5
-    double v35; // rt2
-    rdVector3 *v37; // eax
-    signed int result; // eax
-    rdVector2 *v39; // esi
-    rdVector3 *v40; // ebp
-    rdVector2 *v41; // edx
-    rdVector3 *v42; // edi
-    rdVector2 *v43; // ebx
-    rdVector3 *v44; // ecx
-    double v46; // st7
-    //unsigned __int8 v47; // c0
-    //unsigned __int8 v48; // c3
-    double v50; // st6
-    //char v51; // c3
-    double v53; // st5
-    double v54; // st4
-    //char v55; // c0
-    double v57; // st3
-    //char v58; // c0
-    double v59; // st4
-    double v60; // st3
-    double v61; // st2
-    double v62; // st5
-    double v63; // rt0
-    double v64; // st3
-    double v65; // st5
-    double v66; // rt2
-    double v67; // st3
-    double v68; // st5
-    double v69; // rtt
-    rdVector3 *v71; // eax
-    int v72; // ebx
-    intptr_t v73; // eax
-    rdVector3 *v74; // eax
-    intptr_t v75; // esi
-    rdVector2 *v76; // esi
-    intptr_t v77; // ecx
-    //bool v78; // cc
-    rdVector3 *v79; // ebx
-    rdVector2 *v80; // edi
-    rdVector2 *v81; // ebp
-    rdVector3 *v82; // edx
-    rdVector3 *v83; // ecx
-    //unsigned __int8 v85; // c0
-    //unsigned __int8 v86; // c3
-    double v88; // st6
-    double v89; // st7
-    //char v90; // c3
-    double v92; // st6
-    double v93; // st5
-    //char v94; // c0
-    double v96; // st4
-    //char v97; // c0
-    double v98; // st5
-    double v99; // st4
-    double v100; // st3
-    double v101; // rt1
-    double v102; // st4
-    double v103; // rt2
-    rdVector3 *v105; // edi
-    intptr_t v106; // ebp
-    rdVector2 *v107; // ebp
-    rdVector3 *v108; // eax
-    intptr_t v109; // edx
-    rdVector3 *v110; // ecx
-    float *v111; // edx
-    int v112; // edi
-    rdVector3 *v113; // ebx
-    rdVector2 *v114; // edi
-    rdVector2 *v115; // esi
-    rdVector2 *v116; // ebp
-    rdVector3 *v117; // edx
-    rdVector3 *v118; // ecx
-    //char v120; // c0
-    double v122; // st6
-    double v123; // st7
-    //char v124; // c3
-    double v126; // st6
-    double v127; // st5
-    //char v128; // c0
-    double v130; // st4
-    //char v131; // c0
-    double v132; // st5
-    double v133; // st4
-    double v134; // st3
-    double v135; // rt2
-    double v136; // st4
-    double v137; // rtt
-    rdVector3 *v139; // edi
-    int v140; // esi
-    intptr_t v141; // ebp
-    rdVector2 *v142; // ebp
-    intptr_t v143; // edx
-    int v144; // eax
-    rdVector3 *v145; // ecx
-    rdVector2 *v146; // esi
-    rdVector3 *v147; // ebx
-    rdVector2 *v148; // edi
-    rdVector3 *v149; // edx
-    double v150; // st7
-    double v151; // st5
-    double v152; // st6
-    double v153; // st4
-    double v154; // st5
-    double v155; // rt1
-    double v156; // st5
-    double v157; // st6
-    rdVector3 *v159; // ecx
-    float *v160; // edx
-    rdVector2 *v161; // ebp
-    rdVector3 *v162; // esi
-    rdVector3 *v163; // ecx
-    intptr_t v165; // ebp
-    rdVector2 *v166; // ebp
-    intptr_t v167; // edx
-    int v168; // eax
-    rdVector3 *v169; // ecx
-    rdVector2 *v170; // esi
-    rdVector3 *v171; // ebx
-    rdVector2 *v172; // edi
-    rdVector3 *v173; // edx
-    double v174; // st7
-    double v175; // st5
-    double v176; // st6
-    double v177; // st4
-    double v178; // st5
-    double v179; // st4
-    double v180; // st6
-    double v181; // rt2
-    rdVector3 *v183; // ecx
-    int v184; // [esp+10h] [ebp-20h]
-    int v185; // [esp+10h] [ebp-20h]
-    int v186; // [esp+10h] [ebp-20h]
-    int v187; // [esp+10h] [ebp-20h]
-    int v188; // [esp+10h] [ebp-20h]
-    int v189; // [esp+10h] [ebp-20h]
-    float *v190; // [esp+14h] [ebp-1Ch]
-    float *v191; // [esp+14h] [ebp-1Ch]
-    float *v192; // [esp+14h] [ebp-1Ch]
-    float *v193; // [esp+14h] [ebp-1Ch]
-    float *v194; // [esp+14h] [ebp-1Ch]
-    float *v195; // [esp+14h] [ebp-1Ch]
-    float *v196; // [esp+18h] [ebp-18h]
-    float *v197; // [esp+18h] [ebp-18h]
-    float *v198; // [esp+18h] [ebp-18h]
-    float *v199; // [esp+18h] [ebp-18h]
-    float *v200; // [esp+18h] [ebp-18h]
-    float *v201; // [esp+18h] [ebp-18h]
-    float v202; // [esp+1Ch] [ebp-14h]
-    float v203; // [esp+1Ch] [ebp-14h]
-    float v204; // [esp+1Ch] [ebp-14h]
-    float v205; // [esp+1Ch] [ebp-14h]
-    float v206; // [esp+1Ch] [ebp-14h]
-    float v207; // [esp+1Ch] [ebp-14h]
-    float v208; // [esp+20h] [ebp-10h]
-    float v209; // [esp+20h] [ebp-10h]
-    float v210; // [esp+20h] [ebp-10h]
-    float v211; // [esp+20h] [ebp-10h]
-    float *v212; // [esp+24h] [ebp-Ch]
-    float *v213; // [esp+24h] [ebp-Ch]
-    float v214; // [esp+24h] [ebp-Ch]
-    float v215; // [esp+24h] [ebp-Ch]
-    int v216; // [esp+28h] [ebp-8h]
-    int v217; // [esp+28h] [ebp-8h]
-    float *v218; // [esp+28h] [ebp-8h]
-    float *v219; // [esp+28h] [ebp-8h]
-    int v220; // [esp+2Ch] [ebp-4h]
-    int v221; // [esp+2Ch] [ebp-4h]
-    int v222; // [esp+2Ch] [ebp-4h]
-    int v223; // [esp+2Ch] [ebp-4h]
-    float numVerticesa; // [esp+44h] [ebp+14h]
-    float numVerticesb; // [esp+44h] [ebp+14h]
-    int numVerticesc; // [esp+44h] [ebp+14h]
-    float numVerticesd; // [esp+44h] [ebp+14h]
-    float numVerticese; // [esp+44h] [ebp+14h]
-    int numVerticesf; // [esp+44h] [ebp+14h]
-    float numVerticesg; // [esp+44h] [ebp+14h]
-    int numVerticesh; // [esp+44h] [ebp+14h]
-    float numVerticesi; // [esp+44h] [ebp+14h]
-    float *numVerticesj; // [esp+44h] [ebp+14h]
-    float *numVerticesk; // [esp+44h] [ebp+14h]
-
-    v5 = a4;
-    rdClip_faceStatus = 0;
-    v184 = 0;
-    v6 = uvs;
-    v7 = vertices;
-    pSourceVert = vertices;
-    v8 = &vertices[numVertices - 1];
-    pDestVert = workVerts;
-    pSourceTVert = uvs;
-    pDestTVert = workTVerts;
-    pSourceIVert = a4;
-    pDestIVert = workIVerts;
-    v9 = &uvs[numVertices - 1];
-    v196 = &a4[numVertices - 1];
-    v190 = a4;
-    if ( numVertices > 0 )
+    dst->pos[0][out] = src->pos[0][cur];
+    dst->pos[1][out] = src->pos[1][cur];
+    dst->pos[2][out] = src->pos[2][cur];
+    if (flags & RDCLIP_UV)
     {
-        v212 = workIVerts;
-        v10 = workTVerts;
-        v11 = workVerts;
-        v216 = numVertices;
-        do
-        {
-            numVerticesa = frustum->nearLeft * v8->y;
-            v13 = frustum->nearLeft * v7->y;
-            if ( numVerticesa <= v8->x || v13 <= v7->x )
-            {
-                if ( v8->x != numVerticesa && v13 != v7->x && (v8->x < (double)numVerticesa || v13 > v7->x) )
-                {
-                    numVerticesb = v7->y - v8->y;
-                    v208 = v7->x - v8->x;
-                    v16 = v7->y * v8->x - v8->y * v7->x;
-                    v202 = frustum->nearLeft * numVerticesb - v208;
-                    if (v202 != 0.0)
-                    {
-                        v16 = v16 / v202;
-                    }
-                    v19 = frustum->nearLeft * v16;
-                    v20 = numVerticesb;
-                    if (v20 < 0.0)
-                        v20 = -v20;
-                    v23 = v208;
-                    if (v23 < 0.0)
-                        v23 = -v23;
-                    if ( v20 <= v23 )
-                        v25 = (v19 - v8->x) / v208;
-                    else
-                        v25 = (v16 - v8->y) / numVerticesb;
-                    ++v11;
-                    ++v10;
-                    v26 = (v6->x - v9->x) * v25;
-                    v27 = v19;
-                    v28 = *v190;
-                    v11[-1].x = v27;
-                    v29 = v26 + v9->x;
-                    v11[-1].y = v16;
-                    v30 = v28;
-                    v31 = v7->z;
-                    v32 = v30 - *v196;
-                    v10[-1].x = v29;
-                    v33 = v31 - v8->z;
-                    v34 = (v6->y - v9->y) * v25 + v9->y;
-                    v35 = v32 * v25 + *v196;
-                    v11[-1].z = v33 * v25 + v8->z;
-                    v10[-1].y = v34;
-                    *v212++ = v35;
-                    ++v184;
-                    rdClip_faceStatus |= 0x10;
-                }
-                if ( v13 <= v7->x )
-                {
-                    v37 = v11++;
-                    ++v10;
-                    *v37 = *v7;
-                    v10[-1].x = v6->x;
-                    v10[-1].y = v6->y;
-                    ++v184;
-                    *v212++ = *v190;
-                }
-            }
-            v8 = v7;
-            v196 = v190++;
-            v9 = v6;
-            ++v7;
-            ++v6;
-            --v216;
-        }
-        while ( v216 );
-        v7 = vertices;
-        v5 = a4;
+        dst->uv[0][out] = src->uv[0][cur];
+        dst->uv[1][out] = src->uv[1][cur];
     }
-    if ( v184 < 3 )
-        return v184;
-    pDestVert = v7;
-    numVerticesc = v184;
-    pDestTVert = uvs;
-    v39 = workTVerts;
-    pSourceVert = workVerts;
-    pSourceTVert = workTVerts;
-    pDestIVert = v5;
-    pSourceIVert = workIVerts;
-    v185 = 0;
-    v40 = &workVerts[numVerticesc - 1];
-    v41 = &workTVerts[numVerticesc - 1];
-    v191 = workIVerts;
-    v197 = &workIVerts[numVerticesc - 1];
-    v42 = workVerts;
-    v43 = pDestTVert;
-    v44 = pDestVert;
-    v213 = pDestIVert;
-    v217 = numVerticesc;
-    do
+    if (flags & RDCLIP_LIGHT)
+        dst->light[out] = src->light[cur];
+}
+
+// Clips against the plane through the camera where sign*(a - k*y) >= 0 is
+// inside, a being x for left/right and z for top/bottom.
+static int rdClip_PolySide(const rdClipPoly *src, rdClipPoly *dst, int numVertices, int axis, float k, float sign, int plane, int flags)
+{
+    const float *pA = src->pos[axis];
+    const float *pB = src->pos[2 - axis];
+    const float *pY = src->pos[1];
+    int num = 0;
+    int prev = numVertices - 1;
+
+    for (int cur = 0; cur < numVertices; cur++)
     {
-        numVerticesd = frustum->right * v40->y;
-        v46 = frustum->right * v42->y;
-        if ( numVerticesd >= v40->x || v46 >= v42->x )
+        float dPrev = sign * (pA[prev] - k * pY[prev]);
+        float dCur = sign * (pA[cur] - k * pY[cur]);
+
+        if (dPrev >= 0.0 || dCur >= 0.0)
         {
-            if ( v40->x != numVerticesd && v46 != v42->x && (v40->x > (double)numVerticesd || v46 < v42->x) )
+            if (dPrev != 0.0 && dCur != 0.0 && (dPrev < 0.0 || dCur < 0.0))
             {
-                numVerticese = v42->y - v40->y;
-                v209 = v42->x - v40->x;
-                v50 = v42->y * v40->x - v40->y * v42->x;
-                v203 = frustum->right * numVerticese - v209;
-                if (v203 != 0.0)
-                {
-                    
-                    v50 = v50 / v203;
-                }
-                v53 = frustum->right * v50;
-                v54 = numVerticese;
-                if ( v54 < 0.0 )
-                    v54 = -v54;
-                v57 = v209;
-                if ( v57 < 0.0 )
-                    v57 = -v57;
-                if ( v54 <= v57 )
-                    v59 = (v53 - v40->x) / v209;
+                float dy = pY[cur] - pY[prev];
+                float da = pA[cur] - pA[prev];
+                float y = pY[cur] * pA[prev] - pY[prev] * pA[cur];
+                float denom = k * dy - da;
+                float a, t;
+
+                if (denom != 0.0)
+                    y = y / denom;
+                a = k * y;
+
+                if (fabs(dy) <= fabs(da))
+                    t = (a - pA[prev]) / da;
                 else
-                    v59 = (v50 - v40->y) / numVerticese;
-                ++v44;
-                ++v43;
-                v60 = (v39->x - v41->x) * v59;
-                v61 = v53;
-                v62 = *v191;
-                v44[-1].x = v61;
-                v63 = v60 + v41->x;
-                v44[-1].y = v50;
-                v64 = v62;
-                v65 = v42->z;
-                v66 = v64 - *v197;
-                v43[-1].x = v63;
-                v67 = v65 - v40->z;
-                v68 = (v39->y - v41->y) * v59 + v41->y;
-                v69 = v66 * v59 + *v197;
-                v44[-1].z = v67 * v59 + v40->z;
-                v43[-1].y = v68;
-                *v213++ = v69;
-                ++v185;
-                rdClip_faceStatus |= 0x20;
-            }
-            if ( v46 >= v42->x )
-            {
-                v71 = v44++;
-                ++v43;
-                v71->x = v42->x;
-                v71->y = v42->y;
-                v71->z = v42->z;
-                v43[-1].x = v39->x;
-                v43[-1].y = v39->y;
-                ++v185;
-                *v213++ = *v191;
-            }
-        }
-        v40 = v42;
-        v197 = v191++;
-        v41 = v39;
-        ++v42;
-        ++v39;
-        --v217;
-    }
-    while ( v217 );
-    v72 = v185;
-    if ( v185 < 3 )
-        goto LABEL_127;
-    v186 = 0;
-    v73 = (intptr_t)pDestVert ^ (intptr_t)pSourceVert;
-    pDestVert = pSourceVert;
-    v74 = (rdVector3 *)((intptr_t)pSourceVert ^ v73);
-    pSourceVert = v74;
-    v75 = (intptr_t)pDestTVert ^ (intptr_t)pSourceTVert;
-    pDestTVert = pSourceTVert;
-    v76 = (rdVector2 *)((intptr_t)pSourceTVert ^ v75);
-    pSourceTVert = v76;
-    v77 = (intptr_t)pDestIVert ^ (intptr_t)pSourceIVert;
-    pDestIVert = pSourceIVert;
-    pSourceIVert = (float *)((intptr_t)pSourceIVert ^ v77);
-    numVerticesf = v72;
-    v198 = (float *)(((intptr_t)pDestIVert ^ v77) + 4 * v72 - 4);
-    v79 = &v74[v72 - 1];
-    v80 = &v76[numVerticesf - 1];
-    v192 = (float *)((intptr_t)pDestIVert ^ v77);
-    if ( v72 > 0 )
-    {
-        v81 = pDestTVert;
-        v82 = v74;
-        v218 = pDestIVert;
-        v83 = pDestVert;
-        v220 = numVerticesf;
-        do
-        {
-            v204 = frustum->nearTop * v79->y;
-            numVerticesg = v82->y * frustum->nearTop;
-            if ( v79->z <= v204 || v82->z <= (double)numVerticesg )
-            {
-                if ( v79->z != v204 && v82->z != numVerticesg && (v79->z > (double)v204 || v82->z > (double)numVerticesg) )
-                {
-                    v210 = v82->y - v79->y;
-                    v214 = v82->z - v79->z;
-                    v88 = v82->y * v79->z - v82->z * v79->y;
-                    v89 = v88;
-                    v205 = frustum->nearTop * v210 - v214;
-                    if (v205 != 0.0)
-                    {
-                        v89 = v88 / v205;
-                    }
-                    v92 = frustum->nearTop * v89;
-                    v93 = v210;
-                    if ( v93 < 0.0 )
-                        v93 = -v93;
-                    v96 = v214;
-                    if ( v96 < 0.0 )
-                        v96 = -v96;
-                    if ( v93 <= v96 )
-                        v98 = (v92 - v79->z) / v214;
-                    else
-                        v98 = (v89 - v79->y) / v210;
-                    v99 = v82->x - v79->x;
-                    ++v83;
-                    ++v81;
-                    v100 = *v192 - *v198;
-                    ++v186;
-                    v81[-1].x = (v76->x - v80->x) * v98 + v80->x;
-                    v101 = v99 * v98;
-                    v102 = (v76->y - v80->y) * v98 + v80->y;
-                    v103 = v100 * v98 + *v198;
-                    v83[-1].x = v101 + v79->x;
-                    v83[-1].y = v89;
-                    v83[-1].z = v92;
-                    v81[-1].y = v102;
-                    *v218++ = v103;
-                    rdClip_faceStatus |= 0x4;
-                }
-                if ( v82->z <= (double)numVerticesg )
-                {
-                    v105 = v83++;
-                    ++v81;
-                    v105->x = v82->x;
-                    v105->y = v82->y;
-                    v105->z = v82->z;
-                    v81[-1].x = v76->x;
-                    v81[-1].y = v76->y;
-                    ++v186;
-                    *v218++ = *v192;
-                }
+                    t = (y - pY[prev]) / dy;
+
+                dst->pos[axis][num] = a;
+                dst->pos[1][num] = y;
+                dst->pos[2 - axis][num] = (pB[cur] - pB[prev]) * t + pB[prev];
+                rdClip_LerpAttribs(src, dst, prev, cur, num, t, flags);
+                rdClip_faceStatus |= plane;
+                num++;
             }
-            v79 = v82++;
-            v198 = v192++;
-            v80 = v76++;
-            --v220;
+            if (dCur >= 0.0)
+                rdClip_CopyVert(src, dst, cur, num++, flags);
         }
-        while ( v220 );
+        prev = cur;
     }
-    result = v186;
-    if ( v186 >= 3 )
+
+    return num;
+}
+
+// Clips against the plane y = c, inside being sign*(y - c) >= 0.
+static int rdClip_PolyDepth(const rdClipPoly *src, rdClipPoly *dst, int numVertices, float c, float sign, int plane, int flags)
+{
+    const float *pX = src->pos[0];
+    const float *pY = src->pos[1];
+    const float *pZ = src->pos[2];
+    int num = 0;
+    int prev = numVertices - 1;
+
+    for (int cur = 0; cur < numVertices; cur++)
     {
-        v106 = (intptr_t)pDestTVert ^ (intptr_t)pSourceTVert;
-        pDestTVert = pSourceTVert;
-        v107 = (rdVector2 *)((intptr_t)pSourceTVert ^ v106);
-        v108 = pSourceVert;
-        v109 = (intptr_t)pDestIVert ^ (intptr_t)pSourceIVert;
-        v110 = pDestVert;
-        pDestVert = pSourceVert;
-        pDestIVert = pSourceIVert;
-        v111 = (float *)((intptr_t)pSourceIVert ^ v109);
-        pSourceVert = v110;
-        numVerticesh = v186;
-        pSourceTVert = v107;
-        v112 = v186;
-        pSourceIVert = v111;
-        v187 = 0;
-        v113 = &v110[v112 - 1];
-        v114 = &v107[numVerticesh - 1];
-        v193 = v111;
-        v199 = &v111[numVerticesh - 1];
-        v115 = v107;
-        if (v186 > 0)
-        {
-            v116 = pDestTVert;
-            v117 = v110;
-            v219 = pDestIVert;
-            v118 = v108;
-            v221 = numVerticesh;
-            do
-            {
-                v206 = frustum->bottom * v113->y;
-                numVerticesi = v117->y * frustum->bottom;
-                if ( v113->z >= v206 || v117->z >= (double)numVerticesi )
-                {
-                    if ( v113->z != v206 && v117->z != numVerticesi && (v113->z < (double)v206 || v117->z < (double)numVerticesi) )
-                    {
-                        v215 = v117->y - v113->y;
-                        v211 = v117->z - v113->z;
-                        v122 = v117->y * v113->z - v117->z * v113->y;
-                        v123 = v122;
-                        v207 = frustum->bottom * v215 - v211;
-                        if (v207 != 0.0)
-                        {
-                            v123 = v122 / v207;
-                        }
-                        v126 = frustum->bottom * v123;
-                        v127 = v215;
-                        if ( v127 < 0.0 )
-                            v127 = -v127;
-                        v130 = v211;
-                        if ( v130 < 0.0 )
-                            v130 = -v130;
-                        if ( v127 <= v130 )
-                            v132 = (v126 - v113->z) / v211;
-                        else
-                            v132 = (v123 - v113->y) / v215;
-                        v133 = v117->x - v113->x;
-                        ++v118;
-                        ++v116;
-                        v134 = *v193 - *v199;
-                        ++v187;
-                        v116[-1].x = (v115->x - v114->x) * v132 + v114->x;
-                        v135 = v133 * v132;
-                        v136 = (v115->y - v114->y) * v132 + v114->y;
-                        v137 = v134 * v132 + *v199;
-                        v118[-1].x = v135 + v113->x;
-                        v118[-1].y = v123;
-                        v118[-1].z = v126;
-                        v116[-1].y = v136;
-                        *v219++ = v137;
-                        rdClip_faceStatus |= 0x8;
-                    }
-                    if ( v117->z >= (double)numVerticesi )
-                    {
-                        v139 = v118++;
-                        ++v116;
-                        *v139 = *v117;
-                        v116[-1].x = v115->x;
-                        v116[-1].y = v115->y;
-                        ++v187;
-                        *v219++ = *v193;
-                    }
-                }
-                v113 = v117++;
-                v199 = v193++;
-                v114 = v115++;
-                --v221;
-            }
-            while ( v221 );
-            v110 = pSourceVert;
-            v108 = pDestVert;
-            v111 = pSourceIVert;
-            v107 = pSourceTVert;
-        }
-        v140 = v187;
-        if ( v187 < 3 )
-            return v187;
-        v72 = 0;
-        v188 = 0;
-        pDestVert = v110;
-        pSourceVert = v108;
-        v141 = (intptr_t)pDestTVert ^ (intptr_t)v107;
-        pDestTVert = (rdVector2 *)(v141 ^ (intptr_t)pDestTVert);
-        v142 = (rdVector2 *)((intptr_t)pDestTVert ^ v141);
-        pSourceTVert = v142;
-        v143 = (intptr_t)pDestIVert ^ (intptr_t)v111;
-        pDestIVert = (float *)(v143 ^ (intptr_t)pDestIVert);
-        v144 = v140;
-        pSourceIVert = (float *)((intptr_t)pDestIVert ^ v143);
-
-        v200 = (float *)(((intptr_t)pDestIVert ^ v143) + 4 * v140 - 4);
-        v194 = (float *)((intptr_t)pDestIVert ^ v143);
-        v145 = &pSourceVert[v140 - 1];
-        v146 = &v142[v140 - 1];
-        if ( v140 <= 0 )
-        {
-            v161 = pSourceTVert;
-            v163 = pSourceVert;
-            v162 = pDestVert;
-            v160 = pSourceIVert;
-        }
-        else
-        {
-            v147 = pDestVert;
-            numVerticesj = pDestIVert;
-            v148 = pDestTVert;
-            v149 = pSourceVert;
-            v222 = v144;
-            do
-            {
-                if ( v145->y >= (double)frustum->field_0.y || v149->y >= (double)frustum->field_0.y )
-                {
-                    if ( v145->y != frustum->field_0.y
-                      && v149->y != frustum->field_0.y
-                      && (v145->y < (double)frustum->field_0.y || v149->y < (double)frustum->field_0.y) )
-                    {
-                        ++v147;
-                        v150 = (frustum->field_0.y - v145->y) / (v149->y - v145->y);
-                        v147[-1].y = frustum->field_0.y;
-                        ++v148;
-                        ++v188;
-                        v151 = (v142->x - v146->x) * v150 + v146->x;
-                        v152 = *v194 - *v200;
-                        v147[-1].z = (v149->z - v145->z) * v150 + v145->z;
-                        v153 = v151;
-                        v154 = v149->x - v145->x;
-                        v148[-1].x = v153;
-                        v155 = v154 * v150;
-                        v156 = (v142->y - v146->y) * v150 + v146->y;
-                        v157 = v152 * v150 + *v200;
-                        v147[-1].x = v155 + v145->x;
-                        v148[-1].y = v156;
-                        *numVerticesj++ = v157;
-                        rdClip_faceStatus |= 1;
-                    }
-                    if ( v149->y >= (double)frustum->field_0.y )
-                    {
-                        v159 = v147++;
-                        ++v148;
-                        *v159 = *v149;
-                        v148[-1].x = v142->x;
-                        v148[-1].y = v142->y;
-                        ++v188;
-                        *numVerticesj++ = *v194;
-                    }
-                }
-                v145 = v149++;
-                v200 = v194++;
-                v146 = v142++;
-                --v222;
-            }
-            while ( v222 );
-            v160 = pSourceIVert;
-            v161 = pSourceTVert;
-            v162 = pDestVert;
-            v163 = pSourceVert;
-            v72 = v188;
-        }
-        if ( v72 < 3 )
-        {
-            rdClip_faceStatus |= 0x40;
-            return v72;
-        }
-        if (frustum->field_0.x)
+        float dPrev = sign * (pY[prev] - c);
+        float dCur = sign * (pY[cur] - c);
+
+        if (dPrev >= 0.0 || dCur >= 0.0)
         {
-            v165 = (intptr_t)pDestTVert ^ (intptr_t)v161;
-            pDestVert = v163;
-            pDestTVert = (rdVector2 *)(v165 ^ (intptr_t)pDestTVert);
-            v166 = (rdVector2 *)((intptr_t)pDestTVert ^ v165);
-            v167 = (intptr_t)pDestIVert ^ (intptr_t)v160;
-            pSourceVert = v162;
-            pSourceTVert = v166;
-            pDestIVert = (float *)(v167 ^ (intptr_t)pDestIVert);
-            v168 = v72;
-            pSourceIVert = (float *)((intptr_t)pDestIVert ^ v167);
-            v189 = 0;
-            v201 = (float *)(((intptr_t)pDestIVert ^ v167) + 4 * v72 - 4);
-            v169 = &v162[v72 - 1];
-            v170 = &v166[v72 - 1];
-            v195 = (float *)((intptr_t)pDestIVert ^ v167);
-            v171 = pDestVert;
-            numVerticesk = pDestIVert;
-            v172 = pDestTVert;
-            v173 = pSourceVert;
-            v223 = v168;
-            do
+            if (dPrev != 0.0 && dCur != 0.0 && (dPrev < 0.0 || dCur < 0.0))
             {
-                if ( v169->y <= (double)frustum->field_0.z || v173->y <= (double)frustum->field_0.z )
-                {
-                    if ( v169->y != frustum->field_0.z
-                      && v173->y != frustum->field_0.z
-                      && (v169->y > (double)frustum->field_0.z || v173->y > (double)frustum->field_0.z) )
-                    {
-                        ++v171;
-                        v174 = (frustum->field_0.z - v169->y) / (v173->y - v169->y);
-                        v171[-1].y = frustum->field_0.z;
-                        ++v172;
-                        ++v189;
-                        v175 = (v166->x - v170->x) * v174 + v170->x;
-                        v176 = *v195;
-                        v171[-1].z = (v173->z - v169->z) * v174 + v169->z;
-                        v177 = v175;
-                        v178 = v173->x - v169->x;
-                        v172[-1].x = v177;
-                        v179 = (v176 - *v201) * v174;
-                        v180 = (v166->y - v170->y) * v174 + v170->y;
-                        v181 = v179 + *v201;
-                        v171[-1].x = v178 * v174 + v169->x;
-                        v172[-1].y = v180;
-                        *numVerticesk++ = v181;
-                        rdClip_faceStatus |= 0x2;
-                    }
-                    if ( v173->y <= (double)frustum->field_0.z )
-                    {
-                        v183 = v171++;
-                        ++v172;
-                        *v183 = *v173;
-                        v172[-1].x = v166->x;
-                        v172[-1].y = v166->y;
-                        ++v189;
-                        *numVerticesk++ = *v195;
-                    }
-                }
-                v169 = v173++;
-                v201 = v195++;
-                v170 = v166++;
-                --v223;
+                float t = (c - pY[prev]) / (pY[cur] - pY[prev]);
+
+                dst->pos[0][num] = (pX[cur] - pX[prev]) * t + pX[prev];
+                dst->pos[1][num] = c;
+                dst->pos[2][num] = (pZ[cur] - pZ[prev]) * t + pZ[prev];
+                rdClip_LerpAttribs(src, dst, prev, cur, num, t, flags);
+                rdClip_faceStatus |= plane;
+                num++;
             }
-            while ( v223 );
-            v72 = v189;
-            if ( v189 < 3 )
-                goto LABEL_127;
-            v162 = pDestVert;
+            if (dCur >= 0.0)
+                rdClip_CopyVert(src, dst, cur, num++, flags);
         }
-        if ( v162 != vertices )
-        {
-            _memcpy(vertices, v162, sizeof(rdVector3) * v72);
-            _memcpy(uvs, pDestTVert, sizeof(rdVector2) * v72);
-            _memcpy(a4, pDestIVert, sizeof(float) * v72);
-        }
-LABEL_127:
-        result = v72;
+        prev = cur;
     }
-    return result;
+
+    return num;
 }
 
-int rdClip_Face3S(rdClipFrustum *frustum, rdVector3 *vertices, int numVertices)
+static int rdClip_Poly(rdClipFrustum *frustum, float left, float top, int skipSides, rdVector3 *vertices, rdVector2 *uvs, float *lights, int numVertices)
 {
-    //return _rdClip_Face3S(frustum, vertices, numVertices);
-    rdVector3 *v3; // edx
-    int v5; // ebp
-    rdVector3 *v6; // esi
-    rdVector3 *v7; // ecx
-    double v9; // st7
-    double v12; // st6
-    double v20; // st5
-    double v22; // st5
-    rdVector3 *v23; // ecx
-    int v24; // eax
-    rdVector3 *v25; // esi
-    rdVector3 *v26; // edi
-    rdVector3 *v27; // ecx
-    rdVector3 *v28; // edx
-    double v30; // st7
-    double v34; // st6
-    double v37; // st5
-    double v40; // st4
-    double v42; // st5
-    int v43; // eax
-    double v44; // st5
-    rdVector3 *v45; // ecx
-    int v46; // eax
-    rdVector3 *v47; // esi
-    rdVector3 *v48; // edi
-    rdVector3 *v49; // ecx
-    rdVector3 *v50; // edx
-    double v52; // st7
-    double v56; // st5
-    double v57; // st6
-    double v60; // st5
-    double v66; // st4
-    int v67; // eax
-    double v68; // st3
-    rdVector3 *v69; // ecx
-    int v70; // eax
-    rdVector3 *v71; // esi
-    rdVector3 *v72; // edi
-    rdVector3 *v73; // ecx
-    rdVector3 *v74; // edx
-    double v76; // st7
-    double v79; // st5
-    double v80; // st6
-    double v83; // st5
-    double v84; // st4
-    double v87; // st3
-    double v89; // st4
-    int v90; // eax
-    double v91; // st3
-    rdVector3 *v92; // ecx
-    int v93; // eax
-    rdVector3 *v94; // esi
-    rdVector3 *v95; // edi
-    rdVector3 *v96; // ecx
-    rdVector3 *v97; // edx
-    double v98; // st7
-    int v99; // eax
-    rdVector3 *v100; // eax
-    rdVector3 *v101; // esi
-    int v102; // eax
-    int v104; // eax
-    rdVector3 *v105; // esi
-    rdVector3 *v106; // edi
-    rdVector3 *v107; // ecx
-    rdVector3 *v108; // edx
-    double v109; // st7
-    int v110; // eax
-    rdVector3 *v111; // eax
-    double v112; // [esp+10h] [ebp-8h]
-    double v113; // [esp+10h] [ebp-8h]
-    double v114; // [esp+10h] [ebp-8h]
-    double v115; // [esp+10h] [ebp-8h]
-    int v116; // [esp+14h] [ebp-4h]
-    int v117; // [esp+14h] [ebp-4h]
-    int v118; // [esp+14h] [ebp-4h]
-    int v119; // [esp+14h] [ebp-4h]
-    double frustuma; // [esp+1Ch] [ebp+4h]
-    double frustumb; // [esp+1Ch] [ebp+4h]
-    double frustumc; // [esp+1Ch] [ebp+4h]
-    double frustumd; // [esp+1Ch] [ebp+4h]
-    double numVerticesa; // [esp+24h] [ebp+Ch]
-    double numVerticesi; // [esp+24h] [ebp+Ch]
-    double numVerticesb; // [esp+24h] [ebp+Ch]
-    double numVerticesc; // [esp+24h] [ebp+Ch]
-    double numVerticesj; // [esp+24h] [ebp+Ch]
-    double numVerticesd; // [esp+24h] [ebp+Ch]
-    double numVerticese; // [esp+24h] [ebp+Ch]
-    double numVerticesk; // [esp+24h] [ebp+Ch]
-    double numVerticesf; // [esp+24h] [ebp+Ch]
-    double numVerticesl; // [esp+24h] [ebp+Ch]
-    int numVerticesg; // [esp+24h] [ebp+Ch]
-    int numVerticesh; // [esp+24h] [ebp+Ch]
-
-    v3 = vertices;
-    pSourceVert = vertices;
-    v5 = 0;
-    v6 = workVerts;
+    int flags = (uvs ? RDCLIP_UV : 0) | (lights ? RDCLIP_LIGHT : 0);
+    int allOut;
+    int planes;
+    int cur = 0;
+    rdClipPoly *pSrc;
+    rdClipPoly *pDst;
+
     rdClip_faceStatus = 0;
-    pDestVert = workVerts;
-    v7 = &vertices[numVertices - 1];
-    for (v116 = numVertices; v116 > 0; v116-- )
+
+    // Every clipped vertex count below is bounded by numVertices + 6
+    if (numVertices > RDCLIP_MAX_VERTS - 6)
+        return 0;
+
+    planes = rdClip_CalcOutcodes(frustum, left, top, vertices, numVertices, &allOut);
+    if (allOut & (RDCLIP_PLANE_SIDES | RDCLIP_PLANE_FAR))
+        return 0;
+    if (skipSides)
+        planes &= ~RDCLIP_PLANE_SIDES;
+
+    // Entirely inside, nothing to do
+    if (!planes)
+        return numVertices;
+
+    pSrc = &rdClip_aPolys[0];
+    for (int i = 0; i < numVertices; i++)
     {
-        numVerticesa = v7->y * frustum->nearLeft;
-        v9 = v3->y * frustum->nearLeft;
-        if ( numVerticesa <= v7->x || v9 <= v3->x )
+        pSrc->pos[0][i] = vertices[i].x;
+        pSrc->pos[1][i] = vertices[i].y;
+        pSrc->pos[2][i] = vertices[i].z;
+        if (uvs)
         {
-            if ( v7->x != numVerticesa && v9 != v3->x && (v7->x < numVerticesa || v9 > v3->x) )
-            {
-                frustuma = v3->y - v7->y;
-                v112 = v3->x - v7->x;
-                v12 = v3->y * v7->x - v7->y * v3->x;
-                numVerticesi = frustum->nearLeft * frustuma - v112;
-                if ( numVerticesi != 0.0)
-                {
-                    v12 = v12 / numVerticesi;
-                }
-                numVerticesb = frustum->nearLeft * v12;
-
-                if ( fabs(frustuma) <= fabs(v112) )
-                    v20 = (numVerticesb - v7->x) / v112;
-                else
-                    v20 = (v12 - v7->y) / frustuma;
-                v6->x = numVerticesb;
-                v6->y = v12;
-                ++v5;
-                
-                v22 = (v3->z - v7->z) * v20;
-                rdClip_faceStatus |= 0x10;
-                v6->z = v22 + v7->z;
-                ++v6;
-            }
-            if ( v9 <= v3->x )
-            {
-                v23 = v6;
-                ++v5;
-                ++v6;
-                v23->x = v3->x;
-                v23->y = v3->y;
-                v23->z = v3->z;
-            }
+            pSrc->uv[0][i] = uvs[i].x;
+            pSrc->uv[1][i] = uvs[i].y;
         }
-        v7 = v3++;
+        if (lights)
+            pSrc->light[i] = lights[i];
     }
-    if ( v5 < 3 )
-        return v5;
-
-    v24 = v5;
-    v5 = 0;
-    v25 = vertices;
-    v26 = workVerts;
-    pDestVert = vertices;
-    pSourceVert = workVerts;
-    v27 = &workVerts[v24 - 1];
-    v28 = workVerts;
-    for (v117 = v24; v117 > 0; v117--)
+
+#define RDCLIP_NEXT_POLY() \
+    cur ^= 1; \
+    pSrc = &rdClip_aPolys[cur]; \
+    pDst = &rdClip_aPolys[cur ^ 1];
+
+    pDst = &rdClip_aPolys[1];
+    if (planes & RDCLIP_PLANE_LEFT)
     {
-        numVerticesc = frustum->right * v27->y;
-        v30 = frustum->right * v28->y;
-        if ( numVerticesc >= v27->x || v30 >= v28->x )
-        {
-            if ( v27->x != numVerticesc && v30 != v28->x && (v27->x > numVerticesc || v30 < v28->x) )
-            {
-                frustumb = v28->y - v27->y;
-                v113 = v28->x - v27->x;
-                v34 = v28->y * v27->x - v27->y * v28->x;
-                numVerticesj = frustum->right * frustumb - v113;
-                if ( numVerticesj != 0.0 )
-                {
-                    v34 = v34 / numVerticesj;
-                }
-                numVerticesd = frustum->right * v34;
-                v37 = frustumb;
-                if ( v37 < 0.0 )
-                    v37 = -v37;
-                v40 = v113;
-                if ( v40 < 0.0 )
-                    v40 = -v40;
-                if ( v37 <= v40 )
-                    v42 = (numVerticesd - v27->x) / v113;
-                else
-                    v42 = (v34 - v27->y) / frustumb;
-                v25->x = numVerticesd;
-                v25->y = v34;
-                ++v5;
-                
-                v44 = (v28->z - v27->z) * v42;
-                rdClip_faceStatus |= 0x20;
-                v25->z = v44 + v27->z;
-                ++v25;
-            }
-            if ( v30 >= v28->x )
-            {
-                v45 = v25;
-                ++v5;
-                ++v25;
-                v45->x = v28->x;
-                v45->y = v28->y;
-                v45->z = v28->z;
-            }
-        }
-        v27 = v28++;
+        numVertices = rdClip_PolySide(pSrc, pDst, numVertices, 0, left, 1.0, RDCLIP_PLANE_LEFT, flags);
+        if (numVertices < 3)
+            return numVertices;
+        RDCLIP_NEXT_POLY();
     }
-    if ( v5 < 3 )
-        return v5;
-
-    v46 = v5;
-    v47 = pSourceVert;
-    v5 = 0;
-    v48 = pDestVert;
-    pDestVert = v47;
-    pSourceVert = v48;
-    v49 = &v48[v46 - 1];
-    v50 = v48;
-    for (v118 = v46; v118 > 0; v118--)
+    if (planes & RDCLIP_PLANE_RIGHT)
     {
-        numVerticese = frustum->nearTop * v49->y;
-        v52 = v50->y * frustum->nearTop;
-        if ( numVerticese >= v49->z || v52 >= v50->z )
-        {
-            if ( v49->z != numVerticese && v52 != v50->z && (v49->z > numVerticese || v52 < v50->z) )
-            {
-                frustumc = v50->y - v49->y;
-                v114 = v50->z - v49->z;
-                v56 = v50->y * v49->z - v50->z * v49->y;
-                v57 = v56;
-                numVerticesk = frustum->nearTop * frustumc - v114;
-                if ( numVerticesk != 0.0 )
-                {
-                    v57 = v56 / numVerticesk;
-                }
-                v60 = frustum->nearTop * v57;
-
-                if ( fabs(frustumc) <= fabs(v114) )
-                    v66 = (v60 - v49->z) / v114;
-                else
-                    v66 = (v57 - v49->y) / frustumc;
-                ++v5;
-                
-                v68 = (v50->x - v49->x) * v66 + v49->x;
-                rdClip_faceStatus |= 0x4;
-                v47->x = v68;
-                v47->y = v57;
-                v47->z = v60;
-                ++v47;
-            }
-            if ( v52 >= v50->z )
-            {
-                v69 = v47;
-                ++v5;
-                ++v47;
-                v69->x = v50->x;
-                v69->y = v50->y;
-                v69->z = v50->z;
-            }
-        }
-        v49 = v50++;
+        numVertices = rdClip_PolySide(pSrc, pDst, numVertices, 0, frustum->right, -1.0, RDCLIP_PLANE_RIGHT, flags);
+        if (numVertices < 3)
+            return numVertices;
+        RDCLIP_NEXT_POLY();
     }
-    if ( v5 < 3 )
-        return v5;
-
-    v70 = v5;
-    v71 = pSourceVert;
-    v5 = 0;
-    v72 = pDestVert;
-    pDestVert = v71;
-    pSourceVert = v72;
-    v73 = &v72[v70 - 1];
-    v74 = v72;
-
-    for (v119 = v70; v119 > 0; v119--)
+    if (planes & RDCLIP_PLANE_TOP)
     {
-        numVerticesf = frustum->bottom * v73->y;
-        v76 = v74->y * frustum->bottom;
-        if ( numVerticesf <= v73->z || v76 <= v74->z )
-        {
-            if ( v73->z != numVerticesf && v76 != v74->z && (v73->z < numVerticesf || v76 > v74->z) )
-            {
-                frustumd = v74->y - v73->y;
-                v115 = v74->z - v73->z;
-                v79 = v74->y * v73->z - v74->z * v73->y;
-                v80 = v79;
-                numVerticesl = frustum->bottom * frustumd - v115;
-                if ( numVerticesl != 0.0)
-                {
-                    v80 = v79 / numVerticesl;
-                }
-                v83 = frustum->bottom * v80;
-                v84 = frustumd;
-                if ( v84 < 0.0 )
-                    v84 = -v84;
-                v87 = v115;
-                if ( v87 < 0.0 )
-                    v87 = -v87;
-                if ( v84 <= v87 )
-                    v89 = (v83 - v73->z) / v115;
-                else
-                    v89 = (v80 - v73->y) / frustumd;
-                ++v5;
-                
-                v91 = (v74->x - v73->x) * v89 + v73->x;
-                rdClip_faceStatus |= 0x8;
-                v71->x = v91;
-                v71->y = v80;
-                v71->z = v83;
-                ++v71;
-            }
-            if ( v76 <= v74->z )
-            {
-                v92 = v71;
-                ++v5;
-                ++v71;
-                v92->x = v74->x;
-                v92->y = v74->y;
-                v92->z = v74->z;
-            }
-        }
-        v73 = v74++;
+        numVertices = rdClip_PolySide(pSrc, pDst, numVertices, 2, top, -1.0, RDCLIP_PLANE_TOP, flags);
+        if (numVertices < 3)
+            return numVertices;
+        RDCLIP_NEXT_POLY();
+    }
+    if (planes & RDCLIP_PLANE_BOTTOM)
+    {
+        numVertices = rdClip_PolySide(pSrc, pDst, numVertices, 2, frustum->bottom, 1.0, RDCLIP_PLANE_BOTTOM, flags);
+        if (numVertices < 3)
+            return numVertices;
+        RDCLIP_NEXT_POLY();
     }
-    if ( v5 < 3 )
-        return v5;
-
-    v93 = v5;
-    v94 = pSourceVert;
-    v5 = 0;
-    v95 = pDestVert;
-    pDestVert = v94;
-    pSourceVert = v95;
-    v96 = &v95[v93 - 1];
-    v97 = v95;
-    for (numVerticesg = v93; numVerticesg > 0; numVerticesg--)
+    if (planes & RDCLIP_PLANE_NEAR)
     {
-        if ( v96->y >= frustum->field_0.y || v97->y >= frustum->field_0.y )
+        numVertices = rdClip_PolyDepth(pSrc, pDst, numVertices, frustum->field_0.y, 1.0, RDCLIP_PLANE_NEAR, flags);
+        if (numVertices < 3)
         {
-            if ( v96->y != frustum->field_0.y && v97->y != frustum->field_0.y && (v96->y < frustum->field_0.y || v97->y < frustum->field_0.y) )
-            {
-                ++v5;
-                v98 = (frustum->field_0.y - v96->y) / (v97->y - v96->y);
-                v94->y = frustum->field_0.y;
-                rdClip_faceStatus |= 1;
-                v94->z = (v97->z - v96->z) * v98 + v96->z;
-                v94->x = (v97->x - v96->x) * v98 + v96->x;
-                ++v94;
-            }
-            if ( v97->y >= frustum->field_0.y )
-            {
-                v100 = v94;
-                ++v5;
-                ++v94;
-                v100->x = v97->x;
-                v100->y = v97->y;
-                v95 = pSourceVert;
-                v100->z = v97->z;
-            }
+            rdClip_faceStatus |= 0x40;
+            return numVertices;
         }
-        v96 = v97++;
+        RDCLIP_NEXT_POLY();
     }
-    v101 = pDestVert;
-    if ( v5 < 3 )
+    if (planes & RDCLIP_PLANE_FAR)
     {
-        rdClip_faceStatus |= 0x40;
-        return v5;
+        numVertices = rdClip_PolyDepth(pSrc, pDst, numVertices, frustum->field_0.z, -1.0, RDCLIP_PLANE_FAR, flags);
+        if (numVertices < 3)
+            return numVertices;
+        RDCLIP_NEXT_POLY();
     }
-    if (frustum->field_0.x != 0.0)
-    {
-        v104 = v5;
-        v105 = v95;
-        v5 = 0;
-        v106 = pDestVert;
-        pDestVert = v105;
-        pSourceVert = v106;
-        v107 = &v106[v104 - 1];
-        v108 = v106;
 
-        for (numVerticesh = v104; numVerticesh > 0; numVerticesh--)
+#undef RDCLIP_NEXT_POLY
+
+    for (int i = 0; i < numVertices; i++)
+    {
+        vertices[i].x = pSrc->pos[0][i];
+        vertices[i].y = pSrc->pos[1][i];
+        vertices[i].z = pSrc->pos[2][i];
+        if (uvs)
         {
-            if ( v107->y <= frustum->field_0.z || v108->y <= frustum->field_0.z )
-            {
-                if ( v107->y != frustum->field_0.z
-                  && v108->y != frustum->field_0.z
-                  && (v107->y > frustum->field_0.z || v108->y > frustum->field_0.z) )
-                {
-                    ++v5;
-                    v109 = (frustum->field_0.z - v107->y) / (v108->y - v107->y);
-                    v105->y = frustum->field_0.z;
-                    rdClip_faceStatus |= 0x2;
-                    v105->z = (v108->z - v107->z) * v109 + v107->z;
-                    v105->x = (v108->x - v107->x) * v109 + v107->x;
-                    ++v105;
-                }
-                if ( v108->y <= frustum->field_0.z )
-                {
-                    v111 = v105;
-                    ++v5;
-                    v111->x = v108->x;
-                    v111->y = v108->y;
-                    v111->z = v108->z;
-                    ++v105;
-                }
-            }
-            v107 = v108++;
+            uvs[i].x = pSrc->uv[0][i];
+            uvs[i].y = pSrc->uv[1][i];
         }
-        if ( v5 < 3 )
-            return v5;
-        v101 = pDestVert;
+        if (lights)
+            lights[i] = pSrc->light[i];
     }
 
-    if ( v101 != vertices ) {
-        _memcpy(vertices, pDestVert, sizeof(rdVector3) * v5);
-    }
-    return v5;
+    return numVertices;
+}
+
+// Added: guard band. The GPU clips against the viewport by itself, so when a
+// face is drawn through the camera's own frustum on the hardware path only
+// near/far need real clipping. Faces seen through an adjoin get a narrower
+// frustum and still go through the side planes.
+static int rdClip_UseGuardBand(const rdClipFrustum *frustum)
+{
+#ifdef SDL2_RENDER
+    const rdClipFrustum *pCamFrustum;
+
+    if (rdroid_curAcceleration <= 0 || !rdCamera_pCurCamera)
+        return 0;
+
+    pCamFrustum = rdCamera_pCurCamera->cameraClipFrustum;
+    if (!pCamFrustum)
+        return 0;
+    if (frustum == pCamFrustum)
+        return 1;
+
+    return frustum->nearLeft == pCamFrustum->nearLeft
+        && frustum->right == pCamFrustum->right
+        && frustum->nearTop == pCamFrustum->nearTop
+        && frustum->bottom == pCamFrustum->bottom;
+#else
+    return 0;
+#endif
+}
+
+int rdClip_Face3W(rdClipFrustum *frustum, rdVector3 *vertices, int numVertices)
+{
+    //return _rdClip_Face3W(frustum, vertices, numVertices);
+
+    // Used for adjoin visibility, so this always clips to the exact frustum
+    return rdClip_Poly(frustum, frustum->farLeft, frustum->farTop, 0, vertices, NULL, NULL, numVertices);
+}
+
+int rdClip_Face3GT(rdClipFrustum *frustum, rdVector3 *vertices, rdVector2 *uvs, float *a4, int numVertices)
+{
+    //return _rdClip_Face3GT(frustum, vertices, uvs, a4, numVertices);
+    return rdClip_Poly(frustum, frustum->nearLeft, frustum->nearTop, rdClip_UseGuardBand(frustum), vertices, uvs, a4, numVertices);
+}
+
+int rdClip_Face3S(rdClipFrustum *frustum, rdVector3 *vertices, int numVertices)
+{
+    //return _rdClip_Face3S(frustum, vertices, numVertices);
+    return rdClip_Poly(frustum, frustum->nearLeft, frustum->nearTop, rdClip_UseGuardBand(frustum), vertices, NULL, NULL, numVertices);
 }
 
 int rdClip_Face3GS(rdClipFrustum *frustum, rdVector3 *vertices, float *a3, int numVertices)
 {
     //return _rdClip_Face3GS(frustum, vertices, a3, numVertices);
-    rdVector3 *v4; // edx
-    float *v5; // edi
-    float *v6; // ebx
-    rdVector3 *v7; // ecx
-    float *v8; // ebp
-    rdVector3 *v9; // esi
-    double v11; // st7
-    double v14; // st6
-    double v17; // st5
-    double v18; // st4
-    double v21; // st3
-    double v23; // st4
-    double v24; // st3
-    double v25; // st5
-    double v26; // rtt
-    double v27; // st4
-    double v28; // st5
-    rdVector3 *v30; // eax
-    signed int result; // eax
-    float *copy_pDestIVert; // eax
-    rdVector3 *copy_pDestVert; // ebx
-    float *copy_pSourceIVert; // esi
-    rdVector3 *copy_pSourceVert; // edi
-    int v37; // ecx
-    float *v38; // ebp
-    rdVector3 *v39; // ecx
-    rdVector3 *v40; // edx
-    float *v41; // edi
-    double v43; // st7
-    double v47; // st6
-    double v50; // st5
-    double v51; // st4
-    double v54; // st3
-    double v56; // st4
-    double v57; // st3
-    double v58; // st5
-    double v59; // rt2
-    double v60; // st4
-    double v61; // st5
-    rdVector3 *v63; // eax
-    int v64; // ecx
-    int v65; // edi
-    int v66; // esi
-    rdVector3 *v67; // ebx
-    float *v68; // eax
-    rdVector3 *v69; // edi
-    float *v70; // esi
-    rdVector3 *v71; // edx
-    float *v72; // ebp
-    float *v73; // ecx
-    float *v74; // edi
-    double v76; // st7
-    double v80; // st5
-    double v81; // st6
-    double v84; // st5
-    double v85; // st4
-    double v88; // st3
-    double v90; // st4
-    double v91; // st3
-    rdVector3 *v93; // eax
-    rdVector3 *v94; // ebx
-    float *v95; // esi
-    rdVector3 *v96; // edx
-    float *v97; // edi
-    rdVector3 *v98; // ecx
-    float *v99; // ebp
-    float *v100; // edx
-    double v102; // st7
-    double v105; // st5
-    double v106; // st6
-    double v109; // st5
-    double v110; // st4
-    double v113; // st3
-    double v115; // st4
-    double v116; // st3
-    rdVector3 *v118; // eax
-    float *v119; // esi
-    float *v120; // edi
-    rdVector3 *v121; // ebx
-    rdVector3 *v122; // edx
-    int v123; // eax
-    int v124; // ebp
-    rdVector3 *v125; // ecx
-    float *v126; // edx
-    double v127; // st7
-    double v128; // st6
-    double v129; // st5
-    double v130; // st6
-    rdVector3 *v132; // ecx
-    int v135; // edi
-    float* v136; // esi
-    int v137; // edx
-    float *v138; // edi
-    int v139; // ecx
-    rdVector3 *v140; // ebx
-    rdVector3 *v141; // edx
-    int v142; // eax
-    rdVector3 *v143; // ecx
-    float *v144; // edx
-    double v145; // st7
-    double v146; // st6
-    double v147; // st5
-    double v148; // st6
-    rdVector3 *v150; // eax
-    int v151; // [esp+10h] [ebp-10h]
-    int v152; // [esp+10h] [ebp-10h]
-    int v153; // [esp+10h] [ebp-10h]
-    int v154; // [esp+10h] [ebp-10h]
-    float *v155; // [esp+10h] [ebp-10h]
-    float *v156; // [esp+10h] [ebp-10h]
-    double v157; // [esp+14h] [ebp-Ch]
-    double v158; // [esp+14h] [ebp-Ch]
-    double v159; // [esp+14h] [ebp-Ch]
-    double v160; // [esp+14h] [ebp-Ch]
-    double v161; // [esp+18h] [ebp-8h]
-    double v162; // [esp+18h] [ebp-8h]
-    double v163; // [esp+18h] [ebp-8h]
-    double v164; // [esp+18h] [ebp-8h]
-    float *v165; // [esp+18h] [ebp-8h]
-    float *v166; // [esp+18h] [ebp-8h]
-    int v167; // [esp+1Ch] [ebp-4h]
-    int v168; // [esp+1Ch] [ebp-4h]
-    int v169; // [esp+1Ch] [ebp-4h]
-    signed int v170; // [esp+1Ch] [ebp-4h]
-    double numVerticesa; // [esp+30h] [ebp+10h]
-    double numVerticesi; // [esp+30h] [ebp+10h]
-    int numVerticesb; // [esp+30h] [ebp+10h]
-    double numVerticesc; // [esp+30h] [ebp+10h]
-    double numVerticesj; // [esp+30h] [ebp+10h]
-    int numVerticesd; // [esp+30h] [ebp+10h]
-    double numVerticese; // [esp+30h] [ebp+10h]
-    double numVerticesk; // [esp+30h] [ebp+10h]
-    double numVerticesf; // [esp+30h] [ebp+10h]
-    double numVerticesl; // [esp+30h] [ebp+10h]
-    int numVerticesg; // [esp+30h] [ebp+10h]
-    int numVerticesh; // [esp+30h] [ebp+10h]
-
-    v4 = vertices;
-    v5 = a3;
-    v6 = workIVerts;
-    rdClip_faceStatus = 0;
-    pSourceVert = vertices;
-    pSourceIVert = a3;
-    pDestVert = workVerts;
-    pDestIVert = workIVerts;
-    v151 = 0;
-    v7 = &vertices[numVertices - 1];
-    v8 = &a3[numVertices - 1];
-    if ( numVertices > 0 )
-    {
-        v9 = workVerts;
-        v167 = numVertices;
-        do
-        {
-            numVerticesa = v7->y * frustum->nearLeft;
-            v11 = frustum->nearLeft * v4->y;
-            if ( numVerticesa <= v7->x || v11 <= v4->x )
-            {
-                if ( v7->x != numVerticesa && v11 != v4->x && (v7->x < (double)numVerticesa || v11 > v4->x) )
-                {
-                    v157 = v4->y - v7->y;
-                    v161 = v4->x - v7->x;
-                    v14 = v4->y * v7->x - v7->y * v4->x;
-                    numVerticesi = frustum->nearLeft * v157 - v161;
-                    if ( numVerticesi != 0.0 )
-                    {
-                        v14 = v14 / numVerticesi;
-                    }
-                    v17 = frustum->nearLeft * v14;
-                    v18 = v157;
-                    if ( v18 < 0.0 )
-                        v18 = -v18;
-                    v21 = v161;
-                    if ( v21 < 0.0 )
-                        v21 = -v21;
-                    if ( v18 <= v21 )
-                        v23 = (v17 - v7->x) / v161;
-                    else
-                        v23 = (v14 - v7->y) / v157;
-                    v24 = v17;
-                    v25 = *v5;
-                    v9->x = v24;
-                    v26 = v23;
-                    v9->y = v14;
-                    v27 = (v25 - *v8) * v23 + *v8;
-                    v28 = (v4->z - v7->z) * v26 + v7->z;
-                    ++v9;
-                    *v6++ = v27;
-                    v9[-1].z = v28;
-                    ++v151;
-                    rdClip_faceStatus |= 0x10;
-                }
-                if ( v11 <= v4->x )
-                {
-                    v30 = v9++;
-                    v30->x = v4->x;
-                    v30->y = v4->y;
-                    v30->z = v4->z;
-                    *v6 = *v5;
-                    ++v151;
-                    ++v6;
-                }
-            }
-            v7 = v4;
-            v8 = v5;
-            ++v4;
-            ++v5;
-            --v167;
-        }
-        while ( v167 );
-    }
-    result = v151;
-    if ( v151 >= 3 )
-    {
-        copy_pDestIVert = a3;
-        copy_pDestVert = vertices;
-        copy_pSourceIVert = workIVerts;
-        copy_pSourceVert = workVerts;
-        numVerticesb = v151;
-        v37 = v151;
-        v38 = &workIVerts[v151 - 1];
-        pDestVert = vertices;
-        pSourceVert = workVerts;
-        pDestIVert = a3;
-        pSourceIVert = workIVerts;
-        v152 = 0;
-        v39 = &workVerts[v37 - 1];
-        v40 = workVerts;
-        if ( v151 > 0 )
-        {
-            v41 = a3;
-            v168 = numVerticesb;
-            do
-            {
-                numVerticesc = frustum->right * v39->y;
-                v43 = frustum->right * v40->y;
-                if ( numVerticesc >= v39->x || v43 >= v40->x )
-                {
-                    if ( v39->x != numVerticesc && v43 != v40->x && (v39->x > (double)numVerticesc || v43 < v40->x) )
-                    {
-                        v162 = v40->y - v39->y;
-                        v158 = v40->x - v39->x;
-                        v47 = v40->y * v39->x - v39->y * v40->x;
-                        numVerticesj = frustum->right * v162 - v158;
-                        if ( numVerticesj != 0.0 )
-                        {
-                            v47 = v47 / numVerticesj;
-                        }
-                        v50 = frustum->right * v47;
-                        v51 = v162;
-                        if ( v51 < 0.0 )
-                            v51 = -v51;
-                        v54 = v158;
-                        if ( v54 < 0.0 )
-                            v54 = -v54;
-                        if ( v51 <= v54 )
-                            v56 = (v50 - v39->x) / v158;
-                        else
-                            v56 = (v47 - v39->y) / v162;
-                        v57 = v50;
-                        v58 = *copy_pSourceIVert;
-                        copy_pDestVert->x = v57;
-                        v59 = v56;
-                        copy_pDestVert->y = v47;
-                        v60 = (v58 - *v38) * v56 + *v38;
-                        v61 = (v40->z - v39->z) * v59 + v39->z;
-                        ++copy_pDestVert;
-                        *v41++ = v60;
-                        copy_pDestVert[-1].z = v61;
-                        ++v152;
-                        rdClip_faceStatus |= 0x20;
-                    }
-                    if ( v43 >= v40->x )
-                    {
-                        v63 = copy_pDestVert++;
-                        v63->x = v40->x;
-                        v63->y = v40->y;
-                        v63->z = v40->z;
-                        *v41 = *copy_pSourceIVert;
-                        ++v152;
-                        ++v41;
-                    }
-                }
-                v39 = v40;
-                v38 = copy_pSourceIVert;
-                ++v40;
-                ++copy_pSourceIVert;
-                --v168;
-            }
-            while ( v168 );
-            copy_pSourceIVert = pSourceIVert;
-            copy_pDestVert = pDestVert;
-            copy_pSourceVert = pSourceVert;
-            copy_pDestIVert = pDestIVert;
-        }
-        v64 = v152;
-        if ( v152 < 3 )
-            return v152;
-        v65 = (intptr_t)copy_pDestVert ^ (intptr_t)copy_pSourceVert;
-        v66 = (intptr_t)copy_pDestIVert ^ (intptr_t)copy_pSourceIVert;
-        v67 = (rdVector3 *)(v65 ^ (intptr_t)copy_pDestVert);
-        v68 = (float *)(v66 ^ (intptr_t)copy_pDestIVert);
-        v69 = (rdVector3 *)((intptr_t)v67 ^ v65);
-        v70 = (float *)((intptr_t)v68 ^ v66);
-        pDestVert = v67;
-        pSourceVert = v69;
-        pDestIVert = v68;
-        pSourceIVert = v70;
-        numVerticesd = v152;
-        v153 = 0;
-        v71 = &v69[v64 - 1];
-        v72 = &v70[v64 - 1];
-        if ( v64 > 0 )
-        {
-            v73 = &v69->z;
-            v74 = v68;
-            v169 = numVerticesd;
-            do
-            {
-                numVerticese = frustum->nearTop * v71->y;
-                v76 = *(v73 - 1) * frustum->nearTop;
-                if ( numVerticese >= v71->z || v76 >= *v73 )
-                {
-                    if ( v71->z != numVerticese && v76 != *v73 && (v71->z > (double)numVerticese || v76 < *v73) )
-                    {
-                        v163 = *(v73 - 1) - v71->y;
-                        v159 = *v73 - v71->z;
-                        v80 = *(v73 - 1) * v71->z - *v73 * v71->y;
-                        v81 = v80;
-                        numVerticesk = frustum->nearTop * v163 - v159;
-                        if ( numVerticesk != 0.0 )
-                        {
-                            v81 = v80 / numVerticesk;
-                        }
-                        v84 = frustum->nearTop * v81;
-                        v85 = v163;
-                        if ( v85 < 0.0 )
-                            v85 = -v85;
-                        v88 = v159;
-                        if ( v88 < 0.0 )
-                            v88 = -v88;
-                        if ( v85 <= v88 )
-                            v90 = (v84 - v71->z) / v159;
-                        else
-                            v90 = (v81 - v71->y) / v163;
-                        v91 = (*v70 - *v72) * v90 + *v72;
-                        v67->x = (*(v73 - 2) - v71->x) * v90 + v71->x;
-                        ++v67;
-                        v67[-1].y = v81;
-                        v67[-1].z = v84;
-                        *v74++ = v91;
-                        ++v153;
-                        rdClip_faceStatus |= 0x4;
-                    }
-                    if ( v76 >= *v73 )
-                    {
-                        v93 = v67++;
-                        v93->x = *(v73 - 2);
-                        v93->y = *(v73 - 1);
-                        v93->z = *v73;
-                        *v74 = *v70;
-                        ++v153;
-                        ++v74;
-                    }
-                }
-                v71 = (rdVector3 *)(v73 - 2);
-                v72 = v70;
-                v73 += 3;
-                ++v70;
-                --v169;
-            }
-            while ( v169 );
-        }
-        result = v153;
-        if ( v153 >= 3 )
-        {
-            v94 = pSourceVert;
-            v95 = pSourceIVert;
-            v96 = pDestVert;
-            v97 = pDestIVert;
-            pDestVert = pSourceVert;
-            pSourceVert = v96;
-            pDestIVert = pSourceIVert;
-            pSourceIVert = v97;
-            v154 = 0;
-            v98 = &v96[result - 1];
-            v99 = &v97[result - 1];
-            if ( result > 0 )
-            {
-                v100 = &v96->z;
-                v170 = result;
-                do
-                {
-                    numVerticesf = frustum->bottom * v98->y;
-                    v102 = *(v100 - 1) * frustum->bottom;
-                    if ( numVerticesf <= v98->z || v102 <= *v100 )
-                    {
-                        if ( v98->z != numVerticesf && v102 != *v100 && (v98->z < (double)numVerticesf || v102 > *v100) )
-                        {
-                            v164 = *(v100 - 1) - v98->y;
-                            v160 = *v100 - v98->z;
-                            v105 = *(v100 - 1) * v98->z - *v100 * v98->y;
-                            v106 = v105;
-                            numVerticesl = frustum->bottom * v164 - v160;
-                            if ( numVerticesl != 0.0 )
-                            {
-                                v106 = v105 / numVerticesl;
-                            }
-                            v109 = frustum->bottom * v106;
-                            v110 = v164;
-                            if ( v110 < 0.0 )
-                                v110 = -v110;
-                            v113 = v160;
-                            if ( v113 < 0.0 )
-                                v113 = -v113;
-                            if ( v110 <= v113 )
-                                v115 = (v109 - v98->z) / v160;
-                            else
-                                v115 = (v106 - v98->y) / v164;
-                            v116 = (*v97 - *v99) * v115 + *v99;
-                            v94->x = (*(v100 - 2) - v98->x) * v115 + v98->x;
-                            ++v94;
-                            v94[-1].y = v106;
-                            v94[-1].z = v109;
-                            *v95++ = v116;
-                            ++v154;
-                            rdClip_faceStatus |= 0x8;
-                        }
-                        if ( v102 <= *v100 )
-                        {
-                            v118 = v94++;
-                            v118->x = *(v100 - 2);
-                            v118->y = *(v100 - 1);
-                            v118->z = *v100;
-                            *v95 = *v97;
-                            ++v154;
-                            ++v95;
-                        }
-                    }
-                    v98 = (rdVector3 *)(v100 - 2);
-                    v99 = v97;
-                    v100 += 3;
-                    ++v97;
-                    --v170;
-                }
-                while ( v170 );
-            }
-            result = v154;
-            if ( v154 >= 3 )
-            {
-                v119 = pSourceIVert;
-                v120 = pDestIVert;
-                v121 = pSourceVert;
-                v122 = pDestVert;
-                v165 = &pDestIVert[v154 - 1];
-                v123 = v154;
-                v124 = 0;
-                pDestVert = pSourceVert;
-                pSourceVert = v122;
-                pDestIVert = pSourceIVert;
-                pSourceIVert = v120;
-                v125 = &v122[v154 - 1];
-                v155 = v120;
-                if ( v154 > 0 )
-                {
-                    v126 = &v122->y;
-                    numVerticesg = v123;
-                    do
-                    {
-                        if ( v125->y >= (double)frustum->field_0.y || *v126 >= (double)frustum->field_0.y )
-                        {
-                            if ( v125->y != frustum->field_0.y
-                              && *v126 != frustum->field_0.y
-                              && (v125->y < (double)frustum->field_0.y || *v126 < (double)frustum->field_0.y) )
-                            {
-                                ++v124;
-                                ++v119;
-                                v127 = (frustum->field_0.y - v125->y) / (*v126 - v125->y);
-                                v121->y = frustum->field_0.y;
-                                ++v121;
-                                v128 = (*v120 - *v165) * v127;
-                                v121[-1].z = (v126[1] - v125->z) * v127 + v125->z;
-                                v129 = v128 + *v165;
-                                v130 = (*(v126 - 1) - v125->x) * v127 + v125->x;
-                                *(v119 - 1) = v129;
-                                v121[-1].x = v130;
-                                rdClip_faceStatus |= 1;
-                            }
-                            if ( *v126 >= (double)frustum->field_0.y )
-                            {
-                                v132 = v121;
-                                ++v124;
-                                ++v121;
-                                ++v119;
-                                v132->x = *(v126 - 1);
-                                v132->y = *v126;
-                                v120 = v155;
-                                v132->z = v126[1];
-                                *(v119 - 1) = *v155;
-                            }
-                        }
-                        v125 = (rdVector3 *)(v126 - 1);
-                        v165 = v120;
-                        v126 += 3;
-                        ++v120;
-                        v155 = v120;
-                        --numVerticesg;
-                    }
-                    while (numVerticesg != 0);
-                    v122 = pSourceVert;
-                    v120 = pSourceIVert;
-                    v121 = pDestVert;
-                    v119 = pDestIVert;
-                }
-                if ( v124 < 3 )
-                {
-                    rdClip_faceStatus |= 0x40;
-                    return v124;
-                }
-                if (frustum->field_0.x)
-                {
-                    v135 = (intptr_t)v119 ^ (intptr_t)v120;
-                    v136 = (float*)(v135 ^ (intptr_t)v119);
-                    v137 = (intptr_t)v121 ^ (intptr_t)v122;
-                    v138 = (float *)((intptr_t)v136 ^ v135);
-                    v139 = v124;
-                    v140 = (rdVector3 *)(v137 ^ (intptr_t)v121);
-                    v141 = (rdVector3 *)((intptr_t)v140 ^ v137);
-                    v166 = &v138[v124 - 1];
-                    v142 = v124;
-                    v124 = 0;
-                    pDestVert = v140;
-                    pSourceVert = v141;
-                    pDestIVert = v136;
-                    pSourceIVert = v138;
-                    v143 = &v141[v139 - 1];
-                    v156 = v138;
-                    v144 = &v141->y;
-                    numVerticesh = v142;
-                    do
-                    {
-                        if ( v143->y <= (double)frustum->field_0.z || *v144 <= (double)frustum->field_0.z )
-                        {
-                            if ( v143->y != frustum->field_0.z
-                              && *v144 != frustum->field_0.z
-                              && (v143->y > (double)frustum->field_0.z || *v144 > (double)frustum->field_0.z) )
-                            {
-                                ++v124;
-                                v145 = (frustum->field_0.z - v143->y) / (*v144 - v143->y);
-                                v140->y = frustum->field_0.z;
-                                ++v140;
-                                v146 = (*v156 - *v166) * v145;
-                                v140[-1].z = (v144[1] - v143->z) * v145 + v143->z;
-                                v147 = v146 + *v166;
-                                v148 = (*(v144 - 1) - v143->x) * v145 + v143->x;
-                                *v136 = v147;
-                                v136++;
-                                v140[-1].x = v148;
-                                rdClip_faceStatus |= 2;
-                            }
-                            if ( *v144 <= (double)frustum->field_0.z )
-                            {
-                                v150 = v140;
-                                ++v124;
-                                ++v140;
-                                v150->x = *(v144 - 1);
-                                v150->y = *v144;
-                                v150->z = v144[1];
-                                *v136 = *v156;
-                                v136++;
-                            }
-                        }
-                        v143 = (rdVector3 *)(v144 - 1);
-                        v166 = v156++;
-                        v144 += 3;
-                        --numVerticesh;
-                    }
-                    while ( numVerticesh );
-                    if ( v124 < 3 )
-                        return v124;
-                    v121 = pDestVert;
-                }
-                if ( v121 != vertices )
-                {
-                    _memcpy(vertices, v121, v124 * sizeof(rdVector3));
-                    _memcpy(a3, pDestIVert, sizeof(float) * v124);
-                }
-                return v124;
-            }
-        }
-    }
-    return result;
+    return rdClip_Poly(frustum, frustum->nearLeft, frustum->nearTop, rdClip_UseGuardBand(frustum), vertices, NULL, a3, numVertices);
 }
 
 int rdClip_Face3T(rdClipFrustum *frustum, rdVector3 *vertices, rdVector2 *uvs, int numVertices)
 {
     //return _rdClip_Face3T(frustum, vertices, uvs, numVertices);
-
-    rdVector3 *v4; // edx
-    rdVector2 *v5; // ebx
-    rdVector3 *v6; // ecx
-    rdVector2 *v7; // edi
-    rdVector2 *v8; // ebp
-    rdVector2 *v9; // ebx
-    rdVector3 *v10; // esi
-    double v12; // st7
-//    char missing_18; // c0
-    double v15; // st6
-//    char missing_17; // c3
-    double v18; // st5
-    double v19; // st4
-//    char missing_16; // c0
-    double v22; // st3
-//    char missing_15; // c0
-    double v24; // st4
-    double v25; // st3
-    double v26; // st5
-    double v27; // rtt
-    double v28; // st4
-    double v29; // st5
-    double v30; // st4
-    double v31; // st5
-    int v32; // eax
-    rdVector3 *v33; // eax
-    signed int result; // eax
-    rdVector3 *v35; // eax
-    rdVector2 *v36; // ebx
-    rdVector3 *v37; // esi
-    int v39; // ecx
-    rdVector2 *v40; // edi
-    rdVector3 *v41; // ecx
-    rdVector3 *v42; // edx
-    rdVector2 *v43; // ebp
-    rdVector2 *v44; // ebx
-    rdVector3 *v45; // esi
-    double v47; // st7
-//    unsigned __int8 missing_13; // c0
-//    unsigned __int8 missing_14; // c3
-    double v51; // st6
-//    char missing_12; // c3
-    double v54; // st5
-    double v55; // st4
-//    char missing_11; // c0
-    double v58; // st3
-//    char missing_10; // c0
-    double v60; // st4
-    double v61; // st3
-    double v62; // st5
-    double v63; // rt1
-    double v64; // st4
-    double v65; // st5
-    double v66; // st4
-    double v67; // st5
-    int v68; // eax
-    rdVector3 *v69; // eax
-    int v70; // edx
-    int v71; // esi
-    intptr_t v72; // ebx
-    rdVector3 *v73; // eax
-    rdVector3 *v74; // esi
-    rdVector2 *v75; // ebx
-    int v76; // ebp
-    rdVector3 *v77; // ecx
-    rdVector2 *v78; // edi
-    rdVector2 *v79; // ebp
-    float *v80; // edx
-    rdVector3 *v81; // esi
-    double v83; // st7
-//    unsigned __int8 missing_8; // c0
-//    unsigned __int8 missing_9; // c3
-    double v87; // st5
-    double v88; // st6
-//    char missing_7; // c3
-    double v91; // st5
-    double v92; // st4
-//    char missing_6; // c0
-    double v95; // st3
-//    char missing_5; // c0
-    double v97; // st4
-    double v98; // st3
-    int v99; // eax
-    double v100; // st2
-    double v101; // st3
-    rdVector3 *v102; // eax
-    int v103; // esi
-    intptr_t v104; // ebx
-    rdVector3 *v105; // eax
-    rdVector3 *v106; // esi
-    rdVector2 *v107; // ebx
-    int v108; // edi
-    rdVector3 *v109; // edx
-    rdVector2 *v110; // ebp
-    rdVector2 *v111; // edi
-    float *v112; // ecx
-    rdVector3 *v113; // esi
-    double v115; // st7
-//    char missing_4; // c0
-    double v118; // st5
-    double v119; // st6
-//    char missing_3; // c3
-    double v122; // st5
-    double v123; // st4
-//    char missing_2; // c0
-    double v126; // st3
-//    char missing_1; // c0
-    double v128; // st4
-    double v129; // st3
-    int v130; // eax
-    double v131; // st2
-    double v132; // st3
-    rdVector3 *v133; // eax
-    intptr_t v134; // ecx
-    intptr_t v135; // ebp
-    rdVector2 *v136; // ebp
-    int v137; // eax
-    rdVector3 *v138; // ecx
-    rdVector2 *v139; // esi
-    rdVector2 *v140; // edi
-    rdVector3 *v141; // ebx
-    float *v142; // edx
-    double v143; // st7
-    int v144; // eax
-    double v145; // st6
-    double v146; // st5
-    double v147; // st6
-    double v148; // st5
-    double v149; // st6
-    rdVector3 *v150; // ecx
-    rdVector3 *v151; // esi
-    int v152; // eax
-    intptr_t v153; // ebp
-    rdVector2 *v154; // ebp
-    int v155; // eax
-    rdVector3 *v156; // ecx
-    rdVector2 *v157; // esi
-    rdVector2 *v158; // edi
-    rdVector3 *v159; // ebx
-    float *v160; // edx
-    double v161; // st7
-    int v162; // eax
-    double v163; // st6
-    double v164; // st5
-    double v165; // st6
-    double v166; // st5
-    double v167; // st6
-    rdVector3 *v168; // ecx
-    int v169; // [esp+10h] [ebp-10h]
-    int v170; // [esp+10h] [ebp-10h]
-    int v171; // [esp+10h] [ebp-10h]
-    int v172; // [esp+10h] [ebp-10h]
-    int v173; // [esp+10h] [ebp-10h]
-    int v174; // [esp+10h] [ebp-10h]
-    double v175; // [esp+14h] [ebp-Ch]
-    double v176; // [esp+14h] [ebp-Ch]
-    double v177; // [esp+14h] [ebp-Ch]
-    double v178; // [esp+14h] [ebp-Ch]
-    double v179; // [esp+18h] [ebp-8h]
-    double v180; // [esp+18h] [ebp-8h]
-    double v181; // [esp+18h] [ebp-8h]
-    double v182; // [esp+18h] [ebp-8h]
-    int v183; // [esp+1Ch] [ebp-4h]
-    int v184; // [esp+1Ch] [ebp-4h]
-    int v185; // [esp+1Ch] [ebp-4h]
-    int v186; // [esp+1Ch] [ebp-4h]
-    double numVerticesa; // [esp+30h] [ebp+10h]
-    double numVerticesj; // [esp+30h] [ebp+10h]
-    int numVerticesb; // [esp+30h] [ebp+10h]
-    double numVerticesc; // [esp+30h] [ebp+10h]
-    double numVerticesk; // [esp+30h] [ebp+10h]
-    int numVerticesd; // [esp+30h] [ebp+10h]
-    double numVerticese; // [esp+30h] [ebp+10h]
-    double numVerticesl; // [esp+30h] [ebp+10h]
-    int numVerticesf; // [esp+30h] [ebp+10h]
-    double numVerticesg; // [esp+30h] [ebp+10h]
-    double numVerticesm; // [esp+30h] [ebp+10h]
-    int numVerticesh; // [esp+30h] [ebp+10h]
-    int numVerticesi; // [esp+30h] [ebp+10h]
-
-    v4 = vertices;
-    v5 = uvs;
-    rdClip_faceStatus = 0;
-    pSourceVert = vertices;
-    pDestVert = workVerts;
-    pSourceTVert = uvs;
-    pDestTVert = workTVerts;
-    v169 = 0;
-    v6 = &vertices[numVertices - 1];
-    v7 = &uvs[numVertices - 1];
-    v8 = uvs;
-    if ( numVertices > 0 )
-    {
-        v9 = workTVerts;
-        v10 = workVerts;
-        v183 = numVertices;
-        do
-        {
-            numVerticesa = v6->y * frustum->nearLeft;
-            v12 = frustum->nearLeft * v4->y;
-            if ( numVerticesa <= v6->x|| v12 <= v4->x )
-            {
-                if ( v6->x != numVerticesa && v12 != v4->x && (v6->x < (double)numVerticesa || v12 > v4->x) )
-                {
-                    v175 = v4->y - v6->y;
-                    v179 = v4->x - v6->x;
-                    v15 = v4->y * v6->x - v6->y * v4->x;
-                    numVerticesj = frustum->nearLeft * v175 - v179;
-                    if ( numVerticesj != 0 )
-                    {
-                        v15 = v15 / numVerticesj;
-                    }
-                    v18 = frustum->nearLeft * v15;
-                    v19 = v175;
-                    if ( v19 < 0.0 )
-                        v19 = -v19;
-                    v22 = v179;
-                    if ( v22 < 0.0 )
-                        v22 = -v22;
-                    if ( v19 <= v22 )
-                        v24 = (v18 - v6->x) / v179;
-                    else
-                        v24 = (v15 - v6->y) / v175;
-                    ++v10;
-                    v25 = v18;
-                    v26 = (v8->x - v7->x) * v24;
-                    v10[-1].x = v25;
-                    v27 = v24;
-                    v10[-1].y = v15;
-                    v28 = v26 + v7->x;
-                    v29 = v4->z - v6->z;
-                    v9->x = v28;
-                    v30 = v29 * v27 + v6->z;
-                    v31 = (v8->y - v7->y) * v27 + v7->y;
-                    v10[-1].z = v30;
-                    v9->y = v31;
-                    ++v169;
-                    ++v9;
-                    rdClip_faceStatus |= 0x10;
-                }
-                if ( v12 <= v4->x )
-                {
-                    v33 = v10++;
-                    v33->x = v4->x;
-                    v33->y = v4->y;
-                    v33->z = v4->z;
-                    v9->x = v8->x;
-                    v9->y = v8->y;
-                    ++v169;
-                    ++v9;
-                }
-            }
-            v6 = v4;
-            v7 = v8;
-            ++v4;
-            ++v8;
-            --v183;
-        }
-        while ( v183 );
-        v4 = vertices;
-        v5 = uvs;
-    }
-    result = v169;
-    if ( v169 >= 3 )
-    {
-        v35 = v4;
-        pDestTVert = v5;
-        v36 = workTVerts;
-        v37 = workVerts;
-        numVerticesb = v169;
-        v39 = v169;
-        v40 = &workTVerts[v169 - 1];
-        pDestVert = v4;
-        pSourceVert = workVerts;
-        pSourceTVert = workTVerts;
-        v170 = 0;
-        v41 = &workVerts[v39 - 1];
-        v42 = workVerts;
-        v43 = workTVerts;
-        if ( v169 > 0 )
-        {
-            v44 = pDestTVert;
-            v45 = v35;
-            v184 = numVerticesb;
-            do
-            {
-                numVerticesc = frustum->right * v41->y;
-                v47 = frustum->right * v42->y;
-                if ( numVerticesc >= v41->x|| v47 >= v42->x )
-                {
-                    if ( v41->x != numVerticesc && v47 != v42->x && (v41->x > (double)numVerticesc || v47 < v42->x) )
-                    {
-                        v180 = v42->y - v41->y;
-                        v176 = v42->x - v41->x;
-                        v51 = v42->y * v41->x - v41->y * v42->x;
-                        numVerticesk = frustum->right * v180 - v176;
-                        if ( numVerticesk != 0.0 )
-                        {
-                            v51 = v51 / numVerticesk;
-                        }
-                        v54 = frustum->right * v51;
-                        v55 = v180;
-                        if ( v55 < 0.0 )
-                            v55 = -v55;
-                        v58 = v176;
-                        if ( v58 < 0.0 )
-                            v58 = -v58;
-                        if ( v55 <= v58 )
-                            v60 = (v54 - v41->x) / v176;
-                        else
-                            v60 = (v51 - v41->y) / v180;
-                        ++v45;
-                        v61 = v54;
-                        v62 = (v43->x - v40->x) * v60;
-                        v45[-1].x = v61;
-                        v63 = v60;
-                        v45[-1].y = v51;
-                        v64 = v62 + v40->x;
-                        v65 = v42->z - v41->z;
-                        v44->x = v64;
-                        v66 = v65 * v63 + v41->z;
-                        v67 = (v43->y - v40->y) * v63 + v40->y;
-                        v45[-1].z = v66;
-                        v44->y = v67;
-                        ++v170;
-                        ++v44;
-                        rdClip_faceStatus |= 0x20;
-                    }
-                    if ( v47 >= v42->x )
-                    {
-                        v69 = v45++;
-                        v69->x = v42->x;
-                        v69->y = v42->y;
-                        v69->z = v42->z;
-                        v44->x = v43->x;
-                        v44->y = v43->y;
-                        ++v170;
-                        ++v44;
-                    }
-                }
-                v41 = v42;
-                v40 = v43;
-                ++v42;
-                ++v43;
-                --v184;
-            }
-            while ( v184 );
-            v37 = pSourceVert;
-            v36 = pSourceTVert;
-            v35 = pDestVert;
-        }
-        v70 = v170;
-        if ( v170 < 3 )
-            goto LABEL_124;
-        v71 = (intptr_t)v35 ^ (intptr_t)v37;
-        v72 = (intptr_t)pDestTVert ^ (intptr_t)v36;
-        v73 = (rdVector3 *)(v71 ^ (intptr_t)v35);
-        v74 = (rdVector3 *)((intptr_t)v73 ^ v71);
-        pDestTVert = (rdVector2 *)(v72 ^ (intptr_t)pDestTVert);
-        v75 = (rdVector2 *)((intptr_t)pDestTVert ^ v72);
-        v76 = 0;
-        pDestVert = v73;
-        pSourceVert = v74;
-        pSourceTVert = v75;
-        numVerticesd = v170;
-        v171 = 0;
-        v77 = &v74[v70 - 1];
-        v78 = &v75[v70 - 1];
-        if ( v70 > 0 )
-        {
-            v79 = pDestTVert;
-            v80 = &v74->z;
-            v81 = v73;
-            v185 = numVerticesd;
-            do
-            {
-                numVerticese = frustum->nearTop * v77->y;
-                v83 = *(v80 - 1) * frustum->nearTop;
-                if ( numVerticese >= v77->z || v83 >= *v80 )
-                {
-                    if ( v77->z != numVerticese && v83 != *v80 && (v77->z > (double)numVerticese || v83 < *v80) )
-                    {
-                        v181 = *(v80 - 1) - v77->y;
-                        v177 = *v80 - v77->z;
-                        v87 = *(v80 - 1) * v77->z - *v80 * v77->y;
-                        v88 = v87;
-                        numVerticesl = frustum->nearTop * v181 - v177;
-                        if ( numVerticesl != 0.0 )
-                        {
-                            v88 = v87 / numVerticesl;
-                        }
-                        v91 = frustum->nearTop * v88;
-                        v92 = v181;
-                        if ( v92 < 0.0 )
-                            v92 = -v92;
-                        v95 = v177;
-                        if ( v95 < 0.0 )
-                            v95 = -v95;
-                        if ( v92 <= v95 )
-                            v97 = (v91 - v77->z) / v177;
-                        else
-                            v97 = (v88 - v77->y) / v181;
-                        ++v81;
-                        ++v79;
-                        v98 = (*(v80 - 2) - v77->x) * v97;
-                        v79[-1].x = (v75->x - v78->x) * v97 + v78->x;
-                        ++v171;
-                        v100 = v98 + v77->x;
-                        v101 = (v75->y - v78->y) * v97 + v78->y;
-                        v81[-1].x = v100;
-                        v81[-1].y = v88;
-                        v81[-1].z = v91;
-                        v79[-1].y = v101;
-                        rdClip_faceStatus |= 0x4;
-                    }
-                    if ( v83 >= *v80 )
-                    {
-                        v102 = v81++;
-                        v102->x = *(v80 - 2);
-                        v102->y = *(v80 - 1);
-                        v102->z = *v80;
-                        v79->x = v75->x;
-                        v79->y = v75->y;
-                        ++v171;
-                        ++v79;
-                    }
-                }
-                v77 = (rdVector3 *)(v80 - 2);
-                v78 = v75;
-                v80 += 3;
-                ++v75;
-                --v185;
-            }
-            while ( v185 );
-            v74 = pSourceVert;
-            v76 = v171;
-            v75 = pSourceTVert;
-            v73 = pDestVert;
-        }
-        if ( v76 < 3 )
-            return v171;
-        v103 = (intptr_t)v73 ^ (intptr_t)v74;
-        v104 = (intptr_t)pDestTVert ^ (intptr_t)v75;
-        v105 = (rdVector3 *)(v103 ^ (intptr_t)v73);
-        v106 = (rdVector3 *)((intptr_t)v105 ^ v103);
-        pDestTVert = (rdVector2 *)(v104 ^ (intptr_t)pDestTVert);
-        v107 = (rdVector2 *)((intptr_t)pDestTVert ^ v104);
-        v108 = 0;
-        pDestVert = v105;
-        pSourceVert = v106;
-        pSourceTVert = v107;
-        numVerticesf = v76;
-        v172 = 0;
-        v109 = &v106[v76 - 1];
-        v110 = &v107[v76 - 1];
-        if ( v76 > 0 )
-        {
-            v111 = pDestTVert;
-            v112 = &v106->z;
-            v113 = v105;
-            v186 = numVerticesf;
-            do
-            {
-                numVerticesg = frustum->bottom * v109->y;
-                v115 = *(v112 - 1) * frustum->bottom;
-                if ( numVerticesg <= v109->z || v115 <= *v112 )
-                {
-                    if ( v109->z != numVerticesg && v115 != *v112 && (v109->z < (double)numVerticesg || v115 > *v112) )
-                    {
-                        v182 = *(v112 - 1) - v109->y;
-                        v178 = *v112 - v109->z;
-                        v118 = *(v112 - 1) * v109->z - *v112 * v109->y;
-                        v119 = v118;
-                        numVerticesm = frustum->bottom * v182 - v178;
-                        if ( numVerticesm != 0.0 )
-                        {
-                            v119 = v118 / numVerticesm;
-                        }
-                        v122 = frustum->bottom * v119;
-                        v123 = v182;
-                        if ( v123 < 0.0 )
-                            v123 = -v123;
-                        v126 = v178;
-                        if ( v126 < 0.0 )
-                            v126 = -v126;
-                        if ( v123 <= v126 )
-                            v128 = (v122 - v109->z) / v178;
-                        else
-                            v128 = (v119 - v109->y) / v182;
-                        ++v113;
-                        ++v111;
-                        v129 = (*(v112 - 2) - v109->x) * v128;
-                        v111[-1].x = (v107->x - v110->x) * v128 + v110->x;
-                        ++v172;
-                        v131 = v129 + v109->x;
-                        v132 = (v107->y - v110->y) * v128 + v110->y;
-                        v113[-1].x = v131;
-                        v113[-1].y = v119;
-                        v113[-1].z = v122;
-                        v111[-1].y = v132;
-                        rdClip_faceStatus |= 0x8;
-                    }
-                    if ( v115 <= *v112 )
-                    {
-                        v133 = v113++;
-                        v133->x = *(v112 - 2);
-                        v133->y = *(v112 - 1);
-                        v133->z = *v112;
-                        v111->x = v107->x;
-                        v111->y = v107->y;
-                        ++v172;
-                        ++v111;
-                    }
-                }
-                v109 = (rdVector3 *)(v112 - 2);
-                v110 = v107;
-                v112 += 3;
-                ++v107;
-                --v186;
-            }
-            while ( v186 );
-            v108 = v172;
-        }
-        if ( v108 < 3 )
-            return v172;
-        v134 = (intptr_t)pDestVert ^ (intptr_t)pSourceVert;
-        pDestVert = pSourceVert;
-        pSourceVert = (rdVector3 *)((intptr_t)pSourceVert ^ v134);
-        v135 = (intptr_t)pDestTVert ^ (intptr_t)pSourceTVert;
-        v173 = 0;
-        pDestTVert = pSourceTVert;
-        v136 = (rdVector2 *)((intptr_t)pSourceTVert ^ v135);
-        v137 = v108;
-        pSourceTVert = v136;
-        v138 = &pSourceVert[v108 - 1];
-        v139 = &v136[v108 - 1];
-        v140 = pDestTVert;
-        v141 = pDestVert;
-        v142 = &pSourceVert->y;
-        numVerticesh = v137;
-        do
-        {
-            if ( v138->y >= (double)frustum->field_0.y || *v142 >= (double)frustum->field_0.y )
-            {
-                if ( v138->y != frustum->field_0.y
-                  && *v142 != frustum->field_0.y
-                  && (v138->y < (double)frustum->field_0.y || *v142 < (double)frustum->field_0.y) )
-                {
-                    v143 = (frustum->field_0.y - v138->y) / (*v142 - v138->y);
-                    v141->y = frustum->field_0.y;
-                    ++v173;
-                    rdClip_faceStatus |= 0x1;
-                    v145 = (v136->x - v139->x) * v143 + v139->x;
-                    v141->z = (v142[1] - v138->z) * v143 + v138->z;
-                    v146 = v145;
-                    v147 = *(v142 - 1) - v138->x;
-                    v140->x = v146;
-                    v148 = v147 * v143 + v138->x;
-                    v149 = (v136->y - v139->y) * v143 + v139->y;
-                    v141->x = v148;
-                    v140->y = v149;
-                    ++v140;
-                    ++v141;
-                }
-                if ( *v142 >= (double)frustum->field_0.y )
-                {
-                    v150 = v141++;
-                    v150->x = *(v142 - 1);
-                    v150->y = *v142;
-                    v150->z = v142[1];
-                    v140->x = v136->x;
-                    v140->y = v136->y;
-                    ++v173;
-                    ++v140;
-                }
-            }
-            v138 = (rdVector3 *)(v142 - 1);
-            v139 = v136;
-            v142 += 3;
-            ++v136;
-            --numVerticesh;
-        }
-        while ( numVerticesh );
-        v151 = pDestVert;
-        v70 = v173;
-        if ( v173 < 3 )
-        {
-            rdClip_faceStatus |= 0x40;
-            return v173;
-        }
-        if ( frustum->field_0.x != 0.0 )
-        {
-            v153 = (intptr_t)pDestTVert ^ (intptr_t)pSourceTVert;
-            pDestTVert = pSourceTVert;
-            v154 = (rdVector2 *)((intptr_t)pSourceTVert ^ v153);
-            v155 = v173;
-            pDestVert = pSourceVert;
-            pSourceVert = v151;
-            pSourceTVert = v154;
-            v174 = 0;
-            v156 = &v151[v70 - 1];
-            v157 = &v154[v70 - 1];
-            v158 = pDestTVert;
-            v159 = pDestVert;
-            v160 = &pSourceVert->y;
-            numVerticesi = v155;
-            do
-            {
-                if ( v156->y <= (double)frustum->field_0.z || *v160 <= (double)frustum->field_0.z )
-                {
-                    if ( v156->y != frustum->field_0.z
-                      && *v160 != frustum->field_0.z
-                      && (v156->y > (double)frustum->field_0.z || *v160 > (double)frustum->field_0.z) )
-                    {
-                        ++v159;
-                        ++v158;
-                        v161 = (frustum->field_0.z - v156->y) / (*v160 - v156->y);
-                        v159[-1].y = frustum->field_0.z;
-                        ++v174;
-                        rdClip_faceStatus |= 2;
-                        v163 = (v154->x - v157->x) * v161 + v157->x;
-                        v159[-1].z = (v160[1] - v156->z) * v161 + v156->z;
-                        v164 = v163;
-                        v165 = *(v160 - 1) - v156->x;
-                        v158[-1].x = v164;
-                        v166 = v165 * v161 + v156->x;
-                        v167 = (v154->y - v157->y) * v161 + v157->y;
-                        v159[-1].x = v166;
-                        v158[-1].y = v167;
-                    }
-                    if ( *v160 <= (double)frustum->field_0.z )
-                    {
-                        v168 = v159++;
-                        v168->x = *(v160 - 1);
-                        v168->y = *v160;
-                        v168->z = v160[1];
-                        v158->x = v154->x;
-                        v158->y = v154->y;
-                        ++v174;
-                        ++v158;
-                    }
-                }
-                v156 = (rdVector3 *)(v160 - 1);
-                v157 = v154;
-                v160 += 3;
-                ++v154;
-                --numVerticesi;
-            }
-            while ( numVerticesi );
-            v70 = v174;
-            if ( v174 < 3 )
-                goto LABEL_124;
-            v151 = pDestVert;
-        }
-        if ( v151 != vertices )
-        {
-            _memcpy(vertices, v151, v70 * sizeof(rdVector3));
-            _memcpy(uvs, pDestTVert,  v70 * sizeof(rdVector2));
-        }
-LABEL_124:
-        result = v70;
-    }
-    return result;
+    return rdClip_Poly(frustum, frustum->nearLeft, frustum->nearTop, rdClip_UseGuardBand(frustum), vertices, uvs, NULL, numVertices);
 }
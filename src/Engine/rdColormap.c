@@ -6,6 +6,9 @@
 
 static rdTexformat rdColormap_colorInfo = {1, 0x10, 5, 6, 5, 0x0B, 5, 0, 3, 2, 3, 0, 0, 0};
 
+// Added: bumped whenever a colormap's colors are (re)loaded
+uint32_t rdColormap_loadGeneration = 1;
+
 int rdColormap_SetCurrent(rdColormap *colormap)
 {
     if (rdColormap_pCurMap != colormap)
@@ -83,6 +86,7 @@ int rdColormap_LoadEntry(char *colormap_fname, rdColormap *colormap)
         goto safe_fallback;
     }
     rdroid_pHS->fileRead(colormap_fptr, colormap->colors, 0x300);
+    rdColormap_loadGeneration++; // Added
     if ( (colormap->flags & 4) == 0 )
     {
         colorsLights = rdroid_pHS->alloc(0x4100);
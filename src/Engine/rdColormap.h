@@ -26,6 +26,8 @@ void rdColormap_Free(rdColormap *colormap);
 void rdColormap_FreeEntry(rdColormap *colormap);
 int rdColormap_Write(char *outpath, rdColormap *colormap);
 
+extern uint32_t rdColormap_loadGeneration; // Added
+
 static int (*rdColormap_BuildGrayRamp)(rdColormap *colormap) = (void*)rdColormap_BuildGrayRamp_ADDR;
 static int (*rdColormap_BuildRGB16)(uint16_t *a2, rdColor24 *a3, uint8_t a4, uint8_t a5, uint8_t a6, rdTexformat *format) = (void*)rdColormap_BuildRGB16_ADDR;
 //static int (__cdecl *rdColormap_LoadEntry)(char *colormap_fname, rdColormap *colormap) = (void*)rdColormap_LoadEntry_ADDR;
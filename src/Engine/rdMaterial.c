@@ -273,6 +273,11 @@ void rdMaterial_FreeEntry(rdMaterial* material)
           v9 = v7->texture_struct;
           do
           {
+#ifdef SDL2_RENDER
+            // Added: the GPU cache keeps a handle to the surface, drop it first
+            std3D_RemoveTextureFromList(&v7->alphaMats[v8]);
+            std3D_RemoveTextureFromList(&v7->opaqueMats[v8]);
+#endif
             stdDisplay_VBufferFree(*v9);
             ++v8;
             ++v9;
@@ -7,6 +7,24 @@
 #include "stdPlatform.h"
 #include "jk.h"
 
+#ifdef SDL2_RENDER
+#include <SDL.h>
+
+// Fewer than this isn't worth waking the workers for
+#define RDPUPPET_MIN_THREADED_THINGS (4)
+
+static int rdPuppet_bThreadsStarted = 0;
+static int rdPuppet_numThreads = 0;
+static SDL_Thread* rdPuppet_aThreads[RDPUPPET_MAX_THREADS];
+static SDL_sem* rdPuppet_pWorkSem = NULL;
+static SDL_sem* rdPuppet_pDoneSem = NULL;
+static SDL_atomic_t rdPuppet_nextJob;
+static int rdPuppet_bThreadsQuit = 0;
+static rdThing** rdPuppet_apJobThings = NULL;
+static rdMatrix34* rdPuppet_aJobMatrices = NULL;
+static size_t rdPuppet_numJobs = 0;
+#endif
+
 rdPuppet* rdPuppet_New(rdThing *thing)
 {
     rdPuppet* puppet = (rdPuppet *)rdroid_pHS->alloc(sizeof(rdPuppet));
@@ -48,19 +66,113 @@ void rdPuppet_Free(rdPuppet *puppet)
         puppet->tracks[i].keyframe = NULL;
         puppet->tracks[i].callback = NULL;
     }
+
+    // Added: pose cache
+    if (puppet->pPoseCache)
+        rdroid_pHS->free(puppet->pPoseCache);
     
     rdroid_pHS->free(puppet);
 }
 
+// Added: index of the last anim entry which starts at or before `frame`,
+// searching forward from `cursor` (which already does). Entries are sorted by
+// frameNum, so this gallops forward and then bisects instead of stepping one
+// entry at a time, which matters after a track wraps back to entry 0.
+static uint32_t rdPuppet_SeekAnimEntry(rdJoint *joint, uint32_t cursor, float frame)
+{
+    uint32_t last = joint->numAnimEntries - 1;
+    uint32_t lo = cursor;
+    uint32_t hi;
+    uint32_t step = 1;
+
+    // lo always starts at or before frame, hi is always past it (or past the end)
+    while ( lo + step <= last && frame >= (double)joint->animEntries[lo + step].frameNum )
+    {
+        lo += step;
+        step *= 2;
+    }
+    hi = (lo + step <= last) ? lo + step : last + 1;
+
+    while ( hi - lo > 1 )
+    {
+        uint32_t mid = lo + ((hi - lo) / 2);
+        if ( frame >= (double)joint->animEntries[mid].frameNum )
+            lo = mid;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+// Added: the pose cache of thing's puppet, if its model fits. Workers never
+// allocate, rdPuppet_BuildJointMatricesMulti does that on the main thread first.
+static rdPuppetPoseCache* rdPuppet_GetPoseCache(rdThing *thing)
+{
+    rdPuppet* puppet = thing->puppet;
+
+    if ( !puppet || !thing->model3 || thing->model3->numHierarchyNodes > RDPUPPET_POSE_MAX_NODES )
+        return NULL;
+
+    if ( !puppet->pPoseCache )
+    {
+#ifdef SDL2_RENDER
+        if ( rdPuppet_numJobs )
+            return NULL;
+#endif
+        puppet->pPoseCache = (rdPuppetPoseCache*)rdroid_pHS->alloc(sizeof(rdPuppetPoseCache));
+        if ( puppet->pPoseCache )
+            _memset(puppet->pPoseCache, 0, sizeof(rdPuppetPoseCache));
+    }
+    return puppet->pPoseCache;
+}
+
+// Added: fills in what the pose depends on besides the anim entry cursors,
+// which only move with the frame. Returns 1 if it matches the cached pose.
+static int rdPuppet_CheckPoseCache(rdThing *thing, rdPuppetPoseCache *pCache, rdPuppetPoseTrackKey *pKeys)
+{
+    rdPuppet* puppet = thing->puppet;
+    rdModel3* model = thing->model3;
+    int bMatch = (pCache->model == model);
+
+    for (int i = 0; i < 4; i++)
+    {
+        rdPuppetTrack* track = &puppet->tracks[i];
+        rdPuppetPoseTrackKey* pKey = &pKeys[i];
+
+        _memset(pKey, 0, sizeof(*pKey));
+        if ( track->keyframe )
+        {
+            pKey->keyframe = track->keyframe;
+            pKey->bPlaying = (track->status & 2) != 0;
+            pKey->lowPri = track->lowPri;
+            pKey->highPri = track->highPri;
+            pKey->frame = track->field_120;
+            pKey->playSpeed = track->playSpeed;
+        }
+
+        if ( pKey->keyframe != pCache->tracks[i].keyframe
+          || pKey->bPlaying != pCache->tracks[i].bPlaying
+          || pKey->lowPri != pCache->tracks[i].lowPri
+          || pKey->highPri != pCache->tracks[i].highPri
+          || pKey->frame != pCache->tracks[i].frame
+          || pKey->playSpeed != pCache->tracks[i].playSpeed )
+        {
+            bMatch = 0;
+        }
+    }
+
+    if ( bMatch && _memcmp(pCache->nodeRots, thing->hierarchyNodes2, sizeof(rdVector3) * model->numHierarchyNodes) )
+        bMatch = 0;
+
+    return bMatch;
+}
+
 void rdPuppet_BuildJointMatrices(rdThing *thing, rdMatrix34 *matrix)
 {
     rdPuppet *puppet; // eax
     rdPuppetTrack *v4; // ebx
     rdJoint *v8; // esi
-    int v9; // edi
     uint32_t v10; // eax
-    intptr_t v12; // ecx
-    rdAnimEntry *v13;
     rdHierarchyNode *v15; // edi
     rdPuppetTrack *v16; // esi
     rdKeyframe *v17; // ebp
@@ -99,6 +211,9 @@ void rdPuppet_BuildJointMatrices(rdThing *thing, rdMatrix34 *matrix)
     rdVector3 v90; // [esp+6Ch] [ebp-18h]
     rdVector3 v91; // [esp+78h] [ebp-Ch]
     rdVector3 tmp1;
+    rdPuppetPoseCache* pCache;
+    rdPuppetPoseTrackKey aKeys[4];
+    int nodeIdx;
 
     model = thing->model3;
     puppet = thing->puppet;
@@ -119,6 +234,16 @@ void rdPuppet_BuildJointMatrices(rdThing *thing, rdMatrix34 *matrix)
     }
     else
     {
+        // Added: reuse the last pose if none of its inputs changed
+        pCache = rdPuppet_GetPoseCache(thing);
+        if ( pCache && rdPuppet_CheckPoseCache(thing, pCache, aKeys) )
+        {
+            _memcpy(thing->hierarchyNodeMatrices, pCache->nodeMatrices, sizeof(rdMatrix34) * model->numHierarchyNodes);
+            rdThing_AccumulateMatrices(thing, model->hierarchyNodes, matrix);
+            thing->frameTrue = rdroid_frameTrue;
+            return;
+        }
+
         v4 = puppet->tracks;
         //if (thing->parentSithThing == g_localPlayerThing)
         //    printf("%s\n", v4->keyframe->name);
@@ -130,40 +255,23 @@ void rdPuppet_BuildJointMatrices(rdThing *thing, rdMatrix34 *matrix)
                 for (int j = 0; j < v4->keyframe->numJoints2; j++)
                 {
                     v8 = &v4->keyframe->joints[j];
-                    v9 = 0;
                     if ( v8->numAnimEntries )
                     {
-                        // Added: this spot keeps crashing, add bounds checks
-                        if (v8->nodeIdx < 0 || v8->nodeIdx >= 64)
+                        // Added: this spot keeps crashing, add bounds checks.
+                        // Keyframes are shared between workers, so don't write the fix back
+                        nodeIdx = v8->nodeIdx;
+                        if (nodeIdx < 0 || nodeIdx >= 64)
                         {
-                            v8->nodeIdx = 0;
+                            nodeIdx = 0;
                         }
 
-                        v10 = v4->nodes[v8->nodeIdx];// nodeIdx
+                        v10 = v4->nodes[nodeIdx];// nodeIdx
                         if ( v10 != v8->numAnimEntries - 1 )
                         {
-                            v12 = v10 + 1;
                             if ( v4->field_120 >= (double)v8->animEntries[v10 + 1].frameNum )
                             {
-                                v13 = &v8->animEntries[v10 + 2];
-                                do
-                                {
-                                    if ( v12 == v8->numAnimEntries - 1 )
-                                    {
-                                        v9 = 1;
-                                    }
-                                    else if ( v4->field_120 >= (double)v13->frameNum )
-                                    {
-                                        ++v12;
-                                        v13++;
-                                    }
-                                    else
-                                    {
-                                        v9 = 1;
-                                    }
-                                }
-                                while ( !v9 );
-                                v4->nodes[j] = v12;
+                                // Added: was a linear walk from the cursor
+                                v4->nodes[j] = rdPuppet_SeekAnimEntry(v8, v10 + 1, v4->field_120);
                             }
                         }
                     }
@@ -318,11 +426,138 @@ void rdPuppet_BuildJointMatrices(rdThing *thing, rdMatrix34 *matrix)
                 rdMatrix_PreRotate34(&thing->hierarchyNodeMatrices[v80], &thing->hierarchyNodes2[v80]);
             v15++;
         }
+
+        // Added: pose cache
+        if ( pCache )
+        {
+            pCache->model = model;
+            _memcpy(pCache->tracks, aKeys, sizeof(aKeys));
+            _memcpy(pCache->nodeRots, thing->hierarchyNodes2, sizeof(rdVector3) * model->numHierarchyNodes);
+            _memcpy(pCache->nodeMatrices, thing->hierarchyNodeMatrices, sizeof(rdMatrix34) * model->numHierarchyNodes);
+        }
     }
     rdThing_AccumulateMatrices(thing, model->hierarchyNodes, matrix);
     thing->frameTrue = rdroid_frameTrue;
 }
 
+#ifdef SDL2_RENDER
+static void rdPuppet_RunJobs()
+{
+    while (1)
+    {
+        int idx = SDL_AtomicAdd(&rdPuppet_nextJob, 1);
+        if (idx >= (int)rdPuppet_numJobs)
+            break;
+
+        rdPuppet_BuildJointMatrices(rdPuppet_apJobThings[idx], &rdPuppet_aJobMatrices[idx]);
+    }
+}
+
+static int rdPuppet_WorkerThread(void* unused)
+{
+    while (1)
+    {
+        SDL_SemWait(rdPuppet_pWorkSem);
+        if (rdPuppet_bThreadsQuit)
+            break;
+
+        rdPuppet_RunJobs();
+        SDL_SemPost(rdPuppet_pDoneSem);
+    }
+    return 0;
+}
+
+static void rdPuppet_StartThreads()
+{
+    int numThreads;
+
+    rdPuppet_bThreadsStarted = 1;
+    rdPuppet_numThreads = 0;
+
+#ifndef ARCH_WASM
+    numThreads = stdPlatform_GetNumCpus() - 1;
+    if (numThreads > RDPUPPET_MAX_THREADS - 1)
+        numThreads = RDPUPPET_MAX_THREADS - 1;
+    if (numThreads <= 0)
+        return;
+
+    rdPuppet_pWorkSem = SDL_CreateSemaphore(0);
+    rdPuppet_pDoneSem = SDL_CreateSemaphore(0);
+    if (!rdPuppet_pWorkSem || !rdPuppet_pDoneSem)
+        return;
+
+    rdPuppet_bThreadsQuit = 0;
+    for (int i = 0; i < numThreads; i++)
+    {
+        rdPuppet_aThreads[i] = SDL_CreateThread(rdPuppet_WorkerThread, "rdPuppet", NULL);
+        if (!rdPuppet_aThreads[i])
+            break;
+        rdPuppet_numThreads++;
+    }
+#endif
+}
+
+void rdPuppet_Shutdown()
+{
+    if (rdPuppet_numThreads)
+    {
+        rdPuppet_bThreadsQuit = 1;
+        for (int i = 0; i < rdPuppet_numThreads; i++)
+            SDL_SemPost(rdPuppet_pWorkSem);
+        for (int i = 0; i < rdPuppet_numThreads; i++)
+            SDL_WaitThread(rdPuppet_aThreads[i], NULL);
+    }
+    if (rdPuppet_pWorkSem)
+        SDL_DestroySemaphore(rdPuppet_pWorkSem);
+    if (rdPuppet_pDoneSem)
+        SDL_DestroySemaphore(rdPuppet_pDoneSem);
+    rdPuppet_pWorkSem = NULL;
+    rdPuppet_pDoneSem = NULL;
+    rdPuppet_numThreads = 0;
+    rdPuppet_bThreadsStarted = 0;
+}
+
+// Every thing's pose only touches its own rdThing and puppet, the models and
+// keyframes are only read. aMatrices[i] is the placement passed for apThings[i].
+void rdPuppet_BuildJointMatricesMulti(rdThing **apThings, rdMatrix34 *aMatrices, size_t numThings)
+{
+    int numWorkers;
+
+    if (!numThings)
+        return;
+
+    if (!rdPuppet_bThreadsStarted)
+        rdPuppet_StartThreads();
+
+    // The allocator isn't thread safe, give every pose its cache before the workers start
+    for (size_t i = 0; i < numThings; i++)
+        rdPuppet_GetPoseCache(apThings[i]);
+
+    rdPuppet_apJobThings = apThings;
+    rdPuppet_aJobMatrices = aMatrices;
+    rdPuppet_numJobs = numThings;
+
+    numWorkers = rdPuppet_numThreads;
+    if (numWorkers > (int)numThings - 1)
+        numWorkers = (int)numThings - 1;
+    if (numThings < RDPUPPET_MIN_THREADED_THINGS)
+        numWorkers = 0;
+
+    SDL_AtomicSet(&rdPuppet_nextJob, 0);
+    for (int i = 0; i < numWorkers; i++)
+        SDL_SemPost(rdPuppet_pWorkSem);
+
+    rdPuppet_RunJobs();
+
+    for (int i = 0; i < numWorkers; i++)
+        SDL_SemWait(rdPuppet_pDoneSem);
+
+    rdPuppet_apJobThings = NULL;
+    rdPuppet_aJobMatrices = NULL;
+    rdPuppet_numJobs = 0;
+}
+#endif
+
 int rdPuppet_ResetTrack(rdPuppet *puppet, int trackNum)
 {
     if ( puppet->tracks[trackNum].callback )
@@ -43,11 +43,34 @@ typedef struct rdPuppetTrack
     int field_130;
 } rdPuppetTrack;
 
+// Added: the last pose rdPuppet_BuildJointMatrices evaluated, before the
+// hierarchy is accumulated. Reused while nothing it depends on has changed.
+#define RDPUPPET_POSE_MAX_NODES (64)
+
+typedef struct rdPuppetPoseTrackKey
+{
+    rdKeyframe* keyframe;
+    int bPlaying;
+    int lowPri;
+    int highPri;
+    float frame;
+    float playSpeed;
+} rdPuppetPoseTrackKey;
+
+typedef struct rdPuppetPoseCache
+{
+    rdModel3* model;
+    rdPuppetPoseTrackKey tracks[4];
+    rdVector3 nodeRots[RDPUPPET_POSE_MAX_NODES];
+    rdMatrix34 nodeMatrices[RDPUPPET_POSE_MAX_NODES];
+} rdPuppetPoseCache;
+
 typedef struct rdPuppet
 {
     uint32_t paused;
     rdThing *rdthing;
     rdPuppetTrack tracks[4];
+    rdPuppetPoseCache* pPoseCache; // Added
 } rdPuppet;
 
 rdPuppet* rdPuppet_New(rdThing *thing);
@@ -66,6 +89,14 @@ int rdPuppet_PlayTrack(rdPuppet *puppet, int trackNum);
 void rdPuppet_unk(rdPuppet *puppet, int trackNum);
 int rdPuppet_RemoveTrack(rdPuppet *puppet, rdThing *rdthing);
 
+#ifdef SDL2_RENDER
+// Added: evaluates the poses of many things at once on worker threads
+#define RDPUPPET_MAX_THREADS (8)
+
+void rdPuppet_Shutdown();
+void rdPuppet_BuildJointMatricesMulti(rdThing **apThings, rdMatrix34 *aMatrices, size_t numThings);
+#endif
+
 //static void (*rdPuppet_unk)(rdPuppet *a1, int a2) = (void*)rdPuppet_unk_ADDR;
 //static int (*rdPuppet_AddTrack)(rdPuppet *puppet, rdKeyframe *keyframe, int a3, int a4) = (void*)rdPuppet_AddTrack_ADDR;
 //static void (*rdPuppet_SetCallback)(rdPuppet *a1, int trackNum, int callback) = (void*)rdPuppet_SetCallback_ADDR;
@@ -3,6 +3,7 @@
 #include "Raster/rdRaster.h"
 #include "rdActive.h"
 #include "rdCache.h"
+#include "rdPuppet.h"
 #include "Primitives/rdModel3.h"
 #include "General/stdPalEffects.h"
 #include "Engine/rdCamera.h"
@@ -26,7 +27,13 @@ int rdStartup(struct common_functions *p_hs)
 void rdShutdown()
 {
     if (bRDroidStartup)
+    {
+        rdCache_Shutdown();
+#ifdef SDL2_RENDER
+        rdPuppet_Shutdown(); // Added
+#endif
         bRDroidStartup = 0;
+    }
 }
 
 int rdOpen(int a1)
@@ -8,6 +8,7 @@
 #include "General/sithStrTable.h"
 #include "General/stdString.h"
 #include "General/stdFnames.h"
+#include "General/stdProfiler.h"
 #include "Win95/sithDplay.h"
 #include "Win95/DebugConsole.h"
 #include "Win95/Window.h"
@@ -30,6 +31,7 @@
 #include "Engine/sithTime.h"
 #include "Engine/sithRender.h"
 #include "Engine/sithControl.h"
+#include "Engine/sithInterp.h"
 #include "Engine/sithMulti.h"
 #include "Dss/sithGamesave.h"
 #include "Engine/sithNet.h"
@@ -238,13 +240,19 @@ int sith_Tick()
         sithSoundSys_ResumeMusic(0);
         sithTime_Tick();
         sithSoundSys_Tick(sithTime_deltaSeconds);
+        stdProfiler_Begin(STDPROFILER_ZONE_EVENT);
         sithEvent_Advance();
+        stdProfiler_End(STDPROFILER_ZONE_EVENT);
 
+        stdProfiler_Begin(STDPROFILER_ZONE_COGVM);
         if ( sithCogVm_bSyncMultiplayer )
             sithCogVm_Sync();
+        stdProfiler_End(STDPROFILER_ZONE_COGVM);
 
+        stdProfiler_Begin(STDPROFILER_ZONE_AI);
         if ( (g_debugmodeFlags & 1) == 0 )
             sithAI_TickAll();
+        stdProfiler_End(STDPROFILER_ZONE_AI);
 
         sithSurface_Tick(sithTime_deltaSeconds);
 
@@ -253,8 +261,13 @@ int sith_Tick()
             sithControl_Tick(sithTime_deltaSeconds, sithTime_deltaMs);
         }
 
+        stdProfiler_Begin(STDPROFILER_ZONE_THINGS);
         sithThing_TickAll(sithTime_deltaSeconds, sithTime_deltaMs);
+        stdProfiler_End(STDPROFILER_ZONE_THINGS);
+
+        stdProfiler_Begin(STDPROFILER_ZONE_COGSCRIPT);
         sithCogScript_TickAll();
+        stdProfiler_End(STDPROFILER_ZONE_COGSCRIPT);
         
         DebugConsole_AdvanceLogBuf();
 #ifndef LINUX_TMP
@@ -265,6 +278,31 @@ int sith_Tick()
     }
 }
 
+#ifdef QOL_IMPROVEMENTS
+// Added: Ticks the simulation in fixed steps of 1/hz seconds, as many as the
+// real time since the last call covers. Returns like sith_Tick.
+int sith_TickFixed(int hz)
+{
+    int numSteps = sithTime_BeginFixedSteps(hz);
+    int ret = (g_submodeFlags & 8) != 0;
+
+    for (int i = 0; i < numSteps; i++)
+    {
+        sithInterp_SaveThings();
+        ret = sith_Tick();
+        if ( (g_submodeFlags & 8) == 0 && sithCamera_currentCamera )
+            sithCamera_FollowFocusStep(sithCamera_currentCamera);
+
+        // The level is over, leave the rest to the next one
+        if ( sith_bEndLevel || g_sithMode == 5 )
+            break;
+    }
+    sithTime_EndFixedSteps();
+
+    return ret;
+}
+#endif
+
 void sith_UpdateCamera()
 {
     if ( (g_submodeFlags & 8) == 0 )
@@ -292,6 +330,18 @@ void sith_UpdateCamera()
         }
 #endif
 
+#ifdef QOL_IMPROVEMENTS
+        // Added: draw between the last two fixed steps
+        if ( sithTime_fixedHz )
+        {
+            sithCamera_InterpolateFocus(sithCamera_currentCamera, sithTime_fixedAlpha);
+            sithInterp_ApplyThings(sithTime_fixedAlpha);
+            sithCamera_SetRdCameraAndRenderidk();
+            sithInterp_RestoreThings();
+            return;
+        }
+#endif
+
         //sithCamera_currentCamera->rdCam.screenAspectRatio += 0.01;
         sithCamera_FollowFocus(sithCamera_currentCamera);
         sithCamera_SetRdCameraAndRenderidk();
@@ -41,6 +41,10 @@ void sith_SetEpisodeName(char *text);
 void sith_AutoSave();
 void sith_sub_4C4D80();
 
+#ifdef QOL_IMPROVEMENTS
+int sith_TickFixed(int hz);
+#endif
+
 //static int (*sith_Startup)() = (void*)sith_Startup_ADDR;
 //static int (*sith_Tick)() = (void*)sith_Tick_ADDR;
 //static void (*sith_AutoSave)() = (void*)sith_AutoSave_ADDR;
@@ -12,6 +12,7 @@
 #include "Engine/rdCamera.h"
 #include "Engine/sithRender.h"
 #include "Engine/sithAdjoin.h"
+#include "Engine/sithInterp.h"
 #include "jk.h"
 
 static rdVector3 sithCamera_trans = {0.0, 0.3, 0.0};
@@ -22,6 +23,15 @@ static int sithCamera_camIdxToGlobalIdx[2] = {0,1};
 #define SITHCAMERA_FOV (90.0)
 #define SITHCAMERA_ASPECT (1.0)
 
+#ifdef QOL_IMPROVEMENTS
+// Added: the view after the last two fixed steps, see sithCamera_InterpolateFocus
+static sithCamera* sithCamera_pStepCamera = NULL;
+static int sithCamera_stepPerspective = 0;
+static sithSector* sithCamera_pStepSector = NULL;
+static rdMatrix34 sithCamera_prevStepViewMat;
+static rdMatrix34 sithCamera_stepViewMat;
+#endif
+
 int sithCamera_Startup()
 {
     sithCamera_NewEntry(&sithCamera_cameras[0], 0, 1, SITHCAMERA_FOV, SITHCAMERA_ASPECT, NULL, NULL, NULL);
@@ -69,6 +79,9 @@ int sithCamera_Open(rdCanvas *canvas, float aspect)
     rdCamera_SetAttenuation(&sithCamera_cameras[6].rdCam, 0.40000001, 0.80000001);
     rdCamera_SetCanvas(&sithCamera_cameras[6].rdCam, canvas);
     sithCamera_FollowFocus(sithCamera_currentCamera);
+#ifdef QOL_IMPROVEMENTS
+    sithCamera_pStepCamera = NULL; // Added
+#endif
     sithCamera_bOpen = 1;
     return 1;
 }
@@ -395,6 +408,41 @@ LABEL_70:
     sithCamera_povShakeVector2.z = 0.0;
 }
 
+#ifdef QOL_IMPROVEMENTS
+// Added: Follows the focus once per fixed step, so the shake and orbit keep
+// advancing at the simulation's pace, and keeps the views either side of it
+void sithCamera_FollowFocusStep(sithCamera *cam)
+{
+    sithCamera_FollowFocus(cam);
+
+    if ( cam == sithCamera_pStepCamera && cam->cameraPerspective == sithCamera_stepPerspective )
+        rdMatrix_Copy34(&sithCamera_prevStepViewMat, &sithCamera_stepViewMat);
+    else
+        rdMatrix_Copy34(&sithCamera_prevStepViewMat, &cam->viewMat);
+
+    rdMatrix_Copy34(&sithCamera_stepViewMat, &cam->viewMat);
+    sithCamera_pStepSector = cam->sector;
+    sithCamera_pStepCamera = cam;
+    sithCamera_stepPerspective = cam->cameraPerspective;
+}
+
+// Added: Sets the view alpha of the way from the previous fixed step to the
+// last one, in place of sithCamera_FollowFocus
+void sithCamera_InterpolateFocus(sithCamera *cam, float alpha)
+{
+    // Switched cameras since the last step, there's nothing to blend from
+    if ( cam != sithCamera_pStepCamera || cam->cameraPerspective != sithCamera_stepPerspective )
+        sithCamera_FollowFocusStep(cam);
+
+    cam->sector = sithCamera_pStepSector;
+    if ( sithInterp_LerpMatrix(&cam->viewMat, &sithCamera_prevStepViewMat, &sithCamera_stepViewMat, alpha) && cam->sector )
+        cam->sector = sithCollision_GetSectorLookAt(cam->sector, &sithCamera_stepViewMat.scale, &cam->viewMat.scale, 0.0);
+
+    cam->vec3_1 = cam->viewMat.scale;
+    rdMatrix_ExtractAngles34(&cam->viewMat, &cam->vec3_2);
+}
+#endif
+
 void sithCamera_SetRdCameraAndRenderidk()
 {
     if ( sithCamera_currentCamera )
@@ -45,6 +45,11 @@ void sithCamera_SetPovShake(rdVector3 *a1, rdVector3 *a2, float a3, float a4);
 sithThing* sithCamera_GetPrimaryFocus(sithCamera *cam);
 void sithCamera_CycleCamera();
 
+#ifdef QOL_IMPROVEMENTS
+void sithCamera_FollowFocusStep(sithCamera *cam);
+void sithCamera_InterpolateFocus(sithCamera *cam, float alpha);
+#endif
+
 static void (*sithCamera_Shutdown)() = (void*)sithCamera_Shutdown_ADDR;
 static int (*sithCamera_NewEntry_)(sithCamera *camera, int a2, int a3, float fov, float a5, rdCanvas* a6, sithThing *focus_far, sithThing *focus_near) = (void*)sithCamera_NewEntry_ADDR;
 //static void (*sithCamera_SetCameraFocus)(sithCamera *a1, sithThing *primary, sithThing *secondary) = (void*)sithCamera_SetCameraFocus_ADDR;
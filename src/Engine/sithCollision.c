@@ -13,7 +13,10 @@
 #include "Engine/sithSoundClass.h"
 #include "Engine/sithTime.h"
 #include "Engine/sithPhysics.h"
+#include "Engine/sithCollisionGrid.h"
 #include "General/stdMath.h"
+#include "General/stdString.h"
+#include "Win95/DebugConsole.h"
 #include "jk.h"
 
 static int sithCollision_initted = 0;
@@ -66,6 +69,358 @@ void sithCollision_RegisterHitHandler(int type, void* a2)
     sithCollision_funcList[type] = a2;
 }
 
+#ifdef QOL_IMPROVEMENTS
+// Added: Growable replacement for one level of sithCollision_searchStack.
+// aResults keeps the order results were found in, aHeap is a min-heap of the
+// indices not yet handed out by sithCollision_NextSearchResult.
+typedef struct sithCollisionSearchFrame
+{
+    sithCollisionSearchEntry* aResults;
+    uint32_t numResults;
+    uint32_t maxResults;
+    int* aHeap;
+    uint32_t numHeap;
+    uint32_t maxHeap;
+    uint32_t numHeaped;
+    sithSector** apSectors;
+    uint32_t numSectors;
+    uint32_t maxSectors;
+} sithCollisionSearchFrame;
+
+static sithCollisionSearchFrame* sithCollision_aSearchFrames = NULL;
+static uint32_t sithCollision_numSearchFrames = 0;
+
+// Results at the same distance passed over by sithCollision_NextSearchResult
+static int* sithCollision_aTies = NULL;
+static uint32_t sithCollision_maxTies = 0;
+
+uint32_t sithCollision_numResultOverflows = 0;
+uint32_t sithCollision_numSectorOverflows = 0;
+uint32_t sithCollision_numDepthOverflows = 0;
+int sithCollision_maxSearchResults = 0;
+int sithCollision_maxSearchSectors = 0;
+int sithCollision_maxSearchDepth = 0;
+
+// Grows *ppArr to hold at least `amt` elements of `size` bytes
+static int sithCollision_Ensure(void** ppArr, uint32_t* pMax, uint32_t amt, uint32_t minMax, size_t size)
+{
+    uint32_t newMax;
+    void* pNew;
+
+    if (amt <= *pMax)
+        return 1;
+
+    newMax = *pMax ? *pMax : minMax;
+    while (newMax < amt)
+        newMax *= 2;
+
+    pNew = pSithHS->realloc(*ppArr, size * newMax);
+    if (!pNew)
+        return 0;
+
+    *ppArr = pNew;
+    *pMax = newMax;
+    return 1;
+}
+
+static sithCollisionSearchFrame* sithCollision_GetSearchFrame()
+{
+    if (sithCollision_searchStackIdx < 0 || (uint32_t)sithCollision_searchStackIdx >= sithCollision_numSearchFrames)
+        return NULL;
+
+    return &sithCollision_aSearchFrames[sithCollision_searchStackIdx];
+}
+
+// Orders on distance, ties go to whichever was found first
+static int sithCollision_HeapLess(sithCollisionSearchFrame* pFrame, int a, int b)
+{
+    float distA = pFrame->aResults[a].distance;
+    float distB = pFrame->aResults[b].distance;
+
+    return distA < distB || (distA == distB && a < b);
+}
+
+static void sithCollision_HeapPush(sithCollisionSearchFrame* pFrame, int resultIdx)
+{
+    uint32_t i = pFrame->numHeap++;
+
+    while (i)
+    {
+        uint32_t parent = (i - 1) / 2;
+        if (!sithCollision_HeapLess(pFrame, resultIdx, pFrame->aHeap[parent]))
+            break;
+        pFrame->aHeap[i] = pFrame->aHeap[parent];
+        i = parent;
+    }
+    pFrame->aHeap[i] = resultIdx;
+}
+
+static int sithCollision_HeapPop(sithCollisionSearchFrame* pFrame)
+{
+    int ret = pFrame->aHeap[0];
+    int last = pFrame->aHeap[--pFrame->numHeap];
+    uint32_t i = 0;
+
+    while (1)
+    {
+        uint32_t child = i * 2 + 1;
+        if (child >= pFrame->numHeap)
+            break;
+        if (child + 1 < pFrame->numHeap && sithCollision_HeapLess(pFrame, pFrame->aHeap[child + 1], pFrame->aHeap[child]))
+            child++;
+        if (!sithCollision_HeapLess(pFrame, pFrame->aHeap[child], last))
+            break;
+        pFrame->aHeap[i] = pFrame->aHeap[child];
+        i = child;
+    }
+    if (pFrame->numHeap)
+        pFrame->aHeap[i] = last;
+    return ret;
+}
+
+// Drops everything after the first numResults results
+static void sithCollision_SetNumSearchResults(uint32_t numResults)
+{
+    sithCollisionSearchFrame* pFrame = sithCollision_GetSearchFrame();
+    if (!pFrame || numResults >= pFrame->numResults)
+        return;
+
+    pFrame->numResults = numResults;
+    if (pFrame->numHeaped > numResults)
+    {
+        pFrame->numHeap = 0;
+        pFrame->numHeaped = 0;
+    }
+}
+#endif
+
+// Added: starts the next level of the search stack with only `sector` in it
+static void sithCollision_PushSearch(sithSector* sector)
+{
+#ifdef QOL_IMPROVEMENTS
+    sithCollisionSearchFrame* pFrame;
+    uint32_t numFrames = sithCollision_numSearchFrames;
+
+    sithCollision_searchStackIdx++;
+    if ( sithCollision_Ensure((void**)&sithCollision_aSearchFrames, &numFrames, sithCollision_searchStackIdx + 1, SITHCOLLISION_SEARCH_MAX_DEPTH, sizeof(sithCollisionSearchFrame)) )
+    {
+        _memset(&sithCollision_aSearchFrames[sithCollision_numSearchFrames], 0, sizeof(sithCollisionSearchFrame) * (numFrames - sithCollision_numSearchFrames));
+        sithCollision_numSearchFrames = numFrames;
+    }
+
+    if ( sithCollision_searchStackIdx >= SITHCOLLISION_SEARCH_MAX_DEPTH )
+        sithCollision_numDepthOverflows++;
+    if ( sithCollision_searchStackIdx + 1 > sithCollision_maxSearchDepth )
+        sithCollision_maxSearchDepth = sithCollision_searchStackIdx + 1;
+
+    pFrame = sithCollision_GetSearchFrame();
+    if ( !pFrame )
+        return;
+
+    pFrame->numResults = 0;
+    pFrame->numHeap = 0;
+    pFrame->numHeaped = 0;
+    pFrame->numSectors = 0;
+    if ( sithCollision_Ensure((void**)&pFrame->apSectors, &pFrame->maxSectors, 1, SITHCOLLISION_SEARCH_MAX_SECTORS, sizeof(sithSector*)) )
+        pFrame->apSectors[pFrame->numSectors++] = sector;
+#else
+    sithCollision_searchStackIdx++;
+    sithCollision_searchNumResults[sithCollision_searchStackIdx] = 0;
+    sithCollision_stackIdk[sithCollision_searchStackIdx] = 1;
+    sithCollision_stackSectors[sithCollision_searchStackIdx].sectors[0] = sector;
+#endif
+}
+
+// Added: returns NULL once the search can't take another result
+static sithCollisionSearchEntry* sithCollision_AddSearchResult()
+{
+#ifdef QOL_IMPROVEMENTS
+    sithCollisionSearchFrame* pFrame = sithCollision_GetSearchFrame();
+    if ( !pFrame )
+        return NULL;
+
+    if ( !sithCollision_Ensure((void**)&pFrame->aResults, &pFrame->maxResults, pFrame->numResults + 1, SITHCOLLISION_SEARCH_MAX_RESULTS, sizeof(sithCollisionSearchEntry)) )
+        return NULL;
+
+    if ( pFrame->numResults >= SITHCOLLISION_SEARCH_MAX_RESULTS )
+        sithCollision_numResultOverflows++;
+    if ( (int)pFrame->numResults + 1 > sithCollision_maxSearchResults )
+        sithCollision_maxSearchResults = pFrame->numResults + 1;
+
+    return &pFrame->aResults[pFrame->numResults++];
+#else
+    int idx = sithCollision_searchNumResults[sithCollision_searchStackIdx];
+    if ( idx == SITHCOLLISION_SEARCH_MAX_RESULTS )
+        return NULL;
+
+    sithCollision_searchNumResults[sithCollision_searchStackIdx] = idx + 1;
+    return &sithCollision_searchStack[sithCollision_searchStackIdx].collisions[idx];
+#endif
+}
+
+static int sithCollision_GetNumSearchResults()
+{
+#ifdef QOL_IMPROVEMENTS
+    sithCollisionSearchFrame* pFrame = sithCollision_GetSearchFrame();
+    return pFrame ? pFrame->numResults : 0;
+#else
+    return sithCollision_searchNumResults[sithCollision_searchStackIdx];
+#endif
+}
+
+// Added: results by the order they were found in. Adding results may move
+// them, don't hold on to the pointer over a search.
+static sithCollisionSearchEntry* sithCollision_GetSearchResult(int idx)
+{
+#ifdef QOL_IMPROVEMENTS
+    return &sithCollision_GetSearchFrame()->aResults[idx];
+#else
+    return &sithCollision_searchStack[sithCollision_searchStackIdx].collisions[idx];
+#endif
+}
+
+static int sithCollision_GetNumSearchSectors()
+{
+#ifdef QOL_IMPROVEMENTS
+    sithCollisionSearchFrame* pFrame = sithCollision_GetSearchFrame();
+    return pFrame ? pFrame->numSectors : 0;
+#else
+    return sithCollision_stackIdk[sithCollision_searchStackIdx];
+#endif
+}
+
+static sithSector* sithCollision_GetSearchSector(int idx)
+{
+#ifdef QOL_IMPROVEMENTS
+    return sithCollision_GetSearchFrame()->apSectors[idx];
+#else
+    return sithCollision_stackSectors[sithCollision_searchStackIdx].sectors[idx];
+#endif
+}
+
+static int sithCollision_HasSearchSector(sithSector* sector)
+{
+    int numSectors = sithCollision_GetNumSearchSectors();
+
+    for (int i = 0; i < numSectors; i++)
+    {
+        if ( sithCollision_GetSearchSector(i) == sector )
+            return 1;
+    }
+    return 0;
+}
+
+// Added: returns 0 once the search can't take another sector
+static int sithCollision_AddSearchSector(sithSector* sector)
+{
+#ifdef QOL_IMPROVEMENTS
+    sithCollisionSearchFrame* pFrame = sithCollision_GetSearchFrame();
+    if ( !pFrame )
+        return 0;
+
+    if ( !sithCollision_Ensure((void**)&pFrame->apSectors, &pFrame->maxSectors, pFrame->numSectors + 1, SITHCOLLISION_SEARCH_MAX_SECTORS, sizeof(sithSector*)) )
+        return 0;
+
+    if ( pFrame->numSectors >= SITHCOLLISION_SEARCH_MAX_SECTORS )
+        sithCollision_numSectorOverflows++;
+    if ( (int)pFrame->numSectors + 1 > sithCollision_maxSearchSectors )
+        sithCollision_maxSearchSectors = pFrame->numSectors + 1;
+
+    pFrame->apSectors[pFrame->numSectors++] = sector;
+    return 1;
+#else
+    int idx = sithCollision_stackIdk[sithCollision_searchStackIdx];
+    if ( idx == SITHCOLLISION_SEARCH_MAX_SECTORS )
+        return 0;
+
+    sithCollision_stackIdk[sithCollision_searchStackIdx] = idx + 1;
+    sithCollision_stackSectors[sithCollision_searchStackIdx].sectors[idx] = sector;
+    return 1;
+#endif
+}
+
+#ifdef QOL_IMPROVEMENTS
+// Added: Same pick as the linear scan below. Results the scan would never
+// return (not closer than 3.4e38) are left out of the heap. Results at the
+// same distance come out of the heap in the order they were found, the scan
+// then prefers one with collideType & 4 over one with collideType & 0x18.
+sithCollisionSearchEntry* sithCollision_NextSearchResult()
+{
+    sithCollisionSearchFrame* pFrame = sithCollision_GetSearchFrame();
+    sithCollisionSearchEntry* retVal = NULL;
+    sithCollisionSearchEntry* iter;
+    int retIdx = -1;
+    uint32_t numTies = 0;
+    int idx;
+
+    if ( !pFrame )
+        return NULL;
+
+    if ( pFrame->numHeaped < pFrame->numResults
+         && sithCollision_Ensure((void**)&pFrame->aHeap, &pFrame->maxHeap, pFrame->numResults, SITHCOLLISION_SEARCH_MAX_RESULTS, sizeof(int)) )
+    {
+        for ( ; pFrame->numHeaped < pFrame->numResults; pFrame->numHeaped++ )
+        {
+            if ( pFrame->aResults[pFrame->numHeaped].distance < 3.4e38 )
+                sithCollision_HeapPush(pFrame, pFrame->numHeaped);
+        }
+    }
+
+    while ( pFrame->numHeap )
+    {
+        iter = &pFrame->aResults[pFrame->aHeap[0]];
+        if ( iter->hasBeenEnumerated )
+        {
+            sithCollision_HeapPop(pFrame);
+            continue;
+        }
+        if ( retVal && iter->distance != retVal->distance )
+            break;
+
+        idx = sithCollision_HeapPop(pFrame);
+        if ( !retVal )
+        {
+            retVal = iter;
+            retIdx = idx;
+        }
+        else
+        {
+            if ( !sithCollision_Ensure((void**)&sithCollision_aTies, &sithCollision_maxTies, numTies + 1, 16, sizeof(int)) )
+            {
+                sithCollision_HeapPush(pFrame, idx);
+                break;
+            }
+
+            if ( retVal->collideType & 0x18 && iter->collideType & 4 ) // TODO enums
+            {
+                sithCollision_aTies[numTies++] = retIdx;
+                retVal = iter;
+                retIdx = idx;
+            }
+            else
+            {
+                sithCollision_aTies[numTies++] = idx;
+            }
+        }
+    }
+    for (uint32_t i = 0; i < numTies; i++)
+        sithCollision_HeapPush(pFrame, sithCollision_aTies[i]);
+
+    if ( retVal )
+    {
+        retVal->hasBeenEnumerated = 1;
+        return retVal;
+    }
+    else
+    {
+        pFrame->numResults = 0;
+        pFrame->numHeap = 0;
+        pFrame->numHeaped = 0;
+        pFrame->numSectors = 0;
+        return NULL;
+    }
+}
+#else
 sithCollisionSearchEntry* sithCollision_NextSearchResult()
 {
     sithCollisionSearchEntry* retVal = NULL;
@@ -102,110 +457,66 @@ sithCollisionSearchEntry* sithCollision_NextSearchResult()
     }
 }
 
+#endif
+
 float sithCollision_SearchRadiusForThings(sithSector *sector, sithThing *a2, const rdVector3 *position, const rdVector3 *direction, float a5, float range, int flags)
 {
-    int v9; // ecx
-    float v10; // eax
     int v11; // ebx
     sithCollisionSearchEntry *i; // ebp
     sithSector *v13; // esi
-    unsigned int v14; // eax
-    unsigned int v15; // edi
-    unsigned int v17; // edx
-    unsigned int v18; // ebp
+    int v17; // edx
+    int v18; // ebp
     sithSector *j; // eax
     sithAdjoin *v20; // ebx
     sithSector *v21; // esi
-    unsigned int v22; // eax
-    unsigned int v23; // edi
-    sithSector *v24; // edx
     float v25; // [esp+10h] [ebp-8h]
-    unsigned int v26; // [esp+10h] [ebp-8h]
     float a1a; // [esp+1Ch] [ebp+4h]
     float a5a; // [esp+2Ch] [ebp+14h]
 
-    sithCollision_searchStackIdx++;
-    sithCollision_searchNumResults[sithCollision_searchStackIdx] = 0;
-    sithCollision_stackIdk[sithCollision_searchStackIdx] = 1;
+    sithCollision_PushSearch(sector);
     v25 = a5;
-    sithCollision_stackSectors[sithCollision_searchStackIdx].sectors[0] = sector;
 
     if ( (flags & 1) == 0 )
         v25 = sithCollision_UpdateSectorThingCollision(sector, a2, position, direction, a5, range, flags);
     sithCollision_sub_4E86D0(sector, position, direction, v25, range, flags);
 
-    v9 = sithCollision_searchStackIdx;
-    v10 = v25;
-    v26 = 0;
-    a5a = v10;
-    v11 = sithCollision_searchStackIdx;
-    for ( i = sithCollision_searchStack[sithCollision_searchStackIdx].collisions; v26 < sithCollision_searchNumResults[v9]; ++v26 )
+    a5a = v25;
+    for ( v11 = 0; v11 < sithCollision_GetNumSearchResults(); ++v11 )
     {
+        i = sithCollision_GetSearchResult(v11);
         if ( i->collideType == 64 )
         {
             if ( (flags & 0x400) != 0 || i->distance <= (double)a5a )
             {
                 v13 = i->surface->adjoin->sector;
                 a1a = a5a;
-                v14 = sithCollision_stackIdk[v11];
-                for (v15 = 0; v15 < v14; v15++)
+                if ( !sithCollision_HasSearchSector(v13) && sithCollision_AddSearchSector(v13) )
                 {
-                    if ( sithCollision_stackSectors[v9].sectors[v15] == v13 )
-                        break;
-                }
-                
-                if ( v15 >= v14 )
-                {
-                    if ( v14 != 64 )
-                    {
-                        sithCollision_stackIdk[v11] = v14 + 1;
-                        sithCollision_stackSectors[v9].sectors[v14] = v13;
-                        if ( (flags & 1) == 0 )
-                            a1a = sithCollision_UpdateSectorThingCollision(v13, a2, position, direction, a5a, range, flags);
-                        sithCollision_sub_4E86D0(v13, position, direction, a1a, range, flags);
-                        v9 = sithCollision_searchStackIdx;
-                        a5a = a1a;
-                    }
+                    if ( (flags & 1) == 0 )
+                        a1a = sithCollision_UpdateSectorThingCollision(v13, a2, position, direction, a5a, range, flags);
+                    sithCollision_sub_4E86D0(v13, position, direction, a1a, range, flags);
+                    a5a = a1a;
                 }
             }
-            i->hasBeenEnumerated = 1;
+
+            // Added: the adjoin sector's results may have moved i
+            sithCollision_GetSearchResult(v11)->hasBeenEnumerated = 1;
         }
-        v11 = v9;
-        ++i;
     }
     if ( a5a != 0.0 && (flags & 0x800) != 0 )
     {
-        v17 = sithCollision_stackIdk[v9];
+        v17 = sithCollision_GetNumSearchSectors();
         for (v18 = 0; v18 < v17; v18++)
         {
-            j = sithCollision_stackSectors[v9].sectors[v18];
+            j = sithCollision_GetSearchSector(v18);
             v20 = j->adjoins;
             while ( v20 )
             {
                 if ( (v20->flags & 2) != 0 )
                 {
                     v21 = v20->sector;
-                    if ( v21->thingsList )
-                    {
-                        v22 = sithCollision_stackIdk[v9];
-                        for (v23 = 0; v23 < v22; v23++)
-                        {
-                            v24 = sithCollision_stackSectors[v9].sectors[v23];
-                            if ( v24 == v21 )
-                                break;
-                        }
-
-                        if ( v23 >= v22 )
-                        {
-                            if ( v22 != 64 )
-                            {
-                                sithCollision_stackIdk[v9] = v22 + 1;
-                                sithCollision_stackSectors[v9].sectors[v22] = v21;
-                                a5a = sithCollision_UpdateSectorThingCollision(v21, a2, position, direction, a5a, range, flags);
-                                v9 = sithCollision_searchStackIdx;
-                            }
-                        }
-                    }
+                    if ( v21->thingsList && !sithCollision_HasSearchSector(v21) && sithCollision_AddSearchSector(v21) )
+                        a5a = sithCollision_UpdateSectorThingCollision(v21, a2, position, direction, a5a, range, flags);
                 }
                 v20 = v20->next;
             }
@@ -219,7 +530,12 @@ void sithCollision_SearchClose()
     --sithCollision_searchStackIdx;
 }
 
+#ifdef QOL_IMPROVEMENTS
+// Added: apThings, when set, replaces the walk over a1->thingsList
+static float sithCollision_CollideSectorThings(sithSector *a1, sithThing *sender, const rdVector3 *a2, const rdVector3 *a3, float a4, float range, int flags, sithThing **apThings, int numThings)
+#else
 float sithCollision_UpdateSectorThingCollision(sithSector *a1, sithThing *sender, const rdVector3 *a2, const rdVector3 *a3, float a4, float range, int flags)
+#endif
 {
     sithThing *v7; // esi
     sithThing *v8; // ebp
@@ -231,7 +547,6 @@ float sithCollision_UpdateSectorThingCollision(sithSector *a1, sithThing *sender
     sithThing *v16; // eax
     int v19; // eax
     rdFace *v21; // ebx
-    int v22; // edx
     float v23; // st7
     sithCollisionSearchEntry *v24; // ecx
     rdMesh *senderMesh; // edx
@@ -244,6 +559,11 @@ float sithCollision_UpdateSectorThingCollision(sithSector *a1, sithThing *sender
     senderMesh = 0;
     a10 = 0;
     v7 = a1->thingsList;
+#ifdef QOL_IMPROVEMENTS
+    int thingIdx = 0;
+    if ( apThings )
+        v7 = numThings ? apThings[0] : NULL;
+#endif
     if ( v7 )
     {
         v8 = sender;
@@ -283,12 +603,10 @@ LABEL_41:
                                     if ( v19 )
                                     {
                                         v21 = a10;
-                                        v22 = sithCollision_searchNumResults[sithCollision_searchStackIdx];
-                                        if ( v22 != 128 )
+                                        v24 = sithCollision_AddSearchResult();
+                                        if ( v24 )
                                         {
                                             v19 |= 1;
-                                            sithCollision_searchNumResults[sithCollision_searchStackIdx] = v22 + 1;
-                                            v24 = &sithCollision_searchStack[sithCollision_searchStackIdx].collisions[v22];
                                             v24->surface = 0;
                                             v24->hasBeenEnumerated = 0;
                                             v24->collideType = v19;
@@ -316,6 +634,11 @@ LABEL_41:
                     }
                 }
             }
+#ifdef QOL_IMPROVEMENTS
+            if ( apThings )
+                v7 = ++thingIdx < numThings ? apThings[thingIdx] : NULL;
+            else
+#endif
             v7 = v7->nextThing;
             if ( !v7 )
                 break;
@@ -324,31 +647,91 @@ LABEL_41:
     return a4;
 }
 
+#ifdef QOL_IMPROVEMENTS
+// Added: Runs the broadphase candidates and the full thingsList walk and
+// compares what they left on the search stack, the thingsList results win.
+static float sithCollision_CheckSectorThings(sithSector *sector, sithThing *sender, const rdVector3 *pos, const rdVector3 *dir, float dist, float range, int flags, sithThing **apThings, int numThings)
+{
+    static sithCollisionSearchEntry* aGridResults = NULL;
+    static uint32_t maxGridResults = 0;
+    int numBefore = sithCollision_GetNumSearchResults();
+    int numGrid, numFull, bMatch;
+    float gridDist, fullDist;
+
+    gridDist = sithCollision_CollideSectorThings(sector, sender, pos, dir, dist, range, flags, apThings, numThings);
+    numGrid = sithCollision_GetNumSearchResults() - numBefore;
+    if ( !sithCollision_Ensure((void**)&aGridResults, &maxGridResults, numGrid, SITHCOLLISION_SEARCH_MAX_RESULTS, sizeof(sithCollisionSearchEntry)) )
+        numGrid = 0;
+    for (int i = 0; i < numGrid; i++)
+        aGridResults[i] = *sithCollision_GetSearchResult(numBefore + i);
+
+    sithCollision_SetNumSearchResults(numBefore);
+    fullDist = sithCollision_CollideSectorThings(sector, sender, pos, dir, dist, range, flags, NULL, 0);
+    numFull = sithCollision_GetNumSearchResults() - numBefore;
+
+    bMatch = (numGrid == numFull && gridDist == fullDist);
+    for (int i = 0; bMatch && i < numFull; i++)
+    {
+        sithCollisionSearchEntry* pGrid = &aGridResults[i];
+        sithCollisionSearchEntry* pFull = sithCollision_GetSearchResult(numBefore + i);
+
+        bMatch = pGrid->collideType == pFull->collideType
+              && pGrid->receiver == pFull->receiver
+              && pGrid->face == pFull->face
+              && pGrid->sender == pFull->sender
+              && pGrid->distance == pFull->distance
+              && !_memcmp(&pGrid->field_14, &pFull->field_14, sizeof(rdVector3));
+    }
+
+    sithCollisionGrid_numChecks++;
+    if (!bMatch)
+    {
+        // Only the first few, a missed hook tends to repeat every frame
+        if (++sithCollisionGrid_numMismatches <= 16)
+        {
+            char tmp[128];
+            stdString_snprintf(tmp, 128, "collisiongrid: mismatch in sector %d, sender %d, %d vs %d hits", sector->id, sender ? sender->thingIdx : -1, numGrid, numFull);
+            DebugConsole_Print(tmp);
+        }
+    }
+
+    return fullDist;
+}
+
+float sithCollision_UpdateSectorThingCollision(sithSector *a1, sithThing *sender, const rdVector3 *a2, const rdVector3 *a3, float a4, float range, int flags)
+{
+    sithThing** apThings;
+    int numThings;
+    float ret;
+
+    numThings = sithCollisionGrid_GetCandidates(a1, a2, a3, a4, range, flags, &apThings);
+    if ( numThings < 0 )
+        return sithCollision_CollideSectorThings(a1, sender, a2, a3, a4, range, flags, NULL, 0);
+
+    if ( sithCollisionGrid_bCheck )
+        ret = sithCollision_CheckSectorThings(a1, sender, a2, a3, a4, range, flags, apThings, numThings);
+    else
+        ret = sithCollision_CollideSectorThings(a1, sender, a2, a3, a4, range, flags, apThings, numThings);
+    sithCollisionGrid_ReleaseCandidates();
+
+    return ret;
+}
+#endif
+
 void sithCollision_sub_4E86D0(sithSector *sector, const rdVector3 *vec1, const rdVector3 *vec2, float a4, float a5, int unk3Flags)
 {
     sithSurface *v12; // esi
     sithAdjoin *v15; // eax
     int v16; // eax
-    unsigned int v17; // ecx
-    unsigned int v18; // edi
-    sithSector **v19; // eax
-    int v20; // ecx
     double v21; // st7
     sithCollisionSearchEntry *v23; // eax
-    int v24; // ecx
-    unsigned int v25; // edi
-    unsigned int v26; // edx
-    sithSector **v27; // eax
-    int v28; // edx
     double v29; // st7
     sithCollisionSearchEntry *v31; // eax
-    int v32; // edx
     double v33; // st7
     sithCollisionSearchEntry *v34; // eax
     rdVector3 *v35; // ecx
     int v36; // ecx
     double v37; // st7
-    int v38; // edx
     sithCollisionSearchEntry *v40; // eax
     int v42; // [esp+0h] [ebp-40h] BYREF
     float a7; // [esp+10h] [ebp-30h] BYREF
@@ -394,11 +777,9 @@ LABEL_46:
                             if ( (unk3Flags & 0x400) != 0 || vec2->y * v52.y + vec2->z * v52.z + vec2->x * v52.x < 0.0 )
                             {
                                 v37 = a7;
-                                v38 = sithCollision_searchNumResults[sithCollision_searchStackIdx];
-                                if ( v38 != 128 )
+                                v40 = sithCollision_AddSearchResult();
+                                if ( v40 )
                                 {
-                                    sithCollision_searchNumResults[sithCollision_searchStackIdx] = v38 + 1;
-                                    v40 = &sithCollision_searchStack[sithCollision_searchStackIdx].collisions[v38];
                                     v40->receiver = 0;
                                     v40->hasBeenEnumerated = 0;
                                     v40->collideType = v36 | 2;
@@ -434,31 +815,13 @@ LABEL_22:
             if ( sithIntersect_sub_5090B0(vec1, vec2, a4, a5, &v12->surfaceInfo, sithWorld_pCurrentWorld->vertices, &a7, unk3Flags) )
             {
                 if ( !v45 || (unk3Flags & 1) == 0 )
-                {;
-                    v17 = 0;
-                    v18 = sithCollision_stackIdk[sithCollision_searchStackIdx];
-                    if ( v18 )
-                    {
-                        v19 = sithCollision_stackSectors[sithCollision_searchStackIdx].sectors;
-                        while ( *v19 != v15->sector )
-                        {
-                            ++v17;
-                            ++v19;
-                            if ( v17 >= v18 )
-                            {
-                                goto LABEL_30;
-                            }
-                        }
-                    }
-                    else
+                {
+                    if ( !sithCollision_HasSearchSector(v15->sector) )
                     {
-LABEL_30:
-                        v20 = sithCollision_searchNumResults[sithCollision_searchStackIdx];
                         v21 = a7;
-                        if ( v20 != 128 )
+                        v23 = sithCollision_AddSearchResult();
+                        if ( v23 )
                         {
-                            sithCollision_searchNumResults[sithCollision_searchStackIdx] = v20 + 1;
-                            v23 = &sithCollision_searchStack[sithCollision_searchStackIdx].collisions[v20];
                             v23->receiver = 0;
                             v23->hasBeenEnumerated = 0;
                             v23->collideType = 64;
@@ -471,31 +834,14 @@ LABEL_30:
                 // Falling?
                 if ( (unk3Flags & 2) == 0 && sithIntersect_sub_5090B0(vec1, vec2, a4, 0.0, &v12->surfaceInfo, sithWorld_pCurrentWorld->vertices, &v48, unk3Flags) )
                 {
-                    v24 = sithCollision_searchStackIdx;
                     if ( v45 && (unk3Flags & 1) != 0 )
                     {
-                        v25 = sithCollision_stackIdk[sithCollision_searchStackIdx];
-                        v26 = 0;
-                        if ( v25 )
-                        {
-                            v27 = sithCollision_stackSectors[sithCollision_searchStackIdx].sectors;
-                            while ( *v27 != v15->sector )
-                            {
-                                ++v26;
-                                ++v27;
-                                if ( v26 >= v25 )
-                                    goto LABEL_42;
-                            }
-                        }
-                        else
+                        if ( !sithCollision_HasSearchSector(v15->sector) )
                         {
-LABEL_42:
-                            v28 = sithCollision_searchNumResults[sithCollision_searchStackIdx];
                             v29 = a7;
-                            if ( v28 != 128 )
+                            v31 = sithCollision_AddSearchResult();
+                            if ( v31 )
                             {
-                                sithCollision_searchNumResults[sithCollision_searchStackIdx] = v28 + 1;
-                                v31 = &sithCollision_searchStack[sithCollision_searchStackIdx].collisions[v28];
                                 v31->receiver = 0;
                                 v31->hasBeenEnumerated = 0;
                                 v31->collideType = 64;
@@ -504,12 +850,10 @@ LABEL_42:
                             }
                         }
                     }
-                    v32 = sithCollision_searchNumResults[v24];
                     v33 = v48;
-                    if ( v32 != 128 )
+                    v34 = sithCollision_AddSearchResult();
+                    if ( v34 )
                     {
-                        sithCollision_searchNumResults[v24] = v32 + 1;
-                        v34 = &sithCollision_searchStack[sithCollision_searchStackIdx].collisions[v32];
                         v34->receiver = 0;
                         v34->hasBeenEnumerated = 0;
                         v34->collideType = 32;
@@ -527,11 +871,7 @@ sithSector* sithCollision_GetSectorLookAt(sithSector *sector, const rdVector3 *a
     double v4; // st6
     sithSector *result; // eax
     int v7; // edi
-    sithCollisionSearchResult *v8; // ebx
     sithCollisionSearchEntry *v9; // edx
-    double v10; // st7
-    sithCollisionSearchEntry *v11; // ecx
-    int v12; // esi
     rdVector3 a1; // [esp+8h] [ebp-Ch] BYREF
     float a3a; // [esp+1Ch] [ebp+8h]
 
@@ -541,44 +881,9 @@ sithSector* sithCollision_GetSectorLookAt(sithSector *sector, const rdVector3 *a
     a3a = rdVector_Normalize3Acc(&a1);
     sithCollision_SearchRadiusForThings(sector, 0, a3, &a1, a3a, a5, 1);
     v7 = sithCollision_searchStackIdx;
-    v8 = &sithCollision_searchStack[sithCollision_searchStackIdx];
     while ( 1 )
     {
-        v9 = 0;
-        v10 = 3.4e38;
-        v11 = (sithCollisionSearchEntry *)v8;
-        if ( sithCollision_searchNumResults[v7] )
-        {
-            v12 = sithCollision_searchNumResults[v7];
-            do
-            {
-                if ( !v11->hasBeenEnumerated )
-                {
-                    if ( v10 <= v11->distance )
-                    {
-                        if ( v10 == v11->distance && (v9->collideType & 0x18) != 0 && (v11->collideType & 4) != 0 )
-                            v9 = v11;
-                    }
-                    else
-                    {
-                        v10 = v11->distance;
-                        v9 = v11;
-                    }
-                }
-                ++v11;
-                --v12;
-            }
-            while ( v12 );
-        }
-        if ( v9 )
-        {
-            v9->hasBeenEnumerated = 1;
-        }
-        else
-        {
-            sithCollision_searchNumResults[v7] = 0;
-            sithCollision_stackIdk[v7] = 0;
-        }
+        v9 = sithCollision_NextSearchResult();
         if ( !v9 )
             break;
         if ( (v9->collideType & 0x20) == 0 )
@@ -641,9 +946,6 @@ float sithCollision_UpdateThingCollision(sithThing *a3, rdVector3 *a2, float a6,
     float v17; // edx
     int v18; // edx
     sithCollisionSearchEntry *v19; // esi
-    double v20; // st7
-    sithCollisionSearchEntry *v21; // ecx
-    int v22; // ebx
     double v23; // st6
     double v24; // st7
     double v25; // st7
@@ -734,41 +1036,7 @@ LABEL_78:
             while ( 1 )
             {
                 v18 = sithCollision_searchStackIdx;
-                v19 = 0;
-                v20 = 3.4e38;
-                v21 = sithCollision_searchStack[sithCollision_searchStackIdx].collisions;
-                if ( sithCollision_searchNumResults[sithCollision_searchStackIdx] )
-                {
-                    v22 = sithCollision_searchNumResults[sithCollision_searchStackIdx];
-                    do
-                    {
-                        if ( !v21->hasBeenEnumerated )
-                        {
-                            if ( v20 <= v21->distance )
-                            {
-                                if ( v20 == v21->distance && (v19->collideType & 0x18) != 0 && (v21->collideType & 4) != 0 )
-                                    v19 = v21;
-                            }
-                            else
-                            {
-                                v20 = v21->distance;
-                                v19 = v21;
-                            }
-                        }
-                        ++v21;
-                        --v22;
-                    }
-                    while ( v22 );
-                }
-                if ( v19 )
-                {
-                    v19->hasBeenEnumerated = 1;
-                }
-                else
-                {
-                    sithCollision_searchNumResults[sithCollision_searchStackIdx] = 0;
-                    sithCollision_stackIdk[v18] = 0;
-                }
+                v19 = sithCollision_NextSearchResult();
                 if ( !v19 )
                     break;
 
@@ -776,6 +1044,7 @@ LABEL_78:
                 {
                     rdVector_Copy3(&v5->position, &posCopy);
                     rdVector_MultAcc3(&v5->position, &direction, v19->distance);
+                    sithCollisionGrid_UpdateThing(v5); // Added
                 }
                 if ( v19->distance >= (double)a6 )
                 {
@@ -850,6 +1119,7 @@ LABEL_78:
                 v44 = v64 + a6;
                 rdVector_Copy3(&v5->position, &posCopy);
                 rdVector_MultAcc3(&v5->position, &direction, a6);
+                sithCollisionGrid_UpdateThing(v5); // Added
                 rdVector_Zero3(&v5->field_268);
                 a6 = 0.0;
                 v64 = v44;
@@ -868,6 +1138,7 @@ LABEL_81:
     if ( v5->collide && v5->moveType == SITH_MT_PHYSICS && !sithIntersect_IsSphereInSector(&v5->position, 0.0, v5->sector) )
     {
         rdVector_Copy3(&v5->position, &posCopy);
+        sithCollisionGrid_UpdateThing(v5); // Added
         rdVector_Copy3(&direction, &out);
         sithThing_MoveToSector(v5, sectTmp, 0);
         if ( v5->lifeLeftMs )
@@ -879,6 +1150,7 @@ LABEL_81:
         {
             rdMatrix_TransformVector34(&i->position, &i->field_4C, &v5->lookOrientation);
             rdVector_Add3Acc(&i->position, &v5->position);
+            sithCollisionGrid_UpdateThing(i); // Added
             if ( i->sector != v5->sector )
                 sithThing_MoveToSector(i, v5->sector, 0);
         }
@@ -1133,11 +1405,7 @@ int sithCollision_HasLos(sithThing *thing1, sithThing *thing2, int flag)
 {
     int v3; // edi
     int v4; // edi
-    sithCollisionSearchEntry *v5; // ebp
-    double v6; // st7
     sithCollisionSearchEntry *v7; // edx
-    sithCollisionSearchEntry *v8; // ecx
-    int v9; // esi
     sithThing *v10; // edx
     int result; // eax
     int v12; // [esp+10h] [ebp-10h]
@@ -1152,44 +1420,9 @@ int sithCollision_HasLos(sithThing *thing1, sithThing *thing2, int flag)
     a6 = rdVector_Normalize3Acc(&a1a);
     sithCollision_SearchRadiusForThings(thing1->sector, 0, &thing1->position, &a1a, a6, 0.0, v3);
     v4 = sithCollision_searchStackIdx;
-    v5 = sithCollision_searchStack[sithCollision_searchStackIdx].collisions;
     while ( 1 )
     {
-        v6 = 3.4e38;
-        v7 = 0;
-        v8 = v5;
-        if ( sithCollision_searchNumResults[v4] )
-        {
-            v9 = sithCollision_searchNumResults[v4];
-            do
-            {
-                if ( !v8->hasBeenEnumerated )
-                {
-                    if ( v6 <= v8->distance )
-                    {
-                        if ( v6 == v8->distance && (v7->collideType & 0x18) != 0 && (v8->collideType & 4) != 0 )
-                            v7 = v8;
-                    }
-                    else
-                    {
-                        v6 = v8->distance;
-                        v7 = v8;
-                    }
-                }
-                ++v8;
-                --v9;
-            }
-            while ( v9 );
-        }
-        if ( v7 )
-        {
-            v7->hasBeenEnumerated = 1;
-        }
-        else
-        {
-            sithCollision_searchNumResults[v4] = 0;
-            sithCollision_stackIdk[v4] = 0;
-        }
+        v7 = sithCollision_NextSearchResult();
         if ( !v7 )
             break;
         if ( (v7->collideType & 1) != 0 )
@@ -27,6 +27,21 @@
 #define sithCollision_FallHurt_ADDR (0x004E9550)
 #define sithCollision_DebrisPlayerCollide_ADDR (0x004E95A0)
 
+// Limits of the original search stack, see sithCollision_searchStack
+#define SITHCOLLISION_SEARCH_MAX_RESULTS (128)
+#define SITHCOLLISION_SEARCH_MAX_SECTORS (64)
+#define SITHCOLLISION_SEARCH_MAX_DEPTH   (4)
+
+#ifdef QOL_IMPROVEMENTS
+// Added: how often a search went past the limits above
+extern uint32_t sithCollision_numResultOverflows;
+extern uint32_t sithCollision_numSectorOverflows;
+extern uint32_t sithCollision_numDepthOverflows;
+extern int sithCollision_maxSearchResults;
+extern int sithCollision_maxSearchSectors;
+extern int sithCollision_maxSearchDepth;
+#endif
+
 int sithCollision_Startup();
 static void (*sithCollision_Shutdown)() = (void*)sithCollision_Shutdown_ADDR;
 void sithCollision_RegisterCollisionHandler(int idxA, int idxB, void* func, void* a4);
@@ -0,0 +1,429 @@
+#include "sithCollisionGrid.h"
+
+#include "World/sithWorld.h"
+#include "World/jkPlayer.h"
+#include "jk.h"
+
+#include <math.h>
+
+#ifdef QOL_IMPROVEMENTS
+
+// Every world thing sitting in a sector is filed in a hash of
+// (sector, cell of its position) chains, or of (sector, LARGE) for things
+// with a collideSize over SITHCOLLISIONGRID_SMALL_SIZE. A query takes the
+// box around the swept sphere of sithIntersect_sub_508540 and gathers the
+// things filed in its cells, so the only things skipped are ones which
+// can't pass that test.
+//
+// The candidates are then visited in the same order as the sector's
+// thingsList, which only ever gets things pushed on its head: every thing
+// gets a sequence number when it enters a sector and the candidates are
+// sorted by it, highest first.
+
+#define SITHCOLLISIONGRID_LARGE_CELL (INT32_MIN)
+#define SITHCOLLISIONGRID_CELL_CLAMP (1000000.0f)
+#define SITHCOLLISIONGRID_EPSILON    (0.001f)
+
+typedef struct sithCollisionGridEntry
+{
+    sithSector* sector; // NULL if not filed
+    uint32_t seq;
+    int32_t cell[3];
+    uint32_t bucket;
+    int prev;
+    int next;
+} sithCollisionGridEntry;
+
+int sithCollisionGrid_bCheck = 0;
+uint32_t sithCollisionGrid_numChecks = 0;
+uint32_t sithCollisionGrid_numMismatches = 0;
+
+static int sithCollisionGrid_bValid = 0;
+static sithWorld* sithCollisionGrid_pWorld = NULL;
+static sithThing* sithCollisionGrid_pThings = NULL;
+static sithWorld* sithCollisionGrid_pFailedWorld = NULL;
+static sithCollisionGridEntry* sithCollisionGrid_aEntries = NULL;
+static int* sithCollisionGrid_aBuckets = NULL; // thing idx, -1 if empty
+static uint32_t sithCollisionGrid_bucketMask = 0;
+static int* sithCollisionGrid_aSectorCounts = NULL;
+static uint32_t sithCollisionGrid_seq = 0;
+static sithThing** sithCollisionGrid_apCandidates = NULL;
+static int sithCollisionGrid_bCandidatesInUse = 0;
+
+static int32_t sithCollisionGrid_Cell(float val)
+{
+    float cell = val * (float)(1.0 / SITHCOLLISIONGRID_CELL_SIZE);
+
+    // Also catches NaN
+    if (!(cell > -SITHCOLLISIONGRID_CELL_CLAMP))
+        cell = -SITHCOLLISIONGRID_CELL_CLAMP;
+    else if (cell > SITHCOLLISIONGRID_CELL_CLAMP)
+        cell = SITHCOLLISIONGRID_CELL_CLAMP;
+
+    return (int32_t)floorf(cell);
+}
+
+static uint32_t sithCollisionGrid_Hash(int sectorIdx, const int32_t *cell)
+{
+    uint32_t hash = (uint32_t)sectorIdx * 0x9E3779B1u;
+
+    hash ^= (uint32_t)cell[0] * 0x85EBCA77u;
+    hash ^= (uint32_t)cell[1] * 0xC2B2AE3Du;
+    hash ^= (uint32_t)cell[2] * 0x27D4EB2Fu;
+    hash ^= hash >> 15;
+    return hash & sithCollisionGrid_bucketMask;
+}
+
+static void sithCollisionGrid_Link(int idx, sithThing *thing)
+{
+    sithCollisionGridEntry* entry = &sithCollisionGrid_aEntries[idx];
+    int sectorIdx = entry->sector - sithCollisionGrid_pWorld->sectors;
+
+    if (thing->collideSize > SITHCOLLISIONGRID_SMALL_SIZE)
+    {
+        entry->cell[0] = SITHCOLLISIONGRID_LARGE_CELL;
+        entry->cell[1] = SITHCOLLISIONGRID_LARGE_CELL;
+        entry->cell[2] = SITHCOLLISIONGRID_LARGE_CELL;
+    }
+    else
+    {
+        entry->cell[0] = sithCollisionGrid_Cell(thing->position.x);
+        entry->cell[1] = sithCollisionGrid_Cell(thing->position.y);
+        entry->cell[2] = sithCollisionGrid_Cell(thing->position.z);
+    }
+
+    entry->bucket = sithCollisionGrid_Hash(sectorIdx, entry->cell);
+    entry->prev = -1;
+    entry->next = sithCollisionGrid_aBuckets[entry->bucket];
+    if (entry->next >= 0)
+        sithCollisionGrid_aEntries[entry->next].prev = idx;
+    sithCollisionGrid_aBuckets[entry->bucket] = idx;
+}
+
+static void sithCollisionGrid_Unlink(int idx)
+{
+    sithCollisionGridEntry* entry = &sithCollisionGrid_aEntries[idx];
+
+    if (entry->prev >= 0)
+        sithCollisionGrid_aEntries[entry->prev].next = entry->next;
+    else
+        sithCollisionGrid_aBuckets[entry->bucket] = entry->next;
+    if (entry->next >= 0)
+        sithCollisionGrid_aEntries[entry->next].prev = entry->prev;
+
+    entry->prev = -1;
+    entry->next = -1;
+}
+
+static int sithCollisionGrid_GetIdx(sithThing *thing)
+{
+    int idx;
+
+    if (!sithCollisionGrid_bValid
+        || sithCollisionGrid_pWorld != sithWorld_pCurrentWorld
+        || sithCollisionGrid_pThings != sithWorld_pCurrentWorld->things)
+        return -1;
+
+    idx = thing->thingIdx;
+    if (idx < 0 || idx >= sithCollisionGrid_pWorld->numThingsLoaded || &sithCollisionGrid_pThings[idx] != thing)
+        return -1;
+
+    return idx;
+}
+
+void sithCollisionGrid_Reset()
+{
+    if (sithCollisionGrid_aEntries)
+        pSithHS->free(sithCollisionGrid_aEntries);
+    if (sithCollisionGrid_aBuckets)
+        pSithHS->free(sithCollisionGrid_aBuckets);
+    if (sithCollisionGrid_aSectorCounts)
+        pSithHS->free(sithCollisionGrid_aSectorCounts);
+    if (sithCollisionGrid_apCandidates)
+        pSithHS->free(sithCollisionGrid_apCandidates);
+
+    sithCollisionGrid_aEntries = NULL;
+    sithCollisionGrid_aBuckets = NULL;
+    sithCollisionGrid_aSectorCounts = NULL;
+    sithCollisionGrid_apCandidates = NULL;
+    sithCollisionGrid_bucketMask = 0;
+    sithCollisionGrid_seq = 0;
+    sithCollisionGrid_bValid = 0;
+    sithCollisionGrid_pWorld = NULL;
+    sithCollisionGrid_pThings = NULL;
+    sithCollisionGrid_pFailedWorld = NULL;
+    sithCollisionGrid_bCandidatesInUse = 0;
+}
+
+static void sithCollisionGrid_Rebuild()
+{
+    sithWorld* world = sithWorld_pCurrentWorld;
+    uint32_t numBuckets = 64;
+    sithThing* iter;
+    int num, idx;
+
+    sithCollisionGrid_Reset();
+    if (!world || !world->things || !world->sectors || world->numThingsLoaded <= 0)
+        return;
+
+    while (numBuckets < (uint32_t)world->numThingsLoaded * 2)
+        numBuckets <<= 1;
+
+    sithCollisionGrid_aEntries = (sithCollisionGridEntry*)pSithHS->alloc(sizeof(sithCollisionGridEntry) * world->numThingsLoaded);
+    sithCollisionGrid_aBuckets = (int*)pSithHS->alloc(sizeof(int) * numBuckets);
+    sithCollisionGrid_aSectorCounts = (int*)pSithHS->alloc(sizeof(int) * (world->numSectors + 1));
+    sithCollisionGrid_apCandidates = (sithThing**)pSithHS->alloc(sizeof(sithThing*) * world->numThingsLoaded);
+    if (!sithCollisionGrid_aEntries || !sithCollisionGrid_aBuckets || !sithCollisionGrid_aSectorCounts || !sithCollisionGrid_apCandidates)
+        goto fail;
+
+    _memset(sithCollisionGrid_aEntries, 0, sizeof(sithCollisionGridEntry) * world->numThingsLoaded);
+    _memset(sithCollisionGrid_aBuckets, 0xFF, sizeof(int) * numBuckets);
+    _memset(sithCollisionGrid_aSectorCounts, 0, sizeof(int) * (world->numSectors + 1));
+    sithCollisionGrid_bucketMask = numBuckets - 1;
+    sithCollisionGrid_pWorld = world;
+    sithCollisionGrid_pThings = world->things;
+    sithCollisionGrid_bValid = 1;
+
+    for (int i = 0; i < world->numSectors; i++)
+    {
+        sithSector* sector = &world->sectors[i];
+
+        num = 0;
+        for (iter = sector->thingsList; iter; iter = iter->nextThing)
+            num++;
+
+        for (iter = sector->thingsList; iter; iter = iter->nextThing)
+        {
+            idx = sithCollisionGrid_GetIdx(iter);
+            if (idx < 0 || sithCollisionGrid_aEntries[idx].sector)
+                goto fail;
+
+            sithCollisionGrid_aEntries[idx].sector = sector;
+            sithCollisionGrid_aEntries[idx].seq = sithCollisionGrid_seq + num--;
+            sithCollisionGrid_Link(idx, iter);
+            sithCollisionGrid_aSectorCounts[i]++;
+        }
+        sithCollisionGrid_seq += sithCollisionGrid_aSectorCounts[i];
+    }
+    return;
+
+fail:
+    // Leave this world to the thingsList walk
+    sithCollisionGrid_Reset();
+    sithCollisionGrid_pFailedWorld = world;
+}
+
+void sithCollisionGrid_AddThing(sithThing *thing)
+{
+    sithCollisionGridEntry* entry;
+    int idx = sithCollisionGrid_GetIdx(thing);
+
+    if (idx < 0 || !thing->sector)
+        return;
+
+    entry = &sithCollisionGrid_aEntries[idx];
+    if (entry->sector)
+    {
+        sithCollisionGrid_Unlink(idx);
+        sithCollisionGrid_aSectorCounts[entry->sector - sithCollisionGrid_pWorld->sectors]--;
+    }
+
+    // Sequence numbers ran out, number them all again on the next query
+    if (++sithCollisionGrid_seq == 0)
+    {
+        sithCollisionGrid_bValid = 0;
+        return;
+    }
+
+    entry->sector = thing->sector;
+    entry->seq = sithCollisionGrid_seq;
+    sithCollisionGrid_Link(idx, thing);
+    sithCollisionGrid_aSectorCounts[entry->sector - sithCollisionGrid_pWorld->sectors]++;
+}
+
+void sithCollisionGrid_RemoveThing(sithThing *thing)
+{
+    sithCollisionGridEntry* entry;
+    int idx = sithCollisionGrid_GetIdx(thing);
+
+    if (idx < 0)
+        return;
+
+    entry = &sithCollisionGrid_aEntries[idx];
+    if (!entry->sector)
+        return;
+
+    sithCollisionGrid_Unlink(idx);
+    sithCollisionGrid_aSectorCounts[entry->sector - sithCollisionGrid_pWorld->sectors]--;
+    entry->sector = NULL;
+}
+
+void sithCollisionGrid_UpdateThing(sithThing *thing)
+{
+    sithCollisionGridEntry* entry;
+    int32_t cell[3];
+    int idx = sithCollisionGrid_GetIdx(thing);
+
+    if (idx < 0)
+        return;
+
+    entry = &sithCollisionGrid_aEntries[idx];
+    if (!entry->sector)
+        return;
+
+    // Sectors only change through sithThing_EnterSector/LeaveSector, if
+    // that didn't hold the order is lost too
+    if (entry->sector != thing->sector)
+    {
+        sithCollisionGrid_bValid = 0;
+        return;
+    }
+
+    if (thing->collideSize > SITHCOLLISIONGRID_SMALL_SIZE)
+    {
+        cell[0] = SITHCOLLISIONGRID_LARGE_CELL;
+        cell[1] = SITHCOLLISIONGRID_LARGE_CELL;
+        cell[2] = SITHCOLLISIONGRID_LARGE_CELL;
+    }
+    else
+    {
+        cell[0] = sithCollisionGrid_Cell(thing->position.x);
+        cell[1] = sithCollisionGrid_Cell(thing->position.y);
+        cell[2] = sithCollisionGrid_Cell(thing->position.z);
+    }
+
+    if (cell[0] == entry->cell[0] && cell[1] == entry->cell[1] && cell[2] == entry->cell[2])
+        return;
+
+    sithCollisionGrid_Unlink(idx);
+    sithCollisionGrid_Link(idx, thing);
+}
+
+static int sithCollisionGrid_GatherCell(sithSector *sector, int sectorIdx, const int32_t *cell, int numCandidates)
+{
+    sithCollisionGridEntry* entry;
+    int idx = sithCollisionGrid_aBuckets[sithCollisionGrid_Hash(sectorIdx, cell)];
+
+    for (; idx >= 0; idx = entry->next)
+    {
+        entry = &sithCollisionGrid_aEntries[idx];
+        if (entry->sector != sector || entry->cell[0] != cell[0] || entry->cell[1] != cell[1] || entry->cell[2] != cell[2])
+            continue;
+
+        // Wiped or moved without going through the hooks
+        if (sithCollisionGrid_pThings[idx].sector != sector)
+            return -1;
+
+        sithCollisionGrid_apCandidates[numCandidates++] = &sithCollisionGrid_pThings[idx];
+    }
+    return numCandidates;
+}
+
+// Returns the things in sector which may pass the sphere test of
+// sithIntersect_sub_508540 for this sweep, in thingsList order, or -1 if
+// the caller should walk thingsList itself. Must be paired with
+// sithCollisionGrid_ReleaseCandidates.
+int sithCollisionGrid_GetCandidates(sithSector *sector, const rdVector3 *pos, const rdVector3 *dir, float dist, float range, int flags, sithThing ***papOut)
+{
+    sithWorld* world = sithWorld_pCurrentWorld;
+    int32_t cellMin[3], cellMax[3], cell[3];
+    float reach, sweep, lo, hi;
+    int sectorIdx, numCandidates, numCells;
+
+    if (sithCollisionGrid_bCandidatesInUse)
+        return -1;
+
+    if (!jkPlayer_enableCollisionGrid)
+    {
+        if (sithCollisionGrid_aEntries || sithCollisionGrid_pFailedWorld)
+            sithCollisionGrid_Reset();
+        return -1;
+    }
+
+    // With 0x400 a search handler may push the sweep further than it started
+    if ((flags & 0x400) || !world)
+        return -1;
+
+    if (!sithCollisionGrid_bValid || sithCollisionGrid_pWorld != world || sithCollisionGrid_pThings != world->things)
+    {
+        if (sithCollisionGrid_pFailedWorld == world)
+            return -1;
+        sithCollisionGrid_Rebuild();
+        if (!sithCollisionGrid_bValid)
+            return -1;
+    }
+
+    sectorIdx = sector - world->sectors;
+    if (sectorIdx < 0 || sectorIdx >= world->numSectors)
+        return -1;
+    if (sithCollisionGrid_aSectorCounts[sectorIdx] < SITHCOLLISIONGRID_MIN_THINGS)
+        return -1;
+
+    // A hit is within collideSize + range of the sweep, and the sweep runs
+    // at most dist + collideSize + range along dir
+    reach = range + SITHCOLLISIONGRID_SMALL_SIZE + SITHCOLLISIONGRID_EPSILON;
+    sweep = dist + range + SITHCOLLISIONGRID_SMALL_SIZE;
+    numCells = 1;
+    for (int i = 0; i < 3; i++)
+    {
+        float start = (&pos->x)[i];
+        float end = start + (&dir->x)[i] * sweep;
+
+        lo = (start < end ? start : end) - reach;
+        hi = (start < end ? end : start) + reach;
+        cellMin[i] = sithCollisionGrid_Cell(lo);
+        cellMax[i] = sithCollisionGrid_Cell(hi);
+        if (cellMax[i] - cellMin[i] >= SITHCOLLISIONGRID_MAX_CELLS)
+            return -1;
+
+        numCells *= cellMax[i] - cellMin[i] + 1;
+        if (numCells > SITHCOLLISIONGRID_MAX_CELLS)
+            return -1;
+    }
+
+    cell[0] = SITHCOLLISIONGRID_LARGE_CELL;
+    cell[1] = SITHCOLLISIONGRID_LARGE_CELL;
+    cell[2] = SITHCOLLISIONGRID_LARGE_CELL;
+    numCandidates = sithCollisionGrid_GatherCell(sector, sectorIdx, cell, 0);
+
+    for (cell[2] = cellMin[2]; cell[2] <= cellMax[2] && numCandidates >= 0; cell[2]++)
+    {
+        for (cell[1] = cellMin[1]; cell[1] <= cellMax[1] && numCandidates >= 0; cell[1]++)
+        {
+            for (cell[0] = cellMin[0]; cell[0] <= cellMax[0] && numCandidates >= 0; cell[0]++)
+                numCandidates = sithCollisionGrid_GatherCell(sector, sectorIdx, cell, numCandidates);
+        }
+    }
+
+    if (numCandidates < 0)
+    {
+        sithCollisionGrid_bValid = 0;
+        return -1;
+    }
+
+    // Highest sequence first, like thingsList
+    for (int i = 1; i < numCandidates; i++)
+    {
+        sithThing* pThing = sithCollisionGrid_apCandidates[i];
+        uint32_t seq = sithCollisionGrid_aEntries[pThing->thingIdx].seq;
+        int j = i - 1;
+
+        while (j >= 0 && sithCollisionGrid_aEntries[sithCollisionGrid_apCandidates[j]->thingIdx].seq < seq)
+        {
+            sithCollisionGrid_apCandidates[j + 1] = sithCollisionGrid_apCandidates[j];
+            j--;
+        }
+        sithCollisionGrid_apCandidates[j + 1] = pThing;
+    }
+
+    sithCollisionGrid_bCandidatesInUse = 1;
+    *papOut = sithCollisionGrid_apCandidates;
+    return numCandidates;
+}
+
+void sithCollisionGrid_ReleaseCandidates()
+{
+    sithCollisionGrid_bCandidatesInUse = 0;
+}
+
+#endif // QOL_IMPROVEMENTS
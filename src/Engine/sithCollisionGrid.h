@@ -0,0 +1,35 @@
+#ifndef _SITHCOLLISIONGRID_H
+#define _SITHCOLLISIONGRID_H
+
+#include "types.h"
+#include "globals.h"
+
+// Added: Broadphase for sithCollision_UpdateSectorThingCollision in crowded
+// sectors, see jkPlayer_enableCollisionGrid. Things are filed by sector and
+// by the grid cell of their position, and kept up to date wherever a thing
+// enters or leaves a sector, moves or changes size.
+
+#define SITHCOLLISIONGRID_CELL_SIZE   (0.5)
+#define SITHCOLLISIONGRID_SMALL_SIZE  (0.1)  // bigger things are always candidates
+#define SITHCOLLISIONGRID_MIN_THINGS  (16)   // smaller sectors walk thingsList
+#define SITHCOLLISIONGRID_MAX_CELLS   (27)   // bigger queries walk thingsList
+
+#ifdef QOL_IMPROVEMENTS
+extern int sithCollisionGrid_bCheck;
+extern uint32_t sithCollisionGrid_numChecks;
+extern uint32_t sithCollisionGrid_numMismatches;
+
+void sithCollisionGrid_Reset();
+void sithCollisionGrid_AddThing(sithThing *thing);
+void sithCollisionGrid_RemoveThing(sithThing *thing);
+void sithCollisionGrid_UpdateThing(sithThing *thing);
+int sithCollisionGrid_GetCandidates(sithSector *sector, const rdVector3 *pos, const rdVector3 *dir, float dist, float range, int flags, sithThing ***papOut);
+void sithCollisionGrid_ReleaseCandidates();
+#else
+#define sithCollisionGrid_Reset() do {} while (0)
+#define sithCollisionGrid_AddThing(thing) do {} while (0)
+#define sithCollisionGrid_RemoveThing(thing) do {} while (0)
+#define sithCollisionGrid_UpdateThing(thing) do {} while (0)
+#endif
+
+#endif // _SITHCOLLISIONGRID_H
@@ -9,6 +9,8 @@
 #include "World/sithThing.h"
 #include "World/sithActor.h"
 #include "Engine/sithIntersect.h"
+#include "Engine/rdLight.h"
+#include "stdPlatform.h"
 #include "jk.h"
 
 #define sithDebugConsole_CmdTick ((void*)sithDebugConsole_CmdTick_ADDR)
@@ -59,6 +61,9 @@ void sithDebugConsole_Initialize()
         DebugConsole_RegisterDevCmd(sithDebugConsole_CmdActivate, "activate", 0);
         DebugConsole_RegisterDevCmd(sithDebugConsole_CheatSetDebugFlags, "slowmo", 7);
         DebugConsole_RegisterDevCmd(sithDebugConsole_CmdJump, "jump", 0);
+
+        // Added: vertex lighting benchmark
+        DebugConsole_RegisterDevCmd(sithDebugConsole_CmdLightBench, "lightbench", 0);
     }
 }
 
@@ -280,4 +285,117 @@ int sithDebugConsole_CmdJump(stdDebugConsoleCmd *pCmd, const char *pArgStr)
         result = 1;
     }
     return result;
-}
\ No newline at end of file
+}
+
+// Added: Times rdLight_CalcVertexIntensities' original loop against the
+// batched one on a random mesh, and reports the largest difference.
+static float sithDebugConsole_BenchRand(uint32_t *pSeed, float lo, float hi)
+{
+    *pSeed = *pSeed * 1664525 + 1013904223;
+    return lo + (hi - lo) * ((*pSeed >> 8) * (1.0 / 16777216.0));
+}
+
+static uint64_t sithDebugConsole_BenchTimeUs()
+{
+#ifdef PLATFORM_POSIX
+    return Linux_TimeUs();
+#else
+    return (uint64_t)stdPlatform_GetTimeMsec() * 1000;
+#endif
+}
+
+int sithDebugConsole_CmdLightBench(stdDebugConsoleCmd *pCmd, const char *pArgStr)
+{
+    int numVertices = 1024;
+    int numLights = 8;
+    int numIters = 200;
+    uint32_t seed = 1;
+    uint64_t scalarUs, batchUs, startUs;
+    float maxDiff = 0.0;
+    rdLight* aLights;
+    rdLight** apLights;
+    rdVector3* aLightPos;
+    rdVector3* aVertices;
+    rdVector3* aNormals;
+    float* aBase;
+    float* aScalar;
+    float* aBatch;
+
+    if ( pArgStr )
+        _sscanf(pArgStr, "%d %d %d", &numVertices, &numLights, &numIters);
+    if ( numVertices <= 0 || numLights <= 0 || numIters <= 0 )
+    {
+        DebugConsole_Print("Format: LIGHTBENCH [vertices] [lights] [iterations]");
+        return 0;
+    }
+
+    aLights = (rdLight*)pSithHS->alloc(sizeof(rdLight) * numLights);
+    apLights = (rdLight**)pSithHS->alloc(sizeof(rdLight*) * numLights);
+    aLightPos = (rdVector3*)pSithHS->alloc(sizeof(rdVector3) * numLights);
+    aVertices = (rdVector3*)pSithHS->alloc(sizeof(rdVector3) * numVertices);
+    aNormals = (rdVector3*)pSithHS->alloc(sizeof(rdVector3) * numVertices);
+    aBase = (float*)pSithHS->alloc(sizeof(float) * numVertices);
+    aScalar = (float*)pSithHS->alloc(sizeof(float) * numVertices);
+    aBatch = (float*)pSithHS->alloc(sizeof(float) * numVertices);
+    if ( !aLights || !apLights || !aLightPos || !aVertices || !aNormals || !aBase || !aScalar || !aBatch )
+    {
+        DebugConsole_Print("Out of memory.");
+        numIters = 0;
+    }
+
+    if ( numIters )
+    {
+        for (int i = 0; i < numLights; i++)
+        {
+            rdLight_NewEntry(&aLights[i]);
+            aLights[i].intensity = sithDebugConsole_BenchRand(&seed, 0.1, 0.5);
+            aLights[i].falloffMin = sithDebugConsole_BenchRand(&seed, 0.5, 2.0);
+            apLights[i] = &aLights[i];
+            aLightPos[i].x = sithDebugConsole_BenchRand(&seed, -1.5, 1.5);
+            aLightPos[i].y = sithDebugConsole_BenchRand(&seed, -1.5, 1.5);
+            aLightPos[i].z = sithDebugConsole_BenchRand(&seed, -1.5, 1.5);
+        }
+        for (int i = 0; i < numVertices; i++)
+        {
+            aVertices[i].x = sithDebugConsole_BenchRand(&seed, -0.5, 0.5);
+            aVertices[i].y = sithDebugConsole_BenchRand(&seed, -0.5, 0.5);
+            aVertices[i].z = sithDebugConsole_BenchRand(&seed, -0.5, 0.5);
+            aNormals[i].x = sithDebugConsole_BenchRand(&seed, -1.0, 1.0);
+            aNormals[i].y = sithDebugConsole_BenchRand(&seed, -1.0, 1.0);
+            aNormals[i].z = sithDebugConsole_BenchRand(&seed, -1.0, 1.0);
+            rdVector_Normalize3Acc(&aNormals[i]);
+            aBase[i] = sithDebugConsole_BenchRand(&seed, 0.0, 0.5);
+        }
+
+        startUs = sithDebugConsole_BenchTimeUs();
+        for (int i = 0; i < numIters; i++)
+            rdLight_CalcVertexIntensitiesScalar(apLights, aLightPos, numLights, aNormals, aVertices, aBase, aScalar, numVertices, 0.1);
+        scalarUs = sithDebugConsole_BenchTimeUs() - startUs;
+
+        startUs = sithDebugConsole_BenchTimeUs();
+        for (int i = 0; i < numIters; i++)
+            rdLight_CalcVertexIntensities(apLights, aLightPos, numLights, aNormals, aVertices, aBase, aBatch, numVertices, 0.1);
+        batchUs = sithDebugConsole_BenchTimeUs() - startUs;
+
+        for (int i = 0; i < numVertices; i++)
+        {
+            float diff = aScalar[i] > aBatch[i] ? aScalar[i] - aBatch[i] : aBatch[i] - aScalar[i];
+            if ( diff > maxDiff )
+                maxDiff = diff;
+        }
+
+        _sprintf(std_genBuffer, "%d verts x %d lights x %d: scalar %uus, batched %uus, max diff %g",
+                 numVertices, numLights, numIters, (uint32_t)scalarUs, (uint32_t)batchUs, maxDiff);
+        DebugConsole_Print(std_genBuffer);
+    }
+
+    if ( aLights ) pSithHS->free(aLights);
+    if ( apLights ) pSithHS->free(apLights);
+    if ( aLightPos ) pSithHS->free(aLightPos);
+    if ( aVertices ) pSithHS->free(aVertices);
+    if ( aNormals ) pSithHS->free(aNormals);
+    if ( aBase ) pSithHS->free(aBase);
+    if ( aScalar ) pSithHS->free(aScalar);
+    if ( aBatch ) pSithHS->free(aBatch);
+    return numIters != 0;
+}
@@ -31,5 +31,6 @@ int sithDebugConsole_CmdFly();
 int sithDebugConsole_CmdWarp(stdDebugConsoleCmd *pCmd, const char *pArgStr);
 int sithDebugConsole_CmdActivate(stdDebugConsoleCmd *pCmd, const char *pArgStr);
 int sithDebugConsole_CmdJump(stdDebugConsoleCmd *pCmd, const char *pArgStr);
+int sithDebugConsole_CmdLightBench(stdDebugConsoleCmd *pCmd, const char *pArgStr);
 
 #endif // _SITHDEBUGCONSOLE_H
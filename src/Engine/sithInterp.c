@@ -0,0 +1,168 @@
+#include "sithInterp.h"
+
+#include "World/sithWorld.h"
+#include "Primitives/rdVector.h"
+#include "Primitives/rdMatrix.h"
+#include "jk.h"
+
+#ifdef QOL_IMPROVEMENTS
+
+typedef struct sithInterpThing
+{
+    uint32_t signature; // thing the previous pose belongs to, 0 if none
+    int bApplied;
+    rdVector3 prevPos;
+    rdMatrix34 prevOrient;
+    rdVector3 savedPos; // simulated pose, while a blend stands in for it
+    rdMatrix34 savedOrient;
+} sithInterpThing;
+
+static sithWorld* sithInterp_pWorld = NULL;
+static sithThing* sithInterp_pThings = NULL;
+static sithInterpThing* sithInterp_aThings = NULL;
+static int sithInterp_numThings = 0;
+static int sithInterp_bApplied = 0;
+static int sithInterp_applyEnd = 0;
+
+void sithInterp_Reset()
+{
+    if (sithInterp_aThings)
+        pSithHS->free(sithInterp_aThings);
+
+    sithInterp_aThings = NULL;
+    sithInterp_numThings = 0;
+    sithInterp_pWorld = NULL;
+    sithInterp_pThings = NULL;
+    sithInterp_bApplied = 0;
+    sithInterp_applyEnd = 0;
+}
+
+// Blends the orientation and the translation in scale. Returns 0 and copies b
+// when the two are too far apart to be one step's movement.
+int sithInterp_LerpMatrix(rdMatrix34 *out, const rdMatrix34 *a, const rdMatrix34 *b, float alpha)
+{
+    rdVector3 delta;
+
+    rdVector_Sub3(&delta, &b->scale, &a->scale);
+    if (rdVector_Len3(&delta) > SITHINTERP_MAX_MOVE
+        || rdVector_Dot3(&a->lvec, &b->lvec) < SITHINTERP_MIN_DOT
+        || rdVector_Dot3(&a->rvec, &b->rvec) < SITHINTERP_MIN_DOT)
+    {
+        *out = *b;
+        return 0;
+    }
+
+    out->scale = a->scale;
+    rdVector_MultAcc3(&out->scale, &delta, alpha);
+
+    rdVector_Sub3(&delta, &b->rvec, &a->rvec);
+    out->rvec = a->rvec;
+    rdVector_MultAcc3(&out->rvec, &delta, alpha);
+
+    rdVector_Sub3(&delta, &b->lvec, &a->lvec);
+    out->lvec = a->lvec;
+    rdVector_MultAcc3(&out->lvec, &delta, alpha);
+
+    // rdMatrix_Normalize34 rebuilds uvec from rvec and lvec
+    rdMatrix_Normalize34(out);
+    return 1;
+}
+
+// Called before each fixed step
+void sithInterp_SaveThings()
+{
+    sithWorld* world = sithWorld_pCurrentWorld;
+
+    if (!world || !world->things || world->numThingsLoaded <= 0)
+        return;
+
+    if (world != sithInterp_pWorld || world->things != sithInterp_pThings || world->numThingsLoaded != sithInterp_numThings)
+    {
+        sithInterp_Reset();
+        sithInterp_aThings = (sithInterpThing*)pSithHS->alloc(sizeof(sithInterpThing) * world->numThingsLoaded);
+        if (!sithInterp_aThings)
+            return;
+        _memset(sithInterp_aThings, 0, sizeof(sithInterpThing) * world->numThingsLoaded);
+        sithInterp_numThings = world->numThingsLoaded;
+        sithInterp_pWorld = world;
+        sithInterp_pThings = world->things;
+    }
+
+    for (int i = 0; i < world->numThings + 1 && i < sithInterp_numThings; i++)
+    {
+        sithThing* thing = &world->things[i];
+        sithInterpThing* pInterp = &sithInterp_aThings[i];
+
+        if (!thing->type)
+        {
+            pInterp->signature = 0;
+            continue;
+        }
+
+        pInterp->signature = thing->signature;
+        pInterp->prevPos = thing->position;
+        pInterp->prevOrient = thing->lookOrientation;
+    }
+}
+
+// Swaps every thing's simulated pose for the blend drawn this frame, until
+// sithInterp_RestoreThings
+void sithInterp_ApplyThings(float alpha)
+{
+    sithWorld* world = sithWorld_pCurrentWorld;
+    rdMatrix34 prev, cur, blend;
+
+    if (sithInterp_bApplied || !world || world != sithInterp_pWorld || world->things != sithInterp_pThings)
+        return;
+
+    sithInterp_applyEnd = world->numThings + 1;
+    if (sithInterp_applyEnd > sithInterp_numThings)
+        sithInterp_applyEnd = sithInterp_numThings;
+
+    for (int i = 0; i < sithInterp_applyEnd; i++)
+    {
+        sithThing* thing = &world->things[i];
+        sithInterpThing* pInterp = &sithInterp_aThings[i];
+
+        if (!thing->type || !pInterp->signature || pInterp->signature != thing->signature)
+            continue;
+
+        pInterp->savedPos = thing->position;
+        pInterp->savedOrient = thing->lookOrientation;
+        pInterp->bApplied = 1;
+
+        prev = pInterp->prevOrient;
+        prev.scale = pInterp->prevPos;
+        cur = thing->lookOrientation;
+        cur.scale = thing->position;
+        sithInterp_LerpMatrix(&blend, &prev, &cur, alpha);
+
+        thing->position = blend.scale;
+        thing->lookOrientation.rvec = blend.rvec;
+        thing->lookOrientation.lvec = blend.lvec;
+        thing->lookOrientation.uvec = blend.uvec;
+    }
+    sithInterp_bApplied = 1;
+}
+
+void sithInterp_RestoreThings()
+{
+    if (!sithInterp_bApplied)
+        return;
+    sithInterp_bApplied = 0;
+
+    for (int i = 0; i < sithInterp_applyEnd; i++)
+    {
+        sithThing* thing = &sithInterp_pThings[i];
+        sithInterpThing* pInterp = &sithInterp_aThings[i];
+
+        if (!pInterp->bApplied)
+            continue;
+
+        thing->position = pInterp->savedPos;
+        thing->lookOrientation = pInterp->savedOrient;
+        pInterp->bApplied = 0;
+    }
+}
+
+#endif // QOL_IMPROVEMENTS
@@ -0,0 +1,25 @@
+#ifndef _SITHINTERP_H
+#define _SITHINTERP_H
+
+#include "types.h"
+#include "globals.h"
+
+// Added: Render side interpolation for fixed rate ticking, see
+// jkPlayer_simRate. Every thing's position and lookOrientation are recorded
+// before each step, and while a frame is drawn they're swapped for a blend
+// of that and the simulated pose, sithTime_fixedAlpha of the way along.
+
+#define SITHINTERP_MAX_MOVE (2.0) // further in one step is a teleport, and snaps
+#define SITHINTERP_MIN_DOT  (0.0) // so is turning more than 90 degrees
+
+#ifdef QOL_IMPROVEMENTS
+void sithInterp_Reset();
+void sithInterp_SaveThings();
+void sithInterp_ApplyThings(float alpha);
+void sithInterp_RestoreThings();
+int sithInterp_LerpMatrix(rdMatrix34 *out, const rdMatrix34 *a, const rdMatrix34 *b, float alpha);
+#else
+#define sithInterp_Reset() do {} while (0)
+#endif
+
+#endif // _SITHINTERP_H
@@ -6,6 +6,7 @@
 #include "Engine/sithAdjoin.h"
 #include "Engine/sithSurface.h"
 #include "Primitives/rdFace.h"
+#include "Primitives/rdModel3.h"
 #include "World/sithSector.h"
 #include "World/sithWorld.h"
 #include "World/sithThing.h"
@@ -511,6 +512,72 @@ int sithIntersect_sub_5090B0(const rdVector3 *a1, const rdVector3 *a2, float a3,
     return 0;
 }
 
+#ifdef QOL_IMPROVEMENTS
+// Added: sithIntersect_sub_508400 over only the faces mesh->pFaceBvh finds
+// near the sweep. A face can only be hit within a4 of a point a4 from the
+// sweep, so nothing further than 2 * a4 is skipped. The faces are still tried
+// in mesh order.
+//
+// The full loop leaves *a6 at whatever the last face to pass the plane test
+// in sithIntersect_sub_508BE0 wrote, hit or not, and sithIntersect_sub_5080D0
+// passes that on. That face is found walking back from the end of the mesh,
+// with a3 as it was when the full loop got to it.
+static int sithIntersect_CollideMeshFaces(rdVector3 *a1, rdVector3 *a2, float a3, float a4, rdMesh *mesh, float *a6, rdFace **faceOut, rdVector3 *a8)
+{
+    int aFaces[RDMESHBVH_MAX_FACES];
+    int aHitFaces[RDMESHBVH_MAX_FACES];
+    float aHitDists[RDMESHBVH_MAX_FACES];
+    int numFaces, numHits;
+    int ret, v11;
+    float startDist, minDot, planeDist, faceDist;
+    rdFace* face;
+    rdVector3 a8a;
+
+    numFaces = rdMeshBvh_FindFaces(mesh->pFaceBvh, a1, a2, a3, a4 * 2.0 + 0.001, aFaces);
+
+    startDist = a3;
+    ret = 0;
+    minDot = 1.0;
+    numHits = 0;
+    for (int i = 0; i < numFaces; i++)
+    {
+        face = &mesh->faces[aFaces[i]];
+        v11 = sithIntersect_sub_508D20(a1, a2, a3, a4, face, mesh->vertices, a6, &a8a, 0);
+        if ( v11
+          && (*a6 < (double)a3
+           || ret != 4 && v11 == 4
+           || rdVector_Dot3(a2, &face->normal) < minDot) )
+        {
+            ret = v11;
+            rdVector_Copy3(a8, &a8a);
+            a3 = *a6;
+            *faceOut = face;
+            minDot = (a2->z * face->normal.z) + (a2->y * face->normal.y) + (face->normal.x * a2->x);
+
+            aHitFaces[numHits] = aFaces[i];
+            aHitDists[numHits] = a3;
+            numHits++;
+        }
+    }
+
+    for (int i = mesh->numFaces - 1; i >= 0; i--)
+    {
+        while ( numHits && aHitFaces[numHits - 1] >= i )
+            numHits--;
+
+        planeDist = numHits ? aHitDists[numHits - 1] : startDist;
+        face = &mesh->faces[i];
+        if ( sithIntersect_sub_508BE0(a1, a2, planeDist, a4, &face->normal, &mesh->vertices[*face->vertexPosIdx], &faceDist, 0) )
+        {
+            *a6 = faceDist;
+            break;
+        }
+    }
+
+    return ret;
+}
+#endif
+
 int sithIntersect_sub_508400(rdVector3 *a1, rdVector3 *a2, float a3, float a4, rdMesh *mesh, float *a6, rdFace **faceOut, rdVector3 *a8)
 {
     float *v10; // ebp
@@ -522,6 +589,11 @@ int sithIntersect_sub_508400(rdVector3 *a1, rdVector3 *a2, float a3, float a4, r
     int v26; // [esp+10h] [ebp-10h]
     rdVector3 a8a; // [esp+14h] [ebp-Ch] BYREF
 
+#ifdef QOL_IMPROVEMENTS
+    if ( mesh->pFaceBvh )
+        return sithIntersect_CollideMeshFaces(a1, a2, a3, a4, mesh, a6, faceOut, a8);
+#endif
+
     v24 = 0;
     v25 = 1.0;
     v26 = 0;
@@ -18,18 +18,50 @@
 #include "Engine/rdCache.h"
 #include "Engine/rdClip.h"
 #include "Engine/rdCamera.h"
+#include "Engine/rdPuppet.h"
+#include "Engine/sithRenderInstance.h"
+#include "Engine/sithRenderLight.h"
 #include "Engine/sithRenderSky.h"
+#include "Engine/sithRenderStatic.h"
 #include "General/stdMath.h"
+#include "General/stdProfiler.h"
 #include "Primitives/rdFace.h"
 #include "Primitives/rdModel3.h"
 #include "Primitives/rdPrimit3.h"
 #include "World/jkPlayer.h"
 #include "World/sithPlayer.h"
+#include "World/sithPVS.h"
 #include "World/sithSector.h"
 #include "World/sithWorld.h"
 #include "Platform/std3D.h"
 
 #ifdef QOL_IMPROVEMENTS
+// Added: the original array only has room for 0x20, see jkPlayer_maxDynamicLights
+static rdLight sithRender_aLightsExt[SITHREND_MAX_LIGHTS];
+static rdLight* sithRender_pLights = sithRender_aLightsExt;
+static int sithRender_maxLights = SITHREND_NUM_LIGHTS;
+#else
+static rdLight* sithRender_pLights = sithRender_aLights;
+static int sithRender_maxLights = SITHREND_NUM_LIGHTS;
+#endif
+
+#ifdef QOL_IMPROVEMENTS
+// Added: grows instead of dropping translucent surfaces past the original 0x20
+static sithSurface** sithRender_pAlphaSurfaces = NULL;
+static int sithRender_maxAlphaSurfaces = 0;
+#else
+static sithSurface** sithRender_pAlphaSurfaces = sithRender_aSurfaces;
+static int sithRender_maxAlphaSurfaces = 32;
+#endif
+
+#ifdef QOL_IMPROVEMENTS
+#ifdef SDL2_RENDER
+static int sithRender_bInstanceThings = 0;
+static rdThing** sithRender_apPoseThings = NULL;
+static rdMatrix34* sithRender_aPoseMatrices = NULL;
+static size_t sithRender_maxPoseThings = 0;
+#endif
+
 static rdThing* lightDebugThing = NULL;
 static rdModel3* lightDebugThing_model3 = NULL;
 static rdMatrix34 lightDebugThing_mat;
@@ -140,15 +172,19 @@ int sithRender_Open()
     sithRender_lightMode = 3;
     sithRender_texMode = 1;
 
-    for (int i = 0; i < SITHREND_NUM_LIGHTS; i++)
+    for (int i = 0; i < SITHREND_MAX_LIGHTS; i++)
     {
-        rdLight_NewEntry(&sithRender_aLights[i]);
+        rdLight_NewEntry(&sithRender_pLights[i]);
     }
 
     rdColormap_SetCurrent(sithWorld_pCurrentWorld->colormaps);
     rdColormap_SetIdentity(sithWorld_pCurrentWorld->colormaps);
 
     sithRenderSky_Open(sithWorld_pCurrentWorld->horizontalPixelsPerRev, sithWorld_pCurrentWorld->horizontalDistance, sithWorld_pCurrentWorld->ceilingSky);
+    sithRenderLight_Open(sithWorld_pCurrentWorld);
+#ifdef SDL2_RENDER
+    sithRenderStatic_Open(sithWorld_pCurrentWorld);
+#endif
 
     sithRender_lightingIRMode = 0; 
     sithRender_needsAspectReset = 0;
@@ -172,6 +208,25 @@ void sithRender_Close()
     rdThing_Free(lightDebugThing);
 
     sithRenderSky_Close();
+    sithRenderLight_Close();
+#ifdef SDL2_RENDER
+    sithRenderStatic_Close();
+    sithRenderInstance_Close();
+
+    if (sithRender_apPoseThings)
+        pSithHS->free(sithRender_apPoseThings);
+    if (sithRender_aPoseMatrices)
+        pSithHS->free(sithRender_aPoseMatrices);
+    sithRender_apPoseThings = NULL;
+    sithRender_aPoseMatrices = NULL;
+    sithRender_maxPoseThings = 0;
+#endif
+#ifdef QOL_IMPROVEMENTS
+    if (sithRender_pAlphaSurfaces)
+        pSithHS->free(sithRender_pAlphaSurfaces);
+    sithRender_pAlphaSurfaces = NULL;
+    sithRender_maxAlphaSurfaces = 0;
+#endif
 }
 
 void sithRender_Shutdown()
@@ -307,6 +362,13 @@ void sithRender_Draw()
         sithRender_numSectors = 0;
         sithRender_numSectors2 = 0;
         sithRender_numLights = 0;
+#ifdef QOL_IMPROVEMENTS
+        sithRender_maxLights = jkPlayer_maxDynamicLights;
+        if (sithRender_maxLights < DYNAMIC_LIGHTS_MIN)
+            sithRender_maxLights = DYNAMIC_LIGHTS_MIN;
+        else if (sithRender_maxLights > SITHREND_MAX_LIGHTS)
+            sithRender_maxLights = SITHREND_MAX_LIGHTS;
+#endif
         sithRender_numClipFrustums = 0;
         sithRender_numSurfaces = 0;
         sithRender_82F4B4 = 0;
@@ -314,29 +376,66 @@ void sithRender_Draw()
         sithRender_831984 = 0;
         sithRender_831980 = 0;
         rdCamera_ClearLights(rdCamera_pCurCamera);
+        stdProfiler_Begin(STDPROFILER_ZONE_CLIP);
         sithRender_Clip(sithCamera_currentCamera->sector, rdCamera_pCurCamera->cameraClipFrustum, 0.0);
+        stdProfiler_End(STDPROFILER_ZONE_CLIP);
         
 #ifdef QOL_IMPROVEMENTS
         sithRender_RenderDebugLights();
 #endif
 
+        stdProfiler_Begin(STDPROFILER_ZONE_LIGHTS);
         sithRender_UpdateAllLights();
         
         if ( (sithRender_flag & 2) != 0 )
             sithRender_RenderDynamicLights();
+        stdProfiler_End(STDPROFILER_ZONE_LIGHTS);
         
+        stdProfiler_Begin(STDPROFILER_ZONE_GEOMETRY);
         sithRender_RenderLevelGeometry();
+        stdProfiler_End(STDPROFILER_ZONE_GEOMETRY);
 
+        stdProfiler_Begin(STDPROFILER_ZONE_RENDERTHINGS);
         if ( sithRender_numSectors2 )
             sithRender_RenderThings();
+        stdProfiler_End(STDPROFILER_ZONE_RENDERTHINGS);
 
+        stdProfiler_Begin(STDPROFILER_ZONE_ALPHA);
         if ( sithRender_numSurfaces )
             sithRender_RenderAlphaSurfaces();
+        stdProfiler_End(STDPROFILER_ZONE_ALPHA);
 
         rdSetCullFlags(3);
     }
 }
 
+// Added: transforms a newly visible sector's vertices in batches instead of one
+// at a time from each surface. Vertices shared with sectors already visited
+// this frame are skipped via alloc_unk98, same as the per-surface loops.
+static void sithRender_TransformSectorVertices(sithSector *sector)
+{
+    int aStale[256];
+    int numStale = 0;
+
+    for (uint32_t i = 0; i < sector->numVertices; i++)
+    {
+        int idx = sector->verticeIdxs[i];
+        if ( sithWorld_pCurrentWorld->alloc_unk98[idx] == sithRender_lastRenderTick )
+            continue;
+
+        sithWorld_pCurrentWorld->alloc_unk98[idx] = sithRender_lastRenderTick;
+        aStale[numStale++] = idx;
+        if ( numStale == 256 )
+        {
+            rdMatrix_TransformPointIdxLst34(&rdCamera_pCurCamera->view_matrix, sithWorld_pCurrentWorld->vertices, sithWorld_pCurrentWorld->verticesTransformed, aStale, numStale);
+            numStale = 0;
+        }
+    }
+
+    if ( numStale )
+        rdMatrix_TransformPointIdxLst34(&rdCamera_pCurCamera->view_matrix, sithWorld_pCurrentWorld->vertices, sithWorld_pCurrentWorld->verticesTransformed, aStale, numStale);
+}
+
 void sithRender_Clip(sithSector *sector, rdClipFrustum *frustumArg, float a3)
 {
     //sithRender_Clip_(sector, frustumArg, a3);
@@ -369,6 +468,7 @@ void sithRender_Clip(sithSector *sector, rdClipFrustum *frustumArg, float a3)
             return;
 
         sithRender_aSectors[sithRender_numSectors++] = sector;
+        sithRender_TransformSectorVertices(sector);
         if ( (sector->flags & SITH_SF_AUTOMAPVISIBLE) == 0 )
         {
             sector->flags |= SITH_SF_AUTOMAPVISIBLE;
@@ -382,7 +482,7 @@ void sithRender_Clip(sithSector *sector, rdClipFrustum *frustumArg, float a3)
         lightIdx = sithRender_numLights;
         while ( thing )
         {
-            if ( lightIdx >= 0x20 )
+            if ( lightIdx >= sithRender_maxLights )
                 break;
 
             // Debug, add extra light from player
@@ -391,8 +491,8 @@ void sithRender_Clip(sithSector *sector, rdClipFrustum *frustumArg, float a3)
             {
                 rdMatrix_TransformPoint34(&vertex_out, &thing->actorParams.lightOffset, &thing->lookOrientation);
                 rdVector_Add3Acc(&vertex_out, &thing->position);
-                sithRender_aLights[sithRender_numLights].intensity = 1.0;//thing->actorParams.lightIntensity;
-                rdCamera_AddLight(rdCamera_pCurCamera, &sithRender_aLights[sithRender_numLights], &vertex_out);
+                sithRender_pLights[sithRender_numLights].intensity = 1.0;//thing->actorParams.lightIntensity;
+                rdCamera_AddLight(rdCamera_pCurCamera, &sithRender_pLights[sithRender_numLights], &vertex_out);
                 lightIdx = ++sithRender_numLights;
             }
 #endif
@@ -402,25 +502,25 @@ void sithRender_Clip(sithSector *sector, rdClipFrustum *frustumArg, float a3)
             {
                 if ( thing->light > 0.0 )
                 {
-                    sithRender_aLights[lightIdx].intensity = thing->light;
-                    rdCamera_AddLight(rdCamera_pCurCamera, &sithRender_aLights[lightIdx], &thing->position);
+                    sithRender_pLights[lightIdx].intensity = thing->light;
+                    rdCamera_AddLight(rdCamera_pCurCamera, &sithRender_pLights[lightIdx], &thing->position);
                     lightIdx = ++sithRender_numLights;
                 }
 
-                if ( (thing->type == SITH_THING_ACTOR || thing->type == SITH_THING_PLAYER) && lightIdx < 0x20 )
+                if ( (thing->type == SITH_THING_ACTOR || thing->type == SITH_THING_PLAYER) && lightIdx < sithRender_maxLights )
                 {
                     if ( (thing->actorParams.typeflags & THING_TYPEFLAGS_DAMAGE) != 0 && thing->actorParams.lightIntensity > 0.0 )
                     {
                         rdMatrix_TransformPoint34(&vertex_out, &thing->actorParams.lightOffset, &thing->lookOrientation);
                         rdVector_Add3Acc(&vertex_out, &thing->position);
-                        sithRender_aLights[sithRender_numLights].intensity = thing->actorParams.lightIntensity;
-                        rdCamera_AddLight(rdCamera_pCurCamera, &sithRender_aLights[sithRender_numLights], &vertex_out);
+                        sithRender_pLights[sithRender_numLights].intensity = thing->actorParams.lightIntensity;
+                        rdCamera_AddLight(rdCamera_pCurCamera, &sithRender_pLights[sithRender_numLights], &vertex_out);
                         lightIdx = ++sithRender_numLights;
                     }
                     if ( thing->actorParams.timeLeftLengthChange > 0.0 )
                     {
-                        sithRender_aLights[lightIdx].intensity = thing->actorParams.timeLeftLengthChange;
-                        rdCamera_AddLight(rdCamera_pCurCamera, &sithRender_aLights[lightIdx], &thing->actorParams.saberBladePos);
+                        sithRender_pLights[lightIdx].intensity = thing->actorParams.timeLeftLengthChange;
+                        rdCamera_AddLight(rdCamera_pCurCamera, &sithRender_pLights[lightIdx], &thing->actorParams.saberBladePos);
                         lightIdx = ++sithRender_numLights;
                     }
                 }
@@ -444,6 +544,13 @@ void sithRender_Clip(sithSector *sector, rdClipFrustum *frustumArg, float a3)
             continue;
         }
 
+        // Added: nothing past this adjoin can be seen from the camera's sector
+        if (!sithPVS_IsVisible(sithCamera_currentCamera->sector, adjoinIter->sector))
+        {
+            adjoinIter = adjoinIter->next;
+            continue;
+        }
+
         adjoinSurface = adjoinIter->surface;
         adjoinMat = adjoinSurface->surfaceInfo.face.material;
         if ( adjoinMat )
@@ -534,6 +641,23 @@ void sithRender_Clip(sithSector *sector, rdClipFrustum *frustumArg, float a3)
     sector->field_90 = v45;
 }
 
+// Added: returns 0 if the alpha surface list can't take another entry
+static int sithRender_GrowAlphaSurfaces()
+{
+#ifdef QOL_IMPROVEMENTS
+    int newMax = sithRender_maxAlphaSurfaces ? sithRender_maxAlphaSurfaces * 2 : 64;
+    sithSurface** pNew = (sithSurface**)pSithHS->realloc(sithRender_pAlphaSurfaces, sizeof(sithSurface*) * newMax);
+    if (!pNew)
+        return 0;
+
+    sithRender_pAlphaSurfaces = pNew;
+    sithRender_maxAlphaSurfaces = newMax;
+    return 1;
+#else
+    return 0;
+#endif
+}
+
 void sithRender_RenderLevelGeometry()
 {
     rdVector2 *vertices_uvs; // edx
@@ -595,6 +719,15 @@ void sithRender_RenderLevelGeometry()
     {
         rdSetZBufferMethod(2);
     }
+#ifdef SDL2_RENDER
+    else
+    {
+        // Added: the native rasterizer has a real depth buffer and there
+        // is no rdActive span buffer without JK.EXE
+        rdSetZBufferMethod(2);
+        rdSetOcclusionMethod(0);
+    }
+#else
     else
     {
         rdSetZBufferMethod(1);
@@ -603,6 +736,7 @@ void sithRender_RenderLevelGeometry()
         else
             rdSetOcclusionMethod(1);
     }
+#endif
     rdSetSortingMethod(0);
 
     vertices_uvs = sithWorld_pCurrentWorld->vertexUVs;
@@ -611,6 +745,10 @@ void sithRender_RenderLevelGeometry()
     sithRender_idxInfo.extraUV = vertices_uvs;
     v77 = rdCamera_pCurCamera->cameraClipFrustum;
 
+#ifdef SDL2_RENDER
+    int bStaticGeometry = sithRenderStatic_BeginFrame();
+#endif
+
     for (v72 = 0; v72 < sithRender_numSectors; v72++)
     {
         level_idk = sithRender_aSectors[v72];
@@ -671,13 +809,19 @@ void sithRender_RenderLevelGeometry()
 
             if ( v65->adjoin && surfaceMat && ((v65->surfaceInfo.face.type & 2) != 0 || (v10->header.texture_type & 8) != 0 && (v10->texture_ptr->alpha_en & 1) != 0) )
             {
-                if (sithRender_numSurfaces < 32)
+                if (sithRender_numSurfaces < sithRender_maxAlphaSurfaces || sithRender_GrowAlphaSurfaces())
                 {
-                    sithRender_aSurfaces[sithRender_numSurfaces++] = v65;
+                    sithRender_pAlphaSurfaces[sithRender_numSurfaces++] = v65;
                 }
                 continue;
             }
 
+#ifdef SDL2_RENDER
+            // Added: Resident surfaces are transformed and clipped on the GPU
+            if ( bStaticGeometry && sithRenderStatic_AddSurface(level_idk, v65) )
+                continue;
+#endif
+
             if ( v65->field_4 != sithRender_lastRenderTick )
             {
                 for (int j = 0; j < v65->surfaceInfo.face.numVertices; j++)
@@ -1052,6 +1196,10 @@ LABEL_150:
         ++sithRender_surfacesDrawn;
     }
 
+#ifdef SDL2_RENDER
+    if ( bStaticGeometry )
+        sithRenderStatic_Draw();
+#endif
     rdCache_Flush();
     rdCamera_pCurCamera->cameraClipFrustum = v77;
 }
@@ -1083,11 +1231,11 @@ void sithRender_UpdateLights(sithSector *sector, float prev, float dist)
         return;
 
     sector->field_8C = sithRender_lastRenderTick;
-    if ( prev < 2.0 && sithRender_numLights < 0x20)
+    if ( prev < 2.0 && sithRender_numLights < sithRender_maxLights)
     {
         for ( i = sector->thingsList; i; i = i->nextThing )
         {
-            if ( sithRender_numLights >= 0x20 )
+            if ( sithRender_numLights >= sithRender_maxLights )
                 break;
 
             if ((i->thingflags & SITH_TF_LIGHT) 
@@ -1095,12 +1243,12 @@ void sithRender_UpdateLights(sithSector *sector, float prev, float dist)
             {
                 if ( i->light > 0.0 )
                 {
-                    sithRender_aLights[sithRender_numLights].intensity = i->light;
-                    rdCamera_AddLight(rdCamera_pCurCamera, &sithRender_aLights[sithRender_numLights], &i->position);
+                    sithRender_pLights[sithRender_numLights].intensity = i->light;
+                    rdCamera_AddLight(rdCamera_pCurCamera, &sithRender_pLights[sithRender_numLights], &i->position);
                     ++sithRender_numLights;
                 }
 
-                if ( (i->type == SITH_THING_ACTOR || i->type == SITH_THING_PLAYER) && sithRender_numLights < 0x20 )
+                if ( (i->type == SITH_THING_ACTOR || i->type == SITH_THING_PLAYER) && sithRender_numLights < sithRender_maxLights )
                 {
                     // Actors all have a small amount of light
                     if ( (i->actorParams.typeflags & THING_TYPEFLAGS_DAMAGE) && i->actorParams.lightIntensity > 0.0 )
@@ -1108,16 +1256,16 @@ void sithRender_UpdateLights(sithSector *sector, float prev, float dist)
                         rdMatrix_TransformPoint34(&vertex_out, &i->actorParams.lightOffset, &i->lookOrientation);
                         rdVector_Add3Acc(&vertex_out, &i->position);
                         
-                        sithRender_aLights[sithRender_numLights].intensity = i->actorParams.lightIntensity;
-                        rdCamera_AddLight(rdCamera_pCurCamera, &sithRender_aLights[sithRender_numLights], &vertex_out);
+                        sithRender_pLights[sithRender_numLights].intensity = i->actorParams.lightIntensity;
+                        rdCamera_AddLight(rdCamera_pCurCamera, &sithRender_pLights[sithRender_numLights], &vertex_out);
                         ++sithRender_numLights;
                     }
                     
                     // Saber light
                     if ( i->actorParams.timeLeftLengthChange > 0.0 )
                     {
-                        sithRender_aLights[sithRender_numLights].intensity = i->actorParams.timeLeftLengthChange;
-                        rdCamera_AddLight(rdCamera_pCurCamera, &sithRender_aLights[sithRender_numLights], &i->actorParams.saberBladePos);
+                        sithRender_pLights[sithRender_numLights].intensity = i->actorParams.timeLeftLengthChange;
+                        rdCamera_AddLight(rdCamera_pCurCamera, &sithRender_pLights[sithRender_numLights], &i->actorParams.saberBladePos);
                         ++sithRender_numLights;
                     }
                 }
@@ -1176,6 +1324,10 @@ void sithRender_RenderDynamicLights()
             }
         }
 
+        // Added: only evaluate lights which can reach each vertex group
+        if (sithRenderLight_LightSector(sectorIter, tmpLights, numSectorLights))
+            continue;
+
         for (int j = 0; j < sectorIter->numVertices; j++)
         {
             int idx = sectorIter->verticeIdxs[j];
@@ -1202,6 +1354,65 @@ void sithRender_RenderDynamicLights()
     }
 }
 
+#ifdef SDL2_RENDER
+// Added: evaluates the poses of every puppeted model sithRender_RenderThings
+// is about to draw in one go, so rdModel3_Draw finds them already built
+static void sithRender_BuildThingPoses()
+{
+    size_t numThings = 0;
+
+    for (int i = 0; i < sithRender_numSectors2; i++)
+    {
+        sithSector* sector = sithRender_aSectors2[i];
+
+        for (sithThing* thing = sector->thingsList; thing; thing = thing->nextThing)
+        {
+            rdVector3 screenPos;
+
+            if ( (thing->thingflags & (SITH_TF_DISABLED|SITH_TF_10|SITH_TF_WILLBEREMOVED|SITH_TF_LEVELGEO)) != 0 )
+                continue;
+            if ( (sithCamera_currentCamera->cameraPerspective & 0xFC) == 0 && thing == sithCamera_currentCamera->primaryFocus )
+                continue;
+            if ( thing->rdthing.type != RD_THINGTYPE_MODEL || !thing->rdthing.puppet || thing->rdthing.field_18 || !thing->rdthing.hierarchyNodeMatrices )
+                continue;
+            if ( thing->rdthing.frameTrue == rdroid_frameTrue )
+                continue;
+
+            rdMatrix_TransformPoint34(&screenPos, &thing->position, &rdCamera_pCurCamera->view_matrix);
+            if ( rdClip_SphereInFrustrum(sector->clipFrustum, &screenPos, thing->rdthing.model3->radius) == 2 )
+                continue;
+
+            if ( numThings >= sithRender_maxPoseThings )
+            {
+                size_t newMax = sithRender_maxPoseThings ? sithRender_maxPoseThings * 2 : 64;
+                rdThing** apNewThings = (rdThing**)pSithHS->realloc(sithRender_apPoseThings, sizeof(rdThing*) * newMax);
+                rdMatrix34* aNewMatrices;
+
+                // Out of memory, whatever isn't built here is built when it's drawn
+                if ( !apNewThings )
+                    goto build;
+                sithRender_apPoseThings = apNewThings;
+
+                aNewMatrices = (rdMatrix34*)pSithHS->realloc(sithRender_aPoseMatrices, sizeof(rdMatrix34) * newMax);
+                if ( !aNewMatrices )
+                    goto build;
+                sithRender_aPoseMatrices = aNewMatrices;
+                sithRender_maxPoseThings = newMax;
+            }
+
+            // Same placement sithRender_RenderPov hands to rdThing_Draw
+            sithRender_apPoseThings[numThings] = &thing->rdthing;
+            sithRender_aPoseMatrices[numThings] = thing->lookOrientation;
+            sithRender_aPoseMatrices[numThings].scale = thing->position;
+            numThings++;
+        }
+    }
+
+build:
+    rdPuppet_BuildJointMatricesMulti(sithRender_apPoseThings, sithRender_aPoseMatrices, numThings);
+}
+#endif
+
 void sithRender_RenderThings()
 {
     uint32_t v0; // edi
@@ -1224,6 +1435,14 @@ void sithRender_RenderThings()
 
     rdSetZBufferMethod(2);
     rdSetOcclusionMethod(0);
+#ifdef SDL2_RENDER
+    // Added: unanimated models drawn instanced after the flush
+    sithRender_bInstanceThings = sithRenderInstance_BeginFrame();
+
+    // Added
+    if ( jkPlayer_enableParallelPoses )
+        sithRender_BuildThingPoses();
+#endif
     v0 = 0;
     for ( i = 0; v0 < sithRender_numSectors2; i = v0 )
     {
@@ -1409,6 +1628,11 @@ LABEL_77:
         ++v0;
     }
     rdCache_Flush();
+#ifdef SDL2_RENDER
+    if ( sithRender_bInstanceThings )
+        sithRenderInstance_Draw();
+    sithRender_bInstanceThings = 0;
+#endif
 }
 
 int sithRender_RenderPov(sithThing *povThing)
@@ -1431,6 +1655,12 @@ int sithRender_RenderPov(sithThing *povThing)
     }
     povThing->isVisible = bShowInvisibleThings;
     povThing->lookOrientation.scale = povThing->position;
+#ifdef SDL2_RENDER
+    // Added: instanced models
+    if ( sithRender_bInstanceThings && sithRenderInstance_AddThing(povThing) )
+        ret = 1;
+    else
+#endif
     ret = rdThing_Draw(&povThing->rdthing, &povThing->lookOrientation);
     povThing->lookOrientation.scale.x = 0.0;
     povThing->lookOrientation.scale.y = 0.0;
@@ -1472,7 +1702,7 @@ void sithRender_RenderAlphaSurfaces()
 
     for (int i = 0; i < sithRender_numSurfaces; i++)
     {
-        v0 = sithRender_aSurfaces[i];
+        v0 = sithRender_pAlphaSurfaces[i];
         v1 = v0->parent_sector;
         surfaceSector = v1;
         if ( sithRender_lightingIRMode )
@@ -54,6 +54,11 @@ int sithRender_SetRenderWeaponHandle(void *a1);
 void sithRender_RenderDebugLight(float intensity, rdVector3* pos);
 
 #define SITHREND_NUM_LIGHTS (32)
+#ifdef QOL_IMPROVEMENTS
+#define SITHREND_MAX_LIGHTS (64) // rdCamera's limit
+#else
+#define SITHREND_MAX_LIGHTS SITHREND_NUM_LIGHTS
+#endif
 
 static void (*sithRender_Clip_)(sithSector *sector, rdClipFrustum *frustumArg, float a3) = (void*)sithRender_Clip_ADDR;
 static void (*sithRender_UpdateLights_)(sithSector *sector, float a2, float dist) = (void*)sithRender_UpdateLights_ADDR;
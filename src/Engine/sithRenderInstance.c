@@ -0,0 +1,681 @@
+#include "sithRenderInstance.h"
+
+#include "Engine/rdroid.h"
+#include "Engine/rdCache.h"
+#include "Engine/rdCamera.h"
+#include "Engine/rdMaterial.h"
+#include "Engine/rdPuppet.h"
+#include "Engine/sithRenderStatic.h"
+#include "General/stdMath.h"
+#include "World/jkPlayer.h"
+#include "Platform/std3D.h"
+#include "jk.h"
+
+#ifdef SDL2_RENDER
+
+// Every mesh of a registered model owns one resident vertex per face vertex,
+// like sithRenderStatic's surfaces. Vertex light and UVs are the same for
+// every instance of a mesh, so they're written once per frame and each
+// instance only adds a matrix, the sector tint and its ambient light.
+//
+// Instances of a mesh share the vertex light baked for the first one drawn
+// each frame, anything which would need different vertex light (dynamic
+// lights in reach, a puppet, amputated joints) goes through rdModel3_Draw.
+
+typedef struct sithRenderInstanceMesh
+{
+    rdMesh* mesh;
+    uint32_t firstVertex;
+    uint32_t numVertices;
+    uint32_t lastFrame;
+    int lightMode;
+    uint32_t firstTri; // this frame's tris
+    uint32_t numTris;
+    uint32_t numInstances;
+} sithRenderInstanceMesh;
+
+typedef struct sithRenderInstanceModel
+{
+    rdModel3* model;
+    int bEligible;
+    uint32_t aFirstMesh[4]; // per geoset
+} sithRenderInstanceModel;
+
+typedef struct sithRenderInstanceEntry
+{
+    uint32_t meshIdx;
+    std3DInstance instance;
+} sithRenderInstanceEntry;
+
+static sithRenderInstanceModel* sithRenderInstance_aModels = NULL;
+static uint32_t sithRenderInstance_numModels = 0;
+static uint32_t sithRenderInstance_maxModels = 0;
+static int* sithRenderInstance_aModelHash = NULL; // model idx + 1, open addressing
+static uint32_t sithRenderInstance_modelHashSize = 0;
+
+static sithRenderInstanceMesh* sithRenderInstance_aMeshes = NULL;
+static uint32_t sithRenderInstance_numMeshes = 0;
+static uint32_t sithRenderInstance_maxMeshes = 0;
+
+static rdVector3* sithRenderInstance_aVertices = NULL;
+static uint32_t sithRenderInstance_numVertices = 0;
+static uint32_t sithRenderInstance_maxVertices = 0;
+static int sithRenderInstance_bDirty = 0;
+
+static uint32_t sithRenderInstance_frame = 0;
+static std3DStaticVertex* sithRenderInstance_pFrameVertices = NULL;
+static rdTri* sithRenderInstance_aTris = NULL;
+static rdTri* sithRenderInstance_aSortTris = NULL;
+static uint32_t sithRenderInstance_numTris = 0;
+static uint32_t sithRenderInstance_maxTris = 0;
+static uint32_t sithRenderInstance_maxSortTris = 0;
+static sithRenderInstanceEntry* sithRenderInstance_aEntries = NULL;
+static uint32_t sithRenderInstance_numEntries = 0;
+static uint32_t sithRenderInstance_maxEntries = 0;
+static std3DInstance* sithRenderInstance_aInstances = NULL;
+static std3DInstanceBatch* sithRenderInstance_aBatches = NULL;
+static uint32_t* sithRenderInstance_aFrameMeshes = NULL;
+static uint32_t sithRenderInstance_numFrameMeshes = 0;
+static uint32_t sithRenderInstance_maxFrameMeshes = 0;
+static uint32_t sithRenderInstance_maxBatches = 0;
+static uint32_t sithRenderInstance_maxInstances = 0;
+static int sithRenderInstance_bActive = 0;
+static float sithRenderInstance_aScreenProj[16];
+
+// Grows *ppArr to hold at least `amt` elements of `size` bytes
+static int sithRenderInstance_Ensure(void** ppArr, uint32_t* pMax, uint32_t amt, size_t size)
+{
+    uint32_t newMax;
+    void* pNew;
+
+    if (amt <= *pMax)
+        return 1;
+
+    newMax = *pMax ? *pMax : 64;
+    while (newMax < amt)
+        newMax *= 2;
+
+    pNew = pSithHS->realloc(*ppArr, size * newMax);
+    if (!pNew)
+        return 0;
+
+    *ppArr = pNew;
+    *pMax = newMax;
+    return 1;
+}
+
+void sithRenderInstance_Close()
+{
+    std3D_FreeInstanceGeometry();
+
+    if (sithRenderInstance_aModels)
+        pSithHS->free(sithRenderInstance_aModels);
+    if (sithRenderInstance_aModelHash)
+        pSithHS->free(sithRenderInstance_aModelHash);
+    if (sithRenderInstance_aMeshes)
+        pSithHS->free(sithRenderInstance_aMeshes);
+    if (sithRenderInstance_aVertices)
+        pSithHS->free(sithRenderInstance_aVertices);
+    if (sithRenderInstance_aTris)
+        pSithHS->free(sithRenderInstance_aTris);
+    if (sithRenderInstance_aSortTris)
+        pSithHS->free(sithRenderInstance_aSortTris);
+    if (sithRenderInstance_aEntries)
+        pSithHS->free(sithRenderInstance_aEntries);
+    if (sithRenderInstance_aInstances)
+        pSithHS->free(sithRenderInstance_aInstances);
+    if (sithRenderInstance_aBatches)
+        pSithHS->free(sithRenderInstance_aBatches);
+    if (sithRenderInstance_aFrameMeshes)
+        pSithHS->free(sithRenderInstance_aFrameMeshes);
+
+    sithRenderInstance_aModels = NULL;
+    sithRenderInstance_numModels = 0;
+    sithRenderInstance_maxModels = 0;
+    sithRenderInstance_aModelHash = NULL;
+    sithRenderInstance_modelHashSize = 0;
+    sithRenderInstance_aMeshes = NULL;
+    sithRenderInstance_numMeshes = 0;
+    sithRenderInstance_maxMeshes = 0;
+    sithRenderInstance_aVertices = NULL;
+    sithRenderInstance_numVertices = 0;
+    sithRenderInstance_maxVertices = 0;
+    sithRenderInstance_bDirty = 0;
+    sithRenderInstance_pFrameVertices = NULL;
+    sithRenderInstance_aTris = NULL;
+    sithRenderInstance_aSortTris = NULL;
+    sithRenderInstance_numTris = 0;
+    sithRenderInstance_maxTris = 0;
+    sithRenderInstance_maxSortTris = 0;
+    sithRenderInstance_aEntries = NULL;
+    sithRenderInstance_numEntries = 0;
+    sithRenderInstance_maxEntries = 0;
+    sithRenderInstance_aInstances = NULL;
+    sithRenderInstance_aBatches = NULL;
+    sithRenderInstance_aFrameMeshes = NULL;
+    sithRenderInstance_numFrameMeshes = 0;
+    sithRenderInstance_maxFrameMeshes = 0;
+    sithRenderInstance_maxBatches = 0;
+    sithRenderInstance_maxInstances = 0;
+    sithRenderInstance_bActive = 0;
+}
+
+static uint32_t sithRenderInstance_HashModel(rdModel3 *model)
+{
+    uintptr_t val = (uintptr_t)model;
+
+    val ^= val >> 16;
+    val *= 0x45D9F3B;
+    val ^= val >> 16;
+    return (uint32_t)val & (sithRenderInstance_modelHashSize - 1);
+}
+
+static sithRenderInstanceModel* sithRenderInstance_FindModel(rdModel3 *model)
+{
+    uint32_t slot;
+
+    if (!sithRenderInstance_modelHashSize)
+        return NULL;
+
+    slot = sithRenderInstance_HashModel(model);
+    while (sithRenderInstance_aModelHash[slot])
+    {
+        sithRenderInstanceModel* pModel = &sithRenderInstance_aModels[sithRenderInstance_aModelHash[slot] - 1];
+        if (pModel->model == model)
+            return pModel;
+        slot = (slot + 1) & (sithRenderInstance_modelHashSize - 1);
+    }
+    return NULL;
+}
+
+static int sithRenderInstance_InsertModelHash(uint32_t idx)
+{
+    uint32_t slot;
+
+    // Keep the table at most half full
+    if ((sithRenderInstance_numModels * 2) > sithRenderInstance_modelHashSize)
+    {
+        uint32_t newSize = sithRenderInstance_modelHashSize ? sithRenderInstance_modelHashSize * 2 : 64;
+        int* pNew = (int*)pSithHS->alloc(sizeof(int) * newSize);
+        if (!pNew)
+            return 0;
+        _memset(pNew, 0, sizeof(int) * newSize);
+
+        if (sithRenderInstance_aModelHash)
+            pSithHS->free(sithRenderInstance_aModelHash);
+        sithRenderInstance_aModelHash = pNew;
+        sithRenderInstance_modelHashSize = newSize;
+
+        // Rehash everything, including idx
+        for (uint32_t i = 0; i < sithRenderInstance_numModels; i++)
+        {
+            slot = sithRenderInstance_HashModel(sithRenderInstance_aModels[i].model);
+            while (sithRenderInstance_aModelHash[slot])
+                slot = (slot + 1) & (sithRenderInstance_modelHashSize - 1);
+            sithRenderInstance_aModelHash[slot] = i + 1;
+        }
+        return 1;
+    }
+
+    slot = sithRenderInstance_HashModel(sithRenderInstance_aModels[idx].model);
+    while (sithRenderInstance_aModelHash[slot])
+        slot = (slot + 1) & (sithRenderInstance_modelHashSize - 1);
+    sithRenderInstance_aModelHash[slot] = idx + 1;
+    return 1;
+}
+
+// Only opaque, fully textured models are drawn instanced
+static int sithRenderInstance_IsModelEligible(rdModel3 *model)
+{
+    for (uint32_t g = 0; g < model->numGeosets; g++)
+    {
+        rdGeoset* geoset = &model->geosets[g];
+
+        for (uint32_t m = 0; m < geoset->numMeshes; m++)
+        {
+            rdMesh* mesh = &geoset->meshes[m];
+
+            if (!mesh->geometryMode)
+                continue;
+            if (mesh->geometryMode < 4)
+                return 0;
+
+            for (int i = 0; i < mesh->numFaces; i++)
+            {
+                rdFace* face = &mesh->faces[i];
+                rdMaterial* material = face->material;
+
+                if (!material || (face->type & 2) != 0 || face->numVertices < 3 || face->geometryMode < 4)
+                    return 0;
+                if (material->num_texinfo <= 0)
+                    return 0;
+
+                for (int j = 0; j < material->num_texinfo; j++)
+                {
+                    rdTexinfo* texinfo = material->texinfos[j];
+                    if (!texinfo || (texinfo->header.texture_type & 8) == 0 || !texinfo->texture_ptr)
+                        return 0;
+                    if ((texinfo->texture_ptr->alpha_en & 1) != 0)
+                        return 0;
+                }
+            }
+        }
+    }
+
+    return 1;
+}
+
+// Lays out the resident vertices for every mesh of the model. They're
+// uploaded at the start of the next frame, so the model is only drawn
+// instanced from then on.
+static sithRenderInstanceModel* sithRenderInstance_AddModel(rdModel3 *model)
+{
+    sithRenderInstanceModel* pModel;
+    uint32_t idx = sithRenderInstance_numModels;
+
+    if (!sithRenderInstance_Ensure((void**)&sithRenderInstance_aModels, &sithRenderInstance_maxModels, idx + 1, sizeof(sithRenderInstanceModel)))
+        return NULL;
+
+    pModel = &sithRenderInstance_aModels[idx];
+    _memset(pModel, 0, sizeof(*pModel));
+    pModel->model = model;
+    pModel->bEligible = sithRenderInstance_IsModelEligible(model);
+
+    for (uint32_t g = 0; g < model->numGeosets && pModel->bEligible; g++)
+    {
+        rdGeoset* geoset = &model->geosets[g];
+
+        pModel->aFirstMesh[g] = sithRenderInstance_numMeshes;
+        if (!sithRenderInstance_Ensure((void**)&sithRenderInstance_aMeshes, &sithRenderInstance_maxMeshes, sithRenderInstance_numMeshes + geoset->numMeshes, sizeof(sithRenderInstanceMesh)))
+            return NULL;
+
+        for (uint32_t m = 0; m < geoset->numMeshes; m++)
+        {
+            rdMesh* mesh = &geoset->meshes[m];
+            sithRenderInstanceMesh* pMesh = &sithRenderInstance_aMeshes[sithRenderInstance_numMeshes++];
+            uint32_t numVertices = 0;
+
+            for (int i = 0; i < mesh->numFaces; i++)
+                numVertices += mesh->faces[i].numVertices;
+
+            _memset(pMesh, 0, sizeof(*pMesh));
+            pMesh->mesh = mesh;
+            pMesh->firstVertex = sithRenderInstance_numVertices;
+            pMesh->numVertices = numVertices;
+            pMesh->lastFrame = sithRenderInstance_frame - 1;
+
+            if (!sithRenderInstance_Ensure((void**)&sithRenderInstance_aVertices, &sithRenderInstance_maxVertices, sithRenderInstance_numVertices + numVertices, sizeof(rdVector3)))
+                return NULL;
+
+            for (int i = 0; i < mesh->numFaces; i++)
+            {
+                rdFace* face = &mesh->faces[i];
+                for (int j = 0; j < face->numVertices; j++)
+                    rdVector_Copy3(&sithRenderInstance_aVertices[sithRenderInstance_numVertices++], &mesh->vertices[face->vertexPosIdx[j]]);
+            }
+        }
+        sithRenderInstance_bDirty = 1;
+    }
+
+    sithRenderInstance_numModels++;
+    if (!sithRenderInstance_InsertModelHash(idx))
+    {
+        sithRenderInstance_numModels--;
+        return NULL;
+    }
+    return pModel;
+}
+
+int sithRenderInstance_BeginFrame()
+{
+    sithRenderInstance_pFrameVertices = NULL;
+    sithRenderInstance_numTris = 0;
+    sithRenderInstance_numEntries = 0;
+    sithRenderInstance_numFrameMeshes = 0;
+    sithRenderInstance_bActive = 0;
+    sithRenderInstance_frame++;
+
+    if (!jkPlayer_enableInstancing || !sithWorld_pCurrentWorld)
+        return 0;
+
+    // Same GPU projection as the resident level geometry
+    if (!rdroid_curAcceleration || rdroid_curZBufferMethod != 2 || rdCache_dword_865258 == 16)
+        return 0;
+    if (rdCamera_pCurCamera->projectType != rdCameraProjectType_Perspective || sithRender_lightingIRMode)
+        return 0;
+    if (rdCamera_pCurCamera->cameraClipFrustum->field_0.z == 0.0)
+        return 0;
+
+    if (sithRenderInstance_bDirty && sithRenderInstance_numVertices)
+    {
+        if (!std3D_UploadInstanceGeometry(sithRenderInstance_aVertices, sithRenderInstance_numVertices))
+            return 0;
+        sithRenderInstance_bDirty = 0;
+    }
+
+    // Models still get registered while nothing is resident yet
+    if (std3D_HasInstanceGeometry())
+    {
+        sithRenderInstance_pFrameVertices = std3D_BeginInstanceRenderList();
+        if (!sithRenderInstance_pFrameVertices)
+            return 0;
+    }
+
+    sithRenderStatic_CalcScreenProj(sithRenderInstance_aScreenProj);
+    sithRenderInstance_bActive = 1;
+    return 1;
+}
+
+// Writes the frame's vertex light and UVs for every face of the mesh, plus
+// its tris. Vertex light is what rdCache_SendFaceListToHardware works out
+// from rdModel3_DrawFace's proc entry, before the ambient floor.
+static int sithRenderInstance_PrepareMesh(sithRenderInstanceMesh *pMesh, int lightMode)
+{
+    rdMesh* mesh = pMesh->mesh;
+    std3DStaticVertex* pOut = &sithRenderInstance_pFrameVertices[pMesh->firstVertex];
+    uint32_t base = pMesh->firstVertex;
+    uint32_t numTris = 0;
+
+    for (int i = 0; i < mesh->numFaces; i++)
+    {
+        numTris += mesh->faces[i].numVertices - 2;
+        if (mesh->faces[i].type & 1)
+            numTris += mesh->faces[i].numVertices - 2;
+    }
+    if (!sithRenderInstance_Ensure((void**)&sithRenderInstance_aTris, &sithRenderInstance_maxTris, sithRenderInstance_numTris + numTris, sizeof(rdTri)))
+        return 0;
+    if (!sithRenderInstance_Ensure((void**)&sithRenderInstance_aSortTris, &sithRenderInstance_maxSortTris, sithRenderInstance_numTris + numTris, sizeof(rdTri)))
+        return 0;
+
+    pMesh->firstTri = sithRenderInstance_numTris;
+    pMesh->numTris = 0;
+
+    for (int i = 0; i < mesh->numFaces; i++)
+    {
+        rdFace* face = &mesh->faces[i];
+        rdMaterial* material = face->material;
+        rdTexture* texture;
+        rdDDrawSurface* tex;
+        unsigned int out_width, out_height;
+        int faceLightMode, cel;
+
+        cel = face->wallCel;
+        if ( cel == -1 )
+            cel = material->celIdx;
+        if ( cel < 0 )
+            cel = 0;
+        else if ( cel > material->num_texinfo - 1 )
+            cel = material->num_texinfo - 1;
+
+        texture = material->texinfos[cel]->texture_ptr;
+        if ( !rdMaterial_AddToTextureCache(material, texture, 0, 0) )
+        {
+            sithRenderInstance_numTris = pMesh->firstTri;
+            return 0;
+        }
+        tex = &texture->alphaMats[0];
+
+        std3D_GetValidDimension(
+            texture->texture_struct[0]->format.width,
+            texture->texture_struct[0]->format.height,
+            &out_width,
+            &out_height);
+
+        faceLightMode = face->lightingMode;
+        if ( faceLightMode >= mesh->lightingMode )
+            faceLightMode = mesh->lightingMode;
+        if ( faceLightMode >= lightMode )
+            faceLightMode = lightMode;
+
+        for (int j = 0; j < face->numVertices; j++)
+        {
+            int posIdx = face->vertexPosIdx[j];
+            int uvIdx = face->vertexUVIdx[j];
+            float light = 1.0;
+            int level;
+
+            if ( faceLightMode == 3 )
+                light = stdMath_Clamp(mesh->vertices_i[posIdx] + face->extraLight, 0.0, 1.0);
+            else if ( faceLightMode != 0 )
+                light = stdMath_Clamp(face->extraLight, 0.0, 1.0);
+
+            level = (int)(light * 255.0);
+            pOut[j].color = 0xFF000000 | (level << 16) | (level << 8) | level;
+            pOut[j].tu = (mesh->vertexUVs[uvIdx].x + face->clipIdk.x) / (float)out_width;
+            pOut[j].tv = (mesh->vertexUVs[uvIdx].y + face->clipIdk.y) / (float)out_height;
+        }
+
+        // Same fan as rdCache_SendFaceListToHardware. rdCache flips the cull
+        // face for the back of a double sided face, here it gets a second
+        // copy wound the other way.
+        for (int side = 0; side < ((face->type & 1) ? 2 : 1); side++)
+        {
+            int a = 0;
+            int b = 1;
+            int c = face->numVertices - 1;
+            for (int k = 0; k < face->numVertices - 2; k++)
+            {
+                rdTri* tri = &sithRenderInstance_aTris[sithRenderInstance_numTris++];
+                tri->v3 = base + (side ? c : a);
+                tri->v2 = base + b;
+                tri->v1 = base + (side ? a : c);
+                tri->flags = RDCACHE_TRI_ZBUFFERED;
+                tri->texture = tex;
+                tri->sortKey = rdCache_TriSortKey(tri);
+                pMesh->numTris++;
+
+                if ( (k & 1) != 0 )
+                {
+                    a = c--;
+                }
+                else
+                {
+                    a = b++;
+                }
+            }
+        }
+
+        pOut += face->numVertices;
+        base += face->numVertices;
+    }
+
+    rdCache_RadixSortTris(&sithRenderInstance_aTris[pMesh->firstTri], sithRenderInstance_aSortTris, pMesh->numTris);
+
+    pMesh->lastFrame = sithRenderInstance_frame;
+    pMesh->lightMode = lightMode;
+    pMesh->numInstances = 0;
+    sithRenderInstance_aFrameMeshes[sithRenderInstance_numFrameMeshes++] = pMesh - sithRenderInstance_aMeshes;
+    return 1;
+}
+
+// Queues a model thing for sithRenderInstance_Draw. Returns 0 if it has to
+// go through rdThing_Draw instead.
+int sithRenderInstance_AddThing(sithThing *thing)
+{
+    rdModel3* model;
+    rdGeoset* geoset;
+    sithRenderInstanceModel* pModel;
+    uint32_t geosetNum, firstMesh;
+    int geometryMode, lightMode, bFullbright;
+    float ambient;
+    rdVector3 tint;
+
+    if (!sithRenderInstance_bActive)
+        return 0;
+    if (thing->rdthing.type != RD_THINGTYPE_MODEL || thing->rdthing.puppet || !thing->rdthing.hierarchyNodeMatrices)
+        return 0;
+    if ((thing->thingflags & SITH_TF_RENDERWEAPON) != 0)
+        return 0;
+
+    model = thing->rdthing.model3;
+    pModel = sithRenderInstance_FindModel(model);
+    if (!pModel)
+    {
+        sithRenderInstance_AddModel(model);
+        return 0;
+    }
+    if (!pModel->bEligible || !sithRenderInstance_pFrameVertices)
+        return 0;
+
+    for (uint32_t i = 0; i < model->numHierarchyNodes; i++)
+    {
+        if (thing->rdthing.amputatedJoints[i])
+            return 0;
+    }
+
+    geometryMode = thing->rdthing.geometryMode;
+    if ( geometryMode >= rdroid_curGeometryMode )
+        geometryMode = rdroid_curGeometryMode;
+    if ( geometryMode != 4 )
+        return 0;
+
+    // Same lighting mode as rdModel3_Draw
+    bFullbright = (rdroid_curRenderOptions & 2) != 0 && rdCamera_pCurCamera->ambientLight >= 1.0;
+    lightMode = 0;
+    if ( !bFullbright )
+    {
+        lightMode = thing->rdthing.lightingMode;
+        if ( lightMode >= rdroid_curLightingMode )
+            lightMode = rdroid_curLightingMode;
+    }
+
+    // Lights in reach would make the vertex light unique to this thing
+    if ( lightMode > 1 )
+    {
+        for (int i = 0; i < rdCamera_pCurCamera->numLights; i++)
+        {
+            if ( rdCamera_pCurCamera->lights[i]->falloffMin + model->radius > rdVector_Dist3(&rdCamera_pCurCamera->lightPositions[i], &thing->position) )
+                return 0;
+        }
+    }
+
+    // Without lights, 2 comes out as the face's extralight just like 1
+    if ( lightMode == 2 )
+        lightMode = 1;
+
+    geosetNum = (thing->rdthing.geosetSelect == (uint32_t)-1) ? model->geosetSelect : thing->rdthing.geosetSelect;
+    if ( geosetNum >= model->numGeosets )
+        return 0;
+    geoset = &model->geosets[geosetNum];
+    firstMesh = pModel->aFirstMesh[geosetNum];
+
+    // Every mesh has to agree with the vertex light other instances already
+    // baked this frame, a fully lit thing comes out the same either way
+    for (uint32_t i = 0; i < geoset->numMeshes; i++)
+    {
+        sithRenderInstanceMesh* pMesh = &sithRenderInstance_aMeshes[firstMesh + i];
+        if ( pMesh->lastFrame == sithRenderInstance_frame && !bFullbright && pMesh->lightMode != lightMode )
+            return 0;
+    }
+
+    if (!sithRenderInstance_Ensure((void**)&sithRenderInstance_aEntries, &sithRenderInstance_maxEntries, sithRenderInstance_numEntries + model->numHierarchyNodes, sizeof(sithRenderInstanceEntry)))
+        return 0;
+    if (!sithRenderInstance_Ensure((void**)&sithRenderInstance_aFrameMeshes, &sithRenderInstance_maxFrameMeshes, sithRenderInstance_numFrameMeshes + geoset->numMeshes, sizeof(uint32_t)))
+        return 0;
+
+    for (uint32_t i = 0; i < geoset->numMeshes; i++)
+    {
+        sithRenderInstanceMesh* pMesh = &sithRenderInstance_aMeshes[firstMesh + i];
+        if ( pMesh->lastFrame != sithRenderInstance_frame && pMesh->mesh->geometryMode && !sithRenderInstance_PrepareMesh(pMesh, lightMode) )
+            return 0;
+    }
+
+    if ( thing->rdthing.frameTrue != rdroid_frameTrue )
+        rdPuppet_BuildJointMatrices(&thing->rdthing, &thing->lookOrientation);
+
+    ambient = (rdroid_curRenderOptions & 2) ? rdCamera_pCurCamera->ambientLight : 0.0;
+    tint.x = tint.y = tint.z = 1.0;
+    if ( rdColormap_pCurMap != rdColormap_pIdentityMap )
+        rdVector_Copy3(&tint, &rdColormap_pCurMap->tint);
+
+    for (uint32_t i = 0; i < model->numHierarchyNodes; i++)
+    {
+        rdHierarchyNode* node = &model->hierarchyNodes[i];
+        rdMatrix34* mat = &thing->rdthing.hierarchyNodeMatrices[node->idx];
+        sithRenderInstanceEntry* pEntry;
+        sithRenderInstanceMesh* pMesh;
+
+        if ( node->meshIdx == (uint32_t)-1 || node->meshIdx >= geoset->numMeshes )
+            continue;
+        pMesh = &sithRenderInstance_aMeshes[firstMesh + node->meshIdx];
+        if ( !pMesh->numTris || pMesh->lastFrame != sithRenderInstance_frame )
+            continue;
+
+        pEntry = &sithRenderInstance_aEntries[sithRenderInstance_numEntries++];
+        pEntry->meshIdx = firstMesh + node->meshIdx;
+        pEntry->instance.aRows[0][0] = mat->rvec.x;
+        pEntry->instance.aRows[0][1] = mat->lvec.x;
+        pEntry->instance.aRows[0][2] = mat->uvec.x;
+        pEntry->instance.aRows[0][3] = mat->scale.x;
+        pEntry->instance.aRows[1][0] = mat->rvec.y;
+        pEntry->instance.aRows[1][1] = mat->lvec.y;
+        pEntry->instance.aRows[1][2] = mat->uvec.y;
+        pEntry->instance.aRows[1][3] = mat->scale.y;
+        pEntry->instance.aRows[2][0] = mat->rvec.z;
+        pEntry->instance.aRows[2][1] = mat->lvec.z;
+        pEntry->instance.aRows[2][2] = mat->uvec.z;
+        pEntry->instance.aRows[2][3] = mat->scale.z;
+        pEntry->instance.tint[0] = tint.x;
+        pEntry->instance.tint[1] = tint.y;
+        pEntry->instance.tint[2] = tint.z;
+        pEntry->instance.ambient = ambient;
+        pMesh->numInstances++;
+    }
+
+    ++rdModel3_numDrawnModels;
+    return 1;
+}
+
+void sithRenderInstance_Draw()
+{
+    uint32_t first = 0;
+
+    if (!sithRenderInstance_pFrameVertices)
+        return;
+
+    if (!sithRenderInstance_numEntries)
+    {
+        std3D_DrawInstancedRenderList(NULL, 0, sithRenderInstance_aScreenProj);
+        sithRenderInstance_pFrameVertices = NULL;
+        return;
+    }
+
+    if (!sithRenderInstance_Ensure((void**)&sithRenderInstance_aInstances, &sithRenderInstance_maxInstances, sithRenderInstance_numEntries, sizeof(std3DInstance))
+        || !sithRenderInstance_Ensure((void**)&sithRenderInstance_aBatches, &sithRenderInstance_maxBatches, sithRenderInstance_numFrameMeshes, sizeof(std3DInstanceBatch)))
+    {
+        std3D_DrawInstancedRenderList(NULL, 0, sithRenderInstance_aScreenProj);
+        sithRenderInstance_pFrameVertices = NULL;
+        return;
+    }
+
+    // Group the instances by mesh, in the order the meshes were first drawn
+    for (uint32_t i = 0; i < sithRenderInstance_numFrameMeshes; i++)
+    {
+        sithRenderInstanceMesh* pMesh = &sithRenderInstance_aMeshes[sithRenderInstance_aFrameMeshes[i]];
+        std3DInstanceBatch* pBatch = &sithRenderInstance_aBatches[i];
+
+        pBatch->tris = &sithRenderInstance_aTris[pMesh->firstTri];
+        pBatch->numTris = pMesh->numTris;
+        pBatch->pInstances = &sithRenderInstance_aInstances[first];
+        pBatch->numInstances = 0;
+        first += pMesh->numInstances;
+
+        // Reused as the batch index while scattering
+        pMesh->numInstances = i;
+    }
+    for (uint32_t i = 0; i < sithRenderInstance_numEntries; i++)
+    {
+        std3DInstanceBatch* pBatch = &sithRenderInstance_aBatches[sithRenderInstance_aMeshes[sithRenderInstance_aEntries[i].meshIdx].numInstances];
+        ((std3DInstance*)pBatch->pInstances)[pBatch->numInstances++] = sithRenderInstance_aEntries[i].instance;
+    }
+
+    std3D_DrawInstancedRenderList(sithRenderInstance_aBatches, sithRenderInstance_numFrameMeshes, sithRenderInstance_aScreenProj);
+
+    sithRenderInstance_pFrameVertices = NULL;
+    sithRenderInstance_numTris = 0;
+    sithRenderInstance_numEntries = 0;
+    sithRenderInstance_numFrameMeshes = 0;
+    sithRenderInstance_bActive = 0;
+}
+
+#endif // SDL2_RENDER
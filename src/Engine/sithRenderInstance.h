@@ -0,0 +1,16 @@
+#ifndef _SITHRENDERINSTANCE_H
+#define _SITHRENDERINSTANCE_H
+
+#include "types.h"
+#include "globals.h"
+
+// Added: Unanimated model things drawn with one instanced call per mesh,
+// see jkPlayer_enableInstancing
+#ifdef SDL2_RENDER
+void sithRenderInstance_Close();
+int sithRenderInstance_BeginFrame();
+int sithRenderInstance_AddThing(sithThing *thing);
+void sithRenderInstance_Draw();
+#endif
+
+#endif // _SITHRENDERINSTANCE_H
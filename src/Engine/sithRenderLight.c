@@ -0,0 +1,279 @@
+#include "sithRenderLight.h"
+
+#include "Engine/rdroid.h"
+#include "Engine/rdCamera.h"
+#include "Primitives/rdVector.h"
+#include "Primitives/rdSimd.h"
+#include "jk.h"
+
+#define SITHRENDERLIGHT_GROUP_SIZE (16)
+#define SITHRENDERLIGHT_MAX_LIGHTS (64)
+
+// Slack on the bounds test so rounding can't drop a light which the
+// per-vertex test would still accept
+#define SITHRENDERLIGHT_EPSILON (0.001)
+
+typedef struct sithRenderLightGroup
+{
+    rdVector3 mins;
+    rdVector3 maxs;
+    uint32_t first;
+    uint32_t count;
+} sithRenderLightGroup;
+
+static sithWorld* sithRenderLight_pWorld = NULL;
+static sithRenderLightGroup* sithRenderLight_aGroups = NULL;
+static uint32_t sithRenderLight_numGroups = 0;
+static uint32_t* sithRenderLight_aSectorGroups = NULL; // numSectors+1 entries
+static int* sithRenderLight_aVertexIdxs = NULL;
+
+static void sithRenderLight_CalcBounds(sithWorld *world, const int *pIdxs, uint32_t count, rdVector3 *pMins, rdVector3 *pMaxs)
+{
+    rdVector_Copy3(pMins, &world->vertices[pIdxs[0]]);
+    rdVector_Copy3(pMaxs, &world->vertices[pIdxs[0]]);
+
+    for (uint32_t i = 1; i < count; i++)
+    {
+        rdVector3* pVert = &world->vertices[pIdxs[i]];
+
+        if (pVert->x < pMins->x) pMins->x = pVert->x;
+        if (pVert->y < pMins->y) pMins->y = pVert->y;
+        if (pVert->z < pMins->z) pMins->z = pVert->z;
+        if (pVert->x > pMaxs->x) pMaxs->x = pVert->x;
+        if (pVert->y > pMaxs->y) pMaxs->y = pVert->y;
+        if (pVert->z > pMaxs->z) pMaxs->z = pVert->z;
+    }
+}
+
+// Halves the range along the longest axis of its bounds until every group is
+// at most SITHRENDERLIGHT_GROUP_SIZE vertices
+static void sithRenderLight_Split(sithWorld *world, uint32_t first, uint32_t count)
+{
+    int* pIdxs = &sithRenderLight_aVertexIdxs[first];
+    rdVector3 mins, maxs, size;
+    int axis;
+    float mid;
+    uint32_t left, right;
+
+    sithRenderLight_CalcBounds(world, pIdxs, count, &mins, &maxs);
+    if (count <= SITHRENDERLIGHT_GROUP_SIZE)
+    {
+        sithRenderLightGroup* pGroup = &sithRenderLight_aGroups[sithRenderLight_numGroups++];
+        pGroup->mins = mins;
+        pGroup->maxs = maxs;
+        pGroup->first = first;
+        pGroup->count = count;
+        return;
+    }
+
+    rdVector_Sub3(&size, &maxs, &mins);
+    axis = 0;
+    if (size.y > (&size.x)[axis])
+        axis = 1;
+    if (size.z > (&size.x)[axis])
+        axis = 2;
+    mid = ((&mins.x)[axis] + (&maxs.x)[axis]) * 0.5;
+
+    left = 0;
+    right = count;
+    while (left < right)
+    {
+        if ((&world->vertices[pIdxs[left]].x)[axis] < mid)
+        {
+            left++;
+        }
+        else
+        {
+            int tmp = pIdxs[left];
+            pIdxs[left] = pIdxs[--right];
+            pIdxs[right] = tmp;
+        }
+    }
+
+    // All on one side (coincident vertices), just cut it in half
+    if (left == 0 || left == count)
+        left = count / 2;
+
+    sithRenderLight_Split(world, first, left);
+    sithRenderLight_Split(world, first + left, count - left);
+}
+
+int sithRenderLight_Open(sithWorld *world)
+{
+    uint32_t numVertices = 0;
+    uint32_t base = 0;
+
+    sithRenderLight_Close();
+
+    if (!world->numSectors)
+        return 1;
+
+    for (int i = 0; i < world->numSectors; i++)
+        numVertices += world->sectors[i].numVertices;
+
+    // Every group holds at least one vertex
+    sithRenderLight_aSectorGroups = (uint32_t*)pSithHS->alloc(sizeof(uint32_t) * (world->numSectors + 1));
+    sithRenderLight_aVertexIdxs = (int*)pSithHS->alloc(sizeof(int) * (numVertices ? numVertices : 1));
+    sithRenderLight_aGroups = (sithRenderLightGroup*)pSithHS->alloc(sizeof(sithRenderLightGroup) * (numVertices ? numVertices : 1));
+    if (!sithRenderLight_aSectorGroups || !sithRenderLight_aVertexIdxs || !sithRenderLight_aGroups)
+    {
+        sithRenderLight_Close();
+        return 0;
+    }
+
+    for (int i = 0; i < world->numSectors; i++)
+    {
+        sithSector* sector = &world->sectors[i];
+
+        sithRenderLight_aSectorGroups[i] = sithRenderLight_numGroups;
+        if (!sector->numVertices)
+            continue;
+
+        _memcpy(&sithRenderLight_aVertexIdxs[base], sector->verticeIdxs, sizeof(int) * sector->numVertices);
+        sithRenderLight_Split(world, base, sector->numVertices);
+        base += sector->numVertices;
+    }
+    sithRenderLight_aSectorGroups[world->numSectors] = sithRenderLight_numGroups;
+
+    sithRenderLight_pWorld = world;
+    return 1;
+}
+
+void sithRenderLight_Close()
+{
+    if (sithRenderLight_aGroups)
+        pSithHS->free(sithRenderLight_aGroups);
+    if (sithRenderLight_aSectorGroups)
+        pSithHS->free(sithRenderLight_aSectorGroups);
+    if (sithRenderLight_aVertexIdxs)
+        pSithHS->free(sithRenderLight_aVertexIdxs);
+
+    sithRenderLight_aGroups = NULL;
+    sithRenderLight_aSectorGroups = NULL;
+    sithRenderLight_aVertexIdxs = NULL;
+    sithRenderLight_numGroups = 0;
+    sithRenderLight_pWorld = NULL;
+}
+
+// Squared distance from pPos to the closest point of the box
+static float sithRenderLight_BoxDist2(const sithRenderLightGroup *pGroup, const rdVector3 *pPos)
+{
+    float dist2 = 0.0;
+
+    for (int i = 0; i < 3; i++)
+    {
+        float v = (&pPos->x)[i];
+        float d = 0.0;
+
+        if (v < (&pGroup->mins.x)[i])
+            d = (&pGroup->mins.x)[i] - v;
+        else if (v > (&pGroup->maxs.x)[i])
+            d = v - (&pGroup->maxs.x)[i];
+        dist2 += d * d;
+    }
+    return dist2;
+}
+
+// Same sum as sithRender_RenderDynamicLights' per-vertex loop, lights are
+// added in the same order and a vertex stops once it's fully lit. Distances
+// are computed for 4 vertices at a time.
+static void sithRenderLight_LightVertices(sithWorld *world, const int *pIdxs, uint32_t numIdxs, rdLight **apLights, int numLights)
+{
+    float attenuation = rdCamera_pCurCamera->attenuationMax;
+
+    for (uint32_t base = 0; base < numIdxs; base += 4)
+    {
+        uint32_t amt = (numIdxs - base < 4) ? numIdxs - base : 4;
+        float aX[4], aY[4], aZ[4], aDist[4];
+        float aLight[4] = {0.0, 0.0, 0.0, 0.0};
+        int done = (0xF << amt) & 0xF;
+
+        for (uint32_t l = 0; l < 4; l++)
+        {
+            rdVector3* pVert = &world->vertices[pIdxs[base + (l < amt ? l : 0)]];
+            aX[l] = pVert->x;
+            aY[l] = pVert->y;
+            aZ[l] = pVert->z;
+        }
+
+        for (int i = 0; i < numLights && done != 0xF; i++)
+        {
+            rdLight* light = apLights[i];
+            rdVector3* pPos = &rdCamera_pCurCamera->lightPositions[light->id];
+
+#ifdef RDSIMD_ENABLED
+            rdSimdF4 dx = rdSimd_Sub(rdSimd_Set1(pPos->x), rdSimd_Load(aX));
+            rdSimdF4 dy = rdSimd_Sub(rdSimd_Set1(pPos->y), rdSimd_Load(aY));
+            rdSimdF4 dz = rdSimd_Sub(rdSimd_Set1(pPos->z), rdSimd_Load(aZ));
+            rdSimdF4 d2 = rdSimd_Add(rdSimd_Add(rdSimd_Mul(dx, dx), rdSimd_Mul(dy, dy)), rdSimd_Mul(dz, dz));
+            rdSimd_Store(aDist, rdSimd_Sqrt(d2));
+#else
+            for (uint32_t l = 0; l < amt; l++)
+                aDist[l] = rdVector_Dist3(pPos, &world->vertices[pIdxs[base + l]]);
+#endif
+
+            for (uint32_t l = 0; l < amt; l++)
+            {
+                if (done & (1 << l))
+                    continue;
+
+                if (aDist[l] < light->falloffMax)
+                    aLight[l] += light->intensity - aDist[l] * attenuation;
+                if (aLight[l] >= 1.0)
+                    done |= (1 << l);
+            }
+        }
+
+        for (uint32_t l = 0; l < amt; l++)
+            world->verticesDynamicLight[pIdxs[base + l]] = aLight[l];
+    }
+}
+
+// Lights the sector's vertices which haven't been lit yet this frame, with
+// the lights sithRender_RenderDynamicLights picked for the sector. Returns 0
+// if the groups aren't built, the caller then does it per vertex.
+int sithRenderLight_LightSector(sithSector *sector, rdLight **apLights, int numLights)
+{
+    sithWorld* world = sithRenderLight_pWorld;
+    rdLight* aGroupLights[SITHRENDERLIGHT_MAX_LIGHTS];
+    int aPending[SITHRENDERLIGHT_GROUP_SIZE];
+    uint32_t sectorIdx;
+
+    if (!world || world != sithWorld_pCurrentWorld || numLights > SITHRENDERLIGHT_MAX_LIGHTS)
+        return 0;
+
+    sectorIdx = sector - world->sectors;
+    if (sectorIdx >= world->numSectors)
+        return 0;
+
+    for (uint32_t g = sithRenderLight_aSectorGroups[sectorIdx]; g < sithRenderLight_aSectorGroups[sectorIdx + 1]; g++)
+    {
+        sithRenderLightGroup* pGroup = &sithRenderLight_aGroups[g];
+        int numGroupLights = 0;
+        uint32_t numPending = 0;
+
+        for (uint32_t i = 0; i < pGroup->count; i++)
+        {
+            int idx = sithRenderLight_aVertexIdxs[pGroup->first + i];
+            if (world->alloc_unk9c[idx] == sithRender_lastRenderTick)
+                continue;
+
+            world->alloc_unk9c[idx] = sithRender_lastRenderTick;
+            aPending[numPending++] = idx;
+        }
+        if (!numPending)
+            continue;
+
+        // Lights which can't reach the group's bounds add nothing to any of its vertices
+        for (int i = 0; i < numLights; i++)
+        {
+            float reach = apLights[i]->falloffMax + SITHRENDERLIGHT_EPSILON;
+            if (sithRenderLight_BoxDist2(pGroup, &rdCamera_pCurCamera->lightPositions[apLights[i]->id]) < reach * reach)
+                aGroupLights[numGroupLights++] = apLights[i];
+        }
+
+        sithRenderLight_LightVertices(world, aPending, numPending, aGroupLights, numGroupLights);
+    }
+
+    return 1;
+}
@@ -0,0 +1,13 @@
+#ifndef _SITHRENDERLIGHT_H
+#define _SITHRENDERLIGHT_H
+
+#include "types.h"
+#include "globals.h"
+
+// Added: Each sector's vertices split into small spatial groups at level load,
+// so dynamic lights are only evaluated against vertices they can reach.
+int sithRenderLight_Open(sithWorld *world);
+void sithRenderLight_Close();
+int sithRenderLight_LightSector(sithSector *sector, rdLight **apLights, int numLights);
+
+#endif // _SITHRENDERLIGHT_H
@@ -0,0 +1,403 @@
+#include "sithRenderStatic.h"
+
+#include "Engine/rdroid.h"
+#include "Engine/rdCache.h"
+#include "Engine/rdCamera.h"
+#include "Engine/rdMaterial.h"
+#include "Primitives/rdMatrix.h"
+#include "Engine/sithSurface.h"
+#include "General/stdMath.h"
+#include "World/jkPlayer.h"
+#include "Platform/std3D.h"
+#include "jk.h"
+
+#ifdef SDL2_RENDER
+
+// Every level surface owns numVertices resident vertices, so UVs and lighting
+// can be streamed per surface while positions stay on the GPU.
+static sithWorld* sithRenderStatic_pWorld = NULL;
+static uint32_t* sithRenderStatic_aSurfaceVertices = NULL;
+static rdVector3* sithRenderStatic_aVertices = NULL;
+static size_t sithRenderStatic_numVertices = 0;
+
+static std3DStaticVertex* sithRenderStatic_pFrameVertices = NULL;
+static std3DVertexRange* sithRenderStatic_aRanges = NULL; // vertices written this frame
+static size_t sithRenderStatic_numRanges = 0;
+static size_t sithRenderStatic_maxRanges = 0;
+static rdTri* sithRenderStatic_aTris = NULL;
+static rdTri* sithRenderStatic_aSortTris = NULL;
+static size_t sithRenderStatic_numTris = 0;
+static size_t sithRenderStatic_maxTris = 0;
+static int sithRenderStatic_numSurfaces = 0;
+static float sithRenderStatic_aScreenProj[16];
+
+
+int sithRenderStatic_Open(sithWorld *world)
+{
+    size_t numVertices = 0;
+
+    sithRenderStatic_Close();
+
+    if (!world->numSurfaces)
+        return 1;
+
+    sithRenderStatic_aSurfaceVertices = (uint32_t*)pSithHS->alloc(sizeof(uint32_t) * world->numSurfaces);
+    if (!sithRenderStatic_aSurfaceVertices)
+        return 0;
+
+    for (int i = 0; i < world->numSurfaces; i++)
+    {
+        sithRenderStatic_aSurfaceVertices[i] = numVertices;
+        numVertices += world->surfaces[i].surfaceInfo.face.numVertices;
+    }
+
+    sithRenderStatic_aVertices = (rdVector3*)pSithHS->alloc(sizeof(rdVector3) * (numVertices ? numVertices : 1));
+    if (!sithRenderStatic_aVertices)
+    {
+        sithRenderStatic_Close();
+        return 0;
+    }
+
+    for (int i = 0; i < world->numSurfaces; i++)
+    {
+        rdFace* face = &world->surfaces[i].surfaceInfo.face;
+        rdVector3* pOut = &sithRenderStatic_aVertices[sithRenderStatic_aSurfaceVertices[i]];
+
+        for (int j = 0; j < face->numVertices; j++)
+            rdVector_Copy3(&pOut[j], &world->vertices[face->vertexPosIdx[j]]);
+    }
+
+    sithRenderStatic_numVertices = numVertices;
+    sithRenderStatic_pWorld = world;
+    return 1;
+}
+
+void sithRenderStatic_Close()
+{
+    std3D_FreeStaticGeometry();
+
+    if (sithRenderStatic_aSurfaceVertices)
+        pSithHS->free(sithRenderStatic_aSurfaceVertices);
+    if (sithRenderStatic_aVertices)
+        pSithHS->free(sithRenderStatic_aVertices);
+    if (sithRenderStatic_aTris)
+        pSithHS->free(sithRenderStatic_aTris);
+    if (sithRenderStatic_aSortTris)
+        pSithHS->free(sithRenderStatic_aSortTris);
+    if (sithRenderStatic_aRanges)
+        pSithHS->free(sithRenderStatic_aRanges);
+
+    sithRenderStatic_aSurfaceVertices = NULL;
+    sithRenderStatic_aVertices = NULL;
+    sithRenderStatic_aTris = NULL;
+    sithRenderStatic_aSortTris = NULL;
+    sithRenderStatic_aRanges = NULL;
+    sithRenderStatic_numRanges = 0;
+    sithRenderStatic_maxRanges = 0;
+    sithRenderStatic_numVertices = 0;
+    sithRenderStatic_numTris = 0;
+    sithRenderStatic_maxTris = 0;
+    sithRenderStatic_pFrameVertices = NULL;
+    sithRenderStatic_pWorld = NULL;
+}
+
+static int sithRenderStatic_EnsureTris(size_t amt)
+{
+    size_t newMax;
+    rdTri* pNew;
+
+    if (amt <= sithRenderStatic_maxTris)
+        return 1;
+
+    newMax = sithRenderStatic_maxTris ? sithRenderStatic_maxTris : 1024;
+    while (newMax < amt)
+        newMax *= 2;
+
+    pNew = (rdTri*)pSithHS->realloc(sithRenderStatic_aTris, sizeof(rdTri) * newMax);
+    if (!pNew)
+        return 0;
+    sithRenderStatic_aTris = pNew;
+
+    pNew = (rdTri*)pSithHS->realloc(sithRenderStatic_aSortTris, sizeof(rdTri) * newMax);
+    if (!pNew)
+        return 0;
+    sithRenderStatic_aSortTris = pNew;
+
+    sithRenderStatic_maxTris = newMax;
+    return 1;
+}
+
+// Marks a surface's vertices for upload, joining it to the last run if they follow on
+static int sithRenderStatic_AddRange(uint32_t first, uint32_t count)
+{
+    std3DVertexRange* pLast;
+
+    if (sithRenderStatic_numRanges)
+    {
+        pLast = &sithRenderStatic_aRanges[sithRenderStatic_numRanges - 1];
+        if (pLast->first + pLast->count == first)
+        {
+            pLast->count += count;
+            return 1;
+        }
+    }
+
+    if (sithRenderStatic_numRanges >= sithRenderStatic_maxRanges)
+    {
+        size_t newMax = sithRenderStatic_maxRanges ? sithRenderStatic_maxRanges * 2 : 256;
+        std3DVertexRange* pNew = (std3DVertexRange*)pSithHS->realloc(sithRenderStatic_aRanges, sizeof(std3DVertexRange) * newMax);
+        if (!pNew)
+            return 0;
+        sithRenderStatic_aRanges = pNew;
+        sithRenderStatic_maxRanges = newMax;
+    }
+
+    sithRenderStatic_aRanges[sithRenderStatic_numRanges].first = first;
+    sithRenderStatic_aRanges[sithRenderStatic_numRanges].count = count;
+    sithRenderStatic_numRanges++;
+    return 1;
+}
+
+// rdCache_SendFaceListToHardware's mip selection, from the nearest vertex's depth
+static int sithRenderStatic_GetMipLevel(rdTexture* texture, rdFace* face)
+{
+    float z_min = 0.0;
+    rdVector3 vertex;
+
+    if (texture->num_mipmaps <= 1)
+        return 0;
+
+    for (int j = 0; j < face->numVertices; j++)
+    {
+        rdMatrix_TransformPoint34(&vertex, &sithRenderStatic_pWorld->vertices[face->vertexPosIdx[j]], &rdCamera_pCurCamera->view_matrix);
+        if (!j || vertex.y < z_min)
+            z_min = vertex.y;
+    }
+
+    if (texture->num_mipmaps == 2)
+        return (z_min <= rdroid_aMipDistances.y) ? 0 : 1;
+
+    if (z_min <= rdroid_aMipDistances.x)
+        return 0;
+    if (z_min <= rdroid_aMipDistances.y)
+        return 1;
+    if (texture->num_mipmaps == 3 || z_min <= rdroid_aMipDistances.z)
+        return 2;
+    return 3;
+}
+
+// Maps world space to rdCache_SendFaceListToHardware's screen space (x, y, 1-(1/z)/far),
+// pre-multiplied by far*z so the GPU can interpolate it perspective correct.
+void sithRenderStatic_CalcScreenProj(float* pOut)
+{
+    rdMatrix34* view = &rdCamera_pCurCamera->view_matrix;
+    rdVector3* aCols[3] = {&view->rvec, &view->lvec, &view->uvec};
+    float invFar = 1.0 / rdCamera_pCurCamera->cameraClipFrustum->field_0.z;
+    float fov = rdCamera_pCurCamera->fov_y;
+    float xCenter = rdCamera_pCurCamera->canvas->screen_height_half;
+    float yCenter = rdCamera_pCurCamera->canvas->screen_width_half;
+    float aspect = rdCamera_pCurCamera->screenAspectRatio;
+
+    if (jkPlayer_enableOrigAspect || rdCamera_pCurCamera->projectLst == rdCamera_PerspProjectSquareLst)
+        aspect = 1.0;
+
+    for (int i = 0; i < 4; i++)
+    {
+        float x = (i < 3) ? aCols[i]->x : view->scale.x;
+        float y = (i < 3) ? aCols[i]->y : view->scale.y;
+        float z = (i < 3) ? aCols[i]->z : view->scale.z;
+        float w = (i < 3) ? 0.0 : 1.0;
+
+        pOut[(i*4)+0] = (fov * x + xCenter * y) / invFar;
+        pOut[(i*4)+1] = (yCenter * y - aspect * fov * z) / invFar;
+        pOut[(i*4)+2] = (y / invFar) - w;
+        pOut[(i*4)+3] = y / invFar;
+    }
+}
+
+int sithRenderStatic_BeginFrame()
+{
+    sithRenderStatic_pFrameVertices = NULL;
+    sithRenderStatic_numTris = 0;
+    sithRenderStatic_numSurfaces = 0;
+    sithRenderStatic_numRanges = 0;
+
+    if (!jkPlayer_enableStaticGeometry || !sithRenderStatic_pWorld || sithRenderStatic_pWorld != sithWorld_pCurrentWorld || !sithRenderStatic_numVertices)
+        return 0;
+
+    // Only the hardware z-buffered perspective path is reproduced on the GPU
+    if (!rdroid_curAcceleration || rdroid_curZBufferMethod != 2 || rdCache_dword_865258 == 16)
+        return 0;
+    if (rdCamera_pCurCamera->projectType != rdCameraProjectType_Perspective || sithRender_lightingIRMode)
+        return 0;
+    if (rdCamera_pCurCamera->cameraClipFrustum->field_0.z == 0.0)
+        return 0;
+
+    if (!std3D_HasStaticGeometry() && !std3D_UploadStaticGeometry(sithRenderStatic_aVertices, sithRenderStatic_numVertices))
+        return 0;
+
+    sithRenderStatic_pFrameVertices = std3D_BeginStaticRenderList();
+    if (!sithRenderStatic_pFrameVertices)
+        return 0;
+
+    sithRenderStatic_CalcScreenProj(sithRenderStatic_aScreenProj);
+
+    return 1;
+}
+
+// Palette effects are applied by the world shader, only the sector tint is baked in
+static uint32_t sithRenderStatic_CalcColor(float light, rdColormap* colormap)
+{
+    int r, g, b;
+
+    r = g = b = (int)(light * 255.0);
+
+    if ( colormap != rdColormap_pIdentityMap )
+    {
+        r = (uint8_t)(int64_t)(colormap->tint.x * (double)r);
+        g = (uint8_t)(int64_t)(colormap->tint.y * (double)g);
+        b = (uint8_t)(int64_t)(colormap->tint.z * (double)b);
+    }
+
+    return 0xFF000000 | (r << 16) | (g << 8) | b;
+}
+
+// Queues a level surface for the resident geometry. Returns 0 if the surface
+// has to go through rdCache instead (sky, translucent, non-gouraud etc).
+int sithRenderStatic_AddSurface(sithSector *sector, sithSurface *surface)
+{
+    rdFace* face = &surface->surfaceInfo.face;
+    rdMaterial* material = face->material;
+    rdTexinfo* texinfo;
+    rdTexture* texture;
+    rdDDrawSurface* tex;
+    std3DStaticVertex* pOut;
+    int geometryMode, lightingMode, cel, mipmap_level;
+    unsigned int out_width, out_height;
+    float ambientLight, minLight;
+    uint32_t base;
+
+    if (!sithRenderStatic_pFrameVertices)
+        return 0;
+    if ( (surface->surfaceFlags & (SURFACEFLAGS_200|SURFACEFLAGS_400)) != 0 )
+        return 0;
+    if ( !material || (face->type & 2) != 0 || face->numVertices < 3 )
+        return 0;
+
+    geometryMode = face->geometryMode;
+    if ( geometryMode >= sithRender_geoMode )
+        geometryMode = sithRender_geoMode;
+    if ( geometryMode >= rdroid_curGeometryMode )
+        geometryMode = rdroid_curGeometryMode;
+    lightingMode = face->lightingMode;
+    if ( lightingMode >= sithRender_lightMode )
+        lightingMode = sithRender_lightMode;
+    if ( lightingMode >= rdroid_curLightingMode )
+        lightingMode = rdroid_curLightingMode;
+    if ( geometryMode != 4 || (lightingMode != 0 && lightingMode != 3) )
+        return 0;
+
+    cel = face->wallCel;
+    if ( cel == -1 )
+        cel = material->celIdx;
+    if ( cel < 0 )
+        cel = 0;
+    else if ( cel > material->num_texinfo - 1 )
+        cel = material->num_texinfo - 1;
+
+    texinfo = material->texinfos[cel];
+    if ( !texinfo || (texinfo->header.texture_type & 8) == 0 )
+        return 0;
+    texture = texinfo->texture_ptr;
+    if ( (texture->alpha_en & 1) != 0 )
+        return 0;
+
+    mipmap_level = sithRenderStatic_GetMipLevel(texture, face);
+    if ( !rdMaterial_AddToTextureCache(material, texture, mipmap_level, 0) )
+        return 0;
+    tex = &texture->alphaMats[mipmap_level];
+
+    base = sithRenderStatic_aSurfaceVertices[surface - sithRenderStatic_pWorld->surfaces];
+    if ( !sithRenderStatic_EnsureTris(sithRenderStatic_numTris + face->numVertices - 2) )
+        return 0;
+    if ( !sithRenderStatic_AddRange(base, face->numVertices) )
+        return 0;
+
+    std3D_GetValidDimension(
+        texture->texture_struct[mipmap_level]->format.width,
+        texture->texture_struct[mipmap_level]->format.height,
+        &out_width,
+        &out_height);
+    out_width <<= mipmap_level;
+    out_height <<= mipmap_level;
+
+    ambientLight = stdMath_Clamp(sector->extraLight, 0.0, 1.0);
+    minLight = (rdroid_curRenderOptions & 2) ? ambientLight : 0.0;
+
+    pOut = &sithRenderStatic_pFrameVertices[base];
+    for (int j = 0; j < face->numVertices; j++)
+    {
+        int posIdx = face->vertexPosIdx[j];
+        int uvIdx = face->vertexUVIdx[j];
+        float light = 1.0;
+
+        // rdPrimit3_ClipFace's gouraud intensities, then rdCache's extralight and ambient floor
+        if ( lightingMode == 3 && ambientLight < 1.0 )
+        {
+            light = stdMath_Clamp(sithRenderStatic_pWorld->verticesDynamicLight[posIdx] + surface->surfaceInfo.intensities[j], 0.0, 1.0);
+            light = stdMath_Clamp(light + face->extraLight, 0.0, 1.0);
+            if ( light <= minLight )
+                light = minLight;
+        }
+
+        pOut[j].color = sithRenderStatic_CalcColor(light, sector->colormap);
+        pOut[j].tu = (sithRenderStatic_pWorld->vertexUVs[uvIdx].x + face->clipIdk.x) / (float)out_width;
+        pOut[j].tv = (sithRenderStatic_pWorld->vertexUVs[uvIdx].y + face->clipIdk.y) / (float)out_height;
+    }
+
+    // Same fan as rdCache_SendFaceListToHardware so the winding matches
+    {
+        int a = 0;
+        int b = 1;
+        int c = face->numVertices - 1;
+        for (int i = 0; i < face->numVertices - 2; i++)
+        {
+            rdTri* tri = &sithRenderStatic_aTris[sithRenderStatic_numTris++];
+            tri->v3 = base + a;
+            tri->v2 = base + b;
+            tri->v1 = base + c;
+            tri->flags = RDCACHE_TRI_ZBUFFERED;
+            tri->texture = tex;
+            tri->sortKey = rdCache_TriSortKey(tri);
+
+            if ( (i & 1) != 0 )
+            {
+                a = c--;
+            }
+            else
+            {
+                a = b++;
+            }
+        }
+    }
+    sithRenderStatic_numSurfaces++;
+
+    return 1;
+}
+
+void sithRenderStatic_Draw()
+{
+    if (!sithRenderStatic_pFrameVertices)
+        return;
+
+    rdCache_RadixSortTris(sithRenderStatic_aTris, sithRenderStatic_aSortTris, sithRenderStatic_numTris);
+    std3D_DrawStaticRenderList(sithRenderStatic_aTris, sithRenderStatic_numTris, sithRenderStatic_aRanges, sithRenderStatic_numRanges, sithRenderStatic_aScreenProj);
+
+    rdCache_drawnFaces += sithRenderStatic_numSurfaces;
+    sithRenderStatic_pFrameVertices = NULL;
+    sithRenderStatic_numTris = 0;
+    sithRenderStatic_numSurfaces = 0;
+    sithRenderStatic_numRanges = 0;
+}
+
+#endif // SDL2_RENDER
@@ -0,0 +1,17 @@
+#ifndef _SITHRENDERSTATIC_H
+#define _SITHRENDERSTATIC_H
+
+#include "types.h"
+#include "globals.h"
+
+// Added: Level surfaces kept resident on the GPU, see jkPlayer_enableStaticGeometry
+#ifdef SDL2_RENDER
+int sithRenderStatic_Open(sithWorld *world);
+void sithRenderStatic_Close();
+int sithRenderStatic_BeginFrame();
+int sithRenderStatic_AddSurface(sithSector *sector, sithSurface *surface);
+void sithRenderStatic_Draw();
+void sithRenderStatic_CalcScreenProj(float* pOut);
+#endif
+
+#endif // _SITHRENDERSTATIC_H
@@ -11,6 +11,7 @@
 #include "Gui/jkGUISound.h"
 #include "World/sithWorld.h"
 #include "World/sithSector.h"
+#include "World/sithPVS.h"
 #include "World/jkPlayer.h"
 #include "Dss/sithDSSThing.h"
 #include "jk.h"
@@ -1574,6 +1575,18 @@ void sithSoundSys_UpdatePlayingSoundPosition(sithPlayingSound *sound)
             sound->flags &= ~SITHSOUNDFLAG_UNDERWATER;
         else
             sound->flags |= SITHSOUNDFLAG_UNDERWATER;
+
+#ifdef QOL_IMPROVEMENTS
+        // Added: optionally treat things the camera's PVS can't reach as out of range,
+        // so their sounds aren't loaded or positioned
+        if ( jkPlayer_enableSoundCulling
+          && v6->sector
+          && !sithPVS_IsNearVisible(sithCamera_currentCamera->sector, v6->sector) )
+        {
+            sound->anonymous_13 = sound->maxPosition - -1.0;
+            return;
+        }
+#endif
     }
     v13 = pRelative->x;
     if ( v13 < 0.0 )
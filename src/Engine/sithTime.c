@@ -11,8 +11,81 @@
 #define SITHTIME_MAXDELTA (500)
 #endif
 
+#ifdef QOL_IMPROVEMENTS
+#define SITHTIME_MAXFIXEDSTEPS (8) // more are dropped, so a slow frame can't snowball
+
+// Added: fixed rate ticking, see sith_TickFixed
+int sithTime_fixedHz = 0;
+float sithTime_fixedAlpha = 0.0;
+float sithTime_frameSeconds = 0.0; // real time covered by the last sithTime_BeginFixedSteps
+static int sithTime_bFixedStep = 0;
+static uint32_t sithTime_fixedLastMs = 0;  // real time handed out as steps so far, 0 to start over
+static uint64_t sithTime_fixedAccumUs = 0; // real time not yet simulated
+static uint64_t sithTime_fixedSimUs = 0;   // simulated time, steps round to whole ms off this
+
+// Added: Accounts for the real time since the last call and returns how many
+// fixed steps of 1/hz seconds are due. sithTime_Tick hands out one of them
+// each call until sithTime_EndFixedSteps.
+int sithTime_BeginFixedSteps(int hz)
+{
+    uint32_t now = stdPlatform_GetTimeMsec();
+    uint32_t stepUs = 1000000 / hz;
+    uint32_t elapsedMs;
+    int numSteps;
+
+    if ( !sithTime_fixedLastMs || hz != sithTime_fixedHz )
+    {
+        // Pick up from the last tick, whichever kind it was
+        elapsedMs = now - sithTime_curMsAbsolute;
+        sithTime_fixedAccumUs = 0;
+    }
+    else
+    {
+        elapsedMs = now - sithTime_fixedLastMs;
+    }
+    if ( elapsedMs > SITHTIME_MAXDELTA )
+        elapsedMs = SITHTIME_MAXDELTA;
+
+    sithTime_fixedHz = hz;
+    sithTime_fixedLastMs = now ? now : 1;
+    sithTime_fixedAccumUs += (uint64_t)elapsedMs * 1000;
+    sithTime_frameSeconds = (float)elapsedMs * 0.001;
+
+    numSteps = (int)(sithTime_fixedAccumUs / stepUs);
+    if ( numSteps > SITHTIME_MAXFIXEDSTEPS )
+    {
+        numSteps = SITHTIME_MAXFIXEDSTEPS;
+        sithTime_fixedAccumUs = (uint64_t)stepUs * numSteps + sithTime_fixedAccumUs % stepUs;
+    }
+    sithTime_fixedAccumUs -= (uint64_t)stepUs * numSteps;
+    sithTime_fixedAlpha = (float)sithTime_fixedAccumUs / (float)stepUs;
+
+    sithTime_bFixedStep = 1;
+    return numSteps;
+}
+
+void sithTime_EndFixedSteps()
+{
+    sithTime_bFixedStep = 0;
+}
+#endif
+
 void sithTime_Tick()
 {
+#ifdef QOL_IMPROVEMENTS
+    // Added: fixed steps advance by exactly 1/hz, rounded so whole ms add up
+    if ( sithTime_bFixedStep )
+    {
+        uint32_t stepUs = 1000000 / sithTime_fixedHz;
+        int deltaMs = (int)((sithTime_fixedSimUs + stepUs) / 1000 - sithTime_fixedSimUs / 1000);
+
+        sithTime_fixedSimUs += stepUs;
+        sithTime_SetDelta(deltaMs);
+        return;
+    }
+    sithTime_fixedHz = 0;
+    sithTime_fixedLastMs = 0;
+#endif
     sithTime_SetDelta(stdPlatform_GetTimeMsec() - sithTime_curMsAbsolute);
 }
 
@@ -31,6 +104,10 @@ void sithTime_Resume()
     {
         sithTime_bRunning = 0;
         sithTime_curMsAbsolute += stdPlatform_GetTimeMsec() - sithTime_pauseTimeMs;
+#ifdef QOL_IMPROVEMENTS
+        if ( sithTime_fixedLastMs )
+            sithTime_fixedLastMs += stdPlatform_GetTimeMsec() - sithTime_pauseTimeMs;
+#endif
     }
 }
 
@@ -60,6 +137,10 @@ void sithTime_Startup()
     sithTime_deltaSeconds = 0.0;
     sithTime_TickHz = 0.0;
     sithTime_curMsAbsolute = stdPlatform_GetTimeMsec();
+#ifdef QOL_IMPROVEMENTS
+    sithTime_fixedHz = 0;
+    sithTime_fixedLastMs = 0;
+#endif
 }
 
 void sithTime_SetMs(uint32_t curMs)
@@ -70,4 +151,8 @@ void sithTime_SetMs(uint32_t curMs)
     sithTime_deltaMs = 0;
     sithTime_curSeconds = (double)curMs * 0.001;
     sithTime_curMsAbsolute = stdPlatform_GetTimeMsec();
+#ifdef QOL_IMPROVEMENTS
+    sithTime_fixedHz = 0;
+    sithTime_fixedLastMs = 0;
+#endif
 }
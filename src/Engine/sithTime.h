@@ -17,4 +17,13 @@ void sithTime_SetDelta(int deltaMs);
 void sithTime_Startup();
 void sithTime_SetMs(uint32_t curMs);
 
+#ifdef QOL_IMPROVEMENTS
+extern int sithTime_fixedHz;
+extern float sithTime_fixedAlpha;
+extern float sithTime_frameSeconds;
+
+int sithTime_BeginFixedSteps(int hz);
+void sithTime_EndFixedSteps();
+#endif
+
 #endif // _SITHTIME_H
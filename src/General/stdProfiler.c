@@ -0,0 +1,201 @@
+#include "stdProfiler.h"
+
+#include "General/stdString.h"
+#include "stdPlatform.h"
+#include "jk.h"
+
+#ifdef QOL_IMPROVEMENTS
+
+#ifdef SDL2_RENDER
+#ifdef ARCH_WASM
+#include <SDL2/SDL.h>
+#else
+#include <SDL.h>
+#endif
+#endif
+
+int stdProfiler_bActive = 0;
+int stdProfiler_bOverlay = 0;
+
+static const char* stdProfiler_aZoneNames[STDPROFILER_NUM_ZONES] = {
+    "frame",
+    "event",
+    "cogvm",
+    "ai",
+    "things",
+    "cogscript",
+    "clip",
+    "lights",
+    "geometry",
+    "renderthings",
+    "alpha",
+    "flush",
+    "endscene",
+    "present",
+};
+
+static stdFile_t stdProfiler_csvFd = 0;
+static uint64_t stdProfiler_aStartUs[STDPROFILER_NUM_ZONES];
+static uint64_t stdProfiler_aAccumUs[STDPROFILER_NUM_ZONES];
+static uint64_t stdProfiler_lastFrameUs = 0;
+static uint32_t stdProfiler_frameNum = 0;
+
+// Rolling window of per-frame zone times, in milliseconds
+static float stdProfiler_aHistory[STDPROFILER_NUM_ZONES][STDPROFILER_HISTORY];
+static int stdProfiler_historyIdx = 0;
+static int stdProfiler_historyCount = 0;
+
+static uint64_t stdProfiler_TimeUs()
+{
+#if defined(SDL2_RENDER)
+    uint64_t counter = SDL_GetPerformanceCounter();
+    uint64_t freq = SDL_GetPerformanceFrequency();
+
+    return (counter / freq) * 1000000 + ((counter % freq) * 1000000) / freq;
+#elif defined(PLATFORM_POSIX)
+    return Linux_TimeUs();
+#else
+    return (uint64_t)stdPlatform_GetTimeMsec() * 1000;
+#endif
+}
+
+// Called whenever the overlay or CSV log is switched, stale samples from the
+// last time it ran are dropped
+static void stdProfiler_UpdateActive()
+{
+    int bActive = stdProfiler_bOverlay || stdProfiler_csvFd;
+
+    if (bActive && !stdProfiler_bActive)
+    {
+        _memset(stdProfiler_aStartUs, 0, sizeof(stdProfiler_aStartUs));
+        _memset(stdProfiler_aAccumUs, 0, sizeof(stdProfiler_aAccumUs));
+        stdProfiler_lastFrameUs = 0;
+        stdProfiler_historyIdx = 0;
+        stdProfiler_historyCount = 0;
+    }
+    stdProfiler_bActive = bActive;
+}
+
+void stdProfiler_Begin(int zone)
+{
+    if (!stdProfiler_bActive)
+        return;
+
+    stdProfiler_aStartUs[zone] = stdProfiler_TimeUs();
+}
+
+void stdProfiler_End(int zone)
+{
+    if (!stdProfiler_bActive || !stdProfiler_aStartUs[zone])
+        return;
+
+    stdProfiler_aAccumUs[zone] += stdProfiler_TimeUs() - stdProfiler_aStartUs[zone];
+    stdProfiler_aStartUs[zone] = 0;
+}
+
+void stdProfiler_EndFrame()
+{
+    uint64_t now;
+    char aLine[512];
+    int lineLen;
+
+    if (!stdProfiler_bActive)
+        return;
+
+    // The first frame has no start, only begin measuring from here
+    now = stdProfiler_TimeUs();
+    if (!stdProfiler_lastFrameUs)
+    {
+        stdProfiler_lastFrameUs = now;
+        _memset(stdProfiler_aAccumUs, 0, sizeof(stdProfiler_aAccumUs));
+        return;
+    }
+    stdProfiler_aAccumUs[STDPROFILER_ZONE_FRAME] = now - stdProfiler_lastFrameUs;
+    stdProfiler_lastFrameUs = now;
+
+    for (int i = 0; i < STDPROFILER_NUM_ZONES; i++)
+        stdProfiler_aHistory[i][stdProfiler_historyIdx] = (float)stdProfiler_aAccumUs[i] / 1000.0f;
+
+    if (stdProfiler_csvFd)
+    {
+        lineLen = stdString_snprintf(aLine, sizeof(aLine), "%u", stdProfiler_frameNum);
+        for (int i = 0; i < STDPROFILER_NUM_ZONES && lineLen > 0 && lineLen < (int)sizeof(aLine); i++)
+            lineLen += stdString_snprintf(&aLine[lineLen], sizeof(aLine) - lineLen, ",%.3f", stdProfiler_aHistory[i][stdProfiler_historyIdx]);
+        std_pHS->filePrintf(stdProfiler_csvFd, "%s\n", aLine);
+    }
+
+    stdProfiler_historyIdx = (stdProfiler_historyIdx + 1) % STDPROFILER_HISTORY;
+    if (stdProfiler_historyCount < STDPROFILER_HISTORY)
+        stdProfiler_historyCount++;
+
+    _memset(stdProfiler_aAccumUs, 0, sizeof(stdProfiler_aAccumUs));
+    stdProfiler_frameNum++;
+}
+
+void stdProfiler_SetOverlay(int bEnabled)
+{
+    stdProfiler_bOverlay = bEnabled;
+    stdProfiler_UpdateActive();
+}
+
+int stdProfiler_OpenCsv(const char *fpath)
+{
+    stdProfiler_CloseCsv();
+
+    stdProfiler_csvFd = std_pHS->fileOpen(fpath, "w");
+    if (!stdProfiler_csvFd)
+        return 0;
+
+    std_pHS->filePrintf(stdProfiler_csvFd, "framenum");
+    for (int i = 0; i < STDPROFILER_NUM_ZONES; i++)
+        std_pHS->filePrintf(stdProfiler_csvFd, ",%s_ms", stdProfiler_aZoneNames[i]);
+    std_pHS->filePrintf(stdProfiler_csvFd, "\n");
+
+    stdProfiler_frameNum = 0;
+    stdProfiler_UpdateActive();
+    return 1;
+}
+
+void stdProfiler_CloseCsv()
+{
+    if (stdProfiler_csvFd)
+        std_pHS->fileClose(stdProfiler_csvFd);
+
+    stdProfiler_csvFd = 0;
+    stdProfiler_UpdateActive();
+}
+
+int stdProfiler_IsCsvOpen()
+{
+    return stdProfiler_csvFd != 0;
+}
+
+const char* stdProfiler_GetZoneName(int zone)
+{
+    return stdProfiler_aZoneNames[zone];
+}
+
+int stdProfiler_GetZoneStats(int zone, float *pMinMs, float *pAvgMs, float *pMaxMs)
+{
+    float total = 0.0;
+
+    if (!stdProfiler_historyCount)
+        return 0;
+
+    *pMinMs = stdProfiler_aHistory[zone][0];
+    *pMaxMs = stdProfiler_aHistory[zone][0];
+    for (int i = 0; i < stdProfiler_historyCount; i++)
+    {
+        float val = stdProfiler_aHistory[zone][i];
+
+        if (val < *pMinMs)
+            *pMinMs = val;
+        if (val > *pMaxMs)
+            *pMaxMs = val;
+        total += val;
+    }
+    *pAvgMs = total / stdProfiler_historyCount;
+    return 1;
+}
+
+#endif // QOL_IMPROVEMENTS
@@ -0,0 +1,48 @@
+#ifndef _STDPROFILER_H
+#define _STDPROFILER_H
+
+#include "types.h"
+#include "globals.h"
+
+// Added: Scoped per-frame timers around the main tick and render steps.
+// Zones may be entered several times a frame, their times are summed.
+// Nothing is timed unless the overlay or the CSV log is enabled.
+
+#define STDPROFILER_ZONE_FRAME        (0)
+#define STDPROFILER_ZONE_EVENT        (1)
+#define STDPROFILER_ZONE_COGVM        (2)
+#define STDPROFILER_ZONE_AI           (3)
+#define STDPROFILER_ZONE_THINGS       (4)
+#define STDPROFILER_ZONE_COGSCRIPT    (5)
+#define STDPROFILER_ZONE_CLIP         (6)
+#define STDPROFILER_ZONE_LIGHTS       (7)
+#define STDPROFILER_ZONE_GEOMETRY     (8)
+#define STDPROFILER_ZONE_RENDERTHINGS (9)
+#define STDPROFILER_ZONE_ALPHA        (10)
+#define STDPROFILER_ZONE_FLUSH        (11)
+#define STDPROFILER_ZONE_ENDSCENE     (12)
+#define STDPROFILER_ZONE_PRESENT      (13)
+#define STDPROFILER_NUM_ZONES         (14)
+
+#define STDPROFILER_HISTORY (128)
+
+#ifdef QOL_IMPROVEMENTS
+extern int stdProfiler_bActive;
+extern int stdProfiler_bOverlay;
+
+void stdProfiler_Begin(int zone);
+void stdProfiler_End(int zone);
+void stdProfiler_EndFrame();
+void stdProfiler_SetOverlay(int bEnabled);
+int stdProfiler_OpenCsv(const char *fpath);
+void stdProfiler_CloseCsv();
+int stdProfiler_IsCsvOpen();
+const char* stdProfiler_GetZoneName(int zone);
+int stdProfiler_GetZoneStats(int zone, float *pMinMs, float *pAvgMs, float *pMaxMs);
+#else
+#define stdProfiler_Begin(zone) do {} while (0)
+#define stdProfiler_End(zone) do {} while (0)
+#define stdProfiler_EndFrame() do {} while (0)
+#endif
+
+#endif // _STDPROFILER_H
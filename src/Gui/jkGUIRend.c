@@ -192,11 +192,19 @@ LABEL_22:
                         --v30;
                     }
                     while ( v30 );
+#ifdef SDL2_RENDER
+                    stdDisplay_VBufferUnlockRect(vbuf, rect);
+#else
                     stdDisplay_VBufferUnlock(vbuf);
+#endif
                     return;
                 }
             }
+#ifdef SDL2_RENDER
+            stdDisplay_VBufferUnlockRect(vbuf, rect);
+#else
             stdDisplay_VBufferUnlock(vbuf);
+#endif
             return;
         }
     }
@@ -411,6 +411,9 @@ int jkCutscene_smacker_process()
     }
 
     _memcpy(stdDisplay_masterPalette, smk_get_palette(jkCutscene_smk), 0x300);
+#ifdef SDL2_RENDER
+    stdDisplay_paletteGeneration++;
+#endif
     
     stdDisplay_VBufferLock(jkCutscene_frameBuf);
 	_memcpy(jkCutscene_frameBuf->surface_lock_alloc, smk_get_video(jkCutscene_smk), jkCutscene_smk_w*jkCutscene_smk_h);
@@ -4,6 +4,9 @@
 #include "General/stdBitmap.h"
 #include "General/stdFont.h"
 #include "General/stdString.h"
+#include "General/stdProfiler.h"
+#include "Engine/sithCollision.h"
+#include "Engine/sithCollisionGrid.h"
 #include "Win95/stdDisplay.h"
 #include "Win95/DebugConsole.h"
 #include "Win95/WinIdk.h"
@@ -42,6 +45,12 @@ void jkDev_Startup()
     DebugConsole_RegisterDevCmd(jkDev_CmdDispStats, "dispstats", 0);
     DebugConsole_RegisterDevCmd(jkDev_CmdKill, "kill", 0);
     DebugConsole_RegisterDevCmd(jkDev_CmdEndLevel, "endlevel", 0);
+#ifdef QOL_IMPROVEMENTS
+    DebugConsole_RegisterDevCmd(jkDev_CmdProfile, "profile", 0); // Added
+    DebugConsole_RegisterDevCmd(jkDev_CmdCollisionGrid, "collisiongrid", 0); // Added
+    DebugConsole_RegisterDevCmd(jkDev_CmdSearchStats, "searchstats", 0); // Added
+    DebugConsole_RegisterDevCmd(jkDev_CmdSimRate, "simrate", 0); // Added
+#endif
 
     jkDev_RegisterCmd(jkDev_CmdDebugFlags, "whiteflag", "Disable AI", 0);
     jkDev_RegisterCmd(jkDev_CmdFly, "eriamjh", "", 0);
@@ -74,6 +83,9 @@ void jkDev_Shutdown()
     }
     DebugConsole_Close();
     DebugConsole_Shutdown();
+#ifdef QOL_IMPROVEMENTS
+    stdProfiler_CloseCsv();
+#endif
     jkDev_bInitted = 0;
 }
 
@@ -453,6 +465,197 @@ int jkDev_CmdDispStats(stdDebugConsoleCmd *pCmd, const char *pArgStr)
     return 1;
 }
 
+#ifdef QOL_IMPROVEMENTS
+// Added: PROFILE toggles the overlay, PROFILE CSV [file] logs every frame's
+// zone times to a file and PROFILE CSV OFF stops logging
+int jkDev_CmdProfile(stdDebugConsoleCmd *pCmd, const char *pArgStr)
+{
+    char aArg[32];
+    char aPath[128];
+    int numArgs = 0;
+
+    if ( pArgStr )
+        numArgs = _sscanf(pArgStr, "%31s %127s", aArg, aPath);
+
+    if ( numArgs <= 0 )
+    {
+        stdProfiler_SetOverlay(!stdProfiler_bOverlay);
+        return 1;
+    }
+
+    if ( __strcmpi(aArg, "csv") )
+    {
+        DebugConsole_Print("Format: PROFILE [CSV [file|OFF]]");
+        return 0;
+    }
+
+    if ( numArgs >= 2 && !__strcmpi(aPath, "off") )
+    {
+        if ( stdProfiler_IsCsvOpen() )
+            DebugConsole_Print("Profiler CSV closed.");
+        stdProfiler_CloseCsv();
+        return 1;
+    }
+
+    if ( numArgs < 2 )
+        _strncpy(aPath, "profile.csv", sizeof(aPath));
+
+    if ( !stdProfiler_OpenCsv(aPath) )
+    {
+        DebugConsole_Print("Could not open profiler CSV.");
+        return 0;
+    }
+
+    stdString_snprintf(std_genBuffer, 1024, "Writing frame times to %s", aPath);
+    DebugConsole_Print(std_genBuffer);
+    return 1;
+}
+
+// Added: COLLISIONGRID toggles the thing collision broadphase, COLLISIONGRID
+// CHECK also runs the full sector walk for every query it answers and
+// compares the results, COLLISIONGRID STATS prints the check counts
+int jkDev_CmdCollisionGrid(stdDebugConsoleCmd *pCmd, const char *pArgStr)
+{
+    char aArg[32];
+    int numArgs = 0;
+
+    if ( pArgStr )
+        numArgs = _sscanf(pArgStr, "%31s", aArg);
+
+    if ( numArgs <= 0 )
+    {
+        jkPlayer_enableCollisionGrid = !jkPlayer_enableCollisionGrid;
+        DebugConsole_Print(jkPlayer_enableCollisionGrid ? "Collision grid on." : "Collision grid off.");
+        return 1;
+    }
+
+    if ( !__strcmpi(aArg, "check") )
+    {
+        sithCollisionGrid_bCheck = !sithCollisionGrid_bCheck;
+        sithCollisionGrid_numChecks = 0;
+        sithCollisionGrid_numMismatches = 0;
+        DebugConsole_Print(sithCollisionGrid_bCheck ? "Collision grid check on." : "Collision grid check off.");
+        return 1;
+    }
+
+    if ( !__strcmpi(aArg, "stats") )
+    {
+        stdString_snprintf(std_genBuffer, 1024, "Collision grid %s, check %s: %u queries checked, %u mismatches",
+                           jkPlayer_enableCollisionGrid ? "on" : "off", sithCollisionGrid_bCheck ? "on" : "off",
+                           sithCollisionGrid_numChecks, sithCollisionGrid_numMismatches);
+        DebugConsole_Print(std_genBuffer);
+        return 1;
+    }
+
+    DebugConsole_Print("Format: COLLISIONGRID [CHECK|STATS]");
+    return 0;
+}
+
+// Added: how far collision searches went past the original search stack
+int jkDev_CmdSearchStats(stdDebugConsoleCmd *pCmd, const char *pArgStr)
+{
+    char aArg[32];
+    int numArgs = 0;
+
+    if ( pArgStr )
+        numArgs = _sscanf(pArgStr, "%31s", aArg);
+
+    if ( numArgs > 0 )
+    {
+        if ( __strcmpi(aArg, "reset") )
+        {
+            DebugConsole_Print("Format: SEARCHSTATS [RESET]");
+            return 0;
+        }
+
+        sithCollision_numResultOverflows = 0;
+        sithCollision_numSectorOverflows = 0;
+        sithCollision_numDepthOverflows = 0;
+        sithCollision_maxSearchResults = 0;
+        sithCollision_maxSearchSectors = 0;
+        sithCollision_maxSearchDepth = 0;
+        DebugConsole_Print("Search stats reset.");
+        return 1;
+    }
+
+    stdString_snprintf(std_genBuffer, 1024, "Results: max %d/%d, %u over",
+                       sithCollision_maxSearchResults, SITHCOLLISION_SEARCH_MAX_RESULTS, sithCollision_numResultOverflows);
+    DebugConsole_Print(std_genBuffer);
+    stdString_snprintf(std_genBuffer, 1024, "Sectors: max %d/%d, %u over",
+                       sithCollision_maxSearchSectors, SITHCOLLISION_SEARCH_MAX_SECTORS, sithCollision_numSectorOverflows);
+    DebugConsole_Print(std_genBuffer);
+    stdString_snprintf(std_genBuffer, 1024, "Depth: max %d/%d, %u over",
+                       sithCollision_maxSearchDepth, SITHCOLLISION_SEARCH_MAX_DEPTH, sithCollision_numDepthOverflows);
+    DebugConsole_Print(std_genBuffer);
+    return 1;
+}
+
+// Added: SIMRATE prints the simulation rate, SIMRATE HZ sets it, 0 ticks
+// once a frame like the original
+int jkDev_CmdSimRate(stdDebugConsoleCmd *pCmd, const char *pArgStr)
+{
+    int hz = 0;
+    int numArgs = 0;
+
+    if ( pArgStr )
+        numArgs = _sscanf(pArgStr, "%d", &hz);
+
+    if ( numArgs > 0 )
+    {
+        if ( hz != 0 && (hz < SIM_RATE_MIN || hz > SIM_RATE_MAX) )
+        {
+            stdString_snprintf(std_genBuffer, 1024, "Format: SIMRATE [0|%d-%d]", SIM_RATE_MIN, SIM_RATE_MAX);
+            DebugConsole_Print(std_genBuffer);
+            return 0;
+        }
+        jkPlayer_simRate = hz;
+    }
+
+    if ( jkPlayer_simRate )
+        stdString_snprintf(std_genBuffer, 1024, "Simulating at %d Hz.", jkPlayer_simRate);
+    else
+        stdString_snprintf(std_genBuffer, 1024, "Simulating once a frame.");
+    DebugConsole_Print(std_genBuffer);
+    return 1;
+}
+
+// Added: rolling min/avg/max of every profiler zone, drawn over the HUD
+void jkDev_DrawProfiler()
+{
+    char aText[32];
+    float minMs, avgMs, maxMs;
+    int lineHeight;
+    int y;
+
+    if ( !stdProfiler_bOverlay || !jkHud_pMsgFontSft || !Video_pCanvas )
+        return;
+
+    lineHeight = (*jkHud_pMsgFontSft->bitmap->mipSurfaces)->format.height + jkHud_pMsgFontSft->marginY;
+    y = Video_pCanvas->yStart + 4;
+
+    stdFont_DrawAscii(Video_pMenuBuffer, jkHud_pMsgFontSft, 4, y, 999, "zone (ms)", 1);
+    stdFont_DrawAscii(Video_pMenuBuffer, jkHud_pMsgFontSft, 100, y, 999, "min", 1);
+    stdFont_DrawAscii(Video_pMenuBuffer, jkHud_pMsgFontSft, 150, y, 999, "avg", 1);
+    stdFont_DrawAscii(Video_pMenuBuffer, jkHud_pMsgFontSft, 200, y, 999, "max", 1);
+    y += lineHeight;
+
+    for (int i = 0; i < STDPROFILER_NUM_ZONES; i++)
+    {
+        if ( !stdProfiler_GetZoneStats(i, &minMs, &avgMs, &maxMs) )
+            break;
+
+        stdFont_DrawAscii(Video_pMenuBuffer, jkHud_pMsgFontSft, 4, y, 999, (char*)stdProfiler_GetZoneName(i), 1);
+        stdString_snprintf(aText, sizeof(aText), "%.2f", minMs);
+        stdFont_DrawAscii(Video_pMenuBuffer, jkHud_pMsgFontSft, 100, y, 999, aText, 1);
+        stdString_snprintf(aText, sizeof(aText), "%.2f", avgMs);
+        stdFont_DrawAscii(Video_pMenuBuffer, jkHud_pMsgFontSft, 150, y, 999, aText, 1);
+        stdString_snprintf(aText, sizeof(aText), "%.2f", maxMs);
+        stdFont_DrawAscii(Video_pMenuBuffer, jkHud_pMsgFontSft, 200, y, 999, aText, 1);
+        y += lineHeight;
+    }
+}
+#endif
+
 int jkDev_CmdKill(stdDebugConsoleCmd *pCmd, const char *pArgStr)
 {
     sithThing_Hit(g_localPlayerThing, g_localPlayerThing, 200.0, 1);
@@ -85,6 +85,13 @@ int jkDev_CmdHeal(stdDebugConsoleCmd *pCmd, const char *pArgStr);
 int jkDev_CmdAllMap(stdDebugConsoleCmd *pCmd, const char *pArgStr);
 int jkDev_CmdMana(stdDebugConsoleCmd *pCmd, const char *pArgStr);
 int jkDev_CmdTeam(stdDebugConsoleCmd *pCmd, const char *pArgStr);
+#ifdef QOL_IMPROVEMENTS
+int jkDev_CmdProfile(stdDebugConsoleCmd *pCmd, const char *pArgStr);
+int jkDev_CmdCollisionGrid(stdDebugConsoleCmd *pCmd, const char *pArgStr);
+int jkDev_CmdSearchStats(stdDebugConsoleCmd *pCmd, const char *pArgStr);
+int jkDev_CmdSimRate(stdDebugConsoleCmd *pCmd, const char *pArgStr);
+void jkDev_DrawProfiler();
+#endif
 
 int jkDev_UpdateEntries();
 
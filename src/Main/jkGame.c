@@ -1,6 +1,7 @@
 #include "jkGame.h"
 
 #include "General/stdPalEffects.h"
+#include "General/stdProfiler.h"
 #include "Engine/sith.h"
 #include "Engine/rdroid.h"
 #include "Engine/rdCache.h"
@@ -182,6 +183,12 @@ int jkGame_Update()
     return result;
 }
 #else
+// Added: what the master palette was last copied from, so it's only
+// rewritten (and its generation bumped) when the source changes
+static rdColormap* jkGame_pPaletteColormap = NULL;
+static uint32_t jkGame_paletteColormapGeneration = 0;
+static uint32_t jkGame_paletteGeneration = 0;
+
 int jkGame_Update()
 {
     int64_t v0; // rcx
@@ -206,7 +213,17 @@ int jkGame_Update()
     //if ( Video_modeStruct.b3DAccel )
         rdSetColorEffects(&stdPalEffects_state.effect);
 
-    _memcpy(stdDisplay_masterPalette, sithWorld_pCurrentWorld->colormaps->colors, 0x300);
+    if (jkGame_pPaletteColormap != sithWorld_pCurrentWorld->colormaps
+        || jkGame_paletteColormapGeneration != rdColormap_loadGeneration
+        || jkGame_paletteGeneration != stdDisplay_paletteGeneration)
+    {
+        _memcpy(stdDisplay_masterPalette, sithWorld_pCurrentWorld->colormaps->colors, 0x300);
+        stdDisplay_paletteGeneration++;
+
+        jkGame_pPaletteColormap = sithWorld_pCurrentWorld->colormaps;
+        jkGame_paletteColormapGeneration = rdColormap_loadGeneration;
+        jkGame_paletteGeneration = stdDisplay_paletteGeneration;
+    }
     rdAdvanceFrame();
     //if ( Video_modeStruct.b3DAccel )
     {
@@ -274,10 +291,47 @@ int jkGame_Update()
         }
     }*/
 
+#ifdef QOL_IMPROVEMENTS
+    if ( Main_bDispStats )
+    {
+        ++Video_dword_5528A0;
+        Video_dword_5528A8 = stdPlatform_GetTimeMsec();
+        if ( (unsigned int)(Video_dword_5528A8 - Video_lastTimeMsec) > 0x3E8 )
+        {
+            Video_flt_55289C = (double)(Video_dword_5528A0 - Video_dword_5528A4) * 1000.0 / (double)(unsigned int)(Video_dword_5528A8 - Video_lastTimeMsec);
+#ifdef SDL2_RENDER
+            _sprintf(
+                std_genBuffer,
+                "%02.3f %3ds %4dp %2dfl %5dt %3db",
+                Video_flt_55289C,
+                sithRender_surfacesDrawn,
+                rdCache_drawnFaces,
+                rdCache_lastFrameFlushes,
+                std3D_lastFrameTris,
+                std3D_lastFrameBatches);
+#else
+            _sprintf(
+                std_genBuffer,
+                "%02.3f %3ds %4dp %2dfl",
+                Video_flt_55289C,
+                sithRender_surfacesDrawn,
+                rdCache_drawnFaces,
+                rdCache_lastFrameFlushes);
+#endif
+            jkDev_sub_41FC40(100, std_genBuffer);
+            Video_lastTimeMsec = Video_dword_5528A8;
+            Video_dword_5528A4 = Video_dword_5528A0;
+        }
+    }
+#endif
+
     if ( (playerThings[playerThingIdx].actorThing->actorParams.typeflags & THING_TYPEFLAGS_800000) == 0 )
         jkHud_Draw();
     jkDev_sub_41F950();
     jkHudInv_Draw();
+#ifdef QOL_IMPROVEMENTS
+    jkDev_DrawProfiler();
+#endif
     //if ( Video_modeStruct.b3DAccel )
     //    std3D_DrawOverlay();
 
@@ -285,10 +339,14 @@ int jkGame_Update()
     std3D_DrawMenu();
     rdFinishFrame();
 
+    stdProfiler_Begin(STDPROFILER_ZONE_PRESENT);
     if ( Video_modeStruct.b3DAccel )
         result = stdDisplay_DDrawGdiSurfaceFlip();
     else
         result = stdDisplay_VBufferCopy(Video_pOtherBuf, Video_pMenuBuffer, 0, 0, 0, 0);
+    stdProfiler_End(STDPROFILER_ZONE_PRESENT);
+
+    stdProfiler_EndFrame();
     return result;
 }
 #endif
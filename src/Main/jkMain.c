@@ -507,6 +507,14 @@ void jkMain_GameplayTick(int a2)
             if (v1 > jkMain_lastTickMs + TICKRATE_MS)
             {
                 jkMain_lastTickMs = v1;
+#ifdef QOL_IMPROVEMENTS
+                // Added: the limit only paces drawing, the simulation keeps its own rate
+                if (jkPlayer_simRate)
+                {
+                    if (sith_TickFixed(jkPlayer_simRate)) return;
+                }
+                else
+#endif
                 if (sith_Tick()) return;
             }
             
@@ -1294,7 +1302,17 @@ int jkMain_SetVideoMode()
     jkHud_Open();
     jkDev_Open();
     
+#if defined(SDL2_RENDER) && defined(QOL_IMPROVEMENTS)
+    // Added: native software rasterizer, see rdRaster_DrawFaces. Headless GL
+    // builds have no context to draw into, so they always take it.
+#ifdef NULL_RENDER
+    rdroid_curAcceleration = jkPlayer_enableSoftwareRender ? 0 : 1;
+#else
+    rdroid_curAcceleration = (jkPlayer_enableSoftwareRender || Window_bHeadless) ? 0 : 1;
+#endif
+#else
     rdroid_curAcceleration = 1;
+#endif
     Video_pCanvas = rdCanvas_New(2, Video_pMenuBuffer, Video_pVbufIdk, 0, 0, newW, newH, 6);
     sithRender_SetSomeRenderflag(0x2a);
     sithRender_SetGeoMode(Video_modeStruct.geoMode);
@@ -12,6 +12,7 @@
 #include <emscripten.h>
 #include <SDL.h>
 #include <SDL_opengles2.h>
+#include <GLES3/gl3.h>
 #endif
 
 #include <stdbool.h>
@@ -37,6 +38,15 @@
 #define TEX_MODE_16BPP 5
 #define TEX_MODE_BILINEAR_16BPP 6
 
+// Streaming ring buffers for world geometry. Each ring is split into sections,
+// and a section is only written to again once the GPU has signalled the fence
+// placed after its last draw.
+#define STD3D_STREAM_SECTIONS (4)
+#define STD3D_STREAM_ALIGN (16)
+#define STD3D_STREAM_VBO_SIZE (0x400000)
+#define STD3D_STREAM_IBO_SIZE (0x100000)
+#define STD3D_STREAM_INSTANCE_SIZE (0x40000)
+
 static bool has_initted = false;
 static GLuint fb;
 static GLuint fbTex;
@@ -56,8 +66,11 @@ static int activeFb;
 
 int init_once = 0;
 GLuint programDefault, programMenu;
-GLint attribute_coord3d, attribute_v_color, attribute_v_uv, attribute_v_norm;
+GLint attribute_coord3d, attribute_v_color, attribute_v_uv, attribute_v_norm, attribute_v_layer, attribute_v_light;
+GLint attribute_v_inst_x, attribute_v_inst_y, attribute_v_inst_z, attribute_v_inst_light;
 GLint uniform_mvp, uniform_tex, uniform_tex_mode, uniform_blend_mode, uniform_worldPalette;
+GLint uniform_mvp_static, uniform_static_geo;
+GLint uniform_colorEffects_mul;
 
 GLint programMenu_attribute_coord3d, programMenu_attribute_v_color, programMenu_attribute_v_uv, programMenu_attribute_v_norm;
 GLint programMenu_uniform_mvp, programMenu_uniform_tex, programMenu_uniform_displayPalette;
@@ -67,42 +80,477 @@ void* worldpal_data;
 GLuint displaypal_texture;
 void* displaypal_data;
 
-static rdDDrawSurface* std3D_aLoadedSurfaces[1024];
-static GLuint std3D_aLoadedTextures[1024];
-static size_t std3D_loadedTexturesAmt = 0;
+// Added: palette textures are re-uploaded when these change instead of
+// comparing the palettes every frame
+static rdColormap* std3D_pWorldPalColormap = NULL;
+static uint32_t std3D_worldPalGeneration = 0;
+static uint32_t std3D_displayPalGeneration = 0;
+
+// Texture cache. Every surface handed to std3D_AddToTextureCache gets an entry
+// and surface->gpu_accel_maybe holds its index + 1. Surfaces draw with a small
+// placeholder while a worker thread builds the full mip chain, and finished
+// chains are uploaded at the start of a frame, a limited number of bytes at a
+// time. Once the total goes over jkPlayer_textureBudgetMb the least recently
+// drawn textures are dropped and get uploaded again the next time they're used.
+//
+// Full chains go into a layer of a GL_TEXTURE_2D_ARRAY page shared by every
+// texture with the same size and format. texture_id is the page, so rdCache's
+// sort keys batch all of them together, and the layer rides along per vertex.
+#define STD3D_TEX_UPLOAD_BUDGET (0x100000)
+#define STD3D_TEX_PLACEHOLDER_SIZE (16)
+#define STD3D_TEX_MAX_LEVELS (16)
+#define STD3D_TEX_PAGE_BYTES (0x400000)
+#define STD3D_TEX_PAGE_MAX_LAYERS (64)
+
+#ifndef ARCH_WASM
+#define STD3D_ASYNC_TEXTURES
+#endif
+
+#define STD3D_TEXFMT_INDEXED (0)
+#define STD3D_TEXFMT_RGB565 (1)
+#define STD3D_TEXFMT_RGBA5551 (2)
+
+typedef struct std3DTextureJob
+{
+    uint32_t idx;
+    uint32_t jobId;
+    int format;
+    uint32_t width;
+    uint32_t height;
+    uint32_t bpp;
+    int numLevels;
+    size_t levelsSize;
+    uint8_t* pPixels; // level 0 on submit, the whole chain once built
+    struct std3DTextureJob* pNext;
+} std3DTextureJob;
+
+typedef struct std3DTexturePage
+{
+    GLuint texture; // 0 when the slot is free
+    int format;
+    uint32_t width;
+    uint32_t height;
+    int numLevels;
+    int numLayers;
+    int usedLayers;
+    uint64_t usedMask;
+    size_t bytes; // every layer, used or not
+    uint32_t lastFrame; // newest lastFrame of the layers in it
+} std3DTexturePage;
+
+typedef struct std3DTexture
+{
+    rdDDrawSurface* surface;
+    GLuint texture;
+    int page; // -1 for the placeholder, which is its own single layer array
+    int layer;
+    uint32_t jobId; // nonzero while the full chain is still pending
+    uint32_t lastFrame;
+    size_t bytes; // only counted for the placeholder, layers are counted with their page
+    int format;
+    int numLevels;
+    int nextFree;
+} std3DTexture;
+
+static std3DTexturePage* std3D_aTexturePages = NULL;
+static size_t std3D_texturePagesAmt = 0;
+static size_t std3D_texturePagesMax = 0;
+static std3DTexture* std3D_aTextures = NULL;
+static size_t std3D_texturesAmt = 0;
+static size_t std3D_texturesMax = 0;
+static int std3D_texturesFree = -1;
+static size_t std3D_textureBytes = 0;
+static uint32_t std3D_textureFrame = 0;
+static uint32_t std3D_textureJobId = 0;
+
+#ifdef STD3D_ASYNC_TEXTURES
+static int std3D_bTexThreadStarted = 0;
+static int std3D_bTexThreadQuit = 0;
+static SDL_Thread* std3D_pTexThread = NULL;
+static SDL_mutex* std3D_pTexMutex = NULL;
+static SDL_cond* std3D_pTexCond = NULL;
+static std3DTextureJob* std3D_pTexPending = NULL;
+static std3DTextureJob* std3D_pTexPendingTail = NULL;
+static std3DTextureJob* std3D_pTexDone = NULL;
+static std3DTextureJob* std3D_pTexDoneTail = NULL;
+#endif
+
+static void std3D_UpdateTextureCache();
+static void std3D_FreeAllTextures();
+static void std3D_SetVertexLayers(uint8_t* pLayers, size_t stride, rdTri* tris, size_t trisAmt);
+#ifdef STD3D_ASYNC_TEXTURES
+static void std3D_StopTextureThread();
+#endif
+
 static rdTri GL_tmpTris[STD3D_MAX_TRIS];
 static size_t GL_tmpTrisAmt = 0;
-static rdLine GL_tmpLines[STD3D_MAX_VERTICES];
+static rdLine* GL_tmpLines = NULL;
 static size_t GL_tmpLinesAmt = 0;
+static size_t GL_tmpLinesMax = 0;
 static D3DVERTEX GL_tmpVertices[STD3D_MAX_VERTICES];
 static size_t GL_tmpVerticesAmt = 0;
 static size_t rendered_tris = 0;
+int std3D_frameTris = 0;
+int std3D_lastFrameTris = 0;
+int std3D_frameBatches = 0;
+int std3D_lastFrameBatches = 0;
 
 rdDDrawSurface* last_tex = NULL;
 int last_flags = 0;
 
+// GL state last emitted for world tris, so batches only send what changed
+static GLuint std3D_curTexture = 0;
+static int std3D_curTexMode = -1;
+static int std3D_curBlendMode = -1;
+static GLenum std3D_curCullFace = 0;
+static GLenum std3D_curDepthFunc = 0;
+static int std3D_texFilterEnabled = 0;
+
 #pragma pack(push, 4)
 typedef struct std3DWorldVBO
 {
     float x;
     float y;
     float z;
-    float nx;
+    uint32_t light; // D3DVERTEX nx, rdCache_SendFaceListToHardware's light terms
     uint32_t color;
-    float nz;
+    float layer; // D3DVERTEX nz, which rdCache leaves at 0
     float tu;
     float tv;
 } std3DWorldVBO;
 #pragma pack(pop)
 
-std3DWorldVBO* world_data_all = NULL;
-GLushort* world_data_elements = NULL;
+typedef struct std3DStreamBuffer
+{
+    GLuint buffer;
+    GLenum target;
+    size_t size;
+    size_t head;
+    int section;
+    uint8_t* pMapped; // persistent, coherent mapping if supported
+    uint8_t* pShadow; // CPU staging for the orphan-and-subdata fallback
+    GLsync aFences[STD3D_STREAM_SECTIONS];
+} std3DStreamBuffer;
+
+static std3DStreamBuffer world_vbo_stream;
+static std3DStreamBuffer world_ibo_stream;
+static std3DWorldVBO* world_data_all = NULL;
+static size_t world_data_all_offs = 0;
+static size_t world_verticesAmt = 0;
+static size_t world_verticesMax = 0;
+static rdTri* world_tris = NULL;
+static size_t world_trisAmt = 0;
+static size_t world_trisMax = 0;
+
+// Resident level geometry, positions are uploaded once and only
+// colors/UVs for the visible surfaces are streamed each frame
+static GLuint world_vbo_static = 0;
+static size_t world_staticVerticesAmt = 0;
+static std3DStreamBuffer world_static_stream;
+static std3DStaticVertex* world_static_data = NULL;
+static size_t world_static_data_offs = 0;
+
+// Resident model meshes, drawn once per instance with the instance's
+// matrix and light values streamed alongside
+static GLuint world_vbo_instance = 0;
+static size_t world_instanceVerticesAmt = 0;
+static std3DStreamBuffer world_instance_vtx_stream;
+static std3DStreamBuffer world_instance_stream;
+static std3DStaticVertex* world_instance_data = NULL;
+static size_t world_instance_data_offs = 0;
 GLuint world_vbo_all;
 GLuint world_ibo_triangle;
 
 GLuint menu_vbo_vertices, menu_vbo_colors, menu_vbo_uvs;
 GLuint menu_ibo_triangle;
 
+static int std3D_StreamInit(std3DStreamBuffer* pStream, GLuint buffer, GLenum target, size_t size)
+{
+    memset(pStream, 0, sizeof(*pStream));
+    pStream->buffer = buffer;
+    pStream->target = target;
+    pStream->size = size;
+
+    glBindBuffer(target, buffer);
+
+#ifndef ARCH_WASM
+    if (GLEW_ARB_buffer_storage)
+    {
+        GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glBufferStorage(target, size, NULL, flags);
+        pStream->pMapped = glMapBufferRange(target, 0, size, flags);
+        if (pStream->pMapped)
+            return 1;
+
+        // Immutable storage can't be respecified, start over with a fresh buffer.
+        glDeleteBuffers(1, &pStream->buffer);
+        glGenBuffers(1, &pStream->buffer);
+        glBindBuffer(target, pStream->buffer);
+    }
+#endif
+
+    pStream->pShadow = malloc(size);
+    if (!pStream->pShadow)
+        return 0;
+    glBufferData(target, size, NULL, GL_STREAM_DRAW);
+    return 1;
+}
+
+static void std3D_StreamFree(std3DStreamBuffer* pStream)
+{
+    for (int i = 0; i < STD3D_STREAM_SECTIONS; i++)
+    {
+        if (pStream->aFences[i])
+            glDeleteSync(pStream->aFences[i]);
+        pStream->aFences[i] = 0;
+    }
+
+#ifndef ARCH_WASM
+    if (pStream->pMapped)
+    {
+        glBindBuffer(pStream->target, pStream->buffer);
+        glUnmapBuffer(pStream->target);
+    }
+#endif
+    pStream->pMapped = NULL;
+
+    if (pStream->pShadow)
+        free(pStream->pShadow);
+    pStream->pShadow = NULL;
+}
+
+static void std3D_StreamNextSection(std3DStreamBuffer* pStream)
+{
+    size_t sectionSize = pStream->size / STD3D_STREAM_SECTIONS;
+
+    // Everything written to the current section has already been submitted
+    if (pStream->pMapped)
+    {
+        if (pStream->aFences[pStream->section])
+            glDeleteSync(pStream->aFences[pStream->section]);
+        pStream->aFences[pStream->section] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+
+    pStream->section = (pStream->section + 1) % STD3D_STREAM_SECTIONS;
+    pStream->head = pStream->section * sectionSize;
+
+    if (pStream->pMapped)
+    {
+        GLsync fence = pStream->aFences[pStream->section];
+        if (fence)
+        {
+            while (glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000) == GL_TIMEOUT_EXPIRED);
+            glDeleteSync(fence);
+            pStream->aFences[pStream->section] = 0;
+        }
+    }
+    else if (!pStream->section)
+    {
+        // Orphan the old storage on wrap, the driver hands us a fresh block
+        glBindBuffer(pStream->target, pStream->buffer);
+        glBufferData(pStream->target, pStream->size, NULL, GL_STREAM_DRAW);
+    }
+}
+
+// Replaces the stream storage with one whose sections fit `len` bytes.
+// Only valid while nothing is reserved from the stream.
+static int std3D_StreamGrow(std3DStreamBuffer* pStream, size_t len)
+{
+    GLuint buffer;
+    GLenum target = pStream->target;
+    size_t size = pStream->size;
+
+    while (size / STD3D_STREAM_SECTIONS < len)
+        size *= 2;
+
+    std3D_StreamFree(pStream);
+    glDeleteBuffers(1, &pStream->buffer);
+    glGenBuffers(1, &buffer);
+
+    return std3D_StreamInit(pStream, buffer, target, size);
+}
+
+// Returns a write pointer to `len` contiguous bytes at the ring head
+static void* std3D_StreamReserve(std3DStreamBuffer* pStream, size_t len, size_t* pOffsOut)
+{
+    size_t sectionSize = pStream->size / STD3D_STREAM_SECTIONS;
+
+    if (len > sectionSize)
+    {
+        if (!std3D_StreamGrow(pStream, len))
+            return NULL;
+        sectionSize = pStream->size / STD3D_STREAM_SECTIONS;
+    }
+
+    if (pStream->head + len > (pStream->section + 1) * sectionSize)
+        std3D_StreamNextSection(pStream);
+
+    *pOffsOut = pStream->head;
+    return (pStream->pMapped ? pStream->pMapped : pStream->pShadow) + pStream->head;
+}
+
+// Makes `len` bytes written at the ring head visible to the GPU and advances it
+static void std3D_StreamCommit(std3DStreamBuffer* pStream, size_t len)
+{
+    if (!pStream->pMapped && len)
+    {
+        glBindBuffer(pStream->target, pStream->buffer);
+        glBufferSubData(pStream->target, pStream->head, len, pStream->pShadow + pStream->head);
+    }
+
+    pStream->head += (len + (STD3D_STREAM_ALIGN - 1)) & ~(STD3D_STREAM_ALIGN - 1);
+}
+
+// Like std3D_StreamCommit, but of the `len` bytes reserved only the given runs
+// of `stride` byte elements were written, so only those are uploaded
+static void std3D_StreamCommitRanges(std3DStreamBuffer* pStream, size_t len, size_t stride, const std3DVertexRange* pRanges, size_t numRanges)
+{
+    if (!pStream->pMapped)
+    {
+        glBindBuffer(pStream->target, pStream->buffer);
+        for (size_t i = 0; i < numRanges; i++)
+        {
+            size_t offs = pStream->head + pRanges[i].first * stride;
+            glBufferSubData(pStream->target, offs, pRanges[i].count * stride, pStream->pShadow + offs);
+        }
+    }
+
+    pStream->head += (len + (STD3D_STREAM_ALIGN - 1)) & ~(STD3D_STREAM_ALIGN - 1);
+}
+
+static void std3D_SetWorldVertexAttribs(size_t offs)
+{
+    glBindBuffer(GL_ARRAY_BUFFER, world_vbo_all);
+    glVertexAttribPointer(
+        attribute_coord3d, // attribute
+        3,                 // number of elements per vertex, here (x,y,z)
+        GL_FLOAT,          // the type of each element
+        GL_FALSE,          // normalize fixed-point data?
+        sizeof(std3DWorldVBO),                 // data stride
+        (GLvoid*)(offs + offsetof(std3DWorldVBO, x))                  // offset of first element
+    );
+    
+    glVertexAttribPointer(
+        attribute_v_color, // attribute
+        4,                 // number of elements per vertex, here (R,G,B,A)
+        GL_UNSIGNED_BYTE,  // the type of each element
+        GL_TRUE,          // normalize fixed-point data?
+        sizeof(std3DWorldVBO),                 // no extra data between each position
+        (GLvoid*)(offs + offsetof(std3DWorldVBO, color)) // offset of first element
+    );
+
+    glVertexAttribPointer(
+        attribute_v_uv,    // attribute
+        2,                 // number of elements per vertex, here (U,V)
+        GL_FLOAT,          // the type of each element
+        GL_FALSE,          // take our values as-is
+        sizeof(std3DWorldVBO),                 // no extra data between each position
+        (GLvoid*)(offs + offsetof(std3DWorldVBO, tu))                  // offset of first element
+    );
+
+    glVertexAttribPointer(
+        attribute_v_layer, // attribute
+        1,                 // texture array layer
+        GL_FLOAT,          // the type of each element
+        GL_FALSE,          // take our values as-is
+        sizeof(std3DWorldVBO),                 // no extra data between each position
+        (GLvoid*)(offs + offsetof(std3DWorldVBO, layer))               // offset of first element
+    );
+
+    glVertexAttribPointer(
+        attribute_v_light, // attribute
+        4,                 // intensity, extralight, ambient, lighting mode
+        GL_UNSIGNED_BYTE,  // the type of each element
+        GL_TRUE,           // normalize fixed-point data?
+        sizeof(std3DWorldVBO),                 // no extra data between each position
+        (GLvoid*)(offs + offsetof(std3DWorldVBO, light))               // offset of first element
+    );
+}
+
+// Resident geometry comes in already lit and has no light terms, a constant 0
+// tells the shader to leave its color alone
+static void std3D_EnableLightAttrib(int bEnable)
+{
+    if (bEnable)
+    {
+        glEnableVertexAttribArray(attribute_v_light);
+    }
+    else
+    {
+        glDisableVertexAttribArray(attribute_v_light);
+        glVertexAttrib4f(attribute_v_light, 0.0, 0.0, 0.0, 0.0);
+    }
+}
+
+static void std3D_InvalidateWorldState()
+{
+    std3D_curTexture = (GLuint)-1;
+    std3D_curTexMode = -1;
+    std3D_curBlendMode = -1;
+    std3D_curCullFace = 0;
+    std3D_curDepthFunc = 0;
+}
+
+static void std3D_SetWorldTexture(GLuint tex_id)
+{
+    if (tex_id == std3D_curTexture)
+        return;
+
+    glBindTexture(GL_TEXTURE_2D_ARRAY, tex_id);
+    std3D_curTexture = tex_id;
+}
+
+static void std3D_SetWorldTexMode(int tex_mode)
+{
+    if (tex_mode == std3D_curTexMode)
+        return;
+
+    glUniform1i(uniform_tex_mode, tex_mode);
+    std3D_curTexMode = tex_mode;
+}
+
+static void std3D_SetWorldBlendMode(int blend_mode)
+{
+    if (blend_mode == std3D_curBlendMode)
+        return;
+
+    glUniform1i(uniform_blend_mode, blend_mode);
+    std3D_curBlendMode = blend_mode;
+}
+
+static void std3D_SetWorldCullFace(GLenum mode)
+{
+    if (mode == std3D_curCullFace)
+        return;
+
+    glCullFace(mode);
+    std3D_curCullFace = mode;
+}
+
+static void std3D_SetWorldDepthFunc(GLenum func)
+{
+    if (func == std3D_curDepthFunc)
+        return;
+
+    glDepthFunc(func);
+    std3D_curDepthFunc = func;
+}
+
+// Filtering is texture object state, so it's set once per texture instead of per batch
+static void std3D_SetTextureFilter(int is_16bit, int numLevels)
+{
+    int bLinear = (jkPlayer_enableTextureFilter && is_16bit);
+    GLint minFilter;
+
+    if (numLevels > 1)
+        minFilter = bLinear ? GL_LINEAR_MIPMAP_LINEAR : GL_NEAREST_MIPMAP_NEAREST;
+    else
+        minFilter = bLinear ? GL_LINEAR : GL_NEAREST;
+
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, bLinear ? GL_LINEAR : GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, minFilter);
+}
+
 void generateFramebuffer(GLuint* fbOut, GLuint* fbTexOut, GLuint* fbRboOut)
 {
     // Generate the framebuffer
@@ -230,11 +678,20 @@ int init_resources()
     attribute_coord3d = std3D_tryFindAttribute(programDefault, "coord3d");
     attribute_v_color = std3D_tryFindAttribute(programDefault, "v_color");
     attribute_v_uv = std3D_tryFindAttribute(programDefault, "v_uv");
+    attribute_v_layer = std3D_tryFindAttribute(programDefault, "v_layer");
+    attribute_v_light = std3D_tryFindAttribute(programDefault, "v_light");
+    attribute_v_inst_x = std3D_tryFindAttribute(programDefault, "v_inst_x");
+    attribute_v_inst_y = std3D_tryFindAttribute(programDefault, "v_inst_y");
+    attribute_v_inst_z = std3D_tryFindAttribute(programDefault, "v_inst_z");
+    attribute_v_inst_light = std3D_tryFindAttribute(programDefault, "v_inst_light");
     uniform_mvp = std3D_tryFindUniform(programDefault, "mvp");
     uniform_tex = std3D_tryFindUniform(programDefault, "tex");
     uniform_worldPalette = std3D_tryFindUniform(programDefault, "worldPalette");
     uniform_tex_mode = std3D_tryFindUniform(programDefault, "tex_mode");
     uniform_blend_mode = std3D_tryFindUniform(programDefault, "blend_mode");
+    uniform_mvp_static = std3D_tryFindUniform(programDefault, "mvp_static");
+    uniform_static_geo = std3D_tryFindUniform(programDefault, "static_geo");
+    uniform_colorEffects_mul = std3D_tryFindUniform(programDefault, "colorEffects_mul");
     
     programMenu_attribute_coord3d = std3D_tryFindAttribute(programMenu, "coord3d");
     programMenu_attribute_v_color = std3D_tryFindAttribute(programMenu, "v_color");
@@ -247,6 +704,7 @@ int init_resources()
     glGenTextures(1, &worldpal_texture);
     worldpal_data = malloc(0x300);
     memset(worldpal_data, 0xFF, 0x300);
+    std3D_pWorldPalColormap = NULL;
     
     glBindTexture(GL_TEXTURE_2D, worldpal_texture);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
@@ -261,6 +719,7 @@ int init_resources()
     glGenTextures(1, &displaypal_texture);
     displaypal_data = malloc(0x400);
     memset(displaypal_data, 0xFF, 0x300);
+    std3D_displayPalGeneration = 0;
     
     glBindTexture(GL_TEXTURE_2D, displaypal_texture);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
@@ -274,12 +733,18 @@ int init_resources()
     glGenVertexArrays( 1, &vao );
     glBindVertexArray( vao ); 
 
-    world_data_all = malloc(STD3D_MAX_VERTICES * sizeof(std3DWorldVBO));
-    world_data_elements = malloc(sizeof(GLushort) * 3 * STD3D_MAX_TRIS);
-
     glGenBuffers(1, &world_vbo_all);
     glGenBuffers(1, &world_ibo_triangle);
 
+    if (!std3D_StreamInit(&world_vbo_stream, world_vbo_all, GL_ARRAY_BUFFER, STD3D_STREAM_VBO_SIZE)) return false;
+    if (!std3D_StreamInit(&world_ibo_stream, world_ibo_triangle, GL_ELEMENT_ARRAY_BUFFER, STD3D_STREAM_IBO_SIZE)) return false;
+
+    // Immutable storage may have had to be replaced with a regular buffer
+    world_vbo_all = world_vbo_stream.buffer;
+    world_ibo_triangle = world_ibo_stream.buffer;
+    world_data_all = NULL;
+    world_verticesAmt = 0;
+
     glGenBuffers(1, &menu_vbo_vertices);
     glGenBuffers(1, &menu_vbo_colors);
     glGenBuffers(1, &menu_vbo_uvs);
@@ -296,7 +761,9 @@ int std3D_Startup()
 
 void std3D_Shutdown()
 {
-
+#ifdef STD3D_ASYNC_TEXTURES
+    std3D_StopTextureThread();
+#endif
 }
 
 void std3D_FreeResources()
@@ -315,13 +782,13 @@ void std3D_FreeResources()
     worldpal_data = NULL;
     displaypal_data = NULL;
 
-    if (world_data_all)
-        free(world_data_all);
+    std3D_StreamFree(&world_vbo_stream);
+    std3D_StreamFree(&world_ibo_stream);
     world_data_all = NULL;
+    world_verticesAmt = 0;
 
-    if (world_data_elements)
-        free(world_data_elements);
-    world_data_elements = NULL;
+    std3D_FreeStaticGeometry();
+    std3D_FreeInstanceGeometry();
 
     glDeleteBuffers(1, &world_vbo_all);
     glDeleteBuffers(1, &world_ibo_triangle);
@@ -331,6 +798,13 @@ void std3D_FreeResources()
 
 int std3D_StartScene()
 {
+    std3D_frameTris = 0;
+    std3D_frameBatches = 0;
+
+    // Added: -headless never creates a context
+    if (Window_bHeadless)
+        return 1;
+
     //printf("Begin draw\n");
     if (!has_initted)
     {
@@ -356,58 +830,74 @@ int std3D_StartScene()
     glClearColor(0.0, 0.0, 0.0, 1.0);
     glClear(GL_COLOR_BUFFER_BIT|GL_DEPTH_BUFFER_BIT);
     
-    if (sithWorld_pCurrentWorld && sithWorld_pCurrentWorld->colormaps && memcmp(worldpal_data, sithWorld_pCurrentWorld->colormaps->colors, 0x300))
+    if (sithWorld_pCurrentWorld && sithWorld_pCurrentWorld->colormaps
+        && (std3D_pWorldPalColormap != sithWorld_pCurrentWorld->colormaps || std3D_worldPalGeneration != rdColormap_loadGeneration))
     {
         glBindTexture(GL_TEXTURE_2D, worldpal_texture);
         memcpy(worldpal_data, sithWorld_pCurrentWorld->colormaps->colors, 0x300);
         glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 256, 1, GL_RGB, GL_UNSIGNED_BYTE, worldpal_data);
+
+        std3D_pWorldPalColormap = sithWorld_pCurrentWorld->colormaps;
+        std3D_worldPalGeneration = rdColormap_loadGeneration;
     }
     
-    if (memcmp(displaypal_data, stdDisplay_masterPalette, 0x300))
+    if (std3D_displayPalGeneration != stdDisplay_paletteGeneration)
     {
         glBindTexture(GL_TEXTURE_2D, displaypal_texture);
         memcpy(displaypal_data, stdDisplay_masterPalette, 0x300);
         glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 256, 1, GL_RGB, GL_UNSIGNED_BYTE, displaypal_data);
+
+        std3D_displayPalGeneration = stdDisplay_paletteGeneration;
     }
 
-    // Describe our vertices array to OpenGL (it can't guess its format automatically)
-    glBindBuffer(GL_ARRAY_BUFFER, world_vbo_all);
-    glVertexAttribPointer(
-        attribute_coord3d, // attribute
-        3,                 // number of elements per vertex, here (x,y,z)
-        GL_FLOAT,          // the type of each element
-        GL_FALSE,          // normalize fixed-point data?
-        sizeof(std3DWorldVBO),                 // data stride
-        (GLvoid*)offsetof(std3DWorldVBO, x)                  // offset of first element
-    );
-    
-    glVertexAttribPointer(
-        attribute_v_color, // attribute
-        4,                 // number of elements per vertex, here (R,G,B,A)
-        GL_UNSIGNED_BYTE,  // the type of each element
-        GL_TRUE,          // normalize fixed-point data?
-        sizeof(std3DWorldVBO),                 // no extra data between each position
-        (GLvoid*)offsetof(std3DWorldVBO, color) // offset of first element
-    );
+    if (std3D_texFilterEnabled != jkPlayer_enableTextureFilter)
+    {
+        std3D_texFilterEnabled = jkPlayer_enableTextureFilter;
+        for (size_t i = 0; i < std3D_texturesAmt; i++)
+        {
+            std3DTexture* pEntry = &std3D_aTextures[i];
+            if (!pEntry->surface || !pEntry->texture || pEntry->page >= 0)
+                continue;
 
-    glVertexAttribPointer(
-        attribute_v_uv,    // attribute
-        2,                 // number of elements per vertex, here (U,V)
-        GL_FLOAT,          // the type of each element
-        GL_FALSE,          // take our values as-is
-        sizeof(std3DWorldVBO),                 // no extra data between each position
-        (GLvoid*)offsetof(std3DWorldVBO, tu)                  // offset of first element
-    );
+            glBindTexture(GL_TEXTURE_2D_ARRAY, pEntry->texture);
+            std3D_SetTextureFilter(pEntry->format != STD3D_TEXFMT_INDEXED, pEntry->numLevels);
+        }
+        for (size_t i = 0; i < std3D_texturePagesAmt; i++)
+        {
+            std3DTexturePage* pPage = &std3D_aTexturePages[i];
+            if (!pPage->texture)
+                continue;
+
+            glBindTexture(GL_TEXTURE_2D_ARRAY, pPage->texture);
+            std3D_SetTextureFilter(pPage->format != STD3D_TEXFMT_INDEXED, pPage->numLevels);
+        }
+        std3D_curTexture = (GLuint)-1;
+    }
+
+    std3D_UpdateTextureCache();
+
+    // Describe our vertices array to OpenGL (it can't guess its format automatically)
+    std3D_SetWorldVertexAttribs(0);
 
     glEnableVertexAttribArray(attribute_coord3d);
     glEnableVertexAttribArray(attribute_v_color);
     glEnableVertexAttribArray(attribute_v_uv);
+    glEnableVertexAttribArray(attribute_v_layer);
+    std3D_EnableLightAttrib(1);
     
     return 1;
 }
 
 int std3D_EndScene()
 {
+    std3D_lastFrameTris = std3D_frameTris;
+    std3D_lastFrameBatches = std3D_frameBatches;
+
+    if (Window_bHeadless)
+        return 1;
+
+    std3D_EnableLightAttrib(0);
+    glDisableVertexAttribArray(attribute_v_layer);
     glDisableVertexAttribArray(attribute_v_uv);
     glDisableVertexAttribArray(attribute_v_color);
     glDisableVertexAttribArray(attribute_coord3d);
@@ -422,8 +912,12 @@ int std3D_EndScene()
 
 void std3D_ResetRenderList()
 {
-    rendered_tris += GL_tmpTrisAmt;
+    rendered_tris += world_trisAmt;
 
+    world_data_all = NULL;
+    world_verticesAmt = 0;
+    world_verticesMax = 0;
+    world_trisAmt = 0;
     GL_tmpVerticesAmt = 0;
     GL_tmpTrisAmt = 0;
     GL_tmpLinesAmt = 0;
@@ -515,6 +1009,9 @@ static rdDDrawSurface* test_idk = NULL;
 
 void std3D_DrawMenu()
 {
+    if (Window_bHeadless)
+        return;
+
     glDepthFunc(GL_ALWAYS);
     glUseProgram(programMenu);
     
@@ -631,7 +1128,22 @@ void std3D_DrawMenu()
     glActiveTexture(GL_TEXTURE0 + 0);
     glBindTexture(GL_TEXTURE_2D, Video_menuTexId);
 
-    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, Video_menuBuffer.format.width, Video_menuBuffer.format.height, GL_RED, GL_UNSIGNED_BYTE, Video_menuBuffer.sdlSurface->pixels);
+    // Only the regions written since the last upload
+    rdRect aDirtyRects[STDDISPLAY_MAX_DIRTY_RECTS];
+    int numDirtyRects = stdDisplay_TakeMenuDirtyRects(aDirtyRects);
+    if (numDirtyRects)
+    {
+        const uint8_t* pPixels = (const uint8_t*)Video_menuBuffer.sdlSurface->pixels;
+        uint32_t pitch = Video_menuBuffer.sdlSurface->pitch;
+
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, pitch);
+        for (int i = 0; i < numDirtyRects; i++)
+        {
+            rdRect* pRect = &aDirtyRects[i];
+            glTexSubImage2D(GL_TEXTURE_2D, 0, pRect->x, pRect->y, pRect->width, pRect->height, GL_RED, GL_UNSIGNED_BYTE, pPixels + (pRect->y * pitch) + pRect->x);
+        }
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    }
 
     GLfloat data_vertices[32 * 3];
     GLubyte data_colors[32 * 4];
@@ -776,15 +1288,9 @@ void std3D_DrawMenu()
     //glBindTexture(GL_TEXTURE_2D, 0);
 }
 
-void std3D_DrawRenderList()
+// Maps rdCache's screen space vertices (x, y, 1-(1/z)) to clip space
+static void std3D_GetWorldScreenMatrix(float* pOut)
 {
-    glUseProgram(programDefault);
-    
-    last_tex = NULL;
-
-    // Generate vertices list
-    D3DVERTEX* vertexes = GL_tmpVertices;
-
     float maxX, maxY, scaleX, scaleY, width, height;
 
     float internalWidth = Video_menuBuffer.format.width;
@@ -814,195 +1320,212 @@ void std3D_DrawRenderList()
         zoom_xaspect = 1.0;
     }
 
-    glBindBuffer(GL_ARRAY_BUFFER, world_vbo_all);
-    glBufferData(GL_ARRAY_BUFFER, GL_tmpVerticesAmt * sizeof(std3DWorldVBO), vertexes, GL_STREAM_DRAW);
-    
-    glUniform1i(uniform_tex_mode, TEX_MODE_TEST);
-    glUniform1i(uniform_blend_mode, 2);
-    glActiveTexture(GL_TEXTURE0 + 1);
-    glBindTexture(GL_TEXTURE_2D, worldpal_texture);
-    glActiveTexture(GL_TEXTURE0 + 0);
-    
-    glUniform1i(uniform_tex, 0);
-    glUniform1i(uniform_worldPalette, 1);
-    
-    {
-    
     float d3dmat[16] = {
        maxX*scaleX*zoom_xaspect,      0,                                          0,      0, // right
        0,                                       -maxY*scaleY*zoom_yaspect,               0,      0, // up
        0,                                       0,                                          1,     0, // forward
        -(internalWidth/2)*scaleX*zoom_xaspect,  (internalHeight/2)*scaleY*zoom_yaspect,     (!rdCamera_pCurCamera || rdCamera_pCurCamera->projectType == rdCameraProjectType_Perspective) ? -1 : 1,      1  // pos
     };
-    
-    glUniformMatrix4fv(uniform_mvp, 1, GL_FALSE, d3dmat);
-    glViewport(0, 0, width, height);
-    
-    }
-    
-    rdTri* tris = GL_tmpTris;
-    rdLine* lines = GL_tmpLines;
-    
-    //glEnableVertexAttribArray(attribute_v_norm);
 
-    
+    memcpy(pOut, d3dmat, sizeof(d3dmat));
+}
 
-    int last_tex_idx = 0;
-    //GLushort* world_data_elements = malloc(sizeof(GLushort) * 3 * GL_tmpTrisAmt);
-    for (int j = 0; j < GL_tmpTrisAmt; j++)
+// Folds rdroid_curColorEffects into one per-channel multiplier. rdCache used
+// to apply filter, then tint, then fade to every vertex color on the CPU.
+static void std3D_GetColorEffectsMul(float* pOut)
+{
+    int bFilter = rdroid_curColorEffects.filter.x || rdroid_curColorEffects.filter.y || rdroid_curColorEffects.filter.z;
+    int bTint = rdroid_curColorEffects.tint.x > 0.0 || rdroid_curColorEffects.tint.y > 0.0 || rdroid_curColorEffects.tint.z > 0.0;
+    float fade = rdroid_curColorEffects.fade < 1.0 ? rdroid_curColorEffects.fade : 1.0;
+
+    pOut[0] = pOut[1] = pOut[2] = fade;
+    if (bFilter)
     {
-        world_data_elements[(j*3)+0] = tris[j].v1;
-        world_data_elements[(j*3)+1] = tris[j].v2;
-        world_data_elements[(j*3)+2] = tris[j].v3;
+        if (!rdroid_curColorEffects.filter.x)
+            pOut[0] = 0.0;
+        if (!rdroid_curColorEffects.filter.y)
+            pOut[1] = 0.0;
+        if (!rdroid_curColorEffects.filter.z)
+            pOut[2] = 0.0;
+    }
+    if (bTint)
+    {
+        pOut[0] *= 1.0 + rdroid_curColorEffects.tint.x - (rdroid_curColorEffects.tint.z * 0.5 + rdroid_curColorEffects.tint.y * 0.5);
+        pOut[1] *= 1.0 + rdroid_curColorEffects.tint.y - (rdroid_curColorEffects.tint.x * 0.5 + rdroid_curColorEffects.tint.z * 0.5);
+        pOut[2] *= 1.0 + rdroid_curColorEffects.tint.z - (rdroid_curColorEffects.tint.x * 0.5 + rdroid_curColorEffects.tint.y * 0.5);
     }
+}
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, world_ibo_triangle);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, GL_tmpTrisAmt * 3 * sizeof(GLushort), world_data_elements, GL_STREAM_DRAW);
-    
-    int do_batch = 0;
+static void std3D_BeginWorldDraw()
+{
+    float d3dmat[16];
+    float colorEffects[3];
+
+    glUseProgram(programDefault);
     
-    //glDepthFunc(GL_LESS);
+    last_tex = NULL;
+
+    std3D_InvalidateWorldState();
+    std3D_SetWorldTexMode(TEX_MODE_TEST);
+    std3D_SetWorldBlendMode(2);
+    glActiveTexture(GL_TEXTURE0 + 1);
+    glBindTexture(GL_TEXTURE_2D, worldpal_texture);
+    glActiveTexture(GL_TEXTURE0 + 0);
+    
+    glUniform1i(uniform_tex, 0);
+    glUniform1i(uniform_worldPalette, 1);
+    
+    std3D_GetWorldScreenMatrix(d3dmat);
+    glUniformMatrix4fv(uniform_mvp, 1, GL_FALSE, d3dmat);
+
+    std3D_GetColorEffectsMul(colorEffects);
+    glUniform3fv(uniform_colorEffects_mul, 1, colorEffects);
+    glViewport(0, 0, Window_xSize, Window_ySize);
+}
+
+static void std3D_DrawWorldBatch(size_t numTris, size_t offs, size_t numInstances)
+{
+    if (numInstances)
+        glDrawElementsInstanced(GL_TRIANGLES, numTris * 3, GL_UNSIGNED_INT, (GLvoid*)offs, numInstances);
+    else
+        glDrawElements(GL_TRIANGLES, numTris * 3, GL_UNSIGNED_INT, (GLvoid*)offs);
+    std3D_frameBatches++;
+}
+
+// Uploads indices for `tris` and draws them, batching on the tris' sort keys.
+// Vertex attributes must already be set up. With numInstances, every batch is
+// drawn that many times using the instance attributes.
+static void std3D_DrawWorldTris(rdTri* tris, size_t trisAmt, size_t numInstances)
+{
+    int last_tex_idx = 0;
+    size_t world_data_elements_offs = 0;
+    size_t world_data_elements_size = trisAmt * 3 * sizeof(GLuint);
+
+    // Indices are written straight into the stream, 32-bit so a whole frame fits in one list
+    GLuint* world_data_elements = std3D_StreamReserve(&world_ibo_stream, world_data_elements_size, &world_data_elements_offs);
+    if (!world_data_elements)
+        return;
+
+    world_ibo_triangle = world_ibo_stream.buffer;
+    for (int j = 0; j < trisAmt; j++)
+    {
+        world_data_elements[(j*3)+0] = tris[j].v1;
+        world_data_elements[(j*3)+1] = tris[j].v2;
+        world_data_elements[(j*3)+2] = tris[j].v3;
+    }
+    std3D_StreamCommit(&world_ibo_stream, world_data_elements_size);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, world_ibo_triangle);
+    
+    uint64_t last_key = 0;
+    int last_depth_flags;
+    
+    //glDepthFunc(GL_LESS);
     glDepthMask(GL_TRUE);
-    glCullFace(GL_FRONT);
+    std3D_SetWorldCullFace(GL_FRONT);
 
     if (!(tris[0].flags & 0x800)) {
         //glDepthFunc(GL_ALWAYS);
         glClear(GL_DEPTH_BUFFER_BIT);
     }
+    last_depth_flags = tris[0].flags & 0x1800;
     
-    for (int j = 0; j < GL_tmpTrisAmt; j++)
+    for (int j = 0; j < trisAmt; j++)
     {
-        if (tris[j].texture != last_tex || tris[j].flags != last_flags)
-        {
-            do_batch = 1;
-        }
+        // rdCache packs everything that changes GL state into the sort key
+        if (j && tris[j].sortKey == last_key)
+            continue;
+
+        int num_tris_batch = j - last_tex_idx;
+        rdDDrawSurface* tex = tris[j].texture;
         
-        if (do_batch)
+        test_idk = tex;
+
+        if (num_tris_batch)
         {
-            int num_tris_batch = j - last_tex_idx;
-            rdDDrawSurface* tex = tris[j].texture;
-            
-            test_idk = tex;
+            //printf("batch %u~%u\n", last_tex_idx, j);
+            std3D_DrawWorldBatch(num_tris_batch, world_data_elements_offs + (last_tex_idx * 3 * sizeof(GLuint)), numInstances);
+        }
 
-            if (num_tris_batch)
-            {
-                //printf("batch %u~%u\n", last_tex_idx, j);
-                glDrawElements(GL_TRIANGLES, num_tris_batch * 3, GL_UNSIGNED_SHORT, (GLvoid*)((intptr_t)&world_data_elements[last_tex_idx * 3] - (intptr_t)&world_data_elements[0]));
-            }
+        if (tex && tex->texture_id)
+        {
+            std3D_SetWorldTexture(tex->texture_id);
 
-            if (tex)
-            {
-                int tex_id = tex->texture_id;
-                glActiveTexture(GL_TEXTURE0 + 0);
-                if (tex_id == 0)
-                    glBindTexture(GL_TEXTURE_2D, worldpal_texture);
-                else
-                    glBindTexture(GL_TEXTURE_2D, tex_id);
+            if (!jkPlayer_enableTextureFilter)
+                std3D_SetWorldTexMode(tex->is_16bit ? TEX_MODE_16BPP : TEX_MODE_WORLDPAL);
+            else
+                std3D_SetWorldTexMode(tex->is_16bit ? TEX_MODE_BILINEAR_16BPP : TEX_MODE_BILINEAR);
+        }
+        else
+        {
+            std3D_SetWorldTexture(0);
+            std3D_SetWorldTexMode(TEX_MODE_TEST);
+        }
 
-                if (!jkPlayer_enableTextureFilter)
-                    glUniform1i(uniform_tex_mode, tex->is_16bit ? TEX_MODE_16BPP : TEX_MODE_WORLDPAL);
-                else
-                    glUniform1i(uniform_tex_mode, tex->is_16bit ? TEX_MODE_BILINEAR_16BPP : TEX_MODE_BILINEAR);
-                
-                if (jkPlayer_enableTextureFilter && tex->is_16bit)
-                {
-                    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-                    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-                }
-                else
-                {
-                    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-                    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-                }
+        std3D_SetWorldBlendMode((tris[j].flags & 0x600) ? 5 : 2);
 
-                if (tex_id == 0)
-                    glUniform1i(uniform_tex_mode, TEX_MODE_TEST);
+        if ((tris[j].flags & 0x1800) != last_depth_flags)
+        {
+            if (tris[j].flags & 0x800)
+            {
+                std3D_SetWorldDepthFunc(GL_LESS);
             }
             else
             {
-                glActiveTexture(GL_TEXTURE0 + 0);
-                glBindTexture(GL_TEXTURE_2D, worldpal_texture);
-                glUniform1i(uniform_tex_mode, TEX_MODE_TEST);
+                //glDepthFunc(GL_ALWAYS);
+                glClear(GL_DEPTH_BUFFER_BIT);
             }
             
-            int changed_flags = (last_flags ^ tris[j].flags);
-
-            if (changed_flags & 0x600)
+            if ((last_depth_flags ^ tris[j].flags) & 0x1000)
             {
-                if (tris[j].flags & 0x600)
-                    glUniform1i(uniform_blend_mode, 5);
-                else
-                    glUniform1i(uniform_blend_mode, 2);
+                glDepthMask(GL_TRUE);
             }
-            
-            if (changed_flags & 0x1800)
-            {
-                if (tris[j].flags & 0x800)
-                {
-                    glDepthFunc(GL_LESS);
-                }
-                else
-                {
-                    //glDepthFunc(GL_ALWAYS);
-                    glClear(GL_DEPTH_BUFFER_BIT);
-                }
-                
-                if (changed_flags & 0x1000)
-                {
-                    glDepthMask(GL_TRUE);
-                }
-                else
-                {
-                    //glDepthMask(GL_FALSE);
-                }
-            }
-
-            if (changed_flags & 0x10000)
+            else
             {
-                if (tris[j].flags & 0x10000) {
-                    glCullFace(GL_BACK);
-                }
-                else
-                {
-                    glCullFace(GL_FRONT);
-                }
+                //glDepthMask(GL_FALSE);
             }
-            
-            last_tex = tris[j].texture;
-            last_flags = tris[j].flags;
-            last_tex_idx = j;
-
-            do_batch = 0;
+            last_depth_flags = tris[j].flags & 0x1800;
         }
-        //printf("tri %u: %u,%u,%u, flags %x\n", j, tris[j].v1, tris[j].v2, tris[j].v3, tris[j].flags);
-        
-        
-        /*int vert = tris[j].v1;
-        printf("%u: %f %f %f, %f %f %f, %f %f\n", vert, vertexes[vert].x, vertexes[vert].y, vertexes[vert].z,
-                                      vertexes[vert].nx, vertexes[vert].ny, vertexes[vert].nz,
-                                      vertexes[vert].tu, vertexes[vert].tv);
-        
-        vert = tris[j].v2;
-        printf("%u: %f %f %f, %f %f %f, %f %f\n", vert, vertexes[vert].x, vertexes[vert].y, vertexes[vert].z,
-                                      vertexes[vert].nx, vertexes[vert].ny, vertexes[vert].nz,
-                                      vertexes[vert].tu, vertexes[vert].tv);
+
+        std3D_SetWorldCullFace((tris[j].flags & 0x10000) ? GL_BACK : GL_FRONT);
         
-        vert = tris[j].v3;
-        printf("%u: %f %f %f, %f %f %f, %f %f\n", vert, vertexes[vert].x, vertexes[vert].y, vertexes[vert].z,
-                                      vertexes[vert].nx, vertexes[vert].ny, vertexes[vert].nz,
-                                      vertexes[vert].tu, vertexes[vert].tv);*/
+        last_tex = tris[j].texture;
+        last_flags = tris[j].flags;
+        last_key = tris[j].sortKey;
+        last_tex_idx = j;
     }
     
-    int remaining_batch = GL_tmpTrisAmt - last_tex_idx;
+    int remaining_batch = trisAmt - last_tex_idx;
 
     if (remaining_batch)
     {
-        glDrawElements(GL_TRIANGLES, remaining_batch * 3, GL_UNSIGNED_SHORT, (GLvoid*)((intptr_t)&world_data_elements[last_tex_idx * 3] - (intptr_t)&world_data_elements[0]));
+        std3D_DrawWorldBatch(remaining_batch, world_data_elements_offs + (last_tex_idx * 3 * sizeof(GLuint)), numInstances);
+    }
+    std3D_frameTris += trisAmt * (numInstances ? numInstances : 1);
+        
+    // Done drawing    
+    glBindTexture(GL_TEXTURE_2D, worldpal_texture);
+    glCullFace(GL_FRONT);
+}
+
+void std3D_DrawRenderList()
+{
+    if (!world_data_all || !world_trisAmt)
+    {
+        std3D_ResetRenderList();
+        return;
     }
+
+    // Vertices were already written into the stream by std3D_AddRenderListVertices
+    std3D_SetVertexLayers((uint8_t*)&world_data_all[0].layer, sizeof(std3DWorldVBO), world_tris, world_trisAmt);
+    std3D_StreamCommit(&world_vbo_stream, world_verticesAmt * sizeof(std3DWorldVBO));
+    std3D_SetWorldVertexAttribs(world_data_all_offs);
     
+    std3D_BeginWorldDraw();
+    std3D_DrawWorldTris(world_tris, world_trisAmt, 0);
     
 #if 0
     // Draw all lines
+    rdLine* lines = GL_tmpLines;
     world_data_elements = malloc(sizeof(GLushort) * 2 * GL_tmpLinesAmt);
     for (int j = 0; j < GL_tmpLinesAmt; j++)
     {
@@ -1017,14 +1540,284 @@ void std3D_DrawRenderList()
     glGetBufferParameteriv(GL_ELEMENT_ARRAY_BUFFER, GL_BUFFER_SIZE, &lines_size);
     glDrawElements(GL_LINES, lines_size / sizeof(GLushort), GL_UNSIGNED_SHORT, 0);
 #endif
-        
-    // Done drawing    
-    glBindTexture(GL_TEXTURE_2D, worldpal_texture);
-    glCullFace(GL_FRONT);
     
     std3D_ResetRenderList();
 }
 
+// Combines a world space projection into rdCache's screen space with the
+// screen to clip space matrix
+static void std3D_SetStaticMvp(const float* pScreenProj)
+{
+    float d3dmat[16];
+    float mvp[16];
+
+    std3D_GetWorldScreenMatrix(d3dmat);
+    for (int i = 0; i < 4; i++)
+    {
+        for (int j = 0; j < 4; j++)
+        {
+            mvp[(i*4)+j] = d3dmat[(0*4)+j] * pScreenProj[(i*4)+0]
+                         + d3dmat[(1*4)+j] * pScreenProj[(i*4)+1]
+                         + d3dmat[(2*4)+j] * pScreenProj[(i*4)+2]
+                         + d3dmat[(3*4)+j] * pScreenProj[(i*4)+3];
+        }
+    }
+    glUniformMatrix4fv(uniform_mvp_static, 1, GL_FALSE, mvp);
+}
+
+int std3D_UploadStaticGeometry(const rdVector3* pVertices, size_t numVertices)
+{
+    GLuint buffer;
+    size_t sectionSize;
+
+    std3D_FreeStaticGeometry();
+    if (!has_initted || !numVertices)
+        return 0;
+
+    glGenBuffers(1, &world_vbo_static);
+    glBindBuffer(GL_ARRAY_BUFFER, world_vbo_static);
+    glBufferData(GL_ARRAY_BUFFER, numVertices * sizeof(rdVector3), pVertices, GL_STATIC_DRAW);
+
+    // Every section holds colors/UVs for all resident vertices
+    sectionSize = numVertices * sizeof(std3DStaticVertex);
+    sectionSize = (sectionSize + (STD3D_STREAM_ALIGN - 1)) & ~(STD3D_STREAM_ALIGN - 1);
+
+    glGenBuffers(1, &buffer);
+    if (!std3D_StreamInit(&world_static_stream, buffer, GL_ARRAY_BUFFER, sectionSize * STD3D_STREAM_SECTIONS))
+    {
+        std3D_FreeStaticGeometry();
+        return 0;
+    }
+
+    world_staticVerticesAmt = numVertices;
+    return 1;
+}
+
+void std3D_FreeStaticGeometry()
+{
+    if (!world_vbo_static)
+        return;
+
+    std3D_StreamFree(&world_static_stream);
+    glDeleteBuffers(1, &world_static_stream.buffer);
+    glDeleteBuffers(1, &world_vbo_static);
+    memset(&world_static_stream, 0, sizeof(world_static_stream));
+
+    world_vbo_static = 0;
+    world_staticVerticesAmt = 0;
+    world_static_data = NULL;
+}
+
+int std3D_HasStaticGeometry()
+{
+    return world_vbo_static && world_staticVerticesAmt;
+}
+
+std3DStaticVertex* std3D_BeginStaticRenderList()
+{
+    if (!std3D_HasStaticGeometry())
+        return NULL;
+
+    world_static_data = std3D_StreamReserve(&world_static_stream, world_staticVerticesAmt * sizeof(std3DStaticVertex), &world_static_data_offs);
+    return world_static_data;
+}
+
+// pScreenProj maps world space to rdCache's screen space, scaled by 1/(1-z).
+// Only the vertices in pRanges were written this frame and get uploaded, the
+// rest of the section is stale but no tri indexes it.
+void std3D_DrawStaticRenderList(rdTri* tris, size_t numTris, const std3DVertexRange* pRanges, size_t numRanges, const float* pScreenProj)
+{
+    if (!world_static_data)
+        return;
+
+    std3D_SetVertexLayers((uint8_t*)&world_static_data[0].layer, sizeof(std3DStaticVertex), tris, numTris);
+    std3D_StreamCommitRanges(&world_static_stream, world_staticVerticesAmt * sizeof(std3DStaticVertex), sizeof(std3DStaticVertex), pRanges, numRanges);
+    world_static_data = NULL;
+    if (!numTris)
+        return;
+
+    glBindBuffer(GL_ARRAY_BUFFER, world_vbo_static);
+    glVertexAttribPointer(attribute_coord3d, 3, GL_FLOAT, GL_FALSE, sizeof(rdVector3), (GLvoid*)0);
+
+    glBindBuffer(GL_ARRAY_BUFFER, world_static_stream.buffer);
+    glVertexAttribPointer(attribute_v_color, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(std3DStaticVertex), (GLvoid*)(world_static_data_offs + offsetof(std3DStaticVertex, color)));
+    glVertexAttribPointer(attribute_v_uv, 2, GL_FLOAT, GL_FALSE, sizeof(std3DStaticVertex), (GLvoid*)(world_static_data_offs + offsetof(std3DStaticVertex, tu)));
+    glVertexAttribPointer(attribute_v_layer, 1, GL_FLOAT, GL_FALSE, sizeof(std3DStaticVertex), (GLvoid*)(world_static_data_offs + offsetof(std3DStaticVertex, layer)));
+
+    std3D_BeginWorldDraw();
+    std3D_SetStaticMvp(pScreenProj);
+    glUniform1i(uniform_static_geo, 1);
+    std3D_EnableLightAttrib(0);
+
+    std3D_DrawWorldTris(tris, numTris, 0);
+
+    std3D_EnableLightAttrib(1);
+    glUniform1i(uniform_static_geo, 0);
+}
+
+int std3D_UploadInstanceGeometry(const rdVector3* pVertices, size_t numVertices)
+{
+    GLuint buffer;
+    size_t sectionSize;
+
+    std3D_FreeInstanceGeometry();
+    if (!has_initted || !numVertices)
+        return 0;
+
+    glGenBuffers(1, &world_vbo_instance);
+    glBindBuffer(GL_ARRAY_BUFFER, world_vbo_instance);
+    glBufferData(GL_ARRAY_BUFFER, numVertices * sizeof(rdVector3), pVertices, GL_STATIC_DRAW);
+
+    // Every section holds colors/UVs for all resident mesh vertices
+    sectionSize = numVertices * sizeof(std3DStaticVertex);
+    sectionSize = (sectionSize + (STD3D_STREAM_ALIGN - 1)) & ~(STD3D_STREAM_ALIGN - 1);
+
+    glGenBuffers(1, &buffer);
+    if (!std3D_StreamInit(&world_instance_vtx_stream, buffer, GL_ARRAY_BUFFER, sectionSize * STD3D_STREAM_SECTIONS))
+    {
+        std3D_FreeInstanceGeometry();
+        return 0;
+    }
+
+    glGenBuffers(1, &buffer);
+    if (!std3D_StreamInit(&world_instance_stream, buffer, GL_ARRAY_BUFFER, STD3D_STREAM_INSTANCE_SIZE))
+    {
+        std3D_FreeInstanceGeometry();
+        return 0;
+    }
+
+    world_instanceVerticesAmt = numVertices;
+    return 1;
+}
+
+void std3D_FreeInstanceGeometry()
+{
+    if (!world_vbo_instance)
+        return;
+
+    if (world_instance_vtx_stream.buffer)
+    {
+        std3D_StreamFree(&world_instance_vtx_stream);
+        glDeleteBuffers(1, &world_instance_vtx_stream.buffer);
+    }
+    if (world_instance_stream.buffer)
+    {
+        std3D_StreamFree(&world_instance_stream);
+        glDeleteBuffers(1, &world_instance_stream.buffer);
+    }
+    glDeleteBuffers(1, &world_vbo_instance);
+    memset(&world_instance_vtx_stream, 0, sizeof(world_instance_vtx_stream));
+    memset(&world_instance_stream, 0, sizeof(world_instance_stream));
+
+    world_vbo_instance = 0;
+    world_instanceVerticesAmt = 0;
+    world_instance_data = NULL;
+}
+
+int std3D_HasInstanceGeometry()
+{
+    return world_vbo_instance && world_instanceVerticesAmt;
+}
+
+std3DStaticVertex* std3D_BeginInstanceRenderList()
+{
+    if (!std3D_HasInstanceGeometry())
+        return NULL;
+
+    world_instance_data = std3D_StreamReserve(&world_instance_vtx_stream, world_instanceVerticesAmt * sizeof(std3DStaticVertex), &world_instance_data_offs);
+    return world_instance_data;
+}
+
+static void std3D_SetInstanceAttribs(size_t offs)
+{
+    glVertexAttribPointer(attribute_v_inst_x, 4, GL_FLOAT, GL_FALSE, sizeof(std3DInstance), (GLvoid*)(offs + offsetof(std3DInstance, aRows[0])));
+    glVertexAttribPointer(attribute_v_inst_y, 4, GL_FLOAT, GL_FALSE, sizeof(std3DInstance), (GLvoid*)(offs + offsetof(std3DInstance, aRows[1])));
+    glVertexAttribPointer(attribute_v_inst_z, 4, GL_FLOAT, GL_FALSE, sizeof(std3DInstance), (GLvoid*)(offs + offsetof(std3DInstance, aRows[2])));
+    glVertexAttribPointer(attribute_v_inst_light, 4, GL_FLOAT, GL_FALSE, sizeof(std3DInstance), (GLvoid*)(offs + offsetof(std3DInstance, tint)));
+}
+
+static void std3D_EnableInstanceAttribs(int bEnable)
+{
+    GLint aAttribs[4] = {attribute_v_inst_x, attribute_v_inst_y, attribute_v_inst_z, attribute_v_inst_light};
+
+    for (int i = 0; i < 4; i++)
+    {
+        if (bEnable)
+            glEnableVertexAttribArray(aAttribs[i]);
+        else
+            glDisableVertexAttribArray(aAttribs[i]);
+        glVertexAttribDivisor(aAttribs[i], bEnable ? 1 : 0);
+    }
+}
+
+// Every batch's tris index the resident mesh vertices and are drawn once
+// per instance. pScreenProj is the same world space projection as
+// std3D_DrawStaticRenderList's.
+void std3D_DrawInstancedRenderList(std3DInstanceBatch* pBatches, size_t numBatches, const float* pScreenProj)
+{
+    std3DInstance* pInstances;
+    size_t numInstances = 0;
+    size_t instancesOffs = 0;
+
+    if (!world_instance_data)
+        return;
+
+    for (size_t i = 0; i < numBatches; i++)
+    {
+        std3D_SetVertexLayers((uint8_t*)&world_instance_data[0].layer, sizeof(std3DStaticVertex), pBatches[i].tris, pBatches[i].numTris);
+        numInstances += pBatches[i].numInstances;
+    }
+    std3D_StreamCommit(&world_instance_vtx_stream, world_instanceVerticesAmt * sizeof(std3DStaticVertex));
+    world_instance_data = NULL;
+    if (!numInstances)
+        return;
+
+    pInstances = std3D_StreamReserve(&world_instance_stream, numInstances * sizeof(std3DInstance), &instancesOffs);
+    if (!pInstances)
+        return;
+    for (size_t i = 0; i < numBatches; i++)
+    {
+        memcpy(pInstances, pBatches[i].pInstances, pBatches[i].numInstances * sizeof(std3DInstance));
+        pInstances += pBatches[i].numInstances;
+    }
+    std3D_StreamCommit(&world_instance_stream, numInstances * sizeof(std3DInstance));
+
+    glBindBuffer(GL_ARRAY_BUFFER, world_vbo_instance);
+    glVertexAttribPointer(attribute_coord3d, 3, GL_FLOAT, GL_FALSE, sizeof(rdVector3), (GLvoid*)0);
+
+    glBindBuffer(GL_ARRAY_BUFFER, world_instance_vtx_stream.buffer);
+    glVertexAttribPointer(attribute_v_color, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(std3DStaticVertex), (GLvoid*)(world_instance_data_offs + offsetof(std3DStaticVertex, color)));
+    glVertexAttribPointer(attribute_v_uv, 2, GL_FLOAT, GL_FALSE, sizeof(std3DStaticVertex), (GLvoid*)(world_instance_data_offs + offsetof(std3DStaticVertex, tu)));
+    glVertexAttribPointer(attribute_v_layer, 1, GL_FLOAT, GL_FALSE, sizeof(std3DStaticVertex), (GLvoid*)(world_instance_data_offs + offsetof(std3DStaticVertex, layer)));
+
+    std3D_BeginWorldDraw();
+    std3D_SetStaticMvp(pScreenProj);
+    glUniform1i(uniform_static_geo, 2);
+    std3D_EnableLightAttrib(0);
+
+    std3D_EnableInstanceAttribs(1);
+    for (size_t i = 0; i < numBatches; i++)
+    {
+        if (!pBatches[i].numTris || !pBatches[i].numInstances)
+        {
+            continue;
+        }
+
+        // std3D_DrawWorldTris leaves its own cull face and texture behind
+        std3D_InvalidateWorldState();
+
+        glBindBuffer(GL_ARRAY_BUFFER, world_instance_stream.buffer);
+        std3D_SetInstanceAttribs(instancesOffs);
+        std3D_DrawWorldTris(pBatches[i].tris, pBatches[i].numTris, pBatches[i].numInstances);
+
+        instancesOffs += pBatches[i].numInstances * sizeof(std3DInstance);
+    }
+    std3D_EnableInstanceAttribs(0);
+
+    std3D_EnableLightAttrib(1);
+    glUniform1i(uniform_static_geo, 0);
+}
+
 int std3D_SetCurrentPalette(rdColor24 *a1, int a2)
 {
     return 1;
@@ -1044,27 +1837,42 @@ int std3D_DrawOverlay()
 
 void std3D_UnloadAllTextures()
 {
-    glDeleteTextures(std3D_loadedTexturesAmt, std3D_aLoadedTextures);
-    std3D_loadedTexturesAmt = 0;
+    std3D_FreeAllTextures();
 }
 
 void std3D_AddRenderListTris(rdTri *tris, unsigned int num_tris)
 {
-    if (GL_tmpTrisAmt + num_tris > STD3D_MAX_TRIS)
+    if (world_trisAmt + num_tris > world_trisMax)
     {
-        return;
+        size_t newMax = world_trisMax ? world_trisMax : STD3D_MAX_TRIS;
+        while (newMax < world_trisAmt + num_tris)
+            newMax *= 2;
+
+        rdTri* pNew = realloc(world_tris, sizeof(rdTri) * newMax);
+        if (!pNew)
+            return;
+        world_tris = pNew;
+        world_trisMax = newMax;
     }
     
-    memcpy(&GL_tmpTris[GL_tmpTrisAmt], tris, sizeof(rdTri) * num_tris);
+    memcpy(&world_tris[world_trisAmt], tris, sizeof(rdTri) * num_tris);
     
-    GL_tmpTrisAmt += num_tris;
+    world_trisAmt += num_tris;
 }
 
 void std3D_AddRenderListLines(rdLine* lines, uint32_t num_lines)
 {
-    if (GL_tmpLinesAmt + num_lines > STD3D_MAX_VERTICES)
+    if (GL_tmpLinesAmt + num_lines > GL_tmpLinesMax)
     {
-        return;
+        size_t newMax = GL_tmpLinesMax ? GL_tmpLinesMax : STD3D_MAX_VERTICES;
+        while (newMax < GL_tmpLinesAmt + num_lines)
+            newMax *= 2;
+
+        rdLine* pNew = realloc(GL_tmpLines, sizeof(rdLine) * newMax);
+        if (!pNew)
+            return;
+        GL_tmpLines = pNew;
+        GL_tmpLinesMax = newMax;
     }
     
     memcpy(&GL_tmpLines[GL_tmpLinesAmt], lines, sizeof(rdLine) * num_lines);
@@ -1073,14 +1881,26 @@ void std3D_AddRenderListLines(rdLine* lines, uint32_t num_lines)
 
 int std3D_AddRenderListVertices(D3DVERTEX *vertices, int count)
 {
-    if (GL_tmpVerticesAmt + count >= STD3D_MAX_VERTICES)
+    // Reserve room for a full render list up front, only the used part gets committed.
+    // rdCache hands over the whole frame list at once, so this usually happens once per draw.
+    if (!world_data_all)
+    {
+        size_t reserveAmt = count > STD3D_MAX_VERTICES ? count : STD3D_MAX_VERTICES;
+        world_data_all = std3D_StreamReserve(&world_vbo_stream, reserveAmt * sizeof(std3DWorldVBO), &world_data_all_offs);
+        if (!world_data_all)
+            return 0;
+        world_vbo_all = world_vbo_stream.buffer;
+        world_verticesMax = reserveAmt;
+    }
+
+    if (world_verticesAmt + count > world_verticesMax)
     {
         return 0;
     }
     
-    memcpy(&GL_tmpVertices[GL_tmpVerticesAmt], vertices, sizeof(D3DVERTEX) * count);
+    memcpy(&world_data_all[world_verticesAmt], vertices, sizeof(D3DVERTEX) * count);
     
-    GL_tmpVerticesAmt += count;
+    world_verticesAmt += count;
     
     return 1;
 }
@@ -1090,98 +1910,727 @@ int std3D_ClearZBuffer()
     return 1;
 }
 
-int std3D_AddToTextureCache(stdVBuffer *vbuf, rdDDrawSurface *texture, int is_alpha_tex, int no_alpha)
+static void std3D_GetTextureFormat(int format, GLint* pInternalFormat, GLenum* pFormat, GLenum* pType)
 {
-    //printf("Add to texture cache\n");
-    
-    GLuint image_texture;
-    glGenTextures(1, &image_texture);
-    uint8_t* image_8bpp = vbuf->sdlSurface->pixels;
-    uint16_t* image_16bpp = vbuf->sdlSurface->pixels;
-    uint8_t* pal = vbuf->palette;
-    
-    uint32_t width, height;
-    width = vbuf->format.width;
-    height = vbuf->format.height;
+    switch (format)
+    {
+        case STD3D_TEXFMT_RGB565:
+            *pInternalFormat = GL_RGB8;
+            *pFormat = GL_RGB;
+            *pType = GL_UNSIGNED_SHORT_5_6_5_REV;
+            break;
+        case STD3D_TEXFMT_RGBA5551:
+            *pInternalFormat = GL_RGBA8;
+            *pFormat = GL_RGBA;
+            *pType = GL_UNSIGNED_SHORT_1_5_5_5_REV;
+            break;
+        default:
+            *pInternalFormat = GL_R8;
+            *pFormat = GL_RED;
+            *pType = GL_UNSIGNED_BYTE;
+            break;
+    }
+}
 
-    glBindTexture(GL_TEXTURE_2D, image_texture);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+// Runs on the texture thread, so it may only touch the job itself.
+// Textures stay indexed on the GPU (the palette lookup is in the shader), so
+// 8-bit levels and the 1-bit alpha ones are point sampled and only 565 is
+// box filtered.
+static void std3D_BuildMipChain(std3DTextureJob* pJob)
+{
+    uint32_t bpp = pJob->bpp;
+    uint32_t w = pJob->width;
+    uint32_t h = pJob->height;
+    size_t total = 0;
+    int numLevels = 0;
+    uint8_t* pLevels;
+    uint8_t* pSrc;
+
+    while (1)
+    {
+        total += w * h * bpp;
+        numLevels++;
+        if ((w == 1 && h == 1) || numLevels == STD3D_TEX_MAX_LEVELS)
+            break;
+        w = w > 1 ? w >> 1 : 1;
+        h = h > 1 ? h >> 1 : 1;
+    }
+
+    pLevels = (uint8_t*)malloc(total);
+    if (!pLevels)
+        return;
+
+    w = pJob->width;
+    h = pJob->height;
+    memcpy(pLevels, pJob->pPixels, w * h * bpp);
+
+    pSrc = pLevels;
+    for (int level = 1; level < numLevels; level++)
+    {
+        uint32_t nw = w > 1 ? w >> 1 : 1;
+        uint32_t nh = h > 1 ? h >> 1 : 1;
+        uint8_t* pDst = pSrc + w * h * bpp;
+
+        for (uint32_t y = 0; y < nh; y++)
+        {
+            uint32_t y0 = (y * 2) * w;
+            uint32_t y1 = (y * 2 + 1 < h) ? (y * 2 + 1) * w : y0;
+
+            for (uint32_t x = 0; x < nw; x++)
+            {
+                uint32_t x0 = x * 2;
+                uint32_t x1 = (x * 2 + 1 < w) ? x * 2 + 1 : x0;
+
+                if (pJob->format == STD3D_TEXFMT_RGB565)
+                {
+                    const uint16_t* pSrc16 = (const uint16_t*)pSrc;
+                    uint32_t a = pSrc16[y0 + x0];
+                    uint32_t b = pSrc16[y0 + x1];
+                    uint32_t c = pSrc16[y1 + x0];
+                    uint32_t d = pSrc16[y1 + x1];
+                    uint32_t hi = ((a >> 11) + (b >> 11) + (c >> 11) + (d >> 11) + 2) >> 2;
+                    uint32_t mid = (((a >> 5) & 0x3F) + ((b >> 5) & 0x3F) + ((c >> 5) & 0x3F) + ((d >> 5) & 0x3F) + 2) >> 2;
+                    uint32_t lo = ((a & 0x1F) + (b & 0x1F) + (c & 0x1F) + (d & 0x1F) + 2) >> 2;
+
+                    ((uint16_t*)pDst)[y * nw + x] = (uint16_t)((hi << 11) | (mid << 5) | lo);
+                }
+                else if (bpp == 2)
+                {
+                    ((uint16_t*)pDst)[y * nw + x] = ((const uint16_t*)pSrc)[y0 + x0];
+                }
+                else
+                {
+                    pDst[y * nw + x] = pSrc[y0 + x0];
+                }
+            }
+        }
+
+        pSrc = pDst;
+        w = nw;
+        h = nh;
+    }
+
+    free(pJob->pPixels);
+    pJob->pPixels = pLevels;
+    pJob->numLevels = numLevels;
+    pJob->levelsSize = total;
+}
+
+static GLuint std3D_CreateTextureArray(int format, uint32_t width, uint32_t height, int numLevels, int numLayers)
+{
+    GLuint tex;
+    GLint internalFormat;
+    GLenum glFormat, glType;
+
+    std3D_GetTextureFormat(format, &internalFormat, &glFormat, &glType);
+
+    glGenTextures(1, &tex);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, tex);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
+
+    for (int i = 0; i < numLevels; i++)
+    {
+        glTexImage3D(GL_TEXTURE_2D_ARRAY, i, internalFormat, width, height, numLayers, 0, glFormat, glType, NULL);
+        width = width > 1 ? width >> 1 : 1;
+        height = height > 1 ? height >> 1 : 1;
+    }
+
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, numLevels - 1);
+    std3D_SetTextureFilter(format != STD3D_TEXFMT_INDEXED, numLevels);
+
+    // The world draw caches the bound texture
+    std3D_curTexture = (GLuint)-1;
+    return tex;
+}
+
+static void std3D_UploadLayer(GLuint tex, int format, uint32_t width, uint32_t height, int numLevels, int layer, const uint8_t* pPixels)
+{
+    GLint internalFormat;
+    GLenum glFormat, glType;
+    uint32_t bpp = (format == STD3D_TEXFMT_INDEXED) ? 1 : 2;
+
+    std3D_GetTextureFormat(format, &internalFormat, &glFormat, &glType);
+
+    glBindTexture(GL_TEXTURE_2D_ARRAY, tex);
     glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
 
-    if (vbuf->format.format.is16bit)
+    // The small levels have rows narrower than 4 bytes
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    for (int i = 0; i < numLevels; i++)
     {
-        texture->is_16bit = 1;
-        if (!is_alpha_tex)
-            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB8, width, height, 0,  GL_RGB, GL_UNSIGNED_SHORT_5_6_5_REV, image_8bpp);
+        glTexSubImage3D(GL_TEXTURE_2D_ARRAY, i, 0, 0, layer, width, height, 1, glFormat, glType, pPixels);
+        pPixels += width * height * bpp;
+        width = width > 1 ? width >> 1 : 1;
+        height = height > 1 ? height >> 1 : 1;
+    }
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+    std3D_curTexture = (GLuint)-1;
+}
+
+// Finds a free layer in a page matching the chain, or starts a new page.
+// Pages are sized to roughly STD3D_TEX_PAGE_BYTES, 16-bit formats are
+// counted twice since they're expanded to 8 bits per channel on the GPU.
+// The whole page goes against the texture budget as soon as it exists.
+static int std3D_AllocTextureLayer(int format, uint32_t width, uint32_t height, int numLevels, size_t levelsSize, int* pLayerOut)
+{
+    std3DTexturePage* pPage;
+    size_t layerBytes;
+    int idx = -1;
+
+    for (size_t i = 0; i < std3D_texturePagesAmt; i++)
+    {
+        pPage = &std3D_aTexturePages[i];
+        if (!pPage->texture)
+        {
+            if (idx < 0)
+                idx = i;
+            continue;
+        }
+        if (pPage->format != format || pPage->width != width || pPage->height != height || pPage->usedLayers >= pPage->numLayers)
+            continue;
+
+        for (int j = 0; j < pPage->numLayers; j++)
+        {
+            if (pPage->usedMask & (1ull << j))
+                continue;
+
+            pPage->usedMask |= (1ull << j);
+            pPage->usedLayers++;
+            *pLayerOut = j;
+            return i;
+        }
+    }
+
+    if (idx < 0)
+    {
+        if (std3D_texturePagesAmt >= std3D_texturePagesMax)
+        {
+            size_t newMax = std3D_texturePagesMax ? std3D_texturePagesMax * 2 : 64;
+            std3DTexturePage* pNew = (std3DTexturePage*)realloc(std3D_aTexturePages, sizeof(std3DTexturePage) * newMax);
+            if (!pNew)
+                return -1;
+            std3D_aTexturePages = pNew;
+            std3D_texturePagesMax = newMax;
+        }
+        idx = std3D_texturePagesAmt++;
+    }
+
+    layerBytes = levelsSize * (format == STD3D_TEXFMT_INDEXED ? 1 : 2);
+
+    pPage = &std3D_aTexturePages[idx];
+    memset(pPage, 0, sizeof(std3DTexturePage));
+    pPage->format = format;
+    pPage->width = width;
+    pPage->height = height;
+    pPage->numLevels = numLevels;
+    pPage->numLayers = STD3D_TEX_PAGE_BYTES / (layerBytes ? layerBytes : 1);
+    if (pPage->numLayers < 1)
+        pPage->numLayers = 1;
+    else if (pPage->numLayers > STD3D_TEX_PAGE_MAX_LAYERS)
+        pPage->numLayers = STD3D_TEX_PAGE_MAX_LAYERS;
+    pPage->texture = std3D_CreateTextureArray(format, width, height, numLevels, pPage->numLayers);
+    pPage->usedMask = 1;
+    pPage->usedLayers = 1;
+    pPage->bytes = layerBytes * pPage->numLayers;
+    pPage->lastFrame = std3D_textureFrame;
+    std3D_textureBytes += pPage->bytes;
+
+    *pLayerOut = 0;
+    return idx;
+}
+
+static void std3D_FreeTextureLayer(int page, int layer)
+{
+    std3DTexturePage* pPage = &std3D_aTexturePages[page];
+
+    pPage->usedMask &= ~(1ull << layer);
+    if (--pPage->usedLayers > 0)
+        return;
+
+    glDeleteTextures(1, &pPage->texture);
+    pPage->texture = 0;
+    std3D_textureBytes -= pPage->bytes;
+    std3D_curTexture = (GLuint)-1;
+}
+
+// Texture array layer the surface was put in, written to each vertex
+static float std3D_GetTextureLayer(rdDDrawSurface* surface)
+{
+    uint32_t idx;
+
+    if (!surface)
+        return 0.0;
+
+    idx = surface->gpu_accel_maybe - 1;
+    if (idx >= std3D_texturesAmt || std3D_aTextures[idx].surface != surface)
+        return 0.0;
+    return (float)std3D_aTextures[idx].layer;
+}
+
+static void std3D_SetVertexLayers(uint8_t* pLayers, size_t stride, rdTri* tris, size_t trisAmt)
+{
+    rdDDrawSurface* lastTex = NULL;
+    float layer = 0.0;
+
+    for (size_t i = 0; i < trisAmt; i++)
+    {
+        if (i == 0 || tris[i].texture != lastTex)
+        {
+            lastTex = tris[i].texture;
+            layer = std3D_GetTextureLayer(lastTex);
+        }
+
+        *(float*)(pLayers + tris[i].v1 * stride) = layer;
+        *(float*)(pLayers + tris[i].v2 * stride) = layer;
+        *(float*)(pLayers + tris[i].v3 * stride) = layer;
+    }
+}
+
+#ifdef STD3D_ASYNC_TEXTURES
+// Point sampled stand-in that's drawn until the real chain is uploaded
+static GLuint std3D_UploadPlaceholder(std3DTextureJob* pJob, size_t* pBytesOut)
+{
+    uint8_t aPixels[STD3D_TEX_PLACEHOLDER_SIZE * STD3D_TEX_PLACEHOLDER_SIZE * 2];
+    uint32_t shift = 0;
+    uint32_t w, h;
+    GLuint tex;
+
+    while ((pJob->width >> shift) > STD3D_TEX_PLACEHOLDER_SIZE || (pJob->height >> shift) > STD3D_TEX_PLACEHOLDER_SIZE)
+        shift++;
+
+    w = (pJob->width >> shift) ? (pJob->width >> shift) : 1;
+    h = (pJob->height >> shift) ? (pJob->height >> shift) : 1;
+
+    for (uint32_t y = 0; y < h; y++)
+    {
+        const uint8_t* pRow = pJob->pPixels + (y << shift) * pJob->width * pJob->bpp;
+        for (uint32_t x = 0; x < w; x++)
+            memcpy(&aPixels[(y * w + x) * pJob->bpp], pRow + (x << shift) * pJob->bpp, pJob->bpp);
+    }
+
+    *pBytesOut = w * h * pJob->bpp;
+    tex = std3D_CreateTextureArray(pJob->format, w, h, 1, 1);
+    std3D_UploadLayer(tex, pJob->format, w, h, 1, 0, aPixels);
+    return tex;
+}
+
+static void std3D_FreeTextureJobs(std3DTextureJob* pJob)
+{
+    while (pJob)
+    {
+        std3DTextureJob* pNext = pJob->pNext;
+        free(pJob->pPixels);
+        free(pJob);
+        pJob = pNext;
+    }
+}
+
+static int std3D_TextureThread(void* unused)
+{
+    std3DTextureJob* pJob;
+
+    SDL_LockMutex(std3D_pTexMutex);
+    while (!std3D_bTexThreadQuit)
+    {
+        pJob = std3D_pTexPending;
+        if (!pJob)
+        {
+            SDL_CondWait(std3D_pTexCond, std3D_pTexMutex);
+            continue;
+        }
+
+        std3D_pTexPending = pJob->pNext;
+        if (!std3D_pTexPending)
+            std3D_pTexPendingTail = NULL;
+        SDL_UnlockMutex(std3D_pTexMutex);
+
+        std3D_BuildMipChain(pJob);
+
+        SDL_LockMutex(std3D_pTexMutex);
+        pJob->pNext = NULL;
+        if (std3D_pTexDoneTail)
+            std3D_pTexDoneTail->pNext = pJob;
         else
-            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0,  GL_RGBA, GL_UNSIGNED_SHORT_1_5_5_5_REV, image_8bpp);
+            std3D_pTexDone = pJob;
+        std3D_pTexDoneTail = pJob;
+    }
+    SDL_UnlockMutex(std3D_pTexMutex);
+
+    return 0;
+}
+
+static int std3D_StartTextureThread()
+{
+    if (std3D_bTexThreadStarted)
+        return std3D_pTexThread != NULL;
+
+    std3D_bTexThreadStarted = 1;
+
+    std3D_pTexMutex = SDL_CreateMutex();
+    std3D_pTexCond = SDL_CreateCond();
+    if (!std3D_pTexMutex || !std3D_pTexCond)
+        return 0;
+
+    std3D_bTexThreadQuit = 0;
+    std3D_pTexThread = SDL_CreateThread(std3D_TextureThread, "std3D", NULL);
+    return std3D_pTexThread != NULL;
+}
+
+static void std3D_StopTextureThread()
+{
+    if (std3D_pTexThread)
+    {
+        SDL_LockMutex(std3D_pTexMutex);
+        std3D_bTexThreadQuit = 1;
+        SDL_CondSignal(std3D_pTexCond);
+        SDL_UnlockMutex(std3D_pTexMutex);
+        SDL_WaitThread(std3D_pTexThread, NULL);
+    }
+
+    std3D_FreeTextureJobs(std3D_pTexPending);
+    std3D_FreeTextureJobs(std3D_pTexDone);
+    std3D_pTexPending = NULL;
+    std3D_pTexPendingTail = NULL;
+    std3D_pTexDone = NULL;
+    std3D_pTexDoneTail = NULL;
+
+    if (std3D_pTexCond)
+        SDL_DestroyCond(std3D_pTexCond);
+    if (std3D_pTexMutex)
+        SDL_DestroyMutex(std3D_pTexMutex);
+    std3D_pTexCond = NULL;
+    std3D_pTexMutex = NULL;
+    std3D_pTexThread = NULL;
+    std3D_bTexThreadStarted = 0;
+}
+#endif // STD3D_ASYNC_TEXTURES
+
+static int std3D_AllocTexture()
+{
+    int idx;
+
+    if (std3D_texturesFree >= 0)
+    {
+        idx = std3D_texturesFree;
+        std3D_texturesFree = std3D_aTextures[idx].nextFree;
     }
     else
     {
-        texture->is_16bit = 0;
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, width, height, 0, GL_RED, GL_UNSIGNED_BYTE, image_8bpp);
+        if (std3D_texturesAmt >= std3D_texturesMax)
+        {
+            size_t newMax = std3D_texturesMax ? std3D_texturesMax * 2 : 1024;
+            std3DTexture* pNew = (std3DTexture*)realloc(std3D_aTextures, sizeof(std3DTexture) * newMax);
+            if (!pNew)
+                return -1;
+            std3D_aTextures = pNew;
+            std3D_texturesMax = newMax;
+        }
+        idx = std3D_texturesAmt++;
     }
 
-#if 0    
-    void* image_data = malloc(width*height*4);
-    
-    for (int j = 0; j < height; j++)
+    memset(&std3D_aTextures[idx], 0, sizeof(std3DTexture));
+    std3D_aTextures[idx].page = -1;
+    std3D_aTextures[idx].nextFree = -1;
+    return idx;
+}
+
+// Deletes the GL texture and hands the surface back to rdMaterial, but only if
+// the surface hasn't been reset (and possibly re-added) since.
+static void std3D_FreeTexture(int idx)
+{
+    std3DTexture* pEntry = &std3D_aTextures[idx];
+    rdDDrawSurface* surface = pEntry->surface;
+
+    if (surface && surface->gpu_accel_maybe == (uint32_t)idx + 1)
     {
-        for (int i = 0; i < width; i++)
+        surface->texture_loaded = 0;
+        surface->texture_id = 0;
+        surface->gpu_accel_maybe = 0;
+    }
+
+    if (pEntry->page >= 0)
+    {
+        std3D_FreeTextureLayer(pEntry->page, pEntry->layer);
+    }
+    else
+    {
+        if (pEntry->texture)
         {
-            uint32_t index = (i*height) + j;
-            uint32_t val_rgba = 0xFF000000;
-            
-            if (pal)
+            glDeleteTextures(1, &pEntry->texture);
+            std3D_curTexture = (GLuint)-1;
+        }
+        std3D_textureBytes -= pEntry->bytes;
+    }
+
+    memset(pEntry, 0, sizeof(std3DTexture));
+    pEntry->nextFree = std3D_texturesFree;
+    std3D_texturesFree = idx;
+}
+
+static void std3D_FreeAllTextures()
+{
+    for (size_t i = 0; i < std3D_texturesAmt; i++)
+    {
+        if (std3D_aTextures[i].surface)
+            std3D_FreeTexture(i);
+    }
+
+    // Any chain still being built is dropped when it comes back, its job id no longer matches
+    std3D_texturesAmt = 0;
+    std3D_texturesFree = -1;
+    std3D_textureBytes = 0;
+    std3D_texturePagesAmt = 0;
+}
+
+static void std3D_UpdateTextureCache()
+{
+    size_t budget;
+
+    std3D_textureFrame++;
+
+#ifdef STD3D_ASYNC_TEXTURES
+    if (std3D_pTexThread)
+    {
+        size_t uploaded = 0;
+
+        while (uploaded < STD3D_TEX_UPLOAD_BUDGET)
+        {
+            std3DTextureJob* pJob;
+            std3DTexture* pEntry;
+
+            SDL_LockMutex(std3D_pTexMutex);
+            pJob = std3D_pTexDone;
+            if (pJob)
             {
-                uint8_t val = image_8bpp[index];
-                val_rgba |= (pal[(val * 3) + 2] << 16);
-                val_rgba |= (pal[(val * 3) + 1] << 8);
-                val_rgba |= (pal[(val * 3) + 0] << 0);
+                std3D_pTexDone = pJob->pNext;
+                if (!std3D_pTexDone)
+                    std3D_pTexDoneTail = NULL;
             }
-            else
+            SDL_UnlockMutex(std3D_pTexMutex);
+
+            if (!pJob)
+                break;
+
+            pEntry = (pJob->idx < std3D_texturesAmt) ? &std3D_aTextures[pJob->idx] : NULL;
+            if (pEntry && pEntry->surface && pEntry->jobId == pJob->jobId)
             {
-                uint8_t val = image_8bpp[index];
-                rdColor24* pal_master = (rdColor24*)sithWorld_pCurrentWorld->colormaps->colors;//stdDisplay_gammaPalette;
-                rdColor24* color = &pal_master[val];
-                val_rgba |= (color->r << 16);
-                val_rgba |= (color->g << 8);
-                val_rgba |= (color->b << 0);
+                int layer;
+                int page = std3D_AllocTextureLayer(pJob->format, pJob->width, pJob->height, pJob->numLevels, pJob->levelsSize, &layer);
+
+                // Out of memory just keeps the placeholder
+                pEntry->jobId = 0;
+                if (page >= 0)
+                {
+                    GLuint tex = std3D_aTexturePages[page].texture;
+                    std3D_UploadLayer(tex, pJob->format, pJob->width, pJob->height, pJob->numLevels, layer, pJob->pPixels);
+
+                    glDeleteTextures(1, &pEntry->texture);
+                    std3D_textureBytes -= pEntry->bytes;
+
+                    pEntry->texture = tex;
+                    pEntry->page = page;
+                    pEntry->layer = layer;
+                    pEntry->bytes = pJob->levelsSize;
+                    pEntry->numLevels = pJob->numLevels;
+                    pEntry->surface->texture_id = tex;
+                }
+
+                uploaded += pJob->levelsSize;
             }
-            
-            *(uint32_t*)(image_data + index*4) = val_rgba;
+
+            free(pJob->pPixels);
+            free(pJob);
         }
-        
-        
     }
-    
-    glBindTexture(GL_TEXTURE_2D, image_texture);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, image_data);
 #endif
 
-    
-    
-    
-    std3D_aLoadedSurfaces[std3D_loadedTexturesAmt] = texture;
-    std3D_aLoadedTextures[std3D_loadedTexturesAmt++] = image_texture;
-    /*ext->surfacebuf = image_data;
-    ext->surfacetex = image_texture;
-    ext->surfacepaltex = pal_texture;*/
-    
-    texture->texture_id = image_texture;
+    budget = (size_t)jkPlayer_textureBudgetMb * 0x100000;
+    if (std3D_textureBytes <= budget)
+        return;
+
+    // Pages are only released once every layer in them is, so they're evicted
+    // as a whole, going by the most recently drawn layer.
+    for (size_t i = 0; i < std3D_texturePagesAmt; i++)
+        std3D_aTexturePages[i].lastFrame = 0;
+    for (size_t i = 0; i < std3D_texturesAmt; i++)
+    {
+        std3DTexture* pEntry = &std3D_aTextures[i];
+        if (!pEntry->surface || pEntry->page < 0)
+            continue;
+        if (pEntry->lastFrame > std3D_aTexturePages[pEntry->page].lastFrame)
+            std3D_aTexturePages[pEntry->page].lastFrame = pEntry->lastFrame;
+    }
+
+    // Anything drawn this frame or the last one stays, even when that's over budget
+    while (std3D_textureBytes > budget)
+    {
+        int oldest = -1;
+        int oldestPage = -1;
+        uint32_t oldestFrame = 0;
+
+        for (size_t i = 0; i < std3D_texturesAmt; i++)
+        {
+            std3DTexture* pEntry = &std3D_aTextures[i];
+            if (!pEntry->surface || pEntry->page >= 0 || pEntry->lastFrame + 1 >= std3D_textureFrame)
+                continue;
+            if (oldest < 0 || pEntry->lastFrame < oldestFrame)
+            {
+                oldest = i;
+                oldestFrame = pEntry->lastFrame;
+            }
+        }
+        for (size_t i = 0; i < std3D_texturePagesAmt; i++)
+        {
+            std3DTexturePage* pPage = &std3D_aTexturePages[i];
+            if (!pPage->texture || pPage->lastFrame + 1 >= std3D_textureFrame)
+                continue;
+            if ((oldest < 0 && oldestPage < 0) || pPage->lastFrame < oldestFrame)
+            {
+                oldest = -1;
+                oldestPage = i;
+                oldestFrame = pPage->lastFrame;
+            }
+        }
+
+        if (oldest >= 0)
+        {
+            std3D_FreeTexture(oldest);
+        }
+        else if (oldestPage >= 0)
+        {
+            for (size_t i = 0; i < std3D_texturesAmt; i++)
+            {
+                if (std3D_aTextures[i].surface && std3D_aTextures[i].page == oldestPage)
+                    std3D_FreeTexture(i);
+            }
+        }
+        else
+        {
+            break;
+        }
+    }
+}
+
+int std3D_AddToTextureCache(stdVBuffer *vbuf, rdDDrawSurface *texture, int is_alpha_tex, int no_alpha)
+{
+    std3DTextureJob* pJob;
+    std3DTexture* pEntry;
+    size_t size;
+    int idx;
+
+    // Stale entry from before the surface was reset
+    std3D_RemoveTextureFromList(texture);
+
+    pJob = (std3DTextureJob*)malloc(sizeof(std3DTextureJob));
+    if (!pJob)
+        return 0;
+    memset(pJob, 0, sizeof(std3DTextureJob));
+
+    pJob->width = vbuf->format.width;
+    pJob->height = vbuf->format.height;
+    if (vbuf->format.format.is16bit)
+    {
+        texture->is_16bit = 1;
+        pJob->format = is_alpha_tex ? STD3D_TEXFMT_RGBA5551 : STD3D_TEXFMT_RGB565;
+        pJob->bpp = 2;
+    }
+    else
+    {
+        texture->is_16bit = 0;
+        pJob->format = STD3D_TEXFMT_INDEXED;
+        pJob->bpp = 1;
+    }
+
+    size = pJob->width * pJob->height * pJob->bpp;
+    pJob->pPixels = (uint8_t*)malloc(size);
+    idx = pJob->pPixels ? std3D_AllocTexture() : -1;
+    if (idx < 0)
+    {
+        free(pJob->pPixels);
+        free(pJob);
+        return 0;
+    }
+    memcpy(pJob->pPixels, vbuf->sdlSurface->pixels, size);
+    pJob->idx = idx;
+    pJob->numLevels = 1;
+    pJob->levelsSize = size;
+
+    pEntry = &std3D_aTextures[idx];
+    pEntry->surface = texture;
+    pEntry->format = pJob->format;
+    pEntry->lastFrame = std3D_textureFrame;
+
+#ifdef STD3D_ASYNC_TEXTURES
+    if (std3D_StartTextureThread())
+    {
+        pEntry->texture = std3D_UploadPlaceholder(pJob, &pEntry->bytes);
+        pEntry->numLevels = 1;
+
+        if (!++std3D_textureJobId)
+            ++std3D_textureJobId;
+        pEntry->jobId = pJob->jobId = std3D_textureJobId;
+
+        SDL_LockMutex(std3D_pTexMutex);
+        if (std3D_pTexPendingTail)
+            std3D_pTexPendingTail->pNext = pJob;
+        else
+            std3D_pTexPending = pJob;
+        std3D_pTexPendingTail = pJob;
+        SDL_CondSignal(std3D_pTexCond);
+        SDL_UnlockMutex(std3D_pTexMutex);
+    }
+    else
+#endif
+    {
+        int page, layer;
+
+        std3D_BuildMipChain(pJob);
+        page = std3D_AllocTextureLayer(pJob->format, pJob->width, pJob->height, pJob->numLevels, pJob->levelsSize, &layer);
+        if (page >= 0)
+        {
+            pEntry->page = page;
+            pEntry->layer = layer;
+            pEntry->texture = std3D_aTexturePages[page].texture;
+            pEntry->bytes = pJob->levelsSize;
+            pEntry->numLevels = pJob->numLevels;
+            std3D_UploadLayer(pEntry->texture, pJob->format, pJob->width, pJob->height, pJob->numLevels, layer, pJob->pPixels);
+        }
+
+        free(pJob->pPixels);
+        free(pJob);
+
+        if (page < 0)
+        {
+            std3D_FreeTexture(idx);
+            return 0;
+        }
+    }
+    if (pEntry->page < 0)
+        std3D_textureBytes += pEntry->bytes;
+
+    texture->texture_id = pEntry->texture;
     texture->texture_loaded = 1;
-    
+    texture->gpu_accel_maybe = idx + 1;
+
     return 1;
 }
 
 void std3D_UpdateFrameCount(rdDDrawSurface *surface)
 {
+    uint32_t idx = surface->gpu_accel_maybe - 1;
+
+    if (idx < std3D_texturesAmt && std3D_aTextures[idx].surface == surface)
+        std3D_aTextures[idx].lastFrame = std3D_textureFrame;
+}
+
+void std3D_RemoveTextureFromList(rdDDrawSurface *surface)
+{
+    uint32_t idx = surface->gpu_accel_maybe - 1;
+
+    if (idx < std3D_texturesAmt && std3D_aTextures[idx].surface == surface)
+        std3D_FreeTexture(idx);
 }
 
 // Added helpers
@@ -1202,20 +2651,5 @@ int std3D_HasAlphaFlatStippled()
 
 void std3D_PurgeTextureCache()
 {
-    for (int i = 0; i < 1024; i++)
-    {
-        rdDDrawSurface* tex = std3D_aLoadedSurfaces[i];
-        if (!tex) continue;
-
-        if (std3D_aLoadedTextures[i])
-            glDeleteTextures(1, &std3D_aLoadedTextures[i]);
-
-        std3D_aLoadedTextures[i] = 0;
-
-        tex->texture_loaded = 0;
-        tex->texture_id = 0;
-
-        std3D_aLoadedSurfaces[i] = NULL;
-    }
-    std3D_loadedTexturesAmt = 0;
+    std3D_FreeAllTextures();
 }
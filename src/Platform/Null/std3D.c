@@ -0,0 +1,310 @@
+#include "Platform/std3D.h"
+
+#include "Engine/rdCache.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+// Headless backend: keeps the std3D render list bookkeeping so rdCache runs
+// exactly like it does on GL, but never touches a GPU. Draws are only counted.
+
+int std3D_frameTris = 0;
+int std3D_lastFrameTris = 0;
+int std3D_frameBatches = 0;
+int std3D_lastFrameBatches = 0;
+
+static D3DVERTEX* world_vertices = NULL;
+static size_t world_verticesAmt = 0;
+static size_t world_verticesMax = 0;
+static rdTri* world_tris = NULL;
+static size_t world_trisAmt = 0;
+static size_t world_trisMax = 0;
+static size_t world_linesAmt = 0;
+
+static std3DStaticVertex* world_static_data = NULL;
+static size_t world_staticVerticesAmt = 0;
+static std3DStaticVertex* world_instance_data = NULL;
+
+static uint32_t std3D_nextTextureId = 1;
+
+int std3D_Startup()
+{
+    return 1;
+}
+
+void std3D_Shutdown()
+{
+    std3D_FreeResources();
+}
+
+void std3D_FreeResources()
+{
+    if (world_vertices)
+        free(world_vertices);
+    if (world_tris)
+        free(world_tris);
+
+    world_vertices = NULL;
+    world_verticesAmt = 0;
+    world_verticesMax = 0;
+    world_tris = NULL;
+    world_trisAmt = 0;
+    world_trisMax = 0;
+    world_linesAmt = 0;
+
+    std3D_FreeStaticGeometry();
+    std3D_FreeInstanceGeometry();
+}
+
+int std3D_StartScene()
+{
+    std3D_frameTris = 0;
+    std3D_frameBatches = 0;
+    return 1;
+}
+
+int std3D_EndScene()
+{
+    std3D_ResetRenderList();
+    std3D_lastFrameTris = std3D_frameTris;
+    std3D_lastFrameBatches = std3D_frameBatches;
+    return 1;
+}
+
+void std3D_ResetRenderList()
+{
+    world_verticesAmt = 0;
+    world_trisAmt = 0;
+    world_linesAmt = 0;
+}
+
+int std3D_RenderListVerticesFinish()
+{
+    return 1;
+}
+
+void std3D_DrawMenu()
+{
+}
+
+static void std3D_CountWorldTris(rdTri* tris, size_t trisAmt)
+{
+    uint64_t last_key = 0;
+
+    // Same batching as the GL backend, a new draw starts whenever the sort key changes
+    for (size_t j = 0; j < trisAmt; j++)
+    {
+        if (j && tris[j].sortKey == last_key)
+            continue;
+
+        std3D_frameBatches++;
+        last_key = tris[j].sortKey;
+    }
+    std3D_frameTris += trisAmt;
+}
+
+void std3D_DrawRenderList()
+{
+    if (world_trisAmt)
+        std3D_CountWorldTris(world_tris, world_trisAmt);
+
+    std3D_ResetRenderList();
+}
+
+int std3D_UploadStaticGeometry(const rdVector3* pVertices, size_t numVertices)
+{
+    std3DStaticVertex* pNew;
+
+    std3D_FreeStaticGeometry();
+    if (!numVertices)
+        return 0;
+
+    pNew = (std3DStaticVertex*)malloc(sizeof(std3DStaticVertex) * numVertices);
+    if (!pNew)
+        return 0;
+
+    world_static_data = pNew;
+    world_staticVerticesAmt = numVertices;
+    return 1;
+}
+
+void std3D_FreeStaticGeometry()
+{
+    if (world_static_data)
+        free(world_static_data);
+
+    world_static_data = NULL;
+    world_staticVerticesAmt = 0;
+}
+
+int std3D_HasStaticGeometry()
+{
+    return world_static_data != NULL;
+}
+
+std3DStaticVertex* std3D_BeginStaticRenderList()
+{
+    return world_static_data;
+}
+
+void std3D_DrawStaticRenderList(rdTri* tris, size_t numTris, const std3DVertexRange* pRanges, size_t numRanges, const float* pScreenProj)
+{
+    if (numTris)
+        std3D_CountWorldTris(tris, numTris);
+}
+
+int std3D_UploadInstanceGeometry(const rdVector3* pVertices, size_t numVertices)
+{
+    std3DStaticVertex* pNew;
+
+    std3D_FreeInstanceGeometry();
+    if (!numVertices)
+        return 0;
+
+    pNew = (std3DStaticVertex*)malloc(sizeof(std3DStaticVertex) * numVertices);
+    if (!pNew)
+        return 0;
+
+    world_instance_data = pNew;
+    return 1;
+}
+
+void std3D_FreeInstanceGeometry()
+{
+    if (world_instance_data)
+        free(world_instance_data);
+
+    world_instance_data = NULL;
+}
+
+int std3D_HasInstanceGeometry()
+{
+    return world_instance_data != NULL;
+}
+
+std3DStaticVertex* std3D_BeginInstanceRenderList()
+{
+    return world_instance_data;
+}
+
+void std3D_DrawInstancedRenderList(std3DInstanceBatch* pBatches, size_t numBatches, const float* pScreenProj)
+{
+    for (size_t i = 0; i < numBatches; i++)
+    {
+        if (!pBatches[i].numTris || !pBatches[i].numInstances)
+            continue;
+
+        std3D_CountWorldTris(pBatches[i].tris, pBatches[i].numTris);
+        std3D_frameTris += pBatches[i].numTris * (pBatches[i].numInstances - 1);
+    }
+}
+
+int std3D_SetCurrentPalette(rdColor24 *a1, int a2)
+{
+    return 1;
+}
+
+void std3D_GetValidDimension(unsigned int inW, unsigned int inH, unsigned int *outW, unsigned int *outH)
+{
+    // Match the GL backend so UVs come out the same
+    *outW = inW > 256 ? 256 : inW;
+    *outH = inH > 256 ? 256 : inH;
+}
+
+int std3D_DrawOverlay()
+{
+    return 1;
+}
+
+void std3D_UnloadAllTextures()
+{
+}
+
+void std3D_AddRenderListTris(rdTri *tris, unsigned int num_tris)
+{
+    if (world_trisAmt + num_tris > world_trisMax)
+    {
+        size_t newMax = world_trisMax ? world_trisMax : STD3D_MAX_TRIS;
+        while (newMax < world_trisAmt + num_tris)
+            newMax *= 2;
+
+        rdTri* pNew = realloc(world_tris, sizeof(rdTri) * newMax);
+        if (!pNew)
+            return;
+        world_tris = pNew;
+        world_trisMax = newMax;
+    }
+
+    memcpy(&world_tris[world_trisAmt], tris, sizeof(rdTri) * num_tris);
+    world_trisAmt += num_tris;
+}
+
+void std3D_AddRenderListLines(rdLine* lines, uint32_t num_lines)
+{
+    world_linesAmt += num_lines;
+}
+
+int std3D_AddRenderListVertices(D3DVERTEX *vertices, int count)
+{
+    if (world_verticesAmt + count > world_verticesMax)
+    {
+        size_t newMax = world_verticesMax ? world_verticesMax : STD3D_MAX_VERTICES;
+        while (newMax < world_verticesAmt + count)
+            newMax *= 2;
+
+        D3DVERTEX* pNew = realloc(world_vertices, sizeof(D3DVERTEX) * newMax);
+        if (!pNew)
+            return 0;
+        world_vertices = pNew;
+        world_verticesMax = newMax;
+    }
+
+    // Keep the copy so the CPU cost matches a real upload
+    memcpy(&world_vertices[world_verticesAmt], vertices, sizeof(D3DVERTEX) * count);
+    world_verticesAmt += count;
+
+    return 1;
+}
+
+int std3D_ClearZBuffer()
+{
+    return 1;
+}
+
+int std3D_AddToTextureCache(stdVBuffer *vbuf, rdDDrawSurface *texture, int is_alpha_tex, int no_alpha)
+{
+    texture->texture_id = std3D_nextTextureId++;
+    texture->texture_loaded = 1;
+    texture->is_16bit = vbuf->format.format.is16bit;
+
+    return 1;
+}
+
+void std3D_UpdateFrameCount(rdDDrawSurface *surface)
+{
+}
+
+void std3D_RemoveTextureFromList(rdDDrawSurface *surface)
+{
+    surface->texture_loaded = 0;
+    surface->texture_id = 0;
+}
+
+int std3D_HasAlpha()
+{
+    return 1;
+}
+
+int std3D_HasModulateAlpha()
+{
+    return 1;
+}
+
+int std3D_HasAlphaFlatStippled()
+{
+    return 1;
+}
+
+void std3D_PurgeTextureCache()
+{
+}
@@ -50,6 +50,38 @@ int std3D_HasModulateAlpha();
 int std3D_HasAlphaFlatStippled();
 
 #ifdef SDL2_RENDER
+// Per-frame attributes of a resident level vertex
+typedef struct std3DStaticVertex
+{
+    uint32_t color;
+    float tu;
+    float tv;
+    float layer; // filled in by std3D
+} std3DStaticVertex;
+
+// A run of resident vertices whose attributes were written this frame
+typedef struct std3DVertexRange
+{
+    uint32_t first;
+    uint32_t count;
+} std3DVertexRange;
+
+// Per-instance values for a resident model mesh
+typedef struct std3DInstance
+{
+    float aRows[3][4]; // model to world space
+    float tint[3];     // sector colormap tint
+    float ambient;     // floor for the vertex light
+} std3DInstance;
+
+typedef struct std3DInstanceBatch
+{
+    rdTri* tris;
+    size_t numTris;
+    const std3DInstance* pInstances;
+    size_t numInstances;
+} std3DInstanceBatch;
+
 int std3D_Startup();
 void std3D_Shutdown();
 int std3D_StartScene();
@@ -65,12 +97,31 @@ void std3D_AddRenderListTris(rdTri *tris, unsigned int num_tris);
 void std3D_AddRenderListLines(rdLine* lines, uint32_t num_lines);
 int std3D_AddRenderListVertices(D3DVERTEX *vertex_array, int count);
 void std3D_UpdateFrameCount(rdDDrawSurface *surface);
+void std3D_RemoveTextureFromList(rdDDrawSurface *surface);
 void std3D_PurgeTextureCache();
 void std3D_Shutdown();
 int std3D_ClearZBuffer();
 int std3D_AddToTextureCache(stdVBuffer *vbuf, rdDDrawSurface *texture, int is_alpha_tex, int no_alpha);
 void std3D_DrawMenu();
 void std3D_FreeResources();
+
+// Triangles and draw calls submitted this frame, and in the last finished one
+extern int std3D_frameTris;
+extern int std3D_lastFrameTris;
+extern int std3D_frameBatches;
+extern int std3D_lastFrameBatches;
+
+int std3D_UploadStaticGeometry(const rdVector3* pVertices, size_t numVertices);
+void std3D_FreeStaticGeometry();
+int std3D_HasStaticGeometry();
+std3DStaticVertex* std3D_BeginStaticRenderList();
+void std3D_DrawStaticRenderList(rdTri* tris, size_t numTris, const std3DVertexRange* pRanges, size_t numRanges, const float* pScreenProj);
+
+int std3D_UploadInstanceGeometry(const rdVector3* pVertices, size_t numVertices);
+void std3D_FreeInstanceGeometry();
+int std3D_HasInstanceGeometry();
+std3DStaticVertex* std3D_BeginInstanceRenderList();
+void std3D_DrawInstancedRenderList(std3DInstanceBatch* pBatches, size_t numBatches, const float* pScreenProj);
 #else
 static int (*std3D_Startup)() = (void*)std3D_Startup_ADDR;
 static void (*std3D_Shutdown)() = (void*)std3D_Shutdown_ADDR;
@@ -3,6 +3,7 @@
 #include "jk.h"
 #include <math.h>
 #include "General/stdMath.h"
+#include "Primitives/rdSimd.h"
 
 const rdMatrix34 rdroid_identMatrix34 = {{1.0, 0.0, 0.0}, 
                                          {0.0, 1.0, 0.0}, 
@@ -913,14 +914,77 @@ void rdMatrix_TransformPoint44Acc(rdVector4 *a1, const rdMatrix44 *a2)
     rdMatrix_TransformPoint44(a1, &tmp, a2);
 }
 
+#ifdef RDSIMD_ENABLED
+// Transforms 4 packed vertices, `in` and `out` may alias
+static inline void rdMatrix_TransformPoint34x4(rdVector3 *out, const rdVector3 *in, const rdSimdF4 *pCols)
+{
+    rdSimdF4 x, y, z;
+    rdSimdF4 ox, oy, oz;
+
+    rdSimd_Load3x4(in, &x, &y, &z);
+    ox = rdSimd_Add(rdSimd_Add(rdSimd_Mul(pCols[0], x), rdSimd_Mul(pCols[3], y)), rdSimd_Add(rdSimd_Mul(pCols[6], z), pCols[9]));
+    oy = rdSimd_Add(rdSimd_Add(rdSimd_Mul(pCols[1], x), rdSimd_Mul(pCols[4], y)), rdSimd_Add(rdSimd_Mul(pCols[7], z), pCols[10]));
+    oz = rdSimd_Add(rdSimd_Add(rdSimd_Mul(pCols[2], x), rdSimd_Mul(pCols[5], y)), rdSimd_Add(rdSimd_Mul(pCols[8], z), pCols[11]));
+    rdSimd_Store3x4(out, ox, oy, oz);
+}
+
+static inline void rdMatrix_Splat34(rdSimdF4 *pCols, const rdMatrix34 *m)
+{
+    const float* pM = &m->rvec.x;
+    for (int i = 0; i < 12; i++)
+        pCols[i] = rdSimd_Set1(pM[i]);
+}
+#endif
+
 void rdMatrix_TransformPointLst34(const rdMatrix34 *m, const rdVector3 *in, rdVector3 *out, int num)
 {
-    for (int i = 0; i < num; i++)
+    int i = 0;
+
+#ifdef RDSIMD_ENABLED
+    if (num >= 4)
+    {
+        rdSimdF4 aCols[12];
+        rdMatrix_Splat34(aCols, m);
+        for (; i + 4 <= num; i += 4)
+            rdMatrix_TransformPoint34x4(&out[i], &in[i], aCols);
+    }
+#endif
+
+    for (; i < num; i++)
     {
         rdMatrix_TransformPoint34(&out[i], &in[i], m);
     }
 }
 
+// Added: out[idx[i]] = m * in[idx[i]], for scattered vertex lists like the level's
+void rdMatrix_TransformPointIdxLst34(const rdMatrix34 *m, const rdVector3 *in, rdVector3 *out, const int *idx, int num)
+{
+    int i = 0;
+
+#ifdef RDSIMD_ENABLED
+    if (num >= 4)
+    {
+        rdSimdF4 aCols[12];
+        rdVector3 aTmp[4];
+
+        rdMatrix_Splat34(aCols, m);
+        for (; i + 4 <= num; i += 4)
+        {
+            for (int j = 0; j < 4; j++)
+                aTmp[j] = in[idx[i+j]];
+            rdMatrix_TransformPoint34x4(aTmp, aTmp, aCols);
+            for (int j = 0; j < 4; j++)
+                out[idx[i+j]] = aTmp[j];
+        }
+    }
+#endif
+
+    for (; i < num; i++)
+    {
+        rdMatrix_TransformPoint34(&out[idx[i]], &in[idx[i]], m);
+    }
+}
+
 void rdMatrix_TransformPointLst44(const rdMatrix44 *m, const rdVector4 *in, rdVector4 *out, int num)
 {
     for (int i = 0; i < num; i++)
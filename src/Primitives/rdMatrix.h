@@ -118,6 +118,7 @@ void rdMatrix_TransformPoint44(rdVector4 *a1, const rdVector4 *a2, const rdMatri
 void rdMatrix_TransformPoint44Acc(rdVector4 *a1, const rdMatrix44 *a2);
 void rdMatrix_TransformPointLst34(const rdMatrix34 *m, const rdVector3 *in, rdVector3 *out, int num);
 void rdMatrix_TransformPointLst44(const rdMatrix44 *m, const rdVector4 *in, rdVector4 *out, int num);
+void rdMatrix_TransformPointIdxLst34(const rdMatrix34 *m, const rdVector3 *in, rdVector3 *out, const int *idx, int num);
 
 // Added
 void rdMatrix_Print34(const rdMatrix34 *viewMat);
@@ -0,0 +1,248 @@
+#include "rdMeshBvh.h"
+
+#include "Primitives/rdModel3.h"
+#include "Engine/rdroid.h"
+#include "jk.h"
+
+#ifdef QOL_IMPROVEMENTS
+
+typedef struct rdMeshBvhBuild
+{
+    rdMeshBvh* pBvh;
+    rdVector3* aMins;
+    rdVector3* aMaxs;
+    rdVector3* aCenters;
+} rdMeshBvhBuild;
+
+static void rdMeshBvh_AddBounds(rdVector3* pMins, rdVector3* pMaxs, const rdVector3* pOtherMins, const rdVector3* pOtherMaxs)
+{
+    for (int i = 0; i < 3; i++)
+    {
+        if ((&pOtherMins->x)[i] < (&pMins->x)[i])
+            (&pMins->x)[i] = (&pOtherMins->x)[i];
+        if ((&pOtherMaxs->x)[i] > (&pMaxs->x)[i])
+            (&pMaxs->x)[i] = (&pOtherMaxs->x)[i];
+    }
+}
+
+static void rdMeshBvh_BuildNode(rdMeshBvhBuild* pBuild, int first, int count)
+{
+    rdMeshBvh* pBvh = pBuild->pBvh;
+    rdMeshBvhNode* pNode = &pBvh->aNodes[pBvh->numNodes++];
+    rdVector3 centerMins, centerMaxs, extent;
+    int axis, half;
+
+    pNode->mins = pBuild->aMins[pBvh->aFaces[first]];
+    pNode->maxs = pBuild->aMaxs[pBvh->aFaces[first]];
+    centerMins = pBuild->aCenters[pBvh->aFaces[first]];
+    centerMaxs = centerMins;
+    for (int i = first + 1; i < first + count; i++)
+    {
+        int faceIdx = pBvh->aFaces[i];
+
+        rdMeshBvh_AddBounds(&pNode->mins, &pNode->maxs, &pBuild->aMins[faceIdx], &pBuild->aMaxs[faceIdx]);
+        rdMeshBvh_AddBounds(&centerMins, &centerMaxs, &pBuild->aCenters[faceIdx], &pBuild->aCenters[faceIdx]);
+    }
+
+    if (count <= RDMESHBVH_LEAF_FACES)
+    {
+        pNode->first = first;
+        pNode->count = count;
+        return;
+    }
+
+    // Halve on the longest axis of the face centers, faces are few enough
+    // that an insertion sort does
+    rdVector_Sub3(&extent, &centerMaxs, &centerMins);
+    axis = 0;
+    if (extent.y > extent.x)
+        axis = 1;
+    if (extent.z > (&extent.x)[axis])
+        axis = 2;
+
+    for (int i = first + 1; i < first + count; i++)
+    {
+        uint16_t faceIdx = pBvh->aFaces[i];
+        float key = (&pBuild->aCenters[faceIdx].x)[axis];
+        int j = i;
+
+        while (j > first && (&pBuild->aCenters[pBvh->aFaces[j - 1]].x)[axis] > key)
+        {
+            pBvh->aFaces[j] = pBvh->aFaces[j - 1];
+            j--;
+        }
+        pBvh->aFaces[j] = faceIdx;
+    }
+
+    half = count / 2;
+    pNode->count = 0;
+    rdMeshBvh_BuildNode(pBuild, first, half);
+    pNode->first = pBvh->numNodes;
+    rdMeshBvh_BuildNode(pBuild, first + half, count - half);
+}
+
+int rdMeshBvh_Build(rdMesh *mesh)
+{
+    rdMeshBvhBuild build;
+    rdMeshBvh* pBvh;
+
+    rdMeshBvh_Free(mesh);
+    if (mesh->numFaces < RDMESHBVH_MIN_FACES || mesh->numFaces > RDMESHBVH_MAX_FACES)
+        return 0;
+
+    for (int i = 0; i < mesh->numFaces; i++)
+    {
+        if (!mesh->faces[i].numVertices)
+            return 0;
+    }
+
+    pBvh = (rdMeshBvh*)rdroid_pHS->alloc(sizeof(rdMeshBvh));
+    if (!pBvh)
+        return 0;
+
+    // Median splits down to RDMESHBVH_LEAF_FACES make fewer than 2 nodes a face
+    pBvh->numNodes = 0;
+    pBvh->aNodes = (rdMeshBvhNode*)rdroid_pHS->alloc(sizeof(rdMeshBvhNode) * mesh->numFaces * 2);
+    pBvh->aFaces = (uint16_t*)rdroid_pHS->alloc(sizeof(uint16_t) * mesh->numFaces);
+    build.pBvh = pBvh;
+    build.aMins = (rdVector3*)rdroid_pHS->alloc(sizeof(rdVector3) * mesh->numFaces * 3);
+    if (!pBvh->aNodes || !pBvh->aFaces || !build.aMins)
+    {
+        if (build.aMins)
+            rdroid_pHS->free(build.aMins);
+        mesh->pFaceBvh = pBvh;
+        rdMeshBvh_Free(mesh);
+        return 0;
+    }
+    build.aMaxs = &build.aMins[mesh->numFaces];
+    build.aCenters = &build.aMins[mesh->numFaces * 2];
+
+    for (int i = 0; i < mesh->numFaces; i++)
+    {
+        rdFace* face = &mesh->faces[i];
+
+        build.aMins[i] = mesh->vertices[face->vertexPosIdx[0]];
+        build.aMaxs[i] = build.aMins[i];
+        for (int j = 1; j < face->numVertices; j++)
+        {
+            rdVector3* pVert = &mesh->vertices[face->vertexPosIdx[j]];
+            rdMeshBvh_AddBounds(&build.aMins[i], &build.aMaxs[i], pVert, pVert);
+        }
+        rdVector_Add3(&build.aCenters[i], &build.aMins[i], &build.aMaxs[i]);
+        rdVector_Scale3Acc(&build.aCenters[i], 0.5);
+        pBvh->aFaces[i] = i;
+    }
+
+    rdMeshBvh_BuildNode(&build, 0, mesh->numFaces);
+    rdroid_pHS->free(build.aMins);
+
+    mesh->pFaceBvh = pBvh;
+    return 1;
+}
+
+void rdMeshBvh_Free(rdMesh *mesh)
+{
+    rdMeshBvh* pBvh = mesh->pFaceBvh;
+
+    if (!pBvh)
+        return;
+
+    if (pBvh->aNodes)
+        rdroid_pHS->free(pBvh->aNodes);
+    if (pBvh->aFaces)
+        rdroid_pHS->free(pBvh->aFaces);
+    rdroid_pHS->free(pBvh);
+    mesh->pFaceBvh = NULL;
+}
+
+// Whether pos + dir * t, 0 <= t <= dist, comes within radius of the node
+static int rdMeshBvh_SweepHitsNode(const rdMeshBvhNode* pNode, const rdVector3 *pos, const rdVector3 *dir, float dist, float radius)
+{
+    float tMin = 0.0;
+    float tMax = dist > 0.0 ? dist : 0.0;
+
+    for (int i = 0; i < 3; i++)
+    {
+        float lo = (&pNode->mins.x)[i] - radius;
+        float hi = (&pNode->maxs.x)[i] + radius;
+        float p = (&pos->x)[i];
+        float d = (&dir->x)[i];
+        float t0, t1;
+
+        if (d == 0.0)
+        {
+            if (p < lo || p > hi)
+                return 0;
+            continue;
+        }
+
+        t0 = (lo - p) / d;
+        t1 = (hi - p) / d;
+        if (t0 > t1)
+        {
+            float tmp = t0;
+            t0 = t1;
+            t1 = tmp;
+        }
+        if (t0 > tMin)
+            tMin = t0;
+        if (t1 < tMax)
+            tMax = t1;
+        if (!(tMin <= tMax))
+            return 0;
+    }
+    return 1;
+}
+
+// Fills aFacesOut with the index of every face whose bounds come within
+// radius of the sweep, in mesh order, and returns how many there are
+int rdMeshBvh_FindFaces(const rdMeshBvh *pBvh, const rdVector3 *pos, const rdVector3 *dir, float dist, float radius, int *aFacesOut)
+{
+    uint32_t aFaceBits[RDMESHBVH_MAX_FACES / 32];
+    int aStack[64];
+    int stackSize = 0;
+    int numOut = 0;
+    int maxFace = -1;
+
+    _memset(aFaceBits, 0, sizeof(aFaceBits));
+
+    aStack[stackSize++] = 0;
+    while (stackSize)
+    {
+        const rdMeshBvhNode* pNode = &pBvh->aNodes[aStack[--stackSize]];
+
+        if (!rdMeshBvh_SweepHitsNode(pNode, pos, dir, dist, radius))
+            continue;
+
+        if (pNode->count)
+        {
+            for (int i = pNode->first; i < pNode->first + pNode->count; i++)
+            {
+                int faceIdx = pBvh->aFaces[i];
+
+                aFaceBits[faceIdx >> 5] |= 1u << (faceIdx & 31);
+                if (faceIdx > maxFace)
+                    maxFace = faceIdx;
+            }
+        }
+        else
+        {
+            aStack[stackSize++] = pNode->first;
+            aStack[stackSize++] = (pNode - pBvh->aNodes) + 1;
+        }
+    }
+
+    for (int i = 0; i <= maxFace >> 5; i++)
+    {
+        uint32_t bits = aFaceBits[i];
+
+        for (int j = i << 5; bits; j++, bits >>= 1)
+        {
+            if (bits & 1)
+                aFacesOut[numOut++] = j;
+        }
+    }
+    return numOut;
+}
+
+#endif // QOL_IMPROVEMENTS
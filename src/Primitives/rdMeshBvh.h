@@ -0,0 +1,36 @@
+#ifndef _RDMESHBVH_H
+#define _RDMESHBVH_H
+
+#include "types.h"
+#include "Primitives/rdVector.h"
+
+// Added: Bounding volume tree over the faces of one rdMesh, in mesh space.
+// Built once when the model loads, used by sithIntersect_sub_508400 to skip
+// faces a sweep can't reach on face-collided (collide 3) models.
+
+#define RDMESHBVH_MIN_FACES  (16) // smaller meshes are walked face by face
+#define RDMESHBVH_LEAF_FACES (4)
+#define RDMESHBVH_MAX_FACES  (0x200) // rdModel3_Load limit
+
+typedef struct rdMeshBvhNode
+{
+    rdVector3 mins;
+    rdVector3 maxs;
+    uint16_t first; // leaf: first index into aFaces, otherwise the second child
+    uint16_t count; // 0 for inner nodes, the first child follows its parent
+} rdMeshBvhNode;
+
+typedef struct rdMeshBvh
+{
+    int numNodes;
+    rdMeshBvhNode* aNodes;
+    uint16_t* aFaces;
+} rdMeshBvh;
+
+#ifdef QOL_IMPROVEMENTS
+int rdMeshBvh_Build(rdMesh *mesh);
+void rdMeshBvh_Free(rdMesh *mesh);
+int rdMeshBvh_FindFaces(const rdMeshBvh *pBvh, const rdVector3 *pos, const rdVector3 *dir, float dist, float radius, int *aFacesOut);
+#endif
+
+#endif // _RDMESHBVH_H
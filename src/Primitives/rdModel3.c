@@ -194,6 +194,9 @@ int rdModel3_Load(char *model_fpath, rdModel3 *model)
         {
             mesh = &model->geosets[v78].meshes[i];
             mesh->mesh_num = i;
+#ifdef QOL_IMPROVEMENTS
+            mesh->pFaceBvh = NULL; // Added
+#endif
             if ( !stdConffile_ReadLine() )
                 goto fail;
             if ( _sscanf(stdConffile_aLine, " mesh %d", std_genBuffer) != 1 )
@@ -405,6 +408,11 @@ int rdModel3_Load(char *model_fpath, rdModel3 *model)
                 mesh->faces[v55].normal.y = v_y;
                 mesh->faces[v55].normal.z = v_z;
             }
+
+#ifdef QOL_IMPROVEMENTS
+            // Added: only needed for collide 3 things, but cheap next to loading
+            rdMeshBvh_Build(mesh);
+#endif
         }
     }
     
@@ -748,6 +756,9 @@ void rdModel3_FreeEntry(rdModel3 *model)
                 rdroid_pHS->free(mesh->vertices_unk);
             if (mesh->vertexNormals)
                 rdroid_pHS->free(mesh->vertexNormals);
+#ifdef QOL_IMPROVEMENTS
+            rdMeshBvh_Free(mesh); // Added
+#endif
         }
         if ( geoset->meshes )
             rdroid_pHS->free(geoset->meshes);
@@ -800,6 +811,9 @@ void rdModel3_FreeEntryGeometryOnly(rdModel3 *model)
                 rdroid_pHS->free(mesh->vertices_unk);
             if (mesh->vertexNormals)
                 rdroid_pHS->free(mesh->vertexNormals);
+#ifdef QOL_IMPROVEMENTS
+            rdMeshBvh_Free(mesh); // Added
+#endif
         }
         if ( geoset->meshes )
             rdroid_pHS->free(geoset->meshes);
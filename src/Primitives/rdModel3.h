@@ -8,6 +8,7 @@
 #include "Primitives/rdFace.h"
 #include "Engine/rdMaterial.h"
 #include "Primitives/rdMatrix.h"
+#include "Primitives/rdMeshBvh.h"
 
 #define rdModel3_RegisterLoader_ADDR (0x00443DA0)
 #define rdModel3_RegisterUnloader_ADDR (0x00443DB0)
@@ -113,6 +114,9 @@ typedef struct rdMesh
     float field_64;
     int field_68;
     int field_6C;
+#ifdef QOL_IMPROVEMENTS
+    rdMeshBvh* pFaceBvh; // Added
+#endif
 } rdMesh;
 
 void rdModel3_RegisterLoader(model3Loader_t loader);
@@ -0,0 +1,136 @@
+#ifndef _RDSIMD_H
+#define _RDSIMD_H
+
+#include "types.h"
+
+// 4-wide helpers for batched vertex work. rdVector3 lists are stored as
+// xyzxyz..., so every batch of 4 is swizzled into separate x/y/z registers,
+// processed, and swizzled back. Without SSE2/NEON RDSIMD_ENABLED is left
+// undefined and callers keep their scalar loops.
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define RDSIMD_SSE2
+#define RDSIMD_ENABLED
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#include <math.h>
+#define RDSIMD_NEON
+#define RDSIMD_ENABLED
+#endif
+
+#if defined(RDSIMD_SSE2)
+typedef __m128 rdSimdF4;
+
+static inline rdSimdF4 rdSimd_Set1(float a) { return _mm_set1_ps(a); }
+static inline rdSimdF4 rdSimd_Add(rdSimdF4 a, rdSimdF4 b) { return _mm_add_ps(a, b); }
+static inline rdSimdF4 rdSimd_Sub(rdSimdF4 a, rdSimdF4 b) { return _mm_sub_ps(a, b); }
+static inline rdSimdF4 rdSimd_Mul(rdSimdF4 a, rdSimdF4 b) { return _mm_mul_ps(a, b); }
+static inline rdSimdF4 rdSimd_Div(rdSimdF4 a, rdSimdF4 b) { return _mm_div_ps(a, b); }
+static inline int rdSimd_LessMask(rdSimdF4 a, rdSimdF4 b) { return _mm_movemask_ps(_mm_cmplt_ps(a, b)); }
+static inline rdSimdF4 rdSimd_Sqrt(rdSimdF4 a) { return _mm_sqrt_ps(a); }
+static inline rdSimdF4 rdSimd_Load(const float* p) { return _mm_loadu_ps(p); }
+static inline void rdSimd_Store(float* p, rdSimdF4 a) { _mm_storeu_ps(p, a); }
+
+// Lane masks are all ones/all zeros per lane, kept in the float type
+static inline rdSimdF4 rdSimd_Less(rdSimdF4 a, rdSimdF4 b) { return _mm_cmplt_ps(a, b); }
+static inline rdSimdF4 rdSimd_LessEq(rdSimdF4 a, rdSimdF4 b) { return _mm_cmple_ps(a, b); }
+static inline rdSimdF4 rdSimd_And(rdSimdF4 a, rdSimdF4 b) { return _mm_and_ps(a, b); }
+static inline rdSimdF4 rdSimd_AndNot(rdSimdF4 a, rdSimdF4 b) { return _mm_andnot_ps(a, b); } // ~a & b
+static inline int rdSimd_Mask(rdSimdF4 m) { return _mm_movemask_ps(m); }
+
+// a0 = x0 y0 z0 x1, a1 = y1 z1 x2 y2, a2 = z2 x3 y3 z3
+static inline void rdSimd_Load3x4(const rdVector3* pIn, rdSimdF4* pX, rdSimdF4* pY, rdSimdF4* pZ)
+{
+    const float* p = (const float*)pIn;
+    __m128 a0 = _mm_loadu_ps(p + 0);
+    __m128 a1 = _mm_loadu_ps(p + 4);
+    __m128 a2 = _mm_loadu_ps(p + 8);
+    __m128 t0 = _mm_shuffle_ps(a1, a2, _MM_SHUFFLE(2,1,3,2)); // x2 y2 x3 y3
+    __m128 t1 = _mm_shuffle_ps(a0, a1, _MM_SHUFFLE(1,0,2,1)); // y0 z0 y1 z1
+
+    *pX = _mm_shuffle_ps(a0, t0, _MM_SHUFFLE(2,0,3,0));
+    *pY = _mm_shuffle_ps(t1, t0, _MM_SHUFFLE(3,1,2,0));
+    *pZ = _mm_shuffle_ps(t1, a2, _MM_SHUFFLE(3,0,3,1));
+}
+
+static inline void rdSimd_Store3x4(rdVector3* pOut, rdSimdF4 x, rdSimdF4 y, rdSimdF4 z)
+{
+    float* p = (float*)pOut;
+    __m128 t0 = _mm_shuffle_ps(x, y, _MM_SHUFFLE(2,0,2,0)); // x0 x2 y0 y2
+    __m128 t1 = _mm_shuffle_ps(y, z, _MM_SHUFFLE(3,1,3,1)); // y1 y3 z1 z3
+    __m128 t2 = _mm_shuffle_ps(z, x, _MM_SHUFFLE(3,1,2,0)); // z0 z2 x1 x3
+
+    _mm_storeu_ps(p + 0, _mm_shuffle_ps(t0, t2, _MM_SHUFFLE(2,0,2,0)));
+    _mm_storeu_ps(p + 4, _mm_shuffle_ps(t1, t0, _MM_SHUFFLE(3,1,2,0)));
+    _mm_storeu_ps(p + 8, _mm_shuffle_ps(t2, t1, _MM_SHUFFLE(3,1,3,1)));
+}
+#elif defined(RDSIMD_NEON)
+typedef float32x4_t rdSimdF4;
+
+static inline int rdSimd_U4Mask(uint32x4_t m)
+{
+    static const uint32_t aBits[4] = {1, 2, 4, 8};
+    uint32x4_t bits = vandq_u32(m, vld1q_u32(aBits));
+    uint32x2_t sum = vadd_u32(vget_low_u32(bits), vget_high_u32(bits));
+    return vget_lane_u32(vpadd_u32(sum, sum), 0);
+}
+
+static inline rdSimdF4 rdSimd_Set1(float a) { return vdupq_n_f32(a); }
+static inline rdSimdF4 rdSimd_Add(rdSimdF4 a, rdSimdF4 b) { return vaddq_f32(a, b); }
+static inline rdSimdF4 rdSimd_Sub(rdSimdF4 a, rdSimdF4 b) { return vsubq_f32(a, b); }
+static inline rdSimdF4 rdSimd_Mul(rdSimdF4 a, rdSimdF4 b) { return vmulq_f32(a, b); }
+static inline rdSimdF4 rdSimd_Div(rdSimdF4 a, rdSimdF4 b)
+{
+#ifdef __aarch64__
+    return vdivq_f32(a, b);
+#else
+    rdSimdF4 r = vrecpeq_f32(b);
+    r = vmulq_f32(vrecpsq_f32(b, r), r);
+    r = vmulq_f32(vrecpsq_f32(b, r), r);
+    return vmulq_f32(a, r);
+#endif
+}
+static inline int rdSimd_LessMask(rdSimdF4 a, rdSimdF4 b) { return rdSimd_U4Mask(vcltq_f32(a, b)); }
+static inline rdSimdF4 rdSimd_Load(const float* p) { return vld1q_f32(p); }
+static inline void rdSimd_Store(float* p, rdSimdF4 a) { vst1q_f32(p, a); }
+
+static inline rdSimdF4 rdSimd_Less(rdSimdF4 a, rdSimdF4 b) { return vreinterpretq_f32_u32(vcltq_f32(a, b)); }
+static inline rdSimdF4 rdSimd_LessEq(rdSimdF4 a, rdSimdF4 b) { return vreinterpretq_f32_u32(vcleq_f32(a, b)); }
+static inline rdSimdF4 rdSimd_And(rdSimdF4 a, rdSimdF4 b) { return vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(a), vreinterpretq_u32_f32(b))); }
+static inline rdSimdF4 rdSimd_AndNot(rdSimdF4 a, rdSimdF4 b) { return vreinterpretq_f32_u32(vbicq_u32(vreinterpretq_u32_f32(b), vreinterpretq_u32_f32(a))); }
+static inline int rdSimd_Mask(rdSimdF4 m) { return rdSimd_U4Mask(vreinterpretq_u32_f32(m)); }
+
+// Correctly rounded like sqrtf, so results match the scalar paths
+static inline rdSimdF4 rdSimd_Sqrt(rdSimdF4 a)
+{
+#ifdef __aarch64__
+    return vsqrtq_f32(a);
+#else
+    float tmp[4];
+    vst1q_f32(tmp, a);
+    for (int i = 0; i < 4; i++)
+        tmp[i] = sqrtf(tmp[i]);
+    return vld1q_f32(tmp);
+#endif
+}
+
+static inline void rdSimd_Load3x4(const rdVector3* pIn, rdSimdF4* pX, rdSimdF4* pY, rdSimdF4* pZ)
+{
+    float32x4x3_t v = vld3q_f32((const float*)pIn);
+    *pX = v.val[0];
+    *pY = v.val[1];
+    *pZ = v.val[2];
+}
+
+static inline void rdSimd_Store3x4(rdVector3* pOut, rdSimdF4 x, rdSimdF4 y, rdSimdF4 z)
+{
+    float32x4x3_t v;
+    v.val[0] = x;
+    v.val[1] = y;
+    v.val[2] = z;
+    vst3q_f32((float*)pOut, v);
+}
+#endif
+
+#endif // _RDSIMD_H
@@ -16,3 +16,968 @@ void rdRaster_Startup()
         rdRaster_aOtherLUT[j] = rdRaster_aOneDivXLUT[j] * rdRaster_fixedScale;
     }
 }
+
+#ifdef SDL2_RENDER
+
+#include "Engine/rdroid.h"
+#include "Engine/rdCamera.h"
+#include "Engine/rdColormap.h"
+#include "General/stdMath.h"
+#include "Win95/stdDisplay.h"
+#include "stdPlatform.h"
+
+#include <float.h>
+#include <math.h>
+#include <string.h>
+#include <SDL.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define RDRASTER_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define RDRASTER_NEON
+#endif
+
+#define RDRASTER_ZTEST (1)
+#define RDRASTER_ZWRITE (2)
+
+#define RDRASTER_PLANE_Z (0)
+#define RDRASTER_PLANE_U (1)
+#define RDRASTER_PLANE_V (2)
+#define RDRASTER_PLANE_L (3)
+#define RDRASTER_NUM_PLANES (4)
+
+// Below this many triangles a flush isn't worth waking the workers for
+#define RDRASTER_MIN_THREADED_TRIS (64)
+
+typedef struct rdRasterFace
+{
+    int geometryMode;
+    uint32_t zFlags;
+    int bPerspective;
+    int bLit;
+    int bTransparentTexels;
+    uint8_t color;
+    const uint8_t* pTexels;
+    int texPitch;
+    int texWidth;
+    int texHeight;
+    int texMaskU;
+    int texMaskV;
+    const uint8_t* pLightLevels;
+    const uint8_t* pTransparency;
+} rdRasterFace;
+
+typedef struct rdRasterTri
+{
+    float edgeA[3];
+    float edgeB[3];
+    float edgeC[3];
+    float edgeBias[3];
+    float planeDx[RDRASTER_NUM_PLANES];
+    float planeDy[RDRASTER_NUM_PLANES];
+    float planeC[RDRASTER_NUM_PLANES];
+    float x[3];
+    float y[3];
+    int xMin;
+    int yMin;
+    int xMax;
+    int yMax;
+    uint32_t faceIdx;
+    uint32_t wireEdges;
+} rdRasterTri;
+
+typedef struct rdRasterBin
+{
+    uint32_t* pTris;
+    uint32_t numTris;
+    uint32_t maxTris;
+} rdRasterBin;
+
+static rdRasterFace* rdRaster_aFaces = NULL;
+static size_t rdRaster_numFaces = 0;
+static size_t rdRaster_maxFaces = 0;
+static rdRasterTri* rdRaster_aTris = NULL;
+static size_t rdRaster_numTris = 0;
+static size_t rdRaster_maxTris = 0;
+
+static rdRasterBin* rdRaster_aBins = NULL;
+static int rdRaster_numBinsX = 0;
+static int rdRaster_numBinsY = 0;
+static uint32_t* rdRaster_aActiveBins = NULL;
+static int rdRaster_numActiveBins = 0;
+
+static float* rdRaster_pZBuffer = NULL;
+static int rdRaster_zbufferWidth = 0;
+static int rdRaster_zbufferHeight = 0;
+static int rdRaster_zbufferStride = 0;
+static int rdRaster_bClearZBuffer = 1;
+
+static uint8_t* rdRaster_pPixels = NULL;
+static int rdRaster_pixelPitch = 0;
+static int rdRaster_clipX0 = 0;
+static int rdRaster_clipY0 = 0;
+static int rdRaster_clipX1 = 0;
+static int rdRaster_clipY1 = 0;
+
+static int rdRaster_bThreadsStarted = 0;
+static int rdRaster_numThreads = 0;
+static SDL_Thread* rdRaster_aThreads[RDRASTER_MAX_THREADS];
+static SDL_sem* rdRaster_pWorkSem = NULL;
+static SDL_sem* rdRaster_pDoneSem = NULL;
+static SDL_atomic_t rdRaster_nextBin;
+static int rdRaster_bThreadsQuit = 0;
+
+//
+// 4-wide float helpers, used for coverage, depth and attribute stepping
+//
+#if defined(RDRASTER_SSE2)
+typedef __m128 rdRasterF4;
+
+static inline rdRasterF4 rdRaster_F4Set1(float a) { return _mm_set1_ps(a); }
+static inline rdRasterF4 rdRaster_F4SetR(float a, float b, float c, float d) { return _mm_setr_ps(a, b, c, d); }
+static inline rdRasterF4 rdRaster_F4Add(rdRasterF4 a, rdRasterF4 b) { return _mm_add_ps(a, b); }
+static inline rdRasterF4 rdRaster_F4Mul(rdRasterF4 a, rdRasterF4 b) { return _mm_mul_ps(a, b); }
+static inline rdRasterF4 rdRaster_F4Div(rdRasterF4 a, rdRasterF4 b) { return _mm_div_ps(a, b); }
+static inline rdRasterF4 rdRaster_F4Load(const float* p) { return _mm_loadu_ps(p); }
+static inline void rdRaster_F4Store(float* p, rdRasterF4 a) { _mm_storeu_ps(p, a); }
+static inline int rdRaster_F4GreaterEqual(rdRasterF4 a, rdRasterF4 b) { return _mm_movemask_ps(_mm_cmpge_ps(a, b)); }
+static inline int rdRaster_F4Greater(rdRasterF4 a, rdRasterF4 b) { return _mm_movemask_ps(_mm_cmpgt_ps(a, b)); }
+#elif defined(RDRASTER_NEON)
+typedef float32x4_t rdRasterF4;
+
+static inline int rdRaster_U4Mask(uint32x4_t m)
+{
+    static const uint32_t aBits[4] = {1, 2, 4, 8};
+    uint32x4_t bits = vandq_u32(m, vld1q_u32(aBits));
+    uint32x2_t sum = vadd_u32(vget_low_u32(bits), vget_high_u32(bits));
+    return vget_lane_u32(vpadd_u32(sum, sum), 0);
+}
+
+static inline rdRasterF4 rdRaster_F4Set1(float a) { return vdupq_n_f32(a); }
+static inline rdRasterF4 rdRaster_F4SetR(float a, float b, float c, float d) { float tmp[4] = {a, b, c, d}; return vld1q_f32(tmp); }
+static inline rdRasterF4 rdRaster_F4Add(rdRasterF4 a, rdRasterF4 b) { return vaddq_f32(a, b); }
+static inline rdRasterF4 rdRaster_F4Mul(rdRasterF4 a, rdRasterF4 b) { return vmulq_f32(a, b); }
+static inline rdRasterF4 rdRaster_F4Div(rdRasterF4 a, rdRasterF4 b)
+{
+#ifdef __aarch64__
+    return vdivq_f32(a, b);
+#else
+    rdRasterF4 r = vrecpeq_f32(b);
+    r = vmulq_f32(vrecpsq_f32(b, r), r);
+    r = vmulq_f32(vrecpsq_f32(b, r), r);
+    return vmulq_f32(a, r);
+#endif
+}
+static inline rdRasterF4 rdRaster_F4Load(const float* p) { return vld1q_f32(p); }
+static inline void rdRaster_F4Store(float* p, rdRasterF4 a) { vst1q_f32(p, a); }
+static inline int rdRaster_F4GreaterEqual(rdRasterF4 a, rdRasterF4 b) { return rdRaster_U4Mask(vcgeq_f32(a, b)); }
+static inline int rdRaster_F4Greater(rdRasterF4 a, rdRasterF4 b) { return rdRaster_U4Mask(vcgtq_f32(a, b)); }
+#else
+typedef struct rdRasterF4
+{
+    float v[4];
+} rdRasterF4;
+
+static inline rdRasterF4 rdRaster_F4Set1(float a) { rdRasterF4 out = {{a, a, a, a}}; return out; }
+static inline rdRasterF4 rdRaster_F4SetR(float a, float b, float c, float d) { rdRasterF4 out = {{a, b, c, d}}; return out; }
+static inline rdRasterF4 rdRaster_F4Add(rdRasterF4 a, rdRasterF4 b) { for (int i = 0; i < 4; i++) a.v[i] += b.v[i]; return a; }
+static inline rdRasterF4 rdRaster_F4Mul(rdRasterF4 a, rdRasterF4 b) { for (int i = 0; i < 4; i++) a.v[i] *= b.v[i]; return a; }
+static inline rdRasterF4 rdRaster_F4Div(rdRasterF4 a, rdRasterF4 b) { for (int i = 0; i < 4; i++) a.v[i] /= b.v[i]; return a; }
+static inline rdRasterF4 rdRaster_F4Load(const float* p) { rdRasterF4 out = {{p[0], p[1], p[2], p[3]}}; return out; }
+static inline void rdRaster_F4Store(float* p, rdRasterF4 a) { for (int i = 0; i < 4; i++) p[i] = a.v[i]; }
+static inline int rdRaster_F4GreaterEqual(rdRasterF4 a, rdRasterF4 b) { int m = 0; for (int i = 0; i < 4; i++) m |= (a.v[i] >= b.v[i]) << i; return m; }
+static inline int rdRaster_F4Greater(rdRasterF4 a, rdRasterF4 b) { int m = 0; for (int i = 0; i < 4; i++) m |= (a.v[i] > b.v[i]) << i; return m; }
+#endif
+
+static int rdRaster_EnsureFaces(size_t amt)
+{
+    rdRasterFace* pNew;
+    size_t newMax;
+
+    if (amt <= rdRaster_maxFaces)
+        return 1;
+
+    newMax = rdRaster_maxFaces ? rdRaster_maxFaces : 256;
+    while (newMax < amt)
+        newMax *= 2;
+
+    pNew = (rdRasterFace*)rdroid_pHS->realloc(rdRaster_aFaces, sizeof(rdRasterFace) * newMax);
+    if (!pNew)
+        return 0;
+
+    rdRaster_aFaces = pNew;
+    rdRaster_maxFaces = newMax;
+    return 1;
+}
+
+static int rdRaster_EnsureTris(size_t amt)
+{
+    rdRasterTri* pNew;
+    size_t newMax;
+
+    if (amt <= rdRaster_maxTris)
+        return 1;
+
+    newMax = rdRaster_maxTris ? rdRaster_maxTris : 512;
+    while (newMax < amt)
+        newMax *= 2;
+
+    pNew = (rdRasterTri*)rdroid_pHS->realloc(rdRaster_aTris, sizeof(rdRasterTri) * newMax);
+    if (!pNew)
+        return 0;
+
+    rdRaster_aTris = pNew;
+    rdRaster_maxTris = newMax;
+    return 1;
+}
+
+static void rdRaster_FreeBins()
+{
+    if (rdRaster_aBins)
+    {
+        for (int i = 0; i < rdRaster_numBinsX * rdRaster_numBinsY; i++)
+        {
+            if (rdRaster_aBins[i].pTris)
+                rdroid_pHS->free(rdRaster_aBins[i].pTris);
+        }
+        rdroid_pHS->free(rdRaster_aBins);
+    }
+    if (rdRaster_aActiveBins)
+        rdroid_pHS->free(rdRaster_aActiveBins);
+
+    rdRaster_aBins = NULL;
+    rdRaster_aActiveBins = NULL;
+    rdRaster_numBinsX = 0;
+    rdRaster_numBinsY = 0;
+    rdRaster_numActiveBins = 0;
+}
+
+static int rdRaster_EnsureTarget(int width, int height)
+{
+    int numBinsX = (width + RDRASTER_TILE_SIZE - 1) / RDRASTER_TILE_SIZE;
+    int numBinsY = (height + RDRASTER_TILE_SIZE - 1) / RDRASTER_TILE_SIZE;
+
+    if (rdRaster_pZBuffer && width == rdRaster_zbufferWidth && height == rdRaster_zbufferHeight
+        && numBinsX == rdRaster_numBinsX && numBinsY == rdRaster_numBinsY)
+        return 1;
+
+    if (rdRaster_pZBuffer)
+        rdroid_pHS->free(rdRaster_pZBuffer);
+    rdRaster_FreeBins();
+
+    // Rows are padded to 4 floats so the depth test can always load a full vector
+    rdRaster_zbufferStride = (width + 3) & ~3;
+    rdRaster_pZBuffer = (float*)rdroid_pHS->alloc(sizeof(float) * (rdRaster_zbufferStride * height + 4));
+    rdRaster_aBins = (rdRasterBin*)rdroid_pHS->alloc(sizeof(rdRasterBin) * numBinsX * numBinsY);
+    rdRaster_aActiveBins = (uint32_t*)rdroid_pHS->alloc(sizeof(uint32_t) * numBinsX * numBinsY);
+    if (!rdRaster_pZBuffer || !rdRaster_aBins || !rdRaster_aActiveBins)
+    {
+        if (rdRaster_pZBuffer)
+            rdroid_pHS->free(rdRaster_pZBuffer);
+        if (rdRaster_aBins)
+            rdroid_pHS->free(rdRaster_aBins);
+        if (rdRaster_aActiveBins)
+            rdroid_pHS->free(rdRaster_aActiveBins);
+        rdRaster_pZBuffer = NULL;
+        rdRaster_aBins = NULL;
+        rdRaster_aActiveBins = NULL;
+        rdRaster_zbufferWidth = 0;
+        rdRaster_zbufferHeight = 0;
+        return 0;
+    }
+
+    _memset(rdRaster_aBins, 0, sizeof(rdRasterBin) * numBinsX * numBinsY);
+    rdRaster_numBinsX = numBinsX;
+    rdRaster_numBinsY = numBinsY;
+    rdRaster_zbufferWidth = width;
+    rdRaster_zbufferHeight = height;
+    rdRaster_bClearZBuffer = 1;
+    return 1;
+}
+
+static int rdRaster_WorkerThread(void* unused);
+
+static void rdRaster_StartThreads()
+{
+    int numThreads;
+
+    rdRaster_bThreadsStarted = 1;
+    rdRaster_numThreads = 0;
+
+#ifndef ARCH_WASM
+    numThreads = stdPlatform_GetNumCpus() - 1;
+    if (numThreads > RDRASTER_MAX_THREADS - 1)
+        numThreads = RDRASTER_MAX_THREADS - 1;
+    if (numThreads <= 0)
+        return;
+
+    rdRaster_pWorkSem = SDL_CreateSemaphore(0);
+    rdRaster_pDoneSem = SDL_CreateSemaphore(0);
+    if (!rdRaster_pWorkSem || !rdRaster_pDoneSem)
+        return;
+
+    rdRaster_bThreadsQuit = 0;
+    for (int i = 0; i < numThreads; i++)
+    {
+        rdRaster_aThreads[i] = SDL_CreateThread(rdRaster_WorkerThread, "rdRaster", NULL);
+        if (!rdRaster_aThreads[i])
+            break;
+        rdRaster_numThreads++;
+    }
+#endif
+}
+
+void rdRaster_Shutdown()
+{
+    if (rdRaster_numThreads)
+    {
+        rdRaster_bThreadsQuit = 1;
+        for (int i = 0; i < rdRaster_numThreads; i++)
+            SDL_SemPost(rdRaster_pWorkSem);
+        for (int i = 0; i < rdRaster_numThreads; i++)
+            SDL_WaitThread(rdRaster_aThreads[i], NULL);
+    }
+    if (rdRaster_pWorkSem)
+        SDL_DestroySemaphore(rdRaster_pWorkSem);
+    if (rdRaster_pDoneSem)
+        SDL_DestroySemaphore(rdRaster_pDoneSem);
+    rdRaster_pWorkSem = NULL;
+    rdRaster_pDoneSem = NULL;
+    rdRaster_numThreads = 0;
+    rdRaster_bThreadsStarted = 0;
+
+    if (rdRaster_aFaces)
+        rdroid_pHS->free(rdRaster_aFaces);
+    if (rdRaster_aTris)
+        rdroid_pHS->free(rdRaster_aTris);
+    if (rdRaster_pZBuffer)
+        rdroid_pHS->free(rdRaster_pZBuffer);
+    rdRaster_FreeBins();
+
+    rdRaster_aFaces = NULL;
+    rdRaster_aTris = NULL;
+    rdRaster_pZBuffer = NULL;
+    rdRaster_maxFaces = 0;
+    rdRaster_maxTris = 0;
+    rdRaster_zbufferWidth = 0;
+    rdRaster_zbufferHeight = 0;
+}
+
+void rdRaster_AdvanceFrame()
+{
+    rdRaster_bClearZBuffer = 1;
+}
+
+static int rdRaster_GetMipmapLevel(rdTexture* pTexture, float z_min)
+{
+    // Same distances as rdCache_SendFaceListToHardware
+    switch (pTexture->num_mipmaps)
+    {
+        case 2:
+            return z_min <= rdroid_aMipDistances.y ? 0 : 1;
+        case 3:
+            if (z_min <= rdroid_aMipDistances.x)
+                return 0;
+            return z_min > rdroid_aMipDistances.y ? 2 : 1;
+        case 4:
+            if (z_min <= rdroid_aMipDistances.x)
+                return 0;
+            if (z_min <= rdroid_aMipDistances.y)
+                return 1;
+            return z_min > rdroid_aMipDistances.z ? 3 : 2;
+        case 1:
+            return 0;
+        default:
+            return 1;
+    }
+}
+
+static float rdRaster_GetVertexLight(rdProcEntry* pFace, int lightingMode, int idx, float lightFloor)
+{
+    float light;
+
+    switch (lightingMode)
+    {
+        case 1:
+            light = pFace->extralight;
+            break;
+        case 2:
+            light = pFace->extralight + pFace->light_level_static;
+            break;
+        case 3:
+            light = pFace->extralight + pFace->vertexIntensities[idx];
+            break;
+        default:
+            return 63.0;
+    }
+
+    light = stdMath_Clamp(light, 0.0, 1.0);
+    if (light < lightFloor)
+        light = lightFloor;
+
+    return light * 63.0;
+}
+
+static void rdRaster_SetupTri(rdProcEntry* pFace, const rdRasterFace* pRasterFace, const int* aIdx, const float* aLight, float texScale, uint32_t wireEdges)
+{
+    rdRasterTri* pTri;
+    float x[3];
+    float y[3];
+    float a[RDRASTER_NUM_PLANES][3];
+    float area, tmp, xMin, xMax, yMin, yMax;
+
+    for (int i = 0; i < 3; i++)
+    {
+        rdVector3* pVert = &pFace->vertices[aIdx[i]];
+        float invZ = pVert->z > 0.0 ? 1.0 / pVert->z : 0.0;
+        float u = 0.0;
+        float v = 0.0;
+
+        if (pRasterFace->pTexels)
+        {
+            u = pFace->vertexUVs[aIdx[i]].x * texScale;
+            v = pFace->vertexUVs[aIdx[i]].y * texScale;
+        }
+
+        x[i] = pVert->x;
+        y[i] = pVert->y;
+        a[RDRASTER_PLANE_Z][i] = invZ;
+        a[RDRASTER_PLANE_U][i] = pRasterFace->bPerspective ? u * invZ : u;
+        a[RDRASTER_PLANE_V][i] = pRasterFace->bPerspective ? v * invZ : v;
+        a[RDRASTER_PLANE_L][i] = aLight[i];
+    }
+
+    area = (x[1] - x[0]) * (y[2] - y[0]) - (x[2] - x[0]) * (y[1] - y[0]);
+    if (area == 0.0)
+        return;
+
+    // Keep every triangle wound the same way so coverage is always e >= 0
+    if (area < 0.0)
+    {
+        tmp = x[1]; x[1] = x[2]; x[2] = tmp;
+        tmp = y[1]; y[1] = y[2]; y[2] = tmp;
+        for (int i = 0; i < RDRASTER_NUM_PLANES; i++)
+        {
+            tmp = a[i][1]; a[i][1] = a[i][2]; a[i][2] = tmp;
+        }
+        wireEdges = (wireEdges & 2) | ((wireEdges & 1) << 2) | ((wireEdges & 4) >> 2);
+        area = -area;
+    }
+
+    xMin = x[0]; xMax = x[0];
+    yMin = y[0]; yMax = y[0];
+    for (int i = 1; i < 3; i++)
+    {
+        if (x[i] < xMin) xMin = x[i];
+        if (x[i] > xMax) xMax = x[i];
+        if (y[i] < yMin) yMin = y[i];
+        if (y[i] > yMax) yMax = y[i];
+    }
+
+    if (!rdRaster_EnsureTris(rdRaster_numTris + 1))
+        return;
+
+    pTri = &rdRaster_aTris[rdRaster_numTris];
+    pTri->xMin = (int)floorf(xMin);
+    pTri->yMin = (int)floorf(yMin);
+    pTri->xMax = (int)ceilf(xMax);
+    pTri->yMax = (int)ceilf(yMax);
+    if (pTri->xMin < rdRaster_clipX0) pTri->xMin = rdRaster_clipX0;
+    if (pTri->yMin < rdRaster_clipY0) pTri->yMin = rdRaster_clipY0;
+    if (pTri->xMax > rdRaster_clipX1) pTri->xMax = rdRaster_clipX1;
+    if (pTri->yMax > rdRaster_clipY1) pTri->yMax = rdRaster_clipY1;
+    if (pTri->xMin > pTri->xMax || pTri->yMin > pTri->yMax)
+        return;
+
+    for (int i = 0; i < 3; i++)
+    {
+        int j = (i + 1) % 3;
+        float edgeA = y[i] - y[j];
+        float edgeB = x[j] - x[i];
+
+        pTri->edgeA[i] = edgeA;
+        pTri->edgeB[i] = edgeB;
+        pTri->edgeC[i] = -(edgeA * x[i] + edgeB * y[i]);
+
+        // Top-left fill rule: shared edges are only ever drawn by one triangle
+        pTri->edgeBias[i] = (edgeA > 0.0 || (edgeA == 0.0 && edgeB > 0.0)) ? 0.0 : FLT_MIN;
+
+        pTri->x[i] = x[i];
+        pTri->y[i] = y[i];
+    }
+
+    for (int i = 0; i < RDRASTER_NUM_PLANES; i++)
+    {
+        float d1 = a[i][1] - a[i][0];
+        float d2 = a[i][2] - a[i][0];
+
+        pTri->planeDx[i] = (d1 * (y[2] - y[0]) - d2 * (y[1] - y[0])) / area;
+        pTri->planeDy[i] = (d2 * (x[1] - x[0]) - d1 * (x[2] - x[0])) / area;
+        pTri->planeC[i] = a[i][0] - pTri->planeDx[i] * x[0] - pTri->planeDy[i] * y[0];
+    }
+
+    pTri->faceIdx = rdRaster_numFaces;
+    pTri->wireEdges = wireEdges;
+    rdRaster_numTris++;
+}
+
+static void rdRaster_SetupFace(rdProcEntry* pFace, uint32_t zFlags)
+{
+    rdRasterFace* pRasterFace;
+    rdMaterial* pMaterial;
+    rdTexinfo* pTexinfo;
+    rdColormap* pColormap;
+    int geometryMode, lightingMode, textureMode, cel, mipmapLevel;
+    float lightFloor, texScale;
+    float aLight[3];
+    int aIdx[3];
+    size_t numTrisBefore;
+
+    // User faces (debug lines) were drawn by another JK.EXE routine, there's no
+    // software path for them
+    if ((pFace->extraData & 1) != 0 || pFace->numVertices < 3)
+        return;
+
+    geometryMode = pFace->geometryMode;
+    if (geometryMode >= rdroid_curGeometryMode)
+        geometryMode = rdroid_curGeometryMode;
+    lightingMode = pFace->lightingMode;
+    if (lightingMode >= rdroid_curLightingMode)
+        lightingMode = rdroid_curLightingMode;
+    textureMode = pFace->textureMode;
+    if (textureMode >= rdroid_curTextureMode)
+        textureMode = rdroid_curTextureMode;
+
+    pMaterial = pFace->material;
+    if (!geometryMode || !pMaterial || !pMaterial->num_texinfo)
+        return;
+
+    cel = pFace->wallCel;
+    if (cel == -1)
+        cel = pMaterial->celIdx;
+    if (cel < 0)
+        cel = 0;
+    else if (cel > pMaterial->num_texinfo - 1)
+        cel = pMaterial->num_texinfo - 1;
+
+    pTexinfo = pMaterial->texinfos[cel];
+    pColormap = pFace->colormap ? pFace->colormap : rdColormap_pCurMap;
+    if (!pTexinfo || !pColormap || !pColormap->lightlevel)
+        return;
+
+    if (!rdRaster_EnsureFaces(rdRaster_numFaces + 1))
+        return;
+
+    pRasterFace = &rdRaster_aFaces[rdRaster_numFaces];
+    _memset(pRasterFace, 0, sizeof(*pRasterFace));
+    pRasterFace->zFlags = zFlags;
+    pRasterFace->bPerspective = textureMode > 0;
+    pRasterFace->bLit = lightingMode != 0;
+    pRasterFace->color = (uint8_t)pTexinfo->header.field_4;
+    pRasterFace->pLightLevels = (const uint8_t*)pColormap->lightlevel;
+    if ((pFace->type & 2) != 0)
+        pRasterFace->pTransparency = (const uint8_t*)pColormap->transparency;
+
+    texScale = 1.0;
+    if (geometryMode >= 4 && (pTexinfo->header.texture_type & 8) != 0 && pTexinfo->texture_ptr)
+    {
+        rdTexture* pTexture = pTexinfo->texture_ptr;
+        stdVBuffer* pTexVbuf;
+
+        mipmapLevel = rdRaster_GetMipmapLevel(pTexture, pFace->z_min);
+        pTexVbuf = pTexture->texture_struct[mipmapLevel];
+        if (pTexVbuf && pTexVbuf->sdlSurface && pTexVbuf->format.format.bpp == 8)
+        {
+            pRasterFace->pTexels = (const uint8_t*)pTexVbuf->sdlSurface->pixels;
+            pRasterFace->texPitch = pTexVbuf->sdlSurface->pitch;
+            pRasterFace->texWidth = pTexVbuf->format.width;
+            pRasterFace->texHeight = pTexVbuf->format.height;
+            pRasterFace->texMaskU = (pRasterFace->texWidth & (pRasterFace->texWidth - 1)) ? -1 : pRasterFace->texWidth - 1;
+            pRasterFace->texMaskV = (pRasterFace->texHeight & (pRasterFace->texHeight - 1)) ? -1 : pRasterFace->texHeight - 1;
+            pRasterFace->bTransparentTexels = (pTexture->alpha_en & 1) != 0;
+            texScale = 1.0 / (float)(1 << mipmapLevel);
+        }
+    }
+    if (!pRasterFace->pTexels && geometryMode > 3)
+        geometryMode = 3;
+    pRasterFace->geometryMode = geometryMode;
+
+    lightFloor = (rdroid_curRenderOptions & 2) ? pFace->ambientLight : 0.0;
+
+    // Fan out the polygon, flagging which triangle edges are real polygon
+    // edges for the wireframe mode
+    numTrisBefore = rdRaster_numTris;
+    aIdx[0] = 0;
+    aLight[0] = rdRaster_GetVertexLight(pFace, lightingMode, 0, lightFloor);
+    for (int i = 1; i < pFace->numVertices - 1; i++)
+    {
+        uint32_t wireEdges = 2;
+
+        if (i == 1)
+            wireEdges |= 1;
+        if (i == pFace->numVertices - 2)
+            wireEdges |= 4;
+
+        aIdx[1] = i;
+        aIdx[2] = i + 1;
+        aLight[1] = rdRaster_GetVertexLight(pFace, lightingMode, i, lightFloor);
+        aLight[2] = rdRaster_GetVertexLight(pFace, lightingMode, i + 1, lightFloor);
+        rdRaster_SetupTri(pFace, pRasterFace, aIdx, aLight, texScale, wireEdges);
+    }
+
+    if (rdRaster_numTris != numTrisBefore)
+        rdRaster_numFaces++;
+}
+
+static void rdRaster_BinTris()
+{
+    rdRaster_numActiveBins = 0;
+
+    for (uint32_t i = 0; i < rdRaster_numTris; i++)
+    {
+        rdRasterTri* pTri = &rdRaster_aTris[i];
+        int binX0 = pTri->xMin / RDRASTER_TILE_SIZE;
+        int binY0 = pTri->yMin / RDRASTER_TILE_SIZE;
+        int binX1 = pTri->xMax / RDRASTER_TILE_SIZE;
+        int binY1 = pTri->yMax / RDRASTER_TILE_SIZE;
+
+        for (int binY = binY0; binY <= binY1; binY++)
+        {
+            for (int binX = binX0; binX <= binX1; binX++)
+            {
+                uint32_t binIdx = binY * rdRaster_numBinsX + binX;
+                rdRasterBin* pBin = &rdRaster_aBins[binIdx];
+
+                if (pBin->numTris >= pBin->maxTris)
+                {
+                    uint32_t newMax = pBin->maxTris ? pBin->maxTris * 2 : 64;
+                    uint32_t* pNew = (uint32_t*)rdroid_pHS->realloc(pBin->pTris, sizeof(uint32_t) * newMax);
+                    if (!pNew)
+                        continue;
+                    pBin->pTris = pNew;
+                    pBin->maxTris = newMax;
+                }
+
+                if (!pBin->numTris)
+                    rdRaster_aActiveBins[rdRaster_numActiveBins++] = binIdx;
+                pBin->pTris[pBin->numTris++] = i;
+            }
+        }
+    }
+}
+
+static inline int rdRaster_Wrap(int val, int size, int mask)
+{
+    if (mask >= 0)
+        return val & mask;
+
+    val %= size;
+    if (val < 0)
+        val += size;
+    return val;
+}
+
+static void rdRaster_PlotLine(float ax, float ay, float bx, float by, uint8_t color, int x0, int y0, int x1, int y1)
+{
+    float dx = bx - ax;
+    float dy = by - ay;
+    int steps = (int)ceilf(fabsf(dx) > fabsf(dy) ? fabsf(dx) : fabsf(dy));
+
+    if (steps < 1)
+        steps = 1;
+
+    dx /= (float)steps;
+    dy /= (float)steps;
+    for (int i = 0; i <= steps; i++)
+    {
+        int x = (int)(ax + dx * i);
+        int y = (int)(ay + dy * i);
+
+        if (x >= x0 && x <= x1 && y >= y0 && y <= y1)
+            rdRaster_pPixels[y * rdRaster_pixelPitch + x] = color;
+    }
+}
+
+static void rdRaster_DrawTriWire(const rdRasterTri* pTri, const rdRasterFace* pFace, int x0, int y0, int x1, int y1)
+{
+    for (int i = 0; i < 3; i++)
+    {
+        int j = (i + 1) % 3;
+
+        if (pFace->geometryMode == 1)
+        {
+            int x = (int)pTri->x[i];
+            int y = (int)pTri->y[i];
+            if (x >= x0 && x <= x1 && y >= y0 && y <= y1)
+                rdRaster_pPixels[y * rdRaster_pixelPitch + x] = pFace->color;
+        }
+        else if (pTri->wireEdges & (1 << i))
+        {
+            rdRaster_PlotLine(pTri->x[i], pTri->y[i], pTri->x[j], pTri->y[j], pFace->color, x0, y0, x1, y1);
+        }
+    }
+}
+
+static void rdRaster_DrawTri(const rdRasterTri* pTri, const rdRasterFace* pFace, int x0, int y0, int x1, int y1)
+{
+    rdRasterF4 laneOffs = rdRaster_F4SetR(0.5, 1.5, 2.5, 3.5);
+    rdRasterF4 one = rdRaster_F4Set1(1.0);
+    rdRasterF4 aEdgeStep[3];
+    rdRasterF4 aEdgeLane[3];
+    rdRasterF4 aEdgeBias[3];
+    rdRasterF4 aPlaneStep[RDRASTER_NUM_PLANES];
+    rdRasterF4 aPlaneLane[RDRASTER_NUM_PLANES];
+    float aZ[4], aU[4], aV[4], aL[4];
+
+    if (pTri->xMin > x0) x0 = pTri->xMin;
+    if (pTri->yMin > y0) y0 = pTri->yMin;
+    if (pTri->xMax < x1) x1 = pTri->xMax;
+    if (pTri->yMax < y1) y1 = pTri->yMax;
+    if (x0 > x1 || y0 > y1)
+        return;
+
+    for (int i = 0; i < 3; i++)
+    {
+        aEdgeStep[i] = rdRaster_F4Set1(pTri->edgeA[i] * 4.0);
+        aEdgeLane[i] = rdRaster_F4Mul(rdRaster_F4Set1(pTri->edgeA[i]), laneOffs);
+        aEdgeBias[i] = rdRaster_F4Set1(pTri->edgeBias[i]);
+    }
+    for (int i = 0; i < RDRASTER_NUM_PLANES; i++)
+    {
+        aPlaneStep[i] = rdRaster_F4Set1(pTri->planeDx[i] * 4.0);
+        aPlaneLane[i] = rdRaster_F4Mul(rdRaster_F4Set1(pTri->planeDx[i]), laneOffs);
+    }
+
+    for (int y = y0; y <= y1; y++)
+    {
+        uint8_t* pRow = &rdRaster_pPixels[y * rdRaster_pixelPitch];
+        float* pZRow = &rdRaster_pZBuffer[y * rdRaster_zbufferStride];
+        float fx = (float)x0;
+        float fy = (float)y + 0.5;
+        rdRasterF4 aEdge[3];
+        rdRasterF4 aPlane[RDRASTER_NUM_PLANES];
+
+        for (int i = 0; i < 3; i++)
+            aEdge[i] = rdRaster_F4Add(rdRaster_F4Set1(pTri->edgeA[i] * fx + pTri->edgeB[i] * fy + pTri->edgeC[i]), aEdgeLane[i]);
+        for (int i = 0; i < RDRASTER_NUM_PLANES; i++)
+            aPlane[i] = rdRaster_F4Add(rdRaster_F4Set1(pTri->planeDx[i] * fx + pTri->planeDy[i] * fy + pTri->planeC[i]), aPlaneLane[i]);
+
+        for (int x = x0; x <= x1; x += 4)
+        {
+            int mask = rdRaster_F4GreaterEqual(aEdge[0], aEdgeBias[0])
+                     & rdRaster_F4GreaterEqual(aEdge[1], aEdgeBias[1])
+                     & rdRaster_F4GreaterEqual(aEdge[2], aEdgeBias[2]);
+
+            if (x1 - x < 3)
+                mask &= (1 << (x1 - x + 1)) - 1;
+
+            if (mask && (pFace->zFlags & RDRASTER_ZTEST))
+                mask &= rdRaster_F4Greater(aPlane[RDRASTER_PLANE_Z], rdRaster_F4Load(&pZRow[x]));
+
+            if (mask)
+            {
+                rdRaster_F4Store(aZ, aPlane[RDRASTER_PLANE_Z]);
+                rdRaster_F4Store(aL, aPlane[RDRASTER_PLANE_L]);
+                if (pFace->pTexels)
+                {
+                    if (pFace->bPerspective)
+                    {
+                        rdRasterF4 w = rdRaster_F4Div(one, aPlane[RDRASTER_PLANE_Z]);
+                        rdRaster_F4Store(aU, rdRaster_F4Mul(aPlane[RDRASTER_PLANE_U], w));
+                        rdRaster_F4Store(aV, rdRaster_F4Mul(aPlane[RDRASTER_PLANE_V], w));
+                    }
+                    else
+                    {
+                        rdRaster_F4Store(aU, aPlane[RDRASTER_PLANE_U]);
+                        rdRaster_F4Store(aV, aPlane[RDRASTER_PLANE_V]);
+                    }
+                }
+
+                for (int i = 0; i < 4; i++)
+                {
+                    uint8_t idx;
+
+                    if (!(mask & (1 << i)))
+                        continue;
+
+                    if (pFace->pTexels)
+                    {
+                        int u = rdRaster_Wrap((int)floorf(aU[i]), pFace->texWidth, pFace->texMaskU);
+                        int v = rdRaster_Wrap((int)floorf(aV[i]), pFace->texHeight, pFace->texMaskV);
+
+                        idx = pFace->pTexels[v * pFace->texPitch + u];
+                        if (!idx && pFace->bTransparentTexels)
+                            continue;
+                    }
+                    else
+                    {
+                        idx = pFace->color;
+                    }
+
+                    if (pFace->bLit)
+                    {
+                        int level = (int)aL[i];
+                        if (level < 0)
+                            level = 0;
+                        else if (level > 63)
+                            level = 63;
+                        idx = pFace->pLightLevels[(level << 8) | idx];
+                    }
+
+                    if (pFace->pTransparency)
+                        idx = pFace->pTransparency[(idx << 8) | pRow[x + i]];
+
+                    pRow[x + i] = idx;
+                    if (pFace->zFlags & RDRASTER_ZWRITE)
+                        pZRow[x + i] = aZ[i];
+                }
+            }
+
+            for (int i = 0; i < 3; i++)
+                aEdge[i] = rdRaster_F4Add(aEdge[i], aEdgeStep[i]);
+            for (int i = 0; i < RDRASTER_NUM_PLANES; i++)
+                aPlane[i] = rdRaster_F4Add(aPlane[i], aPlaneStep[i]);
+        }
+    }
+}
+
+static void rdRaster_DrawBin(uint32_t binIdx)
+{
+    rdRasterBin* pBin = &rdRaster_aBins[binIdx];
+    int x0 = (binIdx % rdRaster_numBinsX) * RDRASTER_TILE_SIZE;
+    int y0 = (binIdx / rdRaster_numBinsX) * RDRASTER_TILE_SIZE;
+    int x1 = x0 + RDRASTER_TILE_SIZE - 1;
+    int y1 = y0 + RDRASTER_TILE_SIZE - 1;
+
+    if (x0 < rdRaster_clipX0) x0 = rdRaster_clipX0;
+    if (y0 < rdRaster_clipY0) y0 = rdRaster_clipY0;
+    if (x1 > rdRaster_clipX1) x1 = rdRaster_clipX1;
+    if (y1 > rdRaster_clipY1) y1 = rdRaster_clipY1;
+
+    // Triangles were binned in submission order, so each tile keeps the
+    // painter's ordering rdCache handed us
+    for (uint32_t i = 0; i < pBin->numTris; i++)
+    {
+        const rdRasterTri* pTri = &rdRaster_aTris[pBin->pTris[i]];
+        const rdRasterFace* pFace = &rdRaster_aFaces[pTri->faceIdx];
+
+        if (pFace->geometryMode <= 2)
+            rdRaster_DrawTriWire(pTri, pFace, x0, y0, x1, y1);
+        else
+            rdRaster_DrawTri(pTri, pFace, x0, y0, x1, y1);
+    }
+}
+
+static void rdRaster_DrawBins()
+{
+    while (1)
+    {
+        int idx = SDL_AtomicAdd(&rdRaster_nextBin, 1);
+        if (idx >= rdRaster_numActiveBins)
+            break;
+
+        rdRaster_DrawBin(rdRaster_aActiveBins[idx]);
+    }
+}
+
+static int rdRaster_WorkerThread(void* unused)
+{
+    while (1)
+    {
+        SDL_SemWait(rdRaster_pWorkSem);
+        if (rdRaster_bThreadsQuit)
+            break;
+
+        rdRaster_DrawBins();
+        SDL_SemPost(rdRaster_pDoneSem);
+    }
+    return 0;
+}
+
+void rdRaster_DrawFaces(rdProcEntry* pFaces, size_t numFaces, int zbufferMethod)
+{
+    rdCanvas* pCanvas;
+    stdVBuffer* pVbuf;
+    uint32_t zFlags;
+    int numWorkers;
+
+    if (!rdCamera_pCurCamera || !rdCamera_pCurCamera->canvas)
+        return;
+
+    pCanvas = rdCamera_pCurCamera->canvas;
+    pVbuf = pCanvas->vbuffer;
+    if (!pVbuf || !pVbuf->sdlSurface || pVbuf->format.format.bpp != 8)
+        return;
+
+    if (!rdRaster_EnsureTarget(pVbuf->format.width, pVbuf->format.height))
+        return;
+
+    if (rdRaster_bClearZBuffer)
+    {
+        _memset(rdRaster_pZBuffer, 0, sizeof(float) * (rdRaster_zbufferStride * rdRaster_zbufferHeight + 4));
+        rdRaster_bClearZBuffer = 0;
+    }
+
+    rdRaster_pPixels = pVbuf->surface_lock_alloc ? (uint8_t*)pVbuf->surface_lock_alloc : (uint8_t*)pVbuf->sdlSurface->pixels;
+    rdRaster_pixelPitch = pVbuf->sdlSurface->pitch;
+    rdRaster_clipX0 = pCanvas->xStart < 0 ? 0 : pCanvas->xStart;
+    rdRaster_clipY0 = pCanvas->yStart < 0 ? 0 : pCanvas->yStart;
+    rdRaster_clipX1 = pCanvas->widthMinusOne < pVbuf->format.width - 1 ? pCanvas->widthMinusOne : pVbuf->format.width - 1;
+    rdRaster_clipY1 = pCanvas->heightMinusOne < pVbuf->format.height - 1 ? pCanvas->heightMinusOne : pVbuf->format.height - 1;
+
+    rdRect dirtyRect = {rdRaster_clipX0, rdRaster_clipY0, rdRaster_clipX1 - rdRaster_clipX0 + 1, rdRaster_clipY1 - rdRaster_clipY0 + 1};
+    stdDisplay_VBufferMarkDirty(pVbuf, &dirtyRect);
+
+    switch (zbufferMethod)
+    {
+        case 1:
+            zFlags = RDRASTER_ZWRITE;
+            break;
+        case 2:
+            zFlags = RDRASTER_ZTEST | RDRASTER_ZWRITE;
+            break;
+        case 3:
+            zFlags = RDRASTER_ZTEST;
+            break;
+        default:
+            zFlags = 0;
+            break;
+    }
+
+    // Reset last flush's bins
+    for (int i = 0; i < rdRaster_numActiveBins; i++)
+        rdRaster_aBins[rdRaster_aActiveBins[i]].numTris = 0;
+    rdRaster_numActiveBins = 0;
+
+    rdRaster_numFaces = 0;
+    rdRaster_numTris = 0;
+    for (size_t i = 0; i < numFaces; i++)
+        rdRaster_SetupFace(&pFaces[i], zFlags);
+
+    if (!rdRaster_numTris)
+        return;
+
+    rdRaster_BinTris();
+
+    if (!rdRaster_bThreadsStarted)
+        rdRaster_StartThreads();
+
+    numWorkers = rdRaster_numThreads;
+    if (numWorkers > rdRaster_numActiveBins - 1)
+        numWorkers = rdRaster_numActiveBins - 1;
+    if (rdRaster_numTris < RDRASTER_MIN_THREADED_TRIS)
+        numWorkers = 0;
+
+    SDL_AtomicSet(&rdRaster_nextBin, 0);
+    for (int i = 0; i < numWorkers; i++)
+        SDL_SemPost(rdRaster_pWorkSem);
+
+    rdRaster_DrawBins();
+
+    for (int i = 0; i < numWorkers; i++)
+        SDL_SemWait(rdRaster_pDoneSem);
+}
+
+#endif // SDL2_RENDER
@@ -8,6 +8,17 @@
 
 void rdRaster_Startup();
 
+#ifdef SDL2_RENDER
+// Native replacement for the JK.EXE rdCache_DrawFaceN/Z/User span rasterizers.
+// Faces are binned into screen tiles and the tiles are shaded in parallel.
+#define RDRASTER_TILE_SIZE (64)
+#define RDRASTER_MAX_THREADS (8)
+
+void rdRaster_Shutdown();
+void rdRaster_AdvanceFrame();
+void rdRaster_DrawFaces(rdProcEntry* pFaces, size_t numFaces, int zbufferMethod);
+#endif
+
 //static int (*rdRaster_Startup)(void) = (void*)rdRaster_Startup_ADDR;
 
 
@@ -316,12 +316,14 @@ int Window_DefaultHandler(HWND hWnd, UINT Msg, WPARAM wParam, LPARAM lParam, voi
 
 #include <string.h>
 
+#ifndef NULL_RENDER
 #include <GL/glew.h>
 #ifdef MACOS
 #include "Platform/macOS/SDL_fix.h"
 #else
 #include <GL/gl.h>
 #endif
+#endif
 #include "Win95/Video.h"
 
 SDL_Window* displayWindow = NULL;
@@ -345,6 +347,13 @@ int last_jkGame_isDDraw = 0;
 int Window_menu_mouseX = 0;
 int Window_menu_mouseY = 0;
 
+// Added: no window or GL context, frames only land in the memory framebuffer
+#ifdef NULL_RENDER
+int Window_bHeadless = 1;
+#else
+int Window_bHeadless = 0;
+#endif
+
 void Window_HandleMouseMove(SDL_MouseMotionEvent *event)
 {
     int x = event->x;
@@ -700,7 +709,7 @@ void Window_SdlUpdate()
 
     static int jkPlayer_enableVsync_last = 0;
 
-    if (jkPlayer_enableVsync_last != jkPlayer_enableVsync)
+    if (jkPlayer_enableVsync_last != jkPlayer_enableVsync && !Window_bHeadless)
     {
         SDL_GL_SetSwapInterval(jkPlayer_enableVsync);
     }
@@ -714,10 +723,13 @@ void Window_SdlUpdate()
 
         SDL_SetRelativeMouseMode(SDL_FALSE);
 
-        std3D_StartScene();
-        std3D_DrawMenu();
-        std3D_EndScene();
-        SDL_GL_SwapWindow(displayWindow);
+        if (!Window_bHeadless)
+        {
+            std3D_StartScene();
+            std3D_DrawMenu();
+            std3D_EndScene();
+            SDL_GL_SwapWindow(displayWindow);
+        }
 
         if (Window_needsRecreate)
             Window_RecreateSDL2Window();
@@ -733,7 +745,7 @@ void Window_SdlUpdate()
             Window_menu_mouseY = Window_mouseY;
         }
 
-        if (SDL_GetWindowFlags(displayWindow) & SDL_WINDOW_MOUSE_FOCUS) {
+        if (!Window_bHeadless && (SDL_GetWindowFlags(displayWindow) & SDL_WINDOW_MOUSE_FOCUS)) {
             SDL_SetRelativeMouseMode(SDL_TRUE);
             SDL_WarpMouseInWindow(displayWindow, 100, 100);
         }
@@ -752,7 +764,8 @@ void Window_SdlVblank()
 {
     //static uint32_t roundtrip = 0;
     //uint32_t before = stdPlatform_GetTimeMsec();
-    SDL_GL_SwapWindow(displayWindow);
+    if (!Window_bHeadless)
+        SDL_GL_SwapWindow(displayWindow);
     //uint32_t after = stdPlatform_GetTimeMsec();
     //printf("%u %u\n", after-before, before-roundtrip);
 
@@ -778,8 +791,11 @@ EM_JS(int, canvas_get_height, (), {
 
 void Window_RecreateSDL2Window()
 {
-    printf("Recreating SDL2 Window!\n");
     Window_needsRecreate = 0;
+    if (Window_bHeadless)
+        return;
+
+    printf("Recreating SDL2 Window!\n");
 
     if (displayWindow) {
         std3D_FreeResources();
@@ -876,6 +892,20 @@ int Window_Main_Linux(int argc, char** argv)
 {
     char cmdLine[1024];
     int result;
+
+    // Added: has to be known before SDL picks a video driver
+    for (int i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "-headless"))
+            Window_bHeadless = 1;
+    }
+
+    if (Window_bHeadless)
+    {
+        // The bundled SDL only reads the driver from the environment, the hints came in 2.0.22
+        SDL_setenv("SDL_VIDEODRIVER", "dummy", 1);
+        SDL_setenv("SDL_AUDIODRIVER", "dummy", 1);
+    }
     
     // Init SDL
     SDL_Init(SDL_INIT_VIDEO | SDL_INIT_AUDIO | SDL_INIT_NOPARACHUTE);
@@ -909,8 +939,11 @@ int Window_Main_Linux(int argc, char** argv)
 #endif
 
     Window_RecreateSDL2Window();
-    
-    glewInit();
+
+#ifndef NULL_RENDER
+    if (!Window_bHeadless)
+        glewInit();
+#endif
     
     //SDL_RenderClear(displayRenderer);
     //SDL_RenderPresent(displayRenderer);
@@ -927,6 +960,10 @@ int Window_Main_Linux(int argc, char** argv)
     
     for (int i = 1; i < argc; i++)
     {
+        // Added: handled above, Main_ParseCmdLine doesn't know it
+        if (!strcmp(argv[i], "-headless"))
+            continue;
+
         strcat(cmdLine, argv[i]);
         strcat(cmdLine, " ");
     }
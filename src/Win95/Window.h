@@ -48,6 +48,7 @@ extern int Window_lastYRel;
 extern int Window_lastSampleMs;
 extern int Window_bMouseLeft;
 extern int Window_bMouseRight;
+extern int Window_bHeadless;
 
 int Window_Main_Linux(int argc, char** argv);
 //int Window_AddMsgHandler(WindowHandler_t a1);
@@ -30,17 +30,120 @@ uint8_t* stdDisplay_GetPalette()
 #include <SDL.h>
 #endif
 
+#ifndef NULL_RENDER
 #ifdef MACOS
 #include "OpenGL/gl.h"
 #else
 #include <GL/gl.h>
 #endif
+#endif
 #include <assert.h>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define STDDISPLAY_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define STDDISPLAY_NEON
+#endif
+
 uint32_t Video_menuTexId = 0;
 rdColor24 stdDisplay_masterPalette[256];
+uint32_t stdDisplay_paletteGeneration = 1; // Added
 int Video_bModeSet = 0;
 
+// Added: regions of Video_menuBuffer written since the last
+// stdDisplay_TakeMenuDirtyRects, so the menu texture only re-uploads those
+static rdRect stdDisplay_aMenuDirtyRects[STDDISPLAY_MAX_DIRTY_RECTS];
+static int stdDisplay_numMenuDirtyRects = 0;
+
+static void stdDisplay_UnionRect(rdRect *pOut, const rdRect *pRect)
+{
+    int x1 = pOut->x + pOut->width;
+    int y1 = pOut->y + pOut->height;
+
+    if (pRect->x + pRect->width > x1)
+        x1 = pRect->x + pRect->width;
+    if (pRect->y + pRect->height > y1)
+        y1 = pRect->y + pRect->height;
+    if (pRect->x < pOut->x)
+        pOut->x = pRect->x;
+    if (pRect->y < pOut->y)
+        pOut->y = pRect->y;
+
+    pOut->width = x1 - pOut->x;
+    pOut->height = y1 - pOut->y;
+}
+
+static int stdDisplay_RectsTouch(const rdRect *a, const rdRect *b)
+{
+    return a->x <= b->x + b->width && b->x <= a->x + a->width
+        && a->y <= b->y + b->height && b->y <= a->y + a->height;
+}
+
+void stdDisplay_VBufferMarkDirty(stdVBuffer *vbuf, const rdRect *rect)
+{
+    rdRect clipped;
+    int x1, y1;
+
+    if (vbuf != &Video_menuBuffer)
+        return;
+
+    if (!rect)
+    {
+        clipped.x = 0;
+        clipped.y = 0;
+        clipped.width = vbuf->format.width;
+        clipped.height = vbuf->format.height;
+    }
+    else
+    {
+        clipped.x = rect->x < 0 ? 0 : rect->x;
+        clipped.y = rect->y < 0 ? 0 : rect->y;
+        x1 = rect->x + rect->width;
+        y1 = rect->y + rect->height;
+        if (x1 > (int)vbuf->format.width)
+            x1 = vbuf->format.width;
+        if (y1 > (int)vbuf->format.height)
+            y1 = vbuf->format.height;
+        clipped.width = x1 - clipped.x;
+        clipped.height = y1 - clipped.y;
+    }
+
+    if (clipped.width <= 0 || clipped.height <= 0)
+        return;
+
+    for (int i = 0; i < stdDisplay_numMenuDirtyRects; i++)
+    {
+        if (stdDisplay_RectsTouch(&stdDisplay_aMenuDirtyRects[i], &clipped))
+        {
+            stdDisplay_UnionRect(&stdDisplay_aMenuDirtyRects[i], &clipped);
+            return;
+        }
+    }
+
+    // Out of slots, everything collapses into one bounding box
+    if (stdDisplay_numMenuDirtyRects == STDDISPLAY_MAX_DIRTY_RECTS)
+    {
+        for (int i = 1; i < stdDisplay_numMenuDirtyRects; i++)
+            stdDisplay_UnionRect(&stdDisplay_aMenuDirtyRects[0], &stdDisplay_aMenuDirtyRects[i]);
+        stdDisplay_UnionRect(&stdDisplay_aMenuDirtyRects[0], &clipped);
+        stdDisplay_numMenuDirtyRects = 1;
+        return;
+    }
+
+    stdDisplay_aMenuDirtyRects[stdDisplay_numMenuDirtyRects++] = clipped;
+}
+
+int stdDisplay_TakeMenuDirtyRects(rdRect *aOut)
+{
+    int num = stdDisplay_numMenuDirtyRects;
+
+    _memcpy(aOut, stdDisplay_aMenuDirtyRects, sizeof(rdRect) * num);
+    stdDisplay_numMenuDirtyRects = 0;
+    return num;
+}
+
 int stdDisplay_Startup()
 {
     stdDisplay_bStartup = 1;
@@ -107,7 +210,10 @@ int stdDisplay_SetMode(unsigned int modeIdx, const void *palette, int paged)
     
     if (Video_bModeSet)
     {
-        glDeleteTextures(1, &Video_menuTexId);
+#ifndef NULL_RENDER
+        if (!Window_bHeadless)
+            glDeleteTextures(1, &Video_menuTexId);
+#endif
         if (Video_otherBuf.sdlSurface)
             SDL_FreeSurface(Video_otherBuf.sdlSurface);
         if (Video_menuBuffer.sdlSurface)
@@ -165,12 +271,20 @@ int stdDisplay_SetMode(unsigned int modeIdx, const void *palette, int paged)
     Video_menuBuffer.format.format.bpp = 8;
     Video_otherBuf.format.format.bpp = 8;
     
-    glGenTextures(1, &Video_menuTexId);
-    glBindTexture(GL_TEXTURE_2D, Video_menuTexId);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, newW, newH, 0, GL_RED, GL_UNSIGNED_BYTE, Video_menuBuffer.sdlSurface->pixels);
+#ifndef NULL_RENDER
+    if (!Window_bHeadless)
+    {
+        glGenTextures(1, &Video_menuTexId);
+        glBindTexture(GL_TEXTURE_2D, Video_menuTexId);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, newW, newH, 0, GL_RED, GL_UNSIGNED_BYTE, Video_menuBuffer.sdlSurface->pixels);
+    }
+#endif
+
+    // Added: texture was just recreated from the whole buffer
+    stdDisplay_numMenuDirtyRects = 0;
     
     Video_bModeSet = 1;
     
@@ -201,6 +315,7 @@ int stdDisplay_SetMasterPalette(uint8_t* pal)
     rdColor24* pal24 = (rdColor24*)pal;
     
     memcpy(stdDisplay_masterPalette, pal24, sizeof(stdDisplay_masterPalette));
+    stdDisplay_paletteGeneration++; // Added
     
     SDL_Color* tmp = malloc(sizeof(SDL_Color) * 256);
     for (int i = 0; i < 256; i++)
@@ -272,13 +387,98 @@ int stdDisplay_VBufferLock(stdVBuffer *buf)
 }
 
 void stdDisplay_VBufferUnlock(stdVBuffer *buf)
+{
+    stdDisplay_VBufferUnlockRect(buf, NULL);
+}
+
+// Added: Unlock which only marks `rect` as written, NULL for the whole buffer
+void stdDisplay_VBufferUnlockRect(stdVBuffer *buf, const rdRect *rect)
 {
     if (!buf) return;
     
+    stdDisplay_VBufferMarkDirty(buf, rect);
     buf->surface_lock_alloc = NULL;
     SDL_UnlockSurface(buf->sdlSurface);
 }
 
+static void stdDisplay_ApplyPalette(stdVBuffer *vbuf)
+{
+    rdColor24* pal24 = vbuf->palette;
+    SDL_Color tmp[256];
+
+    for (int i = 0; i < 256; i++)
+    {
+        tmp[i].r = pal24[i].r;
+        tmp[i].g = pal24[i].g;
+        tmp[i].b = pal24[i].b;
+        tmp[i].a = 0xFF;
+    }
+
+    SDL_SetPaletteColors(vbuf->sdlSurface->format->palette, tmp, 0, 256);
+}
+
+// Copies pixels which aren't `key`. Only safe to run forwards when pDst
+// doesn't overlap pSrc from above.
+static void stdDisplay_CopyRowKeyed8(uint8_t *pDst, const uint8_t *pSrc, int width, uint8_t key)
+{
+    int i = 0;
+
+#if defined(STDDISPLAY_SSE2)
+    __m128i vKey = _mm_set1_epi8((char)key);
+    for (; i + 16 <= width; i += 16)
+    {
+        __m128i src = _mm_loadu_si128((const __m128i*)(pSrc + i));
+        __m128i dst = _mm_loadu_si128((const __m128i*)(pDst + i));
+        __m128i mask = _mm_cmpeq_epi8(src, vKey);
+        _mm_storeu_si128((__m128i*)(pDst + i), _mm_or_si128(_mm_and_si128(mask, dst), _mm_andnot_si128(mask, src)));
+    }
+#elif defined(STDDISPLAY_NEON)
+    uint8x16_t vKey = vdupq_n_u8(key);
+    for (; i + 16 <= width; i += 16)
+    {
+        uint8x16_t src = vld1q_u8(pSrc + i);
+        uint8x16_t dst = vld1q_u8(pDst + i);
+        vst1q_u8(pDst + i, vbslq_u8(vceqq_u8(src, vKey), dst, src));
+    }
+#endif
+
+    for (; i < width; i++)
+    {
+        if (pSrc[i] != key)
+            pDst[i] = pSrc[i];
+    }
+}
+
+static void stdDisplay_CopyRowKeyed16(uint16_t *pDst, const uint16_t *pSrc, int width, uint16_t key)
+{
+    int i = 0;
+
+#if defined(STDDISPLAY_SSE2)
+    __m128i vKey = _mm_set1_epi16((short)key);
+    for (; i + 8 <= width; i += 8)
+    {
+        __m128i src = _mm_loadu_si128((const __m128i*)(pSrc + i));
+        __m128i dst = _mm_loadu_si128((const __m128i*)(pDst + i));
+        __m128i mask = _mm_cmpeq_epi16(src, vKey);
+        _mm_storeu_si128((__m128i*)(pDst + i), _mm_or_si128(_mm_and_si128(mask, dst), _mm_andnot_si128(mask, src)));
+    }
+#elif defined(STDDISPLAY_NEON)
+    uint16x8_t vKey = vdupq_n_u16(key);
+    for (; i + 8 <= width; i += 8)
+    {
+        uint16x8_t src = vld1q_u16(pSrc + i);
+        uint16x8_t dst = vld1q_u16(pDst + i);
+        vst1q_u16(pDst + i, vbslq_u16(vceqq_u16(src, vKey), dst, src));
+    }
+#endif
+
+    for (; i < width; i++)
+    {
+        if (pSrc[i] != key)
+            pDst[i] = pSrc[i];
+    }
+}
+
 int stdDisplay_VBufferCopy(stdVBuffer *vbuf, stdVBuffer *vbuf2, unsigned int blit_x, int blit_y, rdRect *rect, int alpha_maybe)
 {
     if (!vbuf || !vbuf2) return 1;
@@ -287,112 +487,90 @@ int stdDisplay_VBufferCopy(stdVBuffer *vbuf, stdVBuffer *vbuf2, unsigned int bli
     if (!rect)
     {
         rect = &fallback;
-        //memcpy(vbuf->sdlSurface->pixels, vbuf2->sdlSurface->pixels, 640*480);
-        //return;
     }
     
     //if (vbuf == &Video_menuBuffer)
     //    printf("Vbuffer copy to menu %u,%u %ux%u %u,%u\n", rect->x, rect->y, rect->width, rect->height, blit_x, blit_y);
     
     if (vbuf->palette)
-    {
-        rdColor24* pal24 = vbuf->palette;
-        SDL_Color* tmp = malloc(sizeof(SDL_Color) * 256);
-        for (int i = 0; i < 256; i++)
-        {
-            tmp[i].r = pal24[i].r;
-            tmp[i].g = pal24[i].g;
-            tmp[i].b = pal24[i].b;
-            tmp[i].a = 0xFF;
-        }
-    
-        SDL_SetPaletteColors(vbuf->sdlSurface->format->palette, tmp, 0, 256);
-        free(tmp);
-    }
-    
+        stdDisplay_ApplyPalette(vbuf);
     if (vbuf2->palette)
-    {
-        rdColor24* pal24 = vbuf2->palette;
-        SDL_Color* tmp = malloc(sizeof(SDL_Color) * 256);
-        for (int i = 0; i < 256; i++)
-        {
-            tmp[i].r = pal24[i].r;
-            tmp[i].g = pal24[i].g;
-            tmp[i].b = pal24[i].b;
-            tmp[i].a = 0xFF;
-        }
-        
-        SDL_SetPaletteColors(vbuf2->sdlSurface->format->palette, tmp, 0, 256);
-        free(tmp);
-    }
-
-    SDL_Rect dstRect = {blit_x, blit_y, rect->width, rect->height};
-    SDL_Rect srcRect = {rect->x, rect->y, rect->width, rect->height};
-    
-    uint8_t* srcPixels = vbuf2->sdlSurface->pixels;
-    uint8_t* dstPixels = vbuf->sdlSurface->pixels;
+        stdDisplay_ApplyPalette(vbuf2);
+
+    // Clip once against both buffers instead of per pixel
+    int srcX = rect->x;
+    int srcY = rect->y;
+    int dstX = (int)blit_x;
+    int dstY = blit_y;
+    int width = rect->width;
+    int height = rect->height;
+
+    if (srcX < 0) { dstX -= srcX; width += srcX; srcX = 0; }
+    if (srcY < 0) { dstY -= srcY; height += srcY; srcY = 0; }
+    if (dstX < 0) { srcX -= dstX; width += dstX; dstX = 0; }
+    if (dstY < 0) { srcY -= dstY; height += dstY; dstY = 0; }
+    if (width > (int)vbuf2->format.width - srcX) width = vbuf2->format.width - srcX;
+    if (height > (int)vbuf2->format.height - srcY) height = vbuf2->format.height - srcY;
+    if (width > (int)vbuf->format.width - dstX) width = vbuf->format.width - dstX;
+    if (height > (int)vbuf->format.height - dstY) height = vbuf->format.height - dstY;
+    if (width <= 0 || height <= 0)
+        return 1;
+
+    rdRect dirtyRect = {dstX, dstY, width, height};
+    stdDisplay_VBufferMarkDirty(vbuf, &dirtyRect); // Added
+
+    int bytesPerPixel = (vbuf->format.format.bpp == 16 && vbuf2->format.format.bpp == 16) ? 2 : 1;
+    int has_alpha = !(rect->width == 640) && (alpha_maybe & 1);
     uint32_t srcStride = vbuf2->format.width_in_bytes;
     uint32_t dstStride = vbuf->format.width_in_bytes;
-
-    int self_copy = 0;
-
-    if (dstPixels == srcPixels)
+    const uint8_t* srcPixels = (const uint8_t*)vbuf2->sdlSurface->pixels + (srcY * srcStride) + (srcX * bytesPerPixel);
+    uint8_t* dstPixels = (uint8_t*)vbuf->sdlSurface->pixels + (dstY * dstStride) + (dstX * bytesPerPixel);
+
+    // Copies within one buffer go bottom-up when moving down, so no source row
+    // is overwritten before it's read. Keyed rows moving right within a row
+    // can't use the forward SIMD loop.
+    int self_copy = (vbuf->sdlSurface->pixels == vbuf2->sdlSurface->pixels);
+    int rowStep = 1;
+    if (self_copy && dstY > srcY)
     {
-        size_t buf_len = srcStride * dstRect.w * dstRect.h;
-        uint8_t* dstPixels = malloc(buf_len);
-        int has_alpha = 0;//!(rect->width == 640);
-
-        SDL_Rect dstRect_inter = {0, 0, rect->width, rect->height};
+        srcPixels += (height - 1) * srcStride;
+        dstPixels += (height - 1) * dstStride;
+        rowStep = -1;
+    }
 
-        for (int i = 0; i < rect->width; i++)
+    for (int j = 0; j < height; j++)
+    {
+        if (!has_alpha)
+        {
+            memmove(dstPixels, srcPixels, width * bytesPerPixel);
+        }
+        else if (self_copy && dstY == srcY && dstX > srcX)
         {
-            for (int j = 0; j < rect->height; j++)
+            for (int i = width - 1; i >= 0; i--)
             {
-                if ((uint32_t)(i + srcRect.x) > (uint32_t)vbuf2->format.width) continue;
-                if ((uint32_t)(j + srcRect.y) > (uint32_t)vbuf2->format.height) continue;
-                
-                uint8_t pixel = srcPixels[(i + srcRect.x) + ((j + srcRect.y)*srcStride)];
-
-                if (!pixel && has_alpha) continue;
-                if ((uint32_t)(i + dstRect_inter.x) > (uint32_t)vbuf->format.width) continue;
-                if ((uint32_t)(j + dstRect_inter.y) > (uint32_t)vbuf->format.height) continue;
-
-                dstPixels[(i + dstRect_inter.x) + ((j + dstRect_inter.y)*srcStride)] = pixel;
+                if (bytesPerPixel == 2)
+                {
+                    uint16_t pixel = ((const uint16_t*)srcPixels)[i];
+                    if (pixel)
+                        ((uint16_t*)dstPixels)[i] = pixel;
+                }
+                else if (srcPixels[i])
+                {
+                    dstPixels[i] = srcPixels[i];
+                }
             }
         }
-        
-        
-
-        srcPixels = dstPixels;
-        srcRect.x = 0;
-        srcRect.y = 0;
-
-        self_copy = 1;
-    }
-    
-    int once = 0;
-    int has_alpha = !(rect->width == 640) && (alpha_maybe & 1);
-    
-    for (int i = 0; i < rect->width; i++)
-    {
-        for (int j = 0; j < rect->height; j++)
+        else if (bytesPerPixel == 2)
         {
-            if ((uint32_t)(i + srcRect.x) > (uint32_t)vbuf2->format.width) continue;
-            if ((uint32_t)(j + srcRect.y) > (uint32_t)vbuf2->format.height) continue;
-            
-            uint8_t pixel = srcPixels[(i + srcRect.x) + ((j + srcRect.y)*srcStride)];
-
-            if (!pixel && has_alpha) continue;
-            if ((uint32_t)(i + dstRect.x) > (uint32_t)vbuf->format.width) continue;
-            if ((uint32_t)(j + dstRect.y) > (uint32_t)vbuf->format.height) continue;
-
-            dstPixels[(i + dstRect.x) + ((j + dstRect.y)*dstStride)] = pixel;
+            stdDisplay_CopyRowKeyed16((uint16_t*)dstPixels, (const uint16_t*)srcPixels, width, 0);
+        }
+        else
+        {
+            stdDisplay_CopyRowKeyed8(dstPixels, srcPixels, width, 0);
         }
-    }
 
-    if (self_copy)
-    {
-        free(srcPixels);
+        srcPixels += rowStep * (intptr_t)srcStride;
+        dstPixels += rowStep * (intptr_t)dstStride;
     }
     
     //SDL_BlitSurface(vbuf2->sdlSurface, &srcRect, vbuf->sdlSurface, &dstRect); //TODO error check
@@ -411,6 +589,7 @@ int stdDisplay_VBufferFill(stdVBuffer *vbuf, int fillColor, rdRect *rect)
     //    printf("Vbuffer fill to menu %u,%u %ux%u\n", rect->x, rect->y, rect->width, rect->height);
 
     SDL_Rect dstRect = {rect->x, rect->y, rect->width, rect->height};
+    stdDisplay_VBufferMarkDirty(vbuf, rect); // Added
     
     //printf("%x; %u %u %u %u\n", fillColor, rect->x, rect->y, rect->width, rect->height);
     
@@ -77,8 +77,11 @@ static void (*stdDisplay_ddraw_surface_flip2)() = (void*)stdDisplay_ddraw_surfac
 static void (*stdDisplay_RestoreDisplayMode)() = (void*)stdDisplay_RestoreDisplayMode_ADDR;
 static stdVBuffer* (*stdDisplay_VBufferConvertColorFormat)(void* a, stdVBuffer* b) = (void*)stdDisplay_VBufferConvertColorFormat_ADDR;
 #else
+#define STDDISPLAY_MAX_DIRTY_RECTS (16)
+
 extern uint32_t Video_menuTexId;
 extern rdColor24 stdDisplay_masterPalette[256];
+extern uint32_t stdDisplay_paletteGeneration; // Added: bumped whenever stdDisplay_masterPalette is written
 
 int stdDisplay_Startup();
 int stdDisplay_VBufferFill(stdVBuffer *a2, int fillColor, rdRect *a4);
@@ -95,6 +98,9 @@ void stdDisplay_Close();
 stdVBuffer* stdDisplay_VBufferNew(stdVBufferTexFmt *a1, int create_ddraw_surface, int gpu_mem, int is_paletted);
 int stdDisplay_VBufferLock(stdVBuffer *a1);
 void stdDisplay_VBufferUnlock(stdVBuffer *a1);
+void stdDisplay_VBufferUnlockRect(stdVBuffer *buf, const rdRect *rect); // Added
+void stdDisplay_VBufferMarkDirty(stdVBuffer *vbuf, const rdRect *rect); // Added
+int stdDisplay_TakeMenuDirtyRects(rdRect *aOut); // Added: aOut holds STDDISPLAY_MAX_DIRTY_RECTS
 int stdDisplay_VBufferSetColorKey(stdVBuffer *vbuf, int color);
 void stdDisplay_VBufferFree(stdVBuffer *vbuf);
 void stdDisplay_ddraw_surface_flip2();
@@ -37,6 +37,15 @@ int jkPlayer_enableTextureFilter = 0;
 int jkPlayer_enableOrigAspect = 0;
 int jkPlayer_fpslimit = 0;
 int jkPlayer_enableVsync = 0;
+int jkPlayer_enableStaticGeometry = 0;
+int jkPlayer_enableSoftwareRender = 0;
+int jkPlayer_textureBudgetMb = TEXTURE_BUDGET_DEFAULT;
+int jkPlayer_maxDynamicLights = DYNAMIC_LIGHTS_DEFAULT;
+int jkPlayer_enableInstancing = 0;
+int jkPlayer_enableParallelPoses = 0;
+int jkPlayer_enableCollisionGrid = 0;
+int jkPlayer_simRate = 0;
+int jkPlayer_enableSoundCulling = 0;
 #endif
 
 int jkPlayer_LoadAutosave()
@@ -262,6 +271,15 @@ void jkPlayer_WriteConf(wchar_t *name)
         stdConffile_Printf("originalaspect %d\n", jkPlayer_enableOrigAspect);
         stdConffile_Printf("fpslimit %d\n", jkPlayer_fpslimit);
         stdConffile_Printf("enablevsync %d\n", jkPlayer_enableVsync);
+        stdConffile_Printf("staticgeometry %d\n", jkPlayer_enableStaticGeometry);
+        stdConffile_Printf("softwarerender %d\n", jkPlayer_enableSoftwareRender);
+        stdConffile_Printf("texturebudget %d\n", jkPlayer_textureBudgetMb);
+        stdConffile_Printf("dynamiclights %d\n", jkPlayer_maxDynamicLights);
+        stdConffile_Printf("instancedmodels %d\n", jkPlayer_enableInstancing);
+        stdConffile_Printf("parallelposes %d\n", jkPlayer_enableParallelPoses);
+        stdConffile_Printf("collisiongrid %d\n", jkPlayer_enableCollisionGrid);
+        stdConffile_Printf("simrate %d\n", jkPlayer_simRate);
+        stdConffile_Printf("soundculling %d\n", jkPlayer_enableSoundCulling);
 #endif
         stdConffile_CloseWrite();
     }
@@ -375,6 +393,69 @@ int jkPlayer_ReadConf(wchar_t *name)
             _sscanf(stdConffile_aLine, "enablevsync %d", &jkPlayer_enableVsync);
             jkPlayer_enableVsync = !!jkPlayer_enableVsync;
         }
+
+        if (stdConffile_ReadLine())
+        {
+            _sscanf(stdConffile_aLine, "staticgeometry %d", &jkPlayer_enableStaticGeometry);
+            jkPlayer_enableStaticGeometry = !!jkPlayer_enableStaticGeometry;
+        }
+
+        if (stdConffile_ReadLine())
+        {
+            _sscanf(stdConffile_aLine, "softwarerender %d", &jkPlayer_enableSoftwareRender);
+            jkPlayer_enableSoftwareRender = !!jkPlayer_enableSoftwareRender;
+        }
+
+        if (stdConffile_ReadLine())
+        {
+            _sscanf(stdConffile_aLine, "texturebudget %d", &jkPlayer_textureBudgetMb);
+            if (jkPlayer_textureBudgetMb < TEXTURE_BUDGET_MIN)
+                jkPlayer_textureBudgetMb = TEXTURE_BUDGET_MIN;
+        }
+
+        if (stdConffile_ReadLine())
+        {
+            _sscanf(stdConffile_aLine, "dynamiclights %d", &jkPlayer_maxDynamicLights);
+            if (jkPlayer_maxDynamicLights < DYNAMIC_LIGHTS_MIN)
+                jkPlayer_maxDynamicLights = DYNAMIC_LIGHTS_MIN;
+            else if (jkPlayer_maxDynamicLights > DYNAMIC_LIGHTS_MAX)
+                jkPlayer_maxDynamicLights = DYNAMIC_LIGHTS_MAX;
+        }
+
+        if (stdConffile_ReadLine())
+        {
+            _sscanf(stdConffile_aLine, "instancedmodels %d", &jkPlayer_enableInstancing);
+            jkPlayer_enableInstancing = !!jkPlayer_enableInstancing;
+        }
+
+        if (stdConffile_ReadLine())
+        {
+            _sscanf(stdConffile_aLine, "parallelposes %d", &jkPlayer_enableParallelPoses);
+            jkPlayer_enableParallelPoses = !!jkPlayer_enableParallelPoses;
+        }
+
+        if (stdConffile_ReadLine())
+        {
+            _sscanf(stdConffile_aLine, "collisiongrid %d", &jkPlayer_enableCollisionGrid);
+            jkPlayer_enableCollisionGrid = !!jkPlayer_enableCollisionGrid;
+        }
+
+        if (stdConffile_ReadLine())
+        {
+            _sscanf(stdConffile_aLine, "simrate %d", &jkPlayer_simRate);
+            if (jkPlayer_simRate <= 0)
+                jkPlayer_simRate = 0;
+            else if (jkPlayer_simRate < SIM_RATE_MIN)
+                jkPlayer_simRate = SIM_RATE_MIN;
+            else if (jkPlayer_simRate > SIM_RATE_MAX)
+                jkPlayer_simRate = SIM_RATE_MAX;
+        }
+
+        if (stdConffile_ReadLine())
+        {
+            _sscanf(stdConffile_aLine, "soundculling %d", &jkPlayer_enableSoundCulling);
+            jkPlayer_enableSoundCulling = !!jkPlayer_enableSoundCulling;
+        }
 #endif
         stdConffile_Close();
         return 1;
@@ -415,13 +496,20 @@ void jkPlayer_DrawPov()
 {
     rdVector3 trans;
     rdMatrix34 viewMat;
+    float frameSeconds = sithTime_deltaSeconds;
 
     if (!playerThings[playerThingIdx].povModel.model3)
         return;
 
+#ifdef QOL_IMPROVEMENTS
+    // Added: this runs once per drawn frame, while fixed steps can run zero or several times
+    if ( sithTime_fixedHz )
+        frameSeconds = sithTime_frameSeconds;
+#endif
+
     if ( playerThings[playerThingIdx].povModel.puppet )
     {
-        rdPuppet_UpdateTracks(playerThings[playerThingIdx].povModel.puppet, sithTime_deltaSeconds);
+        rdPuppet_UpdateTracks(playerThings[playerThingIdx].povModel.puppet, frameSeconds);
     }
 
     if ( !(sithCamera_currentCamera->cameraPerspective & 0xFC) && sithCamera_currentCamera->primaryFocus == sithWorld_pCurrentWorld->cameraFocus )
@@ -432,7 +520,7 @@ void jkPlayer_DrawPov()
 #ifndef QOL_IMPROVEMENTS
         float waggleAmt = (fabs(player->waggle) > 0.02 ? 0.02 : fabs(player->waggle)) * jkPlayer_waggleMag;
 #else
-        float waggleAmt = (fabs(player->waggle) > sithTime_deltaSeconds ? sithTime_deltaSeconds : fabs(player->waggle)) * jkPlayer_waggleMag; // scale animation to be in line w/ 50fps og limit
+        float waggleAmt = (fabs(player->waggle) > frameSeconds ? frameSeconds : fabs(player->waggle)) * jkPlayer_waggleMag; // scale animation to be in line w/ 50fps og limit
 #endif
         if ( waggleAmt == 0.0 )
             jkPlayer_waggleAngle = 0.0;
@@ -120,12 +120,31 @@ extern int jkPlayer_enableTextureFilter;
 extern int jkPlayer_enableOrigAspect;
 extern int jkPlayer_fpslimit;
 extern int jkPlayer_enableVsync;
+extern int jkPlayer_enableStaticGeometry;
+extern int jkPlayer_enableSoftwareRender;
+extern int jkPlayer_textureBudgetMb;
+extern int jkPlayer_maxDynamicLights;
+extern int jkPlayer_enableInstancing;
+extern int jkPlayer_enableParallelPoses;
+extern int jkPlayer_enableCollisionGrid;
+extern int jkPlayer_simRate;
+extern int jkPlayer_enableSoundCulling;
 
 #define FOV_MIN (40)
 #define FOV_MAX (170)
 
 #define FPS_LIMIT_MIN (0)
 #define FPS_LIMIT_MAX (360)
+
+#define TEXTURE_BUDGET_MIN (16)
+#define TEXTURE_BUDGET_DEFAULT (256)
+
+#define DYNAMIC_LIGHTS_MIN (1)
+#define DYNAMIC_LIGHTS_MAX (64)
+#define DYNAMIC_LIGHTS_DEFAULT (32)
+
+#define SIM_RATE_MIN (10) // 0 ticks the simulation once a frame
+#define SIM_RATE_MAX (500)
 #endif
 
 //static void (*jkPlayer_InitThings)() = (void*)jkPlayer_InitThings_ADDR;
@@ -0,0 +1,355 @@
+#include "sithPVS.h"
+
+#include "World/sithWorld.h"
+#include "Engine/sithAdjoin.h"
+#include "General/stdFnames.h"
+#include "General/stdFileUtil.h"
+#include "stdPlatform.h"
+#include "Win95/DebugConsole.h"
+#include "jk.h"
+
+// A sector is potentially visible from another if there is a chain of adjoins
+// between them that a straight line could pass through. A line which crosses a
+// portal stays on the far side of that portal's plane, so every portal further
+// down the chain must reach past the planes of all portals before it, and all
+// earlier portals must reach in front of its plane. Adjoin flags are ignored
+// since cogs can change them at runtime.
+//
+// Walking every chain is exponential in the worst case, so each source sector
+// gets a step budget. When it runs out the sector falls back to a search that
+// only checks pairs of portals, which is never wrong, just less tight.
+
+#define SITHPVS_MAGIC        (0x31535650) // "PVS1"
+#define SITHPVS_MAX_DEPTH    (32)
+#define SITHPVS_STEP_BUDGET  (0x1000)
+#define SITHPVS_EPSILON      (0.001)
+
+typedef struct sithPVSHeader
+{
+    uint32_t magic;
+    uint32_t numSectors;
+    uint32_t checksum;
+} sithPVSHeader;
+
+static sithWorld* sithPVS_pWorld = NULL;
+static uint32_t* sithPVS_aBits = NULL;
+static int sithPVS_numSectors = 0;
+static int sithPVS_stride = 0;
+
+static int sithPVS_steps;
+static int sithPVS_bOverflow;
+
+#define SITHPVS_ROW(idx) (&sithPVS_aBits[(idx) * sithPVS_stride])
+#define SITHPVS_TEST(row, idx) ((row)[(idx) >> 5] & (1u << ((idx) & 31)))
+#define SITHPVS_SET(row, idx) ((row)[(idx) >> 5] |= (1u << ((idx) & 31)))
+
+static uint32_t sithPVS_Hash(uint32_t hash, const void* data, size_t len)
+{
+    const uint8_t* p = (const uint8_t*)data;
+    for (size_t i = 0; i < len; i++)
+    {
+        hash ^= p[i];
+        hash *= 16777619;
+    }
+    return hash;
+}
+
+// Covers everything the sets are derived from, so a stale cache is rebuilt
+static uint32_t sithPVS_CalcChecksum(sithWorld *world)
+{
+    uint32_t hash = 2166136261u;
+
+    hash = sithPVS_Hash(hash, &world->numSectors, sizeof(world->numSectors));
+    for (int i = 0; i < world->numSectors; i++)
+    {
+        for (sithAdjoin* adjoin = world->sectors[i].adjoins; adjoin; adjoin = adjoin->next)
+        {
+            rdFace* face = &adjoin->surface->surfaceInfo.face;
+            int target = adjoin->sector ? adjoin->sector - world->sectors : -1;
+
+            hash = sithPVS_Hash(hash, &target, sizeof(target));
+            for (int j = 0; j < face->numVertices; j++)
+                hash = sithPVS_Hash(hash, &world->vertices[face->vertexPosIdx[j]], sizeof(rdVector3));
+        }
+    }
+    return hash;
+}
+
+static void sithPVS_GetCachePath(sithWorld *world, char *out, int outLen)
+{
+    char fname[64];
+
+    stdFnames_CopyMedName(fname, sizeof(fname), world->map_jkl_fname);
+    stdFnames_ChangeExt(fname, "pvs");
+    stdFnames_MakePath(out, outLen, "pvs", fname);
+}
+
+static int sithPVS_LoadCache(sithWorld *world, uint32_t checksum)
+{
+    char path[128];
+    sithPVSHeader header;
+    stdFile_t fhand;
+    size_t size = sizeof(uint32_t) * sithPVS_stride * sithPVS_numSectors;
+    int ret = 0;
+
+    sithPVS_GetCachePath(world, path, sizeof(path));
+    fhand = std_pHS->fileOpen(path, "rb");
+    if ( !fhand )
+        return 0;
+
+    if ( std_pHS->fileRead(fhand, &header, sizeof(header)) == sizeof(header)
+      && header.magic == SITHPVS_MAGIC
+      && header.numSectors == sithPVS_numSectors
+      && header.checksum == checksum )
+    {
+        ret = std_pHS->fileRead(fhand, sithPVS_aBits, size) == size;
+    }
+    std_pHS->fileClose(fhand);
+    return ret;
+}
+
+static void sithPVS_WriteCache(sithWorld *world, uint32_t checksum)
+{
+    char path[128];
+    sithPVSHeader header;
+    stdFile_t fhand;
+
+    stdFileUtil_MkDir("pvs");
+    sithPVS_GetCachePath(world, path, sizeof(path));
+    fhand = std_pHS->fileOpen(path, "wb");
+    if ( !fhand )
+        return;
+
+    header.magic = SITHPVS_MAGIC;
+    header.numSectors = sithPVS_numSectors;
+    header.checksum = checksum;
+    std_pHS->fileWrite(fhand, &header, sizeof(header));
+    std_pHS->fileWrite(fhand, sithPVS_aBits, sizeof(uint32_t) * sithPVS_stride * sithPVS_numSectors);
+    std_pHS->fileClose(fhand);
+}
+
+// Nonzero if any vertex of portal lies on the side of plane's surface selected by sign
+static int sithPVS_PortalReaches(sithWorld *world, sithAdjoin *portal, sithAdjoin *plane, float sign)
+{
+    rdFace* face = &portal->surface->surfaceInfo.face;
+    rdFace* planeFace = &plane->surface->surfaceInfo.face;
+    rdVector3* origin = &world->vertices[planeFace->vertexPosIdx[0]];
+
+    for (int i = 0; i < face->numVertices; i++)
+    {
+        rdVector3* v = &world->vertices[face->vertexPosIdx[i]];
+        float dist = (v->x - origin->x) * planeFace->normal.x
+                   + (v->y - origin->y) * planeFace->normal.y
+                   + (v->z - origin->z) * planeFace->normal.z;
+        if ( dist * sign > -SITHPVS_EPSILON )
+            return 1;
+    }
+    return 0;
+}
+
+static void sithPVS_Walk(sithWorld *world, uint32_t *row, sithAdjoin **aPath, int depth)
+{
+    sithAdjoin* last = aPath[depth - 1];
+
+    SITHPVS_SET(row, last->sector - world->sectors);
+
+    if ( depth >= SITHPVS_MAX_DEPTH || ++sithPVS_steps > SITHPVS_STEP_BUDGET )
+    {
+        sithPVS_bOverflow = 1;
+        return;
+    }
+
+    for (sithAdjoin* adjoin = last->sector->adjoins; adjoin; adjoin = adjoin->next)
+    {
+        int k;
+
+        if ( !adjoin->sector || !adjoin->surface->surfaceInfo.face.numVertices )
+            continue;
+
+        for (k = 0; k < depth; k++)
+        {
+            // Surface normals point into their sector, so passing through
+            // aPath[k] means ending up behind it, and adjoin's own sector is
+            // in front of it.
+            if ( aPath[k] == adjoin || aPath[k] == adjoin->mirror )
+                break;
+            if ( !sithPVS_PortalReaches(world, adjoin, aPath[k], -1.0) )
+                break;
+            if ( !sithPVS_PortalReaches(world, aPath[k], adjoin, 1.0) )
+                break;
+        }
+        if ( k != depth )
+            continue;
+
+        aPath[depth] = adjoin;
+        sithPVS_Walk(world, row, aPath, depth + 1);
+        if ( sithPVS_bOverflow )
+            return;
+    }
+}
+
+// Fallback once the budget runs out. Only the first portal and the one just
+// passed are checked, so the state is a single adjoin and a breadth first
+// search over adjoins finds a superset of what the full walk would.
+static void sithPVS_WalkWide(sithWorld *world, uint32_t *row, sithAdjoin *first, sithAdjoin **aQueue, int *aVisited, int stamp)
+{
+    int numQueued = 0;
+
+    aQueue[numQueued++] = first;
+    aVisited[first - world->adjoins] = stamp;
+
+    while ( numQueued )
+    {
+        sithAdjoin* last = aQueue[--numQueued];
+
+        SITHPVS_SET(row, last->sector - world->sectors);
+        for (sithAdjoin* adjoin = last->sector->adjoins; adjoin; adjoin = adjoin->next)
+        {
+            int idx = adjoin - world->adjoins;
+
+            if ( !adjoin->sector || !adjoin->surface->surfaceInfo.face.numVertices )
+                continue;
+            if ( aVisited[idx] == stamp || adjoin == last->mirror || adjoin == first->mirror )
+                continue;
+            if ( !sithPVS_PortalReaches(world, adjoin, first, -1.0) || !sithPVS_PortalReaches(world, first, adjoin, 1.0) )
+                continue;
+            if ( !sithPVS_PortalReaches(world, adjoin, last, -1.0) || !sithPVS_PortalReaches(world, last, adjoin, 1.0) )
+                continue;
+
+            aVisited[idx] = stamp;
+            aQueue[numQueued++] = adjoin;
+        }
+    }
+}
+
+int sithPVS_Build(sithWorld *world)
+{
+    sithAdjoin* aPath[SITHPVS_MAX_DEPTH];
+    uint32_t checksum;
+    sithAdjoin** aQueue;
+    int* aVisited;
+    int stamp = 0;
+    int numWidened = 0;
+    int startMsecs;
+    char tmp[128];
+
+    sithPVS_Free(sithPVS_pWorld);
+
+    if ( world->numSectors <= 0 )
+        return 1;
+
+    sithPVS_numSectors = world->numSectors;
+    sithPVS_stride = (world->numSectors + 31) / 32;
+    sithPVS_aBits = (uint32_t*)pSithHS->alloc(sizeof(uint32_t) * sithPVS_stride * sithPVS_numSectors);
+    if ( !sithPVS_aBits )
+        return 0;
+    sithPVS_pWorld = world;
+
+    startMsecs = stdPlatform_GetTimeMsec();
+    checksum = sithPVS_CalcChecksum(world);
+    if ( sithPVS_LoadCache(world, checksum) )
+        return 1;
+
+    aQueue = (sithAdjoin**)pSithHS->alloc(sizeof(sithAdjoin*) * world->numAdjoins);
+    aVisited = (int*)pSithHS->alloc(sizeof(int) * world->numAdjoins);
+    if ( !aQueue || !aVisited )
+    {
+        if ( aQueue )
+            pSithHS->free(aQueue);
+        if ( aVisited )
+            pSithHS->free(aVisited);
+        sithPVS_Free(world);
+        return 0;
+    }
+    _memset(aVisited, 0, sizeof(int) * world->numAdjoins);
+
+    _memset(sithPVS_aBits, 0, sizeof(uint32_t) * sithPVS_stride * sithPVS_numSectors);
+    for (int i = 0; i < world->numSectors; i++)
+    {
+        uint32_t* row = SITHPVS_ROW(i);
+
+        SITHPVS_SET(row, i);
+        sithPVS_steps = 0;
+        sithPVS_bOverflow = 0;
+        for (sithAdjoin* adjoin = world->sectors[i].adjoins; adjoin; adjoin = adjoin->next)
+        {
+            if ( !adjoin->sector )
+                continue;
+
+            aPath[0] = adjoin;
+            sithPVS_Walk(world, row, aPath, 1);
+            if ( sithPVS_bOverflow )
+                break;
+        }
+
+        if ( sithPVS_bOverflow )
+        {
+            for (sithAdjoin* adjoin = world->sectors[i].adjoins; adjoin; adjoin = adjoin->next)
+            {
+                if ( adjoin->sector && adjoin->surface->surfaceInfo.face.numVertices )
+                    sithPVS_WalkWide(world, row, adjoin, aQueue, aVisited, ++stamp);
+            }
+            numWidened++;
+        }
+    }
+    pSithHS->free(aQueue);
+    pSithHS->free(aVisited);
+
+    sithPVS_WriteCache(world, checksum);
+
+    _sprintf(tmp, "%f seconds to build PVS for %d sectors, %d widened.\n", (double)(stdPlatform_GetTimeMsec() - startMsecs) * 0.001, world->numSectors, numWidened);
+    DebugConsole_Print(tmp);
+    return 1;
+}
+
+void sithPVS_Free(sithWorld *world)
+{
+    if ( !world || world != sithPVS_pWorld )
+        return;
+
+    if ( sithPVS_aBits )
+        pSithHS->free(sithPVS_aBits);
+
+    sithPVS_aBits = NULL;
+    sithPVS_pWorld = NULL;
+    sithPVS_numSectors = 0;
+    sithPVS_stride = 0;
+}
+
+static int sithPVS_GetIdx(sithSector *sector)
+{
+    int idx;
+
+    if ( !sector || !sithPVS_aBits || sithPVS_pWorld != sithWorld_pCurrentWorld )
+        return -1;
+
+    idx = sector - sithPVS_pWorld->sectors;
+    if ( idx < 0 || idx >= sithPVS_numSectors )
+        return -1;
+    return idx;
+}
+
+int sithPVS_IsVisible(sithSector *from, sithSector *to)
+{
+    int fromIdx = sithPVS_GetIdx(from);
+    int toIdx = sithPVS_GetIdx(to);
+
+    if ( fromIdx < 0 || toIdx < 0 )
+        return 1;
+
+    return SITHPVS_TEST(SITHPVS_ROW(fromIdx), toIdx) != 0;
+}
+
+// For things, which can poke into the sectors around the one they're in
+int sithPVS_IsNearVisible(sithSector *from, sithSector *to)
+{
+    if ( sithPVS_IsVisible(from, to) )
+        return 1;
+
+    for (sithAdjoin* adjoin = to->adjoins; adjoin; adjoin = adjoin->next)
+    {
+        if ( adjoin->sector && sithPVS_IsVisible(from, adjoin->sector) )
+            return 1;
+    }
+    return 0;
+}
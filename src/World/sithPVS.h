@@ -0,0 +1,15 @@
+#ifndef _SITHPVS_H
+#define _SITHPVS_H
+
+#include "types.h"
+#include "globals.h"
+
+// Added: Per-sector potentially visible sets built from the adjoin graph at
+// level load. Queries are conservative, anything not known to be hidden
+// (including every query when no PVS is loaded) reports visible.
+int sithPVS_Build(sithWorld *world);
+void sithPVS_Free(sithWorld *world);
+int sithPVS_IsVisible(sithSector *from, sithSector *to);
+int sithPVS_IsNearVisible(sithSector *from, sithSector *to);
+
+#endif // _SITHPVS_H
@@ -14,6 +14,8 @@
 #include "World/sithTrackThing.h"
 #include "World/sithExplosion.h"
 #include "Engine/sithCollision.h"
+#include "Engine/sithCollisionGrid.h"
+#include "Engine/sithInterp.h"
 #include "World/sithUnk4.h"
 #include "Engine/sithSurface.h"
 #include "Engine/sithSoundSys.h"
@@ -38,6 +40,8 @@
 #include "stdPlatform.h"
 #include "jk.h"
 
+#include <string.h>
+
 #define NUM_THING_PARAMS (72)
 #define NUM_THING_TYPES (13)
 
@@ -135,6 +139,260 @@ const char* sithThing_aParams[NUM_THING_PARAMS] = {
     "fleshhit",
 };
 
+#ifdef QOL_IMPROVEMENTS
+// Added: Live things as a list of thing indices kept sorted by index, so
+// TickAll visits them in the same order as the old slot scan, plus a
+// thing_id -> thing index hash for GetById. Both are rebuilt by
+// sithThing_sub_4CCE60 once a level or save is loaded, and updated wherever
+// a thing is created or freed. Freed indices still go on sithNet_things.
+typedef struct sithThingIdHashEntry
+{
+    int thing_id;
+    int thingIdx;
+} sithThingIdHashEntry;
+
+static sithWorld* sithThing_pIndexWorld = NULL;
+static sithThing* sithThing_pIndexThings = NULL;
+static int* sithThing_aActive = NULL;
+static int sithThing_numActive = 0;
+static sithThingIdHashEntry* sithThing_aIdHash = NULL;
+static uint32_t sithThing_idHashMask = 0;
+static int sithThing_idHashCount = 0;
+
+static int sithThing_IsIndexed()
+{
+    return sithThing_pIndexWorld
+        && sithThing_pIndexWorld == sithWorld_pCurrentWorld
+        && sithThing_pIndexThings == sithWorld_pCurrentWorld->things;
+}
+
+static uint32_t sithThing_IdHashSlot(int thing_id)
+{
+    return ((uint32_t)thing_id * 2654435761u) & sithThing_idHashMask;
+}
+
+static int sithThing_IdHashFind(int thing_id)
+{
+    uint32_t slot = sithThing_IdHashSlot(thing_id);
+
+    while (sithThing_aIdHash[slot].thing_id >= 0)
+    {
+        if (sithThing_aIdHash[slot].thing_id == thing_id)
+            return sithThing_aIdHash[slot].thingIdx;
+        slot = (slot + 1) & sithThing_idHashMask;
+    }
+    return -1;
+}
+
+static void sithThing_IdHashRebuild();
+
+static void sithThing_IdHashInsert(int thing_id, int thingIdx)
+{
+    uint32_t slot;
+
+    if (thing_id < 0)
+        return;
+
+    slot = sithThing_IdHashSlot(thing_id);
+    while (sithThing_aIdHash[slot].thing_id >= 0)
+    {
+        if (sithThing_aIdHash[slot].thing_id == thing_id)
+        {
+            sithThing_aIdHash[slot].thingIdx = thingIdx;
+            return;
+        }
+        slot = (slot + 1) & sithThing_idHashMask;
+    }
+    sithThing_aIdHash[slot].thing_id = thing_id;
+    sithThing_aIdHash[slot].thingIdx = thingIdx;
+    sithThing_idHashCount++;
+
+    // Slots overwritten without being freed first (save restores) can leave
+    // stale ids behind, start over from the live things if it fills up
+    if (sithThing_idHashCount * 4 > (int)(sithThing_idHashMask + 1) * 3)
+        sithThing_IdHashRebuild();
+}
+
+static void sithThing_IdHashRemove(int thing_id, int thingIdx)
+{
+    uint32_t i, j, k;
+
+    if (thing_id < 0)
+        return;
+
+    i = sithThing_IdHashSlot(thing_id);
+    while (sithThing_aIdHash[i].thing_id != thing_id)
+    {
+        if (sithThing_aIdHash[i].thing_id < 0)
+            return;
+        i = (i + 1) & sithThing_idHashMask;
+    }
+    if (sithThing_aIdHash[i].thingIdx != thingIdx)
+        return;
+
+    // Shift the rest of the probe run back so lookups never need tombstones
+    sithThing_aIdHash[i].thing_id = -1;
+    sithThing_idHashCount--;
+    j = i;
+    while (1)
+    {
+        j = (j + 1) & sithThing_idHashMask;
+        if (sithThing_aIdHash[j].thing_id < 0)
+            break;
+
+        k = sithThing_IdHashSlot(sithThing_aIdHash[j].thing_id);
+        if (i <= j ? (i < k && k <= j) : (i < k || k <= j))
+            continue;
+
+        sithThing_aIdHash[i] = sithThing_aIdHash[j];
+        sithThing_aIdHash[j].thing_id = -1;
+        i = j;
+    }
+}
+
+static void sithThing_IdHashRebuild()
+{
+    sithThing* thing;
+
+    for (uint32_t i = 0; i <= sithThing_idHashMask; i++)
+        sithThing_aIdHash[i].thing_id = -1;
+    sithThing_idHashCount = 0;
+
+    for (int i = 0; i < sithThing_numActive; i++)
+    {
+        thing = &sithThing_pIndexThings[sithThing_aActive[i]];
+        sithThing_IdHashInsert(thing->thing_id, sithThing_aActive[i]);
+    }
+}
+
+// First position in the active list with an index >= thingIdx
+static int sithThing_ActiveLowerBound(int thingIdx)
+{
+    int lo = 0;
+    int hi = sithThing_numActive;
+
+    while (lo < hi)
+    {
+        int mid = (lo + hi) >> 1;
+        if (sithThing_aActive[mid] < thingIdx)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+void sithThing_AddActive(sithThing *thing)
+{
+    int idx, pos;
+
+    if (!sithThing_IsIndexed())
+        return;
+
+    idx = thing->thingIdx;
+    if (idx < 0 || idx >= sithWorld_pCurrentWorld->numThingsLoaded)
+        return;
+
+    pos = sithThing_ActiveLowerBound(idx);
+    if (pos >= sithThing_numActive || sithThing_aActive[pos] != idx)
+    {
+        memmove(&sithThing_aActive[pos + 1], &sithThing_aActive[pos], sizeof(int) * (sithThing_numActive - pos));
+        sithThing_aActive[pos] = idx;
+        sithThing_numActive++;
+    }
+    sithThing_IdHashInsert(thing->thing_id, idx);
+}
+
+// Must be called before thing_id is cleared
+static void sithThing_RemoveActive(sithThing *thing)
+{
+    int idx, pos;
+
+    if (!sithThing_IsIndexed())
+        return;
+
+    idx = thing->thingIdx;
+    pos = sithThing_ActiveLowerBound(idx);
+    if (pos < sithThing_numActive && sithThing_aActive[pos] == idx)
+    {
+        memmove(&sithThing_aActive[pos], &sithThing_aActive[pos + 1], sizeof(int) * (sithThing_numActive - pos - 1));
+        sithThing_numActive--;
+    }
+    sithThing_IdHashRemove(thing->thing_id, idx);
+}
+
+// Next live thing index after thingIdx for TickAll, pPos caches where
+// thingIdx sat in the list. Things created or freed mid-tick move entries
+// around, so the position is looked up again when it no longer matches.
+static int sithThing_NextActive(int thingIdx, int *pPos)
+{
+    int pos;
+
+    if (!sithThing_IsIndexed())
+        return thingIdx + 1;
+
+    pos = *pPos;
+    if (pos >= 0 && pos < sithThing_numActive && sithThing_aActive[pos] == thingIdx)
+        pos++;
+    else
+        pos = sithThing_ActiveLowerBound(thingIdx + 1);
+    *pPos = pos;
+
+    return pos < sithThing_numActive ? sithThing_aActive[pos] : -1;
+}
+
+static void sithThing_FreeIndex()
+{
+    if (sithThing_aActive)
+        pSithHS->free(sithThing_aActive);
+    if (sithThing_aIdHash)
+        pSithHS->free(sithThing_aIdHash);
+
+    sithThing_aActive = NULL;
+    sithThing_aIdHash = NULL;
+    sithThing_numActive = 0;
+    sithThing_idHashMask = 0;
+    sithThing_idHashCount = 0;
+    sithThing_pIndexWorld = NULL;
+    sithThing_pIndexThings = NULL;
+}
+
+static void sithThing_RebuildIndex()
+{
+    sithWorld* world = sithWorld_pCurrentWorld;
+    uint32_t hashSize = 16;
+
+    sithThing_FreeIndex();
+    if (!world || !world->things || world->numThingsLoaded <= 0)
+        return;
+
+    while (hashSize < (uint32_t)world->numThingsLoaded * 2)
+        hashSize <<= 1;
+
+    sithThing_aActive = (int*)pSithHS->alloc(sizeof(int) * world->numThingsLoaded);
+    sithThing_aIdHash = (sithThingIdHashEntry*)pSithHS->alloc(sizeof(sithThingIdHashEntry) * hashSize);
+    if (!sithThing_aActive || !sithThing_aIdHash)
+    {
+        // GetById and TickAll fall back to scanning every slot
+        sithThing_FreeIndex();
+        return;
+    }
+    sithThing_idHashMask = hashSize - 1;
+
+    for (int i = 0; i < world->numThingsLoaded; i++)
+    {
+        if (world->things[i].type)
+            sithThing_aActive[sithThing_numActive++] = i;
+    }
+
+    sithThing_pIndexWorld = world;
+    sithThing_pIndexThings = world->things;
+    sithThing_IdHashRebuild();
+}
+#else
+#define sithThing_RemoveActive(thing) do {} while (0)
+#endif
+
 int sithThing_Startup()
 {
     int v1; // edi
@@ -186,7 +444,13 @@ void sithThing_TickAll(float deltaSeconds, int deltaMs)
     if ( sithWorld_pCurrentWorld->numThings < 0 )
         return;
 
+#ifdef QOL_IMPROVEMENTS
+    // Added: only visit live things
+    int activePos = -1;
+    for (int i = sithThing_NextActive(-1, &activePos); i >= 0 && i < sithWorld_pCurrentWorld->numThings+1; i = sithThing_NextActive(i, &activePos))
+#else
     for (int i = 0; i < sithWorld_pCurrentWorld->numThings+1; i++)
+#endif
     {
         thingIter = &sithWorld_pCurrentWorld->things[i];
         if (!thingIter->type)
@@ -276,6 +540,7 @@ void sithThing_TickAll(float deltaSeconds, int deltaMs)
         rdThing_FreeEntry(&thingIter->rdthing);
         sithSoundSys_FreeThing(thingIter);
 
+        sithThing_RemoveActive(thingIter); // Added
         v7 = thingIter->thingIdx;
         thingIter->type = SITH_THING_FREE;
         v8 = sithWorld_pCurrentWorld->numThings;
@@ -379,6 +644,10 @@ void sithThing_sub_4CCE60()
             sithNet_things_idx++;
         }
     }
+
+#ifdef QOL_IMPROVEMENTS
+    sithThing_RebuildIndex(); // Added
+#endif
 }
 
 void sithThing_FreeEverything(sithThing *thing)
@@ -397,6 +666,7 @@ void sithThing_FreeEverything(sithThing *thing)
         sithPuppet_FreeEntry(thing);
     rdThing_FreeEntry(&thing->rdthing);
     sithSoundSys_FreeThing(thing);
+    sithThing_RemoveActive(thing); // Added
     thing->type = SITH_THING_FREE;
     thing->signature = 0;
     thing->thing_id = -1;
@@ -583,6 +853,14 @@ int sithThing_Load(sithWorld *world, int a2)
     int v38; // [esp+64h] [ebp+8h]
 
     sithThing_bInitted2 = 1;
+
+#ifdef QOL_IMPROVEMENTS
+    // Added: things may be reallocated, sithThing_sub_4CCE60 rebuilds the index
+    sithThing_FreeIndex();
+#endif
+    sithCollisionGrid_Reset(); // Added
+    sithInterp_Reset(); // Added
+
     if ( a2 && world->things )
     {
         for (v36 = 0; v36 < world->numThingsLoaded; v36++)
@@ -1095,6 +1373,7 @@ LABEL_38:
 void sithThing_SetPosAndRot(sithThing *this, rdVector3 *pos, rdMatrix34 *rot)
 {
     rdVector_Copy3(&this->position, pos);
+    sithCollisionGrid_UpdateThing(this); // Added
     rdMatrix_Copy34(&this->lookOrientation, rot);
     rdVector_Zero3(&this->lookOrientation.scale);
 }
@@ -1132,6 +1411,7 @@ void sithThing_LeaveSector(sithThing *thing)
     if ( !_memcmp(&pos, &thing->position, sizeof(rdVector3)) )
     {
 LABEL_5:
+        sithCollisionGrid_RemoveThing(thing); // Added
         prevThing = thing->prevThing;
         nextThing = thing->nextThing;
         if ( prevThing )
@@ -1173,6 +1453,7 @@ void sithThing_EnterSector(sithThing *thing, sithSector *sector, int a3, int a4)
     thing->prevThing = 0;
     sector->thingsList = thing;
     thing->sector = sector;
+    sithCollisionGrid_AddThing(thing); // Added
     if ( (v5 & SITH_SF_UNDERWATER) != 0 )
     {
         v6 = thing->attach_flags;
@@ -1425,6 +1706,7 @@ void sithThing_freestuff(sithWorld *world)
             sithPuppet_FreeEntry(thingIter);
         rdThing_FreeEntry(&thingIter->rdthing);
         sithSoundSys_FreeThing(thingIter);
+        sithThing_RemoveActive(thingIter); // Added
         v3 = sithWorld_pCurrentWorld;
         thingIter->type = SITH_THING_FREE;
         thingIter->signature = 0;
@@ -1461,6 +1743,14 @@ void sithThing_Free(sithWorld *world)
 
     sithThing_freestuff(world);
 
+#ifdef QOL_IMPROVEMENTS
+    // Added
+    if (world == sithThing_pIndexWorld)
+        sithThing_FreeIndex();
+#endif
+    sithCollisionGrid_Reset(); // Added
+    sithInterp_Reset(); // Added
+
     pSithHS->free(world->things);
     world->things = 0;
     world->numThingsLoaded = 0;
@@ -1630,6 +1920,9 @@ LABEL_24:
     if ( !v17 )
         return 0;
     sithThing_sub_4CD8A0(v17, templateThing);
+#ifdef QOL_IMPROVEMENTS
+    sithThing_AddActive(v17); // Added
+#endif
     v17->position = *position;
     _memcpy(&v17->lookOrientation, lookOrientation, sizeof(v17->lookOrientation));
     v17->lookOrientation.scale.x = 0.0;
@@ -1712,6 +2005,7 @@ void sithThing_FreeEverythingNet(sithThing *thing)
         sithPuppet_FreeEntry(thing);
     rdThing_FreeEntry(&thing->rdthing);
     sithSoundSys_FreeThing(thing);
+    sithThing_RemoveActive(thing); // Added
     v1 = sithWorld_pCurrentWorld;
     thing->type = SITH_THING_FREE;
     thing->signature = 0;
@@ -1900,7 +2194,10 @@ void sithThing_MoveToSector(sithThing *thing, sithSector *sector, int a4)
     if ( v3 )
     {
         if ( v3 == sector )
+        {
+            sithCollisionGrid_UpdateThing(thing); // Added: callers may have moved it
             return;
+        }
         sithThing_LeaveSector(thing);
     }
     sithThing_EnterSector(thing, sector, 0, a4);
@@ -2322,7 +2619,22 @@ sithThing* sithThing_GetById(int thing_id)
 
     if ( sithWorld_pCurrentWorld->numThings < 0 )
         return 0;
-    
+
+#ifdef QOL_IMPROVEMENTS
+    // Added: every live thing is in the id hash, a miss means it's gone
+    if (sithThing_IsIndexed())
+    {
+        int idx = sithThing_IdHashFind(thing_id);
+        if (idx < 0)
+            return NULL;
+
+        result = &sithWorld_pCurrentWorld->things[idx];
+        if (result->thing_id == thing_id && result->type != SITH_THING_FREE)
+            return result;
+        return NULL;
+    }
+#endif
+
     for (int i = 0; i < sithWorld_pCurrentWorld->numThings; i++)
     {
         sithThing* iter = &sithWorld_pCurrentWorld->things[i];
@@ -321,6 +321,10 @@ int sithThing_ShouldSync(sithThing *thing);
 sithThing* sithThing_GetById(int thing_id);
 int sithThing_HasAttachment(sithThing *thing);
 
+#ifdef QOL_IMPROVEMENTS
+void sithThing_AddActive(sithThing *thing);
+#endif
+
 //static float (*sithThing_Hit)(sithThing *sender, sithThing *receiver, float amount, int a4) = (void*)sithThing_Hit_ADDR;
 //static void (*sithThing_LandThing)(sithThing *a1, sithThing *a2, rdFace *a3, rdVector3* a4, int a5) = (void*)sithThing_LandThing_ADDR;
 static int (*_sithThing_Load)(sithWorld *world, int a2) = (void*)sithThing_Load_ADDR;
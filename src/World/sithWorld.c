@@ -27,6 +27,7 @@
 #include "Cog/sithCog.h"
 #include "General/util.h"
 #include "World/sithPlayer.h"
+#include "World/sithPVS.h"
 #include "jk.h"
 
 static char jkl_read_copyright[1088];
@@ -292,6 +293,9 @@ int sithWorld_NewEntry(sithWorld *world)
             }
             if ( !sithWorld_Verify(world) )
                 return 0;
+
+            // Added: sector visibility, not fatal if it fails
+            sithPVS_Build(world);
         }
         world->level_type_maybe |= 2;
     }
@@ -323,6 +327,7 @@ void sithWorld_FreeEntry(sithWorld *world)
     }
     if ( world->things )
         sithThing_Free(world);
+    sithPVS_Free(world); // Added
     if ( world->sectors )
         sithSector_Free(world);
     if ( world->models )
@@ -13,6 +13,13 @@
 #include "external/fcaseopen/fcaseopen.h"
 #endif
 
+#ifdef SDL2_RENDER
+#include <SDL.h>
+
+// globals.h defines SDL_cpuinfo_h_, so SDL.h leaves this out
+extern DECLSPEC int SDLCALL SDL_GetCPUCount(void);
+#endif
+
 #ifdef PLATFORM_POSIX
 uint32_t Linux_TimeMs()
 {
@@ -187,6 +194,16 @@ int stdPlatform_Startup()
     return 1;
 }
 
+#ifdef SDL2_RENDER
+// Added: logical CPUs, for sizing worker thread pools
+int stdPlatform_GetNumCpus()
+{
+    int numCpus = SDL_GetCPUCount();
+
+    return numCpus > 0 ? numCpus : 1;
+}
+#endif
+
 #ifdef PLATFORM_POSIX
 int stdPrintf(void* a1, char *a2, int line, char *fmt, ...)
 {
@@ -41,4 +41,8 @@ int stdPlatform_Printf(const char *fmt, ...);
 uint32_t stdPlatform_GetTimeMsec();
 #endif
 
+#ifdef SDL2_RENDER
+int stdPlatform_GetNumCpus();
+#endif
+
 #endif // _STDPLATFORM_H
@@ -693,6 +693,9 @@ typedef struct rdTri
   int v3;
   int flags;
   rdDDrawSurface *texture; // DirectDrawSurface*
+#ifdef SDL2_RENDER
+  uint64_t sortKey;
+#endif
 } rdTri;
 
 typedef struct rdLine